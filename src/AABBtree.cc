@@ -119,6 +119,51 @@ namespace G2lib {
     return hypot(dx,dy);
   }
 
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  real_type
+  BBox::distance( BBox const & box ) const {
+    real_type dx = max( real_type(0), max( box.xmin-xmax, xmin-box.xmax ) );
+    real_type dy = max( real_type(0), max( box.ymin-ymax, ymin-box.ymax ) );
+    return hypot(dx,dy);
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  bool
+  BBox::rayIntersect(
+    real_type   x0,
+    real_type   y0,
+    real_type   dx,
+    real_type   dy,
+    real_type   tmax,
+    real_type & t
+  ) const {
+    // slab method
+    real_type t0 = 0;
+    real_type t1 = tmax;
+    if ( isZero(dx) ) {
+      if ( x0 < xmin || x0 > xmax ) return false;
+    } else {
+      real_type ta = (xmin-x0)/dx;
+      real_type tb = (xmax-x0)/dx;
+      if ( ta > tb ) std::swap( ta, tb );
+      t0 = max( t0, ta );
+      t1 = min( t1, tb );
+    }
+    if ( isZero(dy) ) {
+      if ( y0 < ymin || y0 > ymax ) return false;
+    } else {
+      real_type ta = (ymin-y0)/dy;
+      real_type tb = (ymax-y0)/dy;
+      if ( ta > tb ) std::swap( ta, tb );
+      t0 = max( t0, ta );
+      t1 = min( t1, tb );
+    }
+    t = t0;
+    return t0 <= t1;
+  }
+
   /*\
    |      _        _    ____  ____  _
    |     / \      / \  | __ )| __ )| |_ _ __ ___  ___
@@ -280,47 +325,55 @@ namespace G2lib {
 
   // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
 
+  void
+  AABBtree::addPerfCounts(
+    unsigned long long nodes,
+    unsigned long long leaves
+  ) {
+    G2LIB_PERF_ADD(aabb_nodes,nodes);
+    G2LIB_PERF_ADD(aabb_leaf_tests,leaves);
+    #ifndef G2LIB_PERF_COUNTERS
+    (void)nodes; (void)leaves;
+    #endif
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  // collect the pairs of overlapping leaves
+  class BBox_pair_collect {
+    AABBtree::VecPairPtrBBox & intersectionList;
+    bool                       swap_tree;
+  public:
+    BBox_pair_collect( AABBtree::VecPairPtrBBox & _iList, bool _swap_tree )
+    : intersectionList(_iList), swap_tree(_swap_tree)
+    {}
+
+    bool
+    operator () ( AABBtree::PtrBBox const & b1, AABBtree::PtrBBox const & b2 ) {
+      if ( swap_tree )
+        intersectionList.push_back( AABBtree::PairPtrBBox( b2, b1 ) );
+      else
+        intersectionList.push_back( AABBtree::PairPtrBBox( b1, b2 ) );
+      return true;
+    }
+  };
+
   void
   AABBtree::intersect(
     AABBtree const & tree,
     VecPairPtrBBox & intersectionList,
     bool             swap_tree
   ) const {
+    BBox_pair_collect fun( intersectionList, swap_tree );
+    this->intersect_visit( tree, fun );
+  }
 
-    // check bbox with
-    if ( !tree.pBBox->collision(*pBBox) ) return;
-
-    int icase = (children.empty() ? 0 : 1) +
-                (tree.children.empty()? 0 : 2);
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
 
-    switch ( icase ) {
-    case 0: // both leaf
-      if ( swap_tree )
-        intersectionList.push_back( PairPtrBBox(tree.pBBox,pBBox ) );
-      else
-        intersectionList.push_back( PairPtrBBox(pBBox,tree.pBBox ) );
-      break;
-    case 1: // first is a tree, second is a leaf
-      { vector<PtrAABB>::const_iterator it;
-        for ( it = children.begin(); it != children.end(); ++it )
-          tree.intersect( **it, intersectionList, !swap_tree );
-      }
-      break;
-    case 2: // first leaf, second is a tree
-      { vector<PtrAABB>::const_iterator it;
-        for ( it = tree.children.begin(); it != tree.children.end(); ++it )
-          this->intersect( **it, intersectionList, swap_tree );
-      }
-      break;
-    case 3: // first is a tree, second is a tree
-      { vector<PtrAABB>::const_iterator c1;
-        vector<PtrAABB>::const_iterator c2;
-        for ( c1 = children.begin(); c1 != children.end(); ++c1 )
-          for ( c2 = tree.children.begin(); c2 != tree.children.end(); ++c2 )
-            (*c1)->intersect( **c2, intersectionList, swap_tree );
-      }
-      break;
-    }
+  void
+  AABBtree::intersect_self( VecPairPtrBBox & intersectionList ) const {
+    BBox_pair_collect fun( intersectionList, false );
+    this->intersect_self_visit( fun );
   }
 
   // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
@@ -332,22 +385,29 @@ namespace G2lib {
     AABBtree const & tree,
     real_type        mmDist
   ) {
+    if ( tree.empty() ) return mmDist;
+    SmallStack<AABBtree const *> stack;
+    stack.push( &tree );
+    while ( !stack.empty() ) {
+      AABBtree const * node = stack.pop();
+      G2LIB_PERF_COUNT(aabb_nodes);
 
-    vector<PtrAABB> const & children = tree.children;
+      vector<PtrAABB> const & children = node->children;
 
-    if ( children.empty() ) {
-      real_type dst = tree.pBBox->maxDistance( x, y );
-      return min( dst, mmDist );
-    }
-
-    real_type dmin = tree.pBBox->distance( x, y );
-    if ( dmin > mmDist ) return mmDist;
+      if ( children.empty() ) {
+        real_type dst = node->pBBox->maxDistance( x, y );
+        if ( dst < mmDist ) mmDist = dst;
+        continue;
+      }
 
-    // check bbox with
-    vector<PtrAABB>::const_iterator it;
-    for ( it = children.begin(); it != children.end(); ++it )
-      mmDist = min_maxdist( x, y, **it, mmDist );
+      real_type dmin = node->pBBox->distance( x, y );
+      if ( dmin > mmDist ) continue;
 
+      // check bbox with
+      vector<PtrAABB>::const_iterator it;
+      for ( it = children.begin(); it != children.end(); ++it )
+        stack.push( &(**it) );
+    }
     return mmDist;
   }
 
@@ -361,16 +421,23 @@ namespace G2lib {
     AABBtree const & tree,
     VecPtrBBox     & candidateList
   ) {
-    vector<PtrAABB> const & children = tree.children;
-    real_type dst = tree.pBBox->distance( x, y );
-    if ( dst <= mmDist ) {
+    if ( tree.empty() ) return;
+    SmallStack<AABBtree const *> stack;
+    stack.push( &tree );
+    while ( !stack.empty() ) {
+      AABBtree const * node = stack.pop();
+      G2LIB_PERF_COUNT(aabb_nodes);
+      vector<PtrAABB> const & children = node->children;
+      real_type dst = node->pBBox->distance( x, y );
+      if ( dst > mmDist ) continue;
       if ( children.empty() ) {
-        candidateList.push_back( tree.pBBox );
+        G2LIB_PERF_COUNT(aabb_leaf_tests);
+        candidateList.push_back( node->pBBox );
       } else {
         // check bbox with
         vector<PtrAABB>::const_iterator it;
         for ( it = children.begin(); it != children.end(); ++it )
-          min_maxdist_select( x, y, mmDist, **it, candidateList );
+          stack.push( &(**it) );
       }
     }
   }
@@ -389,6 +456,100 @@ namespace G2lib {
     min_maxdist_select( x, y, mmDist, *this, candidateList );
   }
 
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtree::within_distance(
+    real_type    x,
+    real_type    y,
+    real_type    r,
+    VecPtrBBox & bboxList
+  ) const {
+    if ( empty() ) return;
+    SmallStack<AABBtree const *> stack;
+    stack.push( this );
+    while ( !stack.empty() ) {
+      AABBtree const * node = stack.pop();
+      G2LIB_PERF_COUNT(aabb_nodes);
+      if ( node->pBBox->distance( x, y ) > r ) continue;
+      if ( node->children.empty() ) {
+        G2LIB_PERF_COUNT(aabb_leaf_tests);
+        bboxList.push_back( node->pBBox );
+      } else {
+        vector<PtrAABB>::const_iterator it;
+        for ( it = node->children.begin(); it != node->children.end(); ++it )
+          stack.push( &(**it) );
+      }
+    }
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtree::within_distance(
+    BBox const & box,
+    real_type    r,
+    VecPtrBBox & bboxList
+  ) const {
+    if ( empty() ) return;
+    SmallStack<AABBtree const *> stack;
+    stack.push( this );
+    while ( !stack.empty() ) {
+      AABBtree const * node = stack.pop();
+      G2LIB_PERF_COUNT(aabb_nodes);
+      if ( node->pBBox->distance( box ) > r ) continue;
+      if ( node->children.empty() ) {
+        G2LIB_PERF_COUNT(aabb_leaf_tests);
+        bboxList.push_back( node->pBBox );
+      } else {
+        vector<PtrAABB>::const_iterator it;
+        for ( it = node->children.begin(); it != node->children.end(); ++it )
+          stack.push( &(**it) );
+      }
+    }
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  class BBox_k_nearest {
+    real_type              x;
+    real_type              y;
+    size_t                 k;
+    AABBtree::VecPtrBBox & bboxList;
+  public:
+    BBox_k_nearest(
+      real_type              _x,
+      real_type              _y,
+      size_t                 _k,
+      AABBtree::VecPtrBBox & _bboxList
+    )
+    : x(_x), y(_y), k(_k), bboxList(_bboxList)
+    {}
+
+    real_type
+    distance( AABBtree::PtrBBox const & pbox ) const
+    { return pbox->distance( x, y ); }
+
+    bool
+    visit( AABBtree::PtrBBox const & pbox, real_type ) {
+      bboxList.push_back( pbox );
+      return bboxList.size() < k;
+    }
+  };
+
+  void
+  AABBtree::k_nearest(
+    real_type    x,
+    real_type    y,
+    int_type     k,
+    VecPtrBBox & bboxList
+  ) const {
+    bboxList.clear();
+    if ( k <= 0 ) return;
+    BBox_k_nearest fun( x, y, size_t(k), bboxList );
+    this->nearest( x, y, fun );
+  }
+
 }
 
 ///
@@ -33,6 +33,7 @@
 #include "G2lib.hh"
 
 #include <vector>
+#include <algorithm> // push_heap, pop_heap
 #include <iomanip>
 #include <utility> // pair
 
@@ -149,6 +150,27 @@ namespace G2lib {
     real_type
     maxDistance( real_type x, real_type y ) const;
 
+    //! distance of the bbox `box` to the bbox (0 if they overlap)
+    real_type
+    distance( BBox const & box ) const;
+
+    /*!
+     * Intersect the ray `(x0,y0)+t*(dx,dy)`, `0 <= t <= tmax` with the bbox
+     *
+     * \param[out] t parameter of the entry point of the ray in the bbox
+     *               (0 if `(x0,y0)` is inside the bbox)
+     * \return true if the ray cross the bbox
+     */
+    bool
+    rayIntersect(
+      real_type   x0,
+      real_type   y0,
+      real_type   dx,
+      real_type   dy,
+      real_type   tmax,
+      real_type & t
+    ) const;
+
     void
     print( ostream_type & stream ) const {
       stream
@@ -198,6 +220,106 @@ namespace G2lib {
 
     AABBtree( AABBtree const & tree );
 
+    // stack of the iterative traversals, the first `N` items are stored
+    // in a fixed size array, the heap is used only for very deep trees
+    template <typename T>
+    class SmallStack {
+      static unsigned const N = 64;
+      T         fixed[N];
+      vector<T> extra;
+      unsigned  n;
+    public:
+      SmallStack() : n(0) {}
+
+      bool empty() const { return n == 0; }
+
+      void
+      push( T const & v ) {
+        if ( n < N ) fixed[n++] = v;
+        else         extra.push_back( v );
+      }
+
+      T
+      pop() {
+        if ( !extra.empty() ) {
+          T v = extra.back();
+          extra.pop_back();
+          return v;
+        }
+        return fixed[--n];
+      }
+    };
+
+    // pair of nodes of the simultaneous traversal of two trees
+    class NodePair {
+    public:
+      AABBtree const * A;
+      AABBtree const * B;
+      NodePair() : A(nullptr), B(nullptr) {}
+      NodePair( AABBtree const * a, AABBtree const * b ) : A(a), B(b) {}
+    };
+
+    // nodes and leaves visited by the traversals of the templates,
+    // added to the performance counters when the traversal ends.
+    // The templates do not use G2LIB_PERF_COUNT: they are compiled in the
+    // user code and must be the same with and without G2LIB_PERF_COUNTERS
+    class VisitCount {
+    public:
+      unsigned long long nodes;
+      unsigned long long leaves;
+      VisitCount() : nodes(0), leaves(0) {}
+      ~VisitCount() { addPerfCounts( nodes, leaves ); }
+    };
+
+    // does nothing if the library is compiled without G2LIB_PERF_COUNTERS
+    static
+    void
+    addPerfCounts( unsigned long long nodes, unsigned long long leaves );
+
+    real_type
+    area() const {
+      return ( pBBox->Xmax() - pBBox->Xmin() ) *
+             ( pBBox->Ymax() - pBBox->Ymin() );
+    }
+
+    // adapt the functor of `collision` to `intersect_visit`
+    template <typename COLLISION_fun>
+    class CollisionVisitor {
+      COLLISION_fun & ifun;
+      bool            swap_tree;
+    public:
+      bool collide;
+      CollisionVisitor( COLLISION_fun & _ifun, bool _swap_tree )
+      : ifun(_ifun), swap_tree(_swap_tree), collide(false) {}
+
+      bool
+      operator () ( PtrBBox const & b1, PtrBBox const & b2 ) {
+        collide = swap_tree ? ifun( b2, b1 ) : ifun( b1, b2 );
+        return !collide;
+      }
+    };
+
+    // element of the priority queue used in `nearest`
+    class NearestItem {
+    public:
+      real_type        dst;   // distance (lower bound if not exact)
+      AABBtree const * node;
+      bool             exact; // leaf with the distance already computed
+      NearestItem( real_type d, AABBtree const * n, bool e )
+      : dst(d), node(n), exact(e) {}
+      // reversed to have the nearest on top of the queue
+      bool
+      operator < ( NearestItem const & rhs ) const
+      { return dst > rhs.dst; }
+    };
+
+  public:
+
+    //! heap of the best-first searches, can be reused between the queries
+    typedef vector<NearestItem> NearestQueue;
+
+  private:
+
     /*!
      * Compute the minimum of the maximum distance
      * between a point
@@ -241,6 +363,13 @@ namespace G2lib {
 
     bool empty() const; //!< check if AABB tree is empty
 
+    //! exchange the content of two AABB tree (no copy of the nodes)
+    void
+    swap( AABBtree & tree ) {
+      std::swap( pBBox, tree.pBBox );
+      children.swap( tree.children );
+    }
+
     void
     bbox(
       real_type & xmin,
@@ -277,44 +406,117 @@ namespace G2lib {
       COLLISION_fun    ifun,
       bool             swap_tree = false
     ) const {
+      CollisionVisitor<COLLISION_fun> visitor( ifun, swap_tree );
+      this->intersect_visit( tree, visitor );
+      return visitor.collide;
+    }
+
+    /*!
+     * Visit the pairs of overlapping leaves of two AABB trees
+     * (iterative simultaneous traversal, no memory allocated for
+     * trees of depth less than 64).
+     * The functor `fun` must implement
+     *
+     * - `bool fun( PtrBBox const & b1, PtrBBox const & b2 )` called for each
+     *   pair of overlapping leaves, `b1` of this tree and `b2` of `tree`,
+     *   return `false` to stop the visit
+     *
+     * \param[in] tree the second AABB tree
+     * \param[in] fun  the functor called for each pair of leaves
+     * \return false if the visit was stopped by `fun`
+     */
+    template <typename PAIR_fun>
+    bool
+    intersect_visit(
+      AABBtree const & tree,
+      PAIR_fun       & fun
+    ) const {
 
-      // check bbox with
-      if ( !tree.pBBox->collision(*pBBox) ) return false;
-
-      int icase = (children.empty() ? 0 : 1) +
-                  (tree.children.empty()? 0 : 2);
-
-      switch ( icase ) {
-      case 0: // both leaf, use GeomPrimitive intersection algorithm
-        if ( swap_tree ) return ifun( tree.pBBox, pBBox );
-        else             return ifun( pBBox, tree.pBBox );
-      case 1: // first is a tree, second is a leaf
-        { typename vector<PtrAABB>::const_iterator it;
-          for ( it = children.begin(); it != children.end(); ++it )
-            if ( tree.collision( **it, ifun, !swap_tree ) )
-              return true;
+      if ( empty() || tree.empty() ) return true;
+
+      VisitCount           count;
+      SmallStack<NodePair> stack;
+      stack.push( NodePair( this, &tree ) );
+      while ( !stack.empty() ) {
+        NodePair P = stack.pop();
+        ++count.nodes;
+
+        // check bbox with
+        if ( !P.A->pBBox->collision(*P.B->pBBox) ) continue;
+
+        bool leafA = P.A->children.empty();
+        bool leafB = P.B->children.empty();
+
+        if ( leafA && leafB ) {
+          // both leaf, use GeomPrimitive intersection algorithm
+          ++count.leaves;
+          if ( !fun( P.A->pBBox, P.B->pBBox ) ) return false;
+        } else if ( leafB || ( !leafA && P.A->area() >= P.B->area() ) ) {
+          // descend the first tree
+          typename vector<PtrAABB>::const_iterator it;
+          for ( it = P.A->children.begin(); it != P.A->children.end(); ++it )
+            stack.push( NodePair( &(**it), P.B ) );
+        } else {
+          // descend the second tree
+          typename vector<PtrAABB>::const_iterator it;
+          for ( it = P.B->children.begin(); it != P.B->children.end(); ++it )
+            stack.push( NodePair( P.A, &(**it) ) );
         }
-        break;
-      case 2: // first leaf, second is a tree
-        { typename vector<PtrAABB>::const_iterator it;
-          for ( it = tree.children.begin();
-                it != tree.children.end(); ++it )
-            if ( this->collision( **it, ifun, swap_tree ) )
-              return true;
+      }
+      return true;
+    }
+
+    /*!
+     * Visit the pairs of distinct overlapping leaves of the tree
+     * (traversal of the tree against itself, each unordered pair
+     * is visited only once).
+     * The functor `fun` is the same of `intersect_visit`.
+     *
+     * \param[in] fun the functor called for each pair of leaves
+     * \return false if the visit was stopped by `fun`
+     */
+    template <typename PAIR_fun>
+    bool
+    intersect_self_visit( PAIR_fun & fun ) const {
+
+      if ( empty() ) return true;
+
+      VisitCount           count;
+      SmallStack<NodePair> stack;
+      stack.push( NodePair( this, this ) );
+      while ( !stack.empty() ) {
+        NodePair P = stack.pop();
+        ++count.nodes;
+
+        if ( P.A == P.B ) {
+          // same node: pairs of children (and child with itself)
+          vector<PtrAABB> const & ch = P.A->children;
+          for ( size_t i = 0; i < ch.size(); ++i )
+            for ( size_t j = i; j < ch.size(); ++j )
+              stack.push( NodePair( &(*ch[i]), &(*ch[j]) ) );
+          continue;
         }
-        break;
-      case 3: // first is a tree, second is a tree
-        { typename vector<PtrAABB>::const_iterator c1;
-          typename vector<PtrAABB>::const_iterator c2;
-          for ( c1 = children.begin(); c1 != children.end(); ++c1 )
-            for ( c2 = tree.children.begin();
-                  c2 != tree.children.end(); ++c2 )
-              if ( (*c1)->collision( **c2, ifun, swap_tree ) )
-                return true;
+
+        // check bbox with
+        if ( !P.A->pBBox->collision(*P.B->pBBox) ) continue;
+
+        bool leafA = P.A->children.empty();
+        bool leafB = P.B->children.empty();
+
+        if ( leafA && leafB ) {
+          ++count.leaves;
+          if ( !fun( P.A->pBBox, P.B->pBBox ) ) return false;
+        } else if ( leafB || ( !leafA && P.A->area() >= P.B->area() ) ) {
+          typename vector<PtrAABB>::const_iterator it;
+          for ( it = P.A->children.begin(); it != P.A->children.end(); ++it )
+            stack.push( NodePair( &(**it), P.B ) );
+        } else {
+          typename vector<PtrAABB>::const_iterator it;
+          for ( it = P.B->children.begin(); it != P.B->children.end(); ++it )
+            stack.push( NodePair( P.A, &(**it) ) );
         }
-        break;
       }
-      return false;
+      return true;
     }
 
     /*!
@@ -333,6 +535,14 @@ namespace G2lib {
       bool             swap_tree = false
     ) const;
 
+    /*!
+     * Compute the pairs of distinct overlapping bbox of the tree
+     *
+     * \param[out] intersectionList list of pair bbox that overlaps (appended)
+     */
+    void
+    intersect_self( VecPairPtrBBox & intersectionList ) const;
+
     void
     min_distance(
       real_type    x,
@@ -340,6 +550,221 @@ namespace G2lib {
       VecPtrBBox & candidateList
     ) const;
 
+    /*!
+     * Select the bbox with distance from the point `(x,y)` not greater than `r`
+     *
+     * \param[in]  x        x-coordinate of the point
+     * \param[in]  y        y-coordinate of the point
+     * \param[in]  r        search radius
+     * \param[out] bboxList list of the selected bbox (appended)
+     */
+    void
+    within_distance(
+      real_type    x,
+      real_type    y,
+      real_type    r,
+      VecPtrBBox & bboxList
+    ) const;
+
+    /*!
+     * Select the bbox with distance from the bbox `box` not greater than `r`
+     *
+     * \param[in]  box      the reference bbox
+     * \param[in]  r        search radius
+     * \param[out] bboxList list of the selected bbox (appended)
+     */
+    void
+    within_distance(
+      BBox const & box,
+      real_type    r,
+      VecPtrBBox & bboxList
+    ) const;
+
+    /*!
+     * Select the `k` bbox nearest to the point `(x,y)`
+     * ordered by increasing distance
+     *
+     * \param[in]  x        x-coordinate of the point
+     * \param[in]  y        y-coordinate of the point
+     * \param[in]  k        number of bbox to be selected
+     * \param[out] bboxList list of the selected bbox
+     */
+    void
+    k_nearest(
+      real_type    x,
+      real_type    y,
+      int_type     k,
+      VecPtrBBox & bboxList
+    ) const;
+
+    /*!
+     * Visit the leaves of the tree by increasing distance from the point
+     * `(x,y)` (best-first search with a priority queue).
+     * The functor `fun` must implement
+     *
+     * - `real_type fun.distance( PtrBBox pbox )` the distance of the point
+     *   from the object contained in `pbox`, must be not less than the
+     *   distance from the bbox
+     * - `bool fun.visit( PtrBBox pbox, real_type dst )` called by increasing
+     *   `dst`, return `false` to stop the search
+     *
+     */
+    template <typename NEAREST_fun>
+    void
+    nearest(
+      real_type     x,
+      real_type     y,
+      NEAREST_fun & fun
+    ) const {
+      NearestQueue pq;
+      nearest( x, y, fun, pq );
+    }
+
+    //! as `nearest` using `pq` as the priority queue (no allocation if reused)
+    template <typename NEAREST_fun>
+    void
+    nearest(
+      real_type      x,
+      real_type      y,
+      NEAREST_fun  & fun,
+      NearestQueue & pq
+    ) const {
+
+      pq.clear();
+      if ( empty() ) return;
+
+      typedef NearestItem Item;
+      VisitCount          count;
+      pq.push_back( Item( pBBox->distance( x, y ), this, false ) );
+      while ( !pq.empty() ) {
+        std::pop_heap( pq.begin(), pq.end() );
+        Item it = pq.back(); pq.pop_back();
+        ++count.nodes;
+        AABBtree const & tree = *it.node;
+        if ( it.exact ) {
+          if ( !fun.visit( tree.pBBox, it.dst ) ) return;
+        } else if ( tree.children.empty() ) {
+          ++count.leaves;
+          pq.push_back( Item( fun.distance( tree.pBBox ), it.node, true ) );
+          std::push_heap( pq.begin(), pq.end() );
+        } else {
+          typename vector<PtrAABB>::const_iterator ic;
+          for ( ic = tree.children.begin(); ic != tree.children.end(); ++ic ) {
+            pq.push_back( Item( (*ic)->pBBox->distance( x, y ), &(**ic), false ) );
+            std::push_heap( pq.begin(), pq.end() );
+          }
+        }
+      }
+    }
+
+    /*!
+     * Find the first object of the tree hit by the ray
+     * `(x0,y0)+t*(dx,dy)`, `0 <= t <= tmax`.
+     * The leaves are visited by increasing entry parameter of the
+     * ray in the bbox. The functor `fun` must implement
+     *
+     * - `bool fun.hit( PtrBBox pbox, real_type tmax, real_type & t )`
+     *   intersect the ray with the object contained in `pbox`, return `true`
+     *   if hit with parameter `t <= tmax` (`tmax` shrinks as hits are found)
+     *
+     * \return true if an object is hit, the last successful call of
+     *         `fun.hit` is the nearest hit
+     */
+    template <typename RAY_fun>
+    bool
+    raycast(
+      real_type   x0,
+      real_type   y0,
+      real_type   dx,
+      real_type   dy,
+      real_type   tmax,
+      RAY_fun   & fun
+    ) const {
+      NearestQueue pq;
+      return raycast( x0, y0, dx, dy, tmax, fun, pq );
+    }
+
+    //! as `raycast` using `pq` as the priority queue (no allocation if reused)
+    template <typename RAY_fun>
+    bool
+    raycast(
+      real_type      x0,
+      real_type      y0,
+      real_type      dx,
+      real_type      dy,
+      real_type      tmax,
+      RAY_fun      & fun,
+      NearestQueue & pq
+    ) const {
+
+      pq.clear();
+      if ( empty() ) return false;
+
+      typedef NearestItem Item;
+      VisitCount          count;
+      real_type t;
+      if ( !pBBox->rayIntersect( x0, y0, dx, dy, tmax, t ) ) return false;
+      pq.push_back( Item( t, this, false ) );
+      while ( !pq.empty() ) {
+        std::pop_heap( pq.begin(), pq.end() );
+        Item it = pq.back(); pq.pop_back();
+        ++count.nodes;
+        AABBtree const & tree = *it.node;
+        if ( it.exact ) {
+          return true;
+        } else if ( tree.children.empty() ) {
+          ++count.leaves;
+          if ( fun.hit( tree.pBBox, tmax, t ) ) {
+            tmax = t;
+            pq.push_back( Item( t, it.node, true ) );
+            std::push_heap( pq.begin(), pq.end() );
+          }
+        } else {
+          typename vector<PtrAABB>::const_iterator ic;
+          for ( ic = tree.children.begin(); ic != tree.children.end(); ++ic ) {
+            if ( (*ic)->pBBox->rayIntersect( x0, y0, dx, dy, tmax, t ) ) {
+              pq.push_back( Item( t, &(**ic), false ) );
+              std::push_heap( pq.begin(), pq.end() );
+            }
+          }
+        }
+      }
+      return false;
+    }
+
+  };
+
+  //! \brief Scratch space of the queries that use the AABB trees
+  /*!
+   * The vectors keep their capacity between the calls: passing the same
+   * workspace to the queries (`closestPoint_ISO`, `intersect_ISO`, ...)
+   * no heap allocation is done after the first calls.
+   * A workspace must not be shared by threads running concurrently.
+   */
+  class AABBworkspace {
+  public:
+    AABBtree::VecPtrBBox     candidateList;    //!< bbox selected by a query on a point
+    AABBtree::VecPairPtrBBox intersectionList; //!< pairs of overlapping bbox
+    IntersectList            ilist;            //!< intersections of two primitives
+    AABBtree::NearestQueue   queue;            //!< heap of the best-first searches
+
+    //! reserve the space for `n` bbox (or pairs)
+    void
+    reserve( size_t n ) {
+      candidateList.reserve( n );
+      intersectionList.reserve( n );
+      ilist.reserve( n );
+      queue.reserve( n );
+    }
+
+    //! release the bbox (the capacity is kept)
+    void
+    clear() {
+      candidateList.clear();
+      intersectionList.clear();
+      ilist.clear();
+      queue.clear();
+    }
   };
 
 }
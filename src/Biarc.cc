@@ -823,7 +823,7 @@ namespace G2lib {
     if ( dst1 < dst ) {
       x   = x1;
       y   = y1;
-      s   = s1;
+      s   = s1 + C0.length();
       t   = t1;
       dst = dst1;
       res = res1;
@@ -850,7 +850,7 @@ namespace G2lib {
     if ( dst1 < dst ) {
       x   = x1;
       y   = y1;
-      s   = s1;
+      s   = s1 + C0.length();
       t   = t1;
       dst = dst1;
       res = res1;
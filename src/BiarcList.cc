@@ -21,6 +21,7 @@
 #include "BiarcList.hh"
 #include "Clothoid.hh"
 #include "ClothoidList.hh"
+#include "CurveStatic.hh"
 
 #include <cmath>
 #include <cfloat>
@@ -28,6 +29,11 @@
 #include <limits>
 #include <algorithm>
 
+#ifdef G2LIB_USE_CXX11
+#include <thread>
+#include <exception>
+#endif
+
 #ifdef __GNUC__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wsign-conversion"
@@ -58,6 +64,8 @@ namespace G2lib {
   : BaseCurve(G2LIB_BIARC_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , arcs_done(false)
+  , arcs_last_block(0)
   {
     init();
     push_back( LS );
@@ -67,6 +75,8 @@ namespace G2lib {
   : BaseCurve(G2LIB_BIARC_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , arcs_done(false)
+  , arcs_last_block(0)
   {
     init();
     push_back( C );
@@ -76,6 +86,8 @@ namespace G2lib {
   : BaseCurve(G2LIB_BIARC_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , arcs_done(false)
+  , arcs_last_block(0)
   {
     init();
     push_back( C );
@@ -85,6 +97,8 @@ namespace G2lib {
   : BaseCurve(G2LIB_BIARC_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , arcs_done(false)
+  , arcs_last_block(0)
   {
     init();
     push_back( pl );
@@ -94,6 +108,8 @@ namespace G2lib {
   : BaseCurve(G2LIB_BIARC_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , arcs_done(false)
+  , arcs_last_block(0)
   {
     init();
     switch ( C.type() ) {
@@ -125,6 +141,7 @@ namespace G2lib {
 
   void
   BiarcList::init() {
+    aabb_done = arcs_done = false;
     s0.clear();
     biarcList.clear();
     last_idx = 0;
@@ -134,6 +151,7 @@ namespace G2lib {
 
   void
   BiarcList::copy( BiarcList const & L ) {
+    aabb_done = arcs_done = false;
     biarcList.clear();
     biarcList.reserve(L.biarcList.size());
     std::copy( L.biarcList.begin(),
@@ -158,6 +176,7 @@ namespace G2lib {
 
   void
   BiarcList::push_back( LineSegment const & LS ) {
+    aabb_done = arcs_done = false;
     if ( biarcList.empty() ) {
       s0.push_back(0);
       s0.push_back(LS.length());
@@ -171,6 +190,7 @@ namespace G2lib {
 
   void
   BiarcList::push_back( CircleArc const & C ) {
+    aabb_done = arcs_done = false;
     if ( biarcList.empty() ) {
       s0.push_back(0);
       s0.push_back(C.length());
@@ -184,6 +204,7 @@ namespace G2lib {
 
   void
   BiarcList::push_back( Biarc const & c ) {
+    aabb_done = arcs_done = false;
     if ( biarcList.empty() ) {
       s0.push_back(0);
       s0.push_back(c.length());
@@ -197,6 +218,7 @@ namespace G2lib {
 
   void
   BiarcList::push_back( PolyLine const & c ) {
+    aabb_done = arcs_done = false;
     s0.reserve( s0.size() + c.polylineList.size() + 1 );
     biarcList.reserve( biarcList.size() + c.polylineList.size() );
 
@@ -290,6 +312,222 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  /*\
+   |   Bound of the distance of the points of the clothoid C(s), a <= s <= b,
+   |   from the biarc B. Given the samples s_j with the projections B(u_j)
+   |   at distance d_j, on [s_j,s_j+1] (length h) the function
+   |   f(s) = C(s)-B(u(s)), with u(s) linear from u_j to u_j+1, satisfies
+   |
+   |     |f(s)| <= max(d_j,d_j+1) + M*h^2/8,  M >= |f''|
+   |
+   |   with f'' = kC*NC - r^2*kB*NB (k curvature, N normal, r = u').
+   |   Since |NC-NB| <= |thC-thB| and d(thC-thB)/ds = kC-r*kB
+   |
+   |     M = max|kC-r^2*kB| + r^2*max|kB|*max|thC-thB|
+   |
+   |   where kC is linear and kB is the curvature of the arcs touched.
+   |   The sample intervals are bisected until the bound is less than tol.
+  \*/
+
+  class BiarcSample {
+  public:
+    real_type s, u, d, dth; // abscissa on the clothoid and on the biarc, distance, angle
+    BiarcSample() : s(0), u(0), d(0), dth(0) {}
+
+    // sample with the projection on the biarc
+    BiarcSample(
+      ClothoidCurve const & C,
+      Biarc         const & B,
+      real_type             _s
+    ) : s(_s) {
+      real_type qx, qy, x, y, t;
+      C.eval( s, qx, qy );
+      B.closestPoint_ISO( qx, qy, x, y, u, t, d );
+      dth = C.theta(s) - B.theta(u);
+      rangeSymm( dth );
+    }
+
+    // sample at the extrema (the biarc interpolates the clothoid)
+    BiarcSample( real_type _s, real_type _u )
+    : s(_s), u(_u), d(0), dth(0) {}
+  };
+
+  // maximum of |kC - r*kB| for kC in [kC0,kC1] and the arcs of B touched by [ua,ub]
+  static
+  real_type
+  maxCurvatureGap(
+    Biarc const & B,
+    real_type     kC0,
+    real_type     kC1,
+    real_type     r,
+    real_type     ua,
+    real_type     ub
+  ) {
+    real_type L0  = B.getC0().length();
+    real_type res = 0;
+    for ( int_type i = 0; i < 2; ++i ) {
+      if ( i == 0 && std::min(ua,ub) > L0 ) continue;
+      if ( i == 1 && std::max(ua,ub) < L0 ) continue;
+      real_type kB = r*( i == 0 ? B.getC0().curvature() : B.getC1().curvature() );
+      res = std::max( res, std::max( abs(kC0-kB), abs(kC1-kB) ) );
+    }
+    return res;
+  }
+
+  static
+  real_type
+  biarcErrorBound(
+    ClothoidCurve const & C,
+    Biarc         const & B,
+    real_type             a,
+    real_type             b,
+    real_type             tol,
+    int_type              nsamples
+  ) {
+    real_type KB = std::max( abs(B.getC0().curvature()), abs(B.getC1().curvature()) );
+    // the refinement stops after `maxeval` projections, the piece is split
+    int_type  maxeval = 8*nsamples;
+    real_type e = 0;
+    vector<pair<BiarcSample,BiarcSample> > stack;
+    BiarcSample S0( a, 0 ), S1;
+    for ( int_type j = 1; j <= nsamples; ++j ) {
+      if ( j == nsamples ) S1 = BiarcSample( b, B.length() );
+      else                 S1 = BiarcSample( C, B, a+(b-a)*j/nsamples );
+      stack.push_back( pair<BiarcSample,BiarcSample>( S0, S1 ) );
+      S0 = S1;
+    }
+    while ( !stack.empty() ) {
+      BiarcSample SA = stack.back().first;
+      BiarcSample SB = stack.back().second;
+      stack.pop_back();
+      real_type h   = SB.s-SA.s;
+      real_type r   = (SB.u-SA.u)/h;
+      real_type kCA = C.kappa(SA.s);
+      real_type kCB = C.kappa(SB.s);
+      real_type dth = ( abs(SA.dth) + abs(SB.dth) +
+                        maxCurvatureGap( B, kCA, kCB, r, SA.u, SB.u )*h )/2;
+      real_type M   = maxCurvatureGap( B, kCA, kCB, r*r, SA.u, SB.u ) + r*r*KB*dth;
+      real_type dm  = std::max( SA.d, SB.d );
+      real_type ub  = dm + M*h*h/8;
+      if ( ub <= tol || dm > tol || maxeval <= 0 ) {
+        if ( ub > e ) e = ub;
+        if ( e > tol ) break; // the piece must be split
+        continue;
+      }
+      BiarcSample SM( C, B, (SA.s+SB.s)/2 );
+      --maxeval;
+      stack.push_back( pair<BiarcSample,BiarcSample>( SA, SM ) );
+      stack.push_back( pair<BiarcSample,BiarcSample>( SM, SB ) );
+    }
+    return e;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // approximate the clothoid C with biarcs (appended to `biarcs`)
+  // bisecting the pieces with error bound greater than tol
+  static
+  real_type
+  approxClothoidBiarc(
+    ClothoidCurve const & C,
+    real_type             tol,
+    int_type              nsamples,
+    vector<Biarc>       & biarcs
+  ) {
+    real_type L     = C.length();
+    real_type h_min = L*1e-6; // do not split pieces shorter than this
+    real_type err   = 0;
+    vector<pair<real_type,real_type> > stack; // pieces to be approximated
+    stack.push_back( pair<real_type,real_type>( 0, L ) );
+    while ( !stack.empty() ) {
+      real_type a = stack.back().first;
+      real_type b = stack.back().second;
+      stack.pop_back();
+      real_type x0, y0, x1, y1;
+      C.eval( a, x0, y0 );
+      C.eval( b, x1, y1 );
+      real_type th0 = C.theta(a);
+      real_type th1 = C.theta(b);
+      Biarc B;
+      bool ok = abs(th1-th0) <= m_pi_2 && B.build( x0, y0, th0, x1, y1, th1 );
+      real_type e = numeric_limits<real_type>::infinity();
+      if ( ok ) e = biarcErrorBound( C, B, a, b, tol, nsamples );
+      if ( e > tol && b-a > h_min ) {
+        // right half first, the pieces are appended in order
+        real_type m = (a+b)/2;
+        stack.push_back( pair<real_type,real_type>( m, b ) );
+        stack.push_back( pair<real_type,real_type>( a, m ) );
+      } else {
+        G2LIB_ASSERT(
+          ok, "BiarcList::build( CL, tol ), biarc approximation failed"
+        );
+        biarcs.push_back( B );
+        if ( e > err ) err = e;
+      }
+    }
+    return err;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  BiarcList::build(
+    ClothoidList const & CL,
+    real_type            tol,
+    int_type             nthreads,
+    int_type             nsamples
+  ) {
+    G2LIB_ASSERT(
+      tol > 0 && nthreads > 0 && nsamples > 1,
+      "BiarcList::build( CL, tol = " << tol << ", nthreads = " << nthreads <<
+      ", nsamples = " << nsamples << " ) bad parameters"
+    );
+    int_type ns = CL.numSegment();
+    G2LIB_ASSERT( ns > 0, "BiarcList::build( CL, tol ) empty list" );
+
+    // the biarcs of each segment, the segments are split among the threads
+    size_t                 nn = size_t(ns);
+    vector<vector<Biarc> > biarcs( nn );
+    vector<real_type>      errs( nn, 0 );
+    #ifdef G2LIB_USE_CXX11
+    if ( nthreads > ns ) nthreads = ns;
+    size_t                     nt = size_t(nthreads);
+    vector<std::exception_ptr> exc( nt );
+    vector<std::thread>        workers;
+    for ( int_type it = 0; it < nthreads; ++it ) {
+      workers.push_back( std::thread( [&,it]() {
+        try {
+          for ( int_type i = it; i < ns; i += nthreads )
+            errs[size_t(i)] = approxClothoidBiarc(
+              CL.get(i), tol, nsamples, biarcs[size_t(i)]
+            );
+        } catch (...) {
+          exc[size_t(it)] = std::current_exception();
+        }
+      } ) );
+    }
+    for ( size_t it = 0; it < workers.size(); ++it ) workers[it].join();
+    for ( size_t it = 0; it < exc.size(); ++it )
+      if ( exc[it] ) std::rethrow_exception( exc[it] );
+    #else
+    for ( int_type i = 0; i < ns; ++i )
+      errs[size_t(i)] = approxClothoidBiarc(
+        CL.get(i), tol, nsamples, biarcs[size_t(i)]
+      );
+    #endif
+
+    init();
+    real_type err = 0;
+    for ( size_t i = 0; i < nn; ++i ) {
+      vector<Biarc>::const_iterator ib;
+      for ( ib = biarcs[i].begin(); ib != biarcs[i].end(); ++ib ) push_back( *ib );
+      if ( errs[i] > err ) err = errs[i];
+    }
+    return err;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   Biarc const &
   BiarcList::get( int_type idx ) const {
     G2LIB_ASSERT(
@@ -430,19 +668,19 @@ namespace G2lib {
     vector<Triangle2D>::const_iterator it;
     for ( it = tvec.begin(); it != tvec.end(); ++it ) {
       // - - - - - - - - - - - - - - - - - - - -
-      if      ( it->x1() < xmin ) xmin = it->x1();
-      else if ( it->x1() > xmax ) xmax = it->x1();
-      if      ( it->x2() < xmin ) xmin = it->x2();
-      else if ( it->x2() > xmax ) xmax = it->x2();
-      if      ( it->x3() < xmin ) xmin = it->x3();
-      else if ( it->x3() > xmax ) xmax = it->x3();
+      if ( it->x1() < xmin ) xmin = it->x1();
+      if ( it->x1() > xmax ) xmax = it->x1();
+      if ( it->x2() < xmin ) xmin = it->x2();
+      if ( it->x2() > xmax ) xmax = it->x2();
+      if ( it->x3() < xmin ) xmin = it->x3();
+      if ( it->x3() > xmax ) xmax = it->x3();
       // - - - - - - - - - - - - - - - - - - - -
-      if      ( it->y1() < ymin ) ymin = it->y1();
-      else if ( it->y1() > ymax ) ymax = it->y1();
-      if      ( it->y2() < ymin ) ymin = it->y2();
-      else if ( it->y2() > ymax ) ymax = it->y2();
-      if      ( it->y3() < ymin ) ymin = it->y3();
-      else if ( it->y3() > ymax ) ymax = it->y3();
+      if ( it->y1() < ymin ) ymin = it->y1();
+      if ( it->y1() > ymax ) ymax = it->y1();
+      if ( it->y2() < ymin ) ymin = it->y2();
+      if ( it->y2() > ymax ) ymax = it->y2();
+      if ( it->y3() < ymin ) ymin = it->y3();
+      if ( it->y3() > ymax ) ymax = it->y3();
     }
   }
 
@@ -907,6 +1145,38 @@ namespace G2lib {
     return c.eval_ISO_DDD( s - s0[last_idx], offs, x_DDD, y_DDD );
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BiarcList::eval_ISO(
+    int_type        n,
+    real_type const s[],
+    real_type       offs,
+    real_type       x[],
+    real_type       y[]
+  ) const {
+    G2LIB_ASSERT( !biarcList.empty(), "BiarcList::eval_ISO, empty list" );
+    CurveStatic<Biarc>::sample_ISO( biarcList, s0, offs, n, s, x, y );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BiarcList::evaluate_ISO(
+    int_type        n,
+    real_type const s[],
+    real_type       offs,
+    real_type       theta[],
+    real_type       kappa[],
+    real_type       x[],
+    real_type       y[]
+  ) const {
+    G2LIB_ASSERT( !biarcList.empty(), "BiarcList::evaluate_ISO, empty list" );
+    CurveStatic<Biarc>::sample_ISO(
+      biarcList, s0, offs, n, s, theta, kappa, x, y
+    );
+  }
+
   /*\
    |  _                        __
    | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -917,6 +1187,7 @@ namespace G2lib {
 
   void
   BiarcList::translate( real_type tx, real_type ty ) {
+    aabb_done = arcs_done = false;
     vector<Biarc>::iterator ic = biarcList.begin();
     for (; ic != biarcList.end(); ++ic ) ic->translate( tx, ty );
   }
@@ -925,6 +1196,7 @@ namespace G2lib {
 
   void
   BiarcList::rotate( real_type angle, real_type cx, real_type cy ) {
+    aabb_done = arcs_done = false;
     vector<Biarc>::iterator ic = biarcList.begin();
     for (; ic != biarcList.end(); ++ic ) ic->rotate( angle, cx, cy );
   }
@@ -933,6 +1205,7 @@ namespace G2lib {
 
   void
   BiarcList::scale( real_type sfactor ) {
+    aabb_done = arcs_done = false;
     vector<Biarc>::iterator ic = biarcList.begin();
     real_type newx0 = ic->xBegin();
     real_type newy0 = ic->yBegin();
@@ -950,6 +1223,7 @@ namespace G2lib {
 
   void
   BiarcList::reverse() {
+    aabb_done = arcs_done = false;
     std::reverse( biarcList.begin(), biarcList.end() );
     vector<Biarc>::iterator ic = biarcList.begin();
     ic->reverse();
@@ -971,6 +1245,7 @@ namespace G2lib {
 
   void
   BiarcList::changeOrigin( real_type newx0, real_type newy0 ) {
+    aabb_done = arcs_done = false;
     vector<Biarc>::iterator ic = biarcList.begin();
     for (; ic != biarcList.end(); ++ic ) {
       ic->changeOrigin( newx0, newy0 );
@@ -991,6 +1266,7 @@ namespace G2lib {
       s_end << ") bad range, must be in [ " << s0.front() <<
       ", " << s0.back() << " ]"
     );
+    aabb_done = arcs_done = false;
 
     findAtS( s_begin ); size_t i_begin = size_t(last_idx);
     findAtS( s_end );   size_t i_end   = size_t(last_idx);
@@ -1038,6 +1314,7 @@ namespace G2lib {
     vector<BBox const *> bboxes;
     #endif
 
+    aabb_tri.clear();
     bbTriangles_ISO( offs, aabb_tri, max_angle, max_size );
     bboxes.reserve(aabb_tri.size());
     vector<Triangle2D>::const_iterator it;
@@ -1056,6 +1333,7 @@ namespace G2lib {
       #endif
     }
     aabb_tree.build(bboxes);
+    G2LIB_PERF_COUNT(aabb_rebuilds);
     aabb_done      = true;
     aabb_offs      = offs;
     aabb_max_angle = max_angle;
@@ -1110,11 +1388,31 @@ namespace G2lib {
     real_type         offs_CL,
     IntersectList   & ilist,
     bool              swap_s_vals
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    intersect_ISO( offs, CL, offs_CL, ilist, swap_s_vals, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BiarcList::intersect_ISO(
+    real_type         offs,
+    BiarcList const & CL,
+    real_type         offs_CL,
+    IntersectList   & ilist,
+    bool              swap_s_vals,
+    AABBworkspace   & ws
   ) const {
     if ( intersect_with_AABBtree ) {
       this->build_AABBtree_ISO( offs );
       CL.build_AABBtree_ISO( offs_CL );
-      AABBtree::VecPairPtrBBox iList;
+      AABBtree::VecPairPtrBBox & iList = ws.intersectionList;
+      iList.clear();
       aabb_tree.intersect( CL.aabb_tree, iList );
 
       AABBtree::VecPairPtrBBox::const_iterator ip;
@@ -1128,19 +1426,18 @@ namespace G2lib {
         Biarc const & C1 = biarcList[T1.Icurve()];
         Biarc const & C2 = CL.biarcList[T2.Icurve()];
 
-        IntersectList ilist1;
-        C1.intersect_ISO( offs, C2, offs_CL, ilist1, false );
-
-        for ( IntersectList::const_iterator it = ilist1.begin();
-              it != ilist1.end(); ++it ) {
-          real_type ss1 = it->first  + s0[T1.Icurve()];
-          real_type ss2 = it->second + CL.s0[T2.Icurve()];
-          if ( swap_s_vals ) swap( ss1, ss2 );
-          ilist.push_back( Ipair( ss1, ss2 ) );
-        }
+        CurveStatic<Biarc>::intersect_ISO(
+          C1, s0[T1.Icurve()], offs, C2, CL.s0[T2.Icurve()], offs_CL,
+          ilist, swap_s_vals
+        );
       }
+      iList.clear(); // release the bbox
     } else {
+      // triangles overwritten, the AABB tree is no more valid
+      aabb_done = CL.aabb_done = false;
+      aabb_tri.clear();
       bbTriangles_ISO( offs, aabb_tri, m_pi/18, 1e100 );
+      CL.aabb_tri.clear();
       CL.bbTriangles_ISO( offs_CL, CL.aabb_tri, m_pi/18, 1e100 );
       for ( vector<Triangle2D>::const_iterator i1 = aabb_tri.begin();
             i1 != aabb_tri.end(); ++i1 ) {
@@ -1152,20 +1449,172 @@ namespace G2lib {
           Biarc const & C1 = biarcList[T1.Icurve()];
           Biarc const & C2 = CL.biarcList[T2.Icurve()];
 
-          IntersectList ilist1;
-          C1.intersect_ISO( offs, C2, offs_CL, ilist1, false );
+          CurveStatic<Biarc>::intersect_ISO(
+            C1, s0[T1.Icurve()], offs, C2, CL.s0[T2.Icurve()], offs_CL,
+            ilist, swap_s_vals
+          );
+        }
+      }
 
-          for ( IntersectList::const_iterator it = ilist1.begin();
-                it != ilist1.end(); ++it ) {
-            real_type ss1 = it->first  + s0[T1.Icurve()];
-            real_type ss2 = it->second + CL.s0[T2.Icurve()];
-            if ( swap_s_vals ) swap( ss1, ss2 );
-            ilist.push_back( Ipair( ss1, ss2 ) );
-          }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  BiarcList::intersect_first_ISO(
+    real_type         offs,
+    BiarcList const & CL,
+    real_type         offs_CL,
+    real_type       & s1,
+    real_type       & s2
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    return intersect_first_ISO( offs, CL, offs_CL, s1, s2, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  BiarcList::intersect_first_ISO(
+    real_type         offs,
+    BiarcList const & CL,
+    real_type         offs_CL,
+    real_type       & s1,
+    real_type       & s2,
+    AABBworkspace   & ws
+  ) const {
+    this->build_AABBtree_ISO( offs );
+    CL.build_AABBtree_ISO( offs_CL );
+    AABBtree::VecPairPtrBBox & iList = ws.intersectionList;
+    iList.clear();
+    aabb_tree.intersect( CL.aabb_tree, iList );
+
+    // intersect the pairs of biarcs by increasing s1, each pair only once
+    std::sort( iList.begin(), iList.end(), Pair_biarc_less( this, &CL ) );
+
+    bool     found = false;
+    int_type last1 = -1;
+    int_type last2 = -1;
+    AABBtree::VecPairPtrBBox::const_iterator ip;
+    for ( ip = iList.begin(); ip != iList.end(); ++ip ) {
+      int_type i1 = aabb_tri[size_t(ip->first->Ipos())].Icurve();
+      int_type i2 = CL.aabb_tri[size_t(ip->second->Ipos())].Icurve();
+      if ( i1 == last1 && i2 == last2 ) continue;
+      last1 = i1;
+      last2 = i2;
+
+      // all the remaining candidates start after the intersection found
+      if ( found && s0[size_t(i1)] > s1 ) break;
+
+      IntersectList & ilist1 = ws.ilist;
+      ilist1.clear();
+      CurveStatic<Biarc>::intersect_ISO(
+        biarcList[size_t(i1)],    s0[size_t(i1)],    offs,
+        CL.biarcList[size_t(i2)], CL.s0[size_t(i2)], offs_CL,
+        ilist1, false
+      );
+
+      for ( IntersectList::const_iterator it = ilist1.begin();
+            it != ilist1.end(); ++it ) {
+        real_type ss1 = it->first;
+        if ( !found || ss1 < s1 ) {
+          s1    = ss1;
+          s2    = it->second;
+          found = true;
         }
       }
+    }
+    iList.clear(); // release the bbox
+    return found;
+  }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BiarcList::intersect_self_ISO(
+    real_type       offs,
+    IntersectList & ilist
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    intersect_self_ISO( offs, ilist, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BiarcList::intersect_self_ISO(
+    real_type       offs,
+    IntersectList & ilist,
+    AABBworkspace & ws
+  ) const {
+    this->build_AABBtree_ISO( offs );
+    AABBtree::VecPairPtrBBox & iList = ws.intersectionList;
+    iList.clear();
+    aabb_tree.intersect_self( iList );
+
+    // intersect each pair of distinct biarcs only once
+    AABBtree::VecPairPtrBBox::iterator it;
+    for ( it = iList.begin(); it != iList.end(); ++it )
+      if ( aabb_tri[size_t(it->first->Ipos())].Icurve() >
+           aabb_tri[size_t(it->second->Ipos())].Icurve() )
+        swap( it->first, it->second );
+    std::sort( iList.begin(), iList.end(), Pair_biarc_less( this, this ) );
+
+    // intersections closer than `eps` are the common point of two
+    // consecutive biarcs (or of the begin and the end of a closed list)
+    real_type L   = length();
+    real_type eps = sqrt(machepsi)*L;
+    real_type xb, yb, xe, ye;
+    eval_ISO( 0, offs, xb, yb );
+    eval_ISO( L, offs, xe, ye );
+    bool closed = hypot( xe-xb, ye-yb ) <= eps;
+
+    int_type last1 = -1;
+    int_type last2 = -1;
+    AABBtree::VecPairPtrBBox::const_iterator ip;
+    for ( ip = iList.begin(); ip != iList.end(); ++ip ) {
+      int_type i1 = aabb_tri[size_t(ip->first->Ipos())].Icurve();
+      int_type i2 = aabb_tri[size_t(ip->second->Ipos())].Icurve();
+      if ( i1 == last1 && i2 == last2 ) continue;
+      last1 = i1;
+      last2 = i2;
+
+      IntersectList & ilist1 = ws.ilist;
+      ilist1.clear();
+      if ( i1 == i2 ) {
+        // the two arcs of the same biarc (can cross only with offset)
+        Biarc const & B = biarcList[size_t(i1)];
+        CurveStatic<CircleArc>::intersect_ISO(
+          B.getC0(), s0[size_t(i1)], offs,
+          B.getC1(), s0[size_t(i1)]+B.getC0().length(), offs,
+          ilist1, false
+        );
+      } else {
+        CurveStatic<Biarc>::intersect_ISO(
+          biarcList[size_t(i1)], s0[size_t(i1)], offs,
+          biarcList[size_t(i2)], s0[size_t(i2)], offs,
+          ilist1, false
+        );
+      }
+
+      for ( IntersectList::const_iterator ii = ilist1.begin();
+            ii != ilist1.end(); ++ii ) {
+        real_type ss1 = ii->first;
+        real_type ss2 = ii->second;
+        if ( ss2-ss1 <= eps || ( closed && ss1 <= eps && ss2 >= L-eps ) ) continue;
+        ilist.push_back( Ipair( ss1, ss2 ) );
+      }
     }
+    iList.clear(); // release the bbox
   }
 
   /*\
@@ -1187,38 +1636,295 @@ namespace G2lib {
     real_type & t,
     real_type & DST
   ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    return closestPoint_ISO( qx, qy, offs, x, y, s, t, DST, ws );
+  }
 
-    this->build_AABBtree_ISO( offs );
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-    AABBtree::VecPtrBBox candidateList;
-    aabb_tree.min_distance( qx, qy, candidateList );
-    AABBtree::VecPtrBBox::const_iterator ic;
-    G2LIB_ASSERT(
-      candidateList.size() > 0,
-      "BiarcList::closestPoint no candidate"
-    );
-    int_type icurve = 0;
-    DST = numeric_limits<real_type>::infinity();
-    for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
-      size_t ipos = size_t((*ic)->Ipos());
-      Triangle2D const & T = aabb_tri[ipos];
-      real_type dst = T.distMin( qx, qy );
-      if ( dst < DST ) {
-        // refine distance
-        real_type xx, yy, ss;
-        biarcList[T.Icurve()].closestPoint_ISO( qx, qy, offs, xx, yy, ss, dst );
-        if ( dst < DST ) {
-          DST    = dst;
-          s      = ss + s0[T.Icurve()];
-          x      = xx;
-          y      = yy;
-          icurve = T.Icurve();
+  /*\
+   |   The arcs are stored in blocks of `arc_block` consecutive arcs
+   |   (the last block is padded with copies of the last arc).
+   |   In the frame of the begin of the arc (u along the tangent, v along
+   |   the left normal) the center is (0,1/k) and the begin of the arc
+   |   with offset offs is (0,offs), the distances are computed
+   |   multiplied by |k| so that the formulas hold for k = 0 (segments).
+  \*/
+
+  void
+  BiarcList::build_arcs() const {
+    if ( arcs_done ) return;
+    G2LIB_ASSERT( !biarcList.empty(), "BiarcList::build_arcs, empty list" );
+    size_t na = 2*biarcList.size();
+    size_t nb = (na+size_t(arc_block)-1)/size_t(arc_block);
+    size_t np = nb*size_t(arc_block);
+    arcs.x0.resize(np);  arcs.y0.resize(np);
+    arcs.c0.resize(np);  arcs.s0.resize(np);
+    arcs.k.resize(np);   arcs.L.resize(np);
+    arcs.x1.resize(np);  arcs.y1.resize(np);
+    arcs.nx1.resize(np); arcs.ny1.resize(np);
+    arcs.u1.resize(np);  arcs.v1.resize(np);
+    arcs.big.resize(np);
+    vector<real_type> bxmin(nb), bymin(nb), bxmax(nb), bymax(nb);
+    for ( size_t ib = 0; ib < nb; ++ib ) {
+      bxmin[ib] = bymin[ib] = numeric_limits<real_type>::infinity();
+      bxmax[ib] = bymax[ib] = -numeric_limits<real_type>::infinity();
+    }
+    for ( size_t i = 0; i < np; ++i ) {
+      size_t          ia = std::min( i, na-1 );
+      Biarc     const & b  = biarcList[ia/2];
+      CircleArc const & C  = (ia%2) == 0 ? b.getC0() : b.getC1();
+      real_type x0 = C.xBegin();
+      real_type y0 = C.yBegin();
+      real_type c0 = C.cosTheta0();
+      real_type s0 = C.sinTheta0();
+      real_type x1 = C.xEnd();
+      real_type y1 = C.yEnd();
+      arcs.x0[i]  = x0;
+      arcs.y0[i]  = y0;
+      arcs.c0[i]  = c0;
+      arcs.s0[i]  = s0;
+      arcs.k[i]   = C.curvature();
+      arcs.L[i]   = C.length();
+      arcs.x1[i]  = x1;
+      arcs.y1[i]  = y1;
+      arcs.nx1[i] = -sin(C.thetaEnd());
+      arcs.ny1[i] = cos(C.thetaEnd());
+      arcs.u1[i]  = (x1-x0)*c0 + (y1-y0)*s0;
+      arcs.v1[i]  = (y1-y0)*c0 - (x1-x0)*s0;
+      arcs.big[i] = abs(arcs.k[i]*arcs.L[i]) > m_pi ? 1 : 0;
+      real_type xmin, ymin, xmax, ymax;
+      C.bbox( xmin, ymin, xmax, ymax );
+      size_t ib = i/size_t(arc_block);
+      if ( xmin < bxmin[ib] ) bxmin[ib] = xmin;
+      if ( ymin < bymin[ib] ) bymin[ib] = ymin;
+      if ( xmax > bxmax[ib] ) bxmax[ib] = xmax;
+      if ( ymax > bymax[ib] ) bymax[ib] = ymax;
+    }
+
+    // tree of the bbox of the blocks, the leaves store the index of the block
+    #ifdef G2LIB_USE_CXX11
+    vector<shared_ptr<BBox const> > bboxes;
+    #else
+    vector<BBox const *> bboxes;
+    #endif
+    bboxes.reserve( nb );
+    for ( size_t ib = 0; ib < nb; ++ib ) {
+      #ifdef G2LIB_USE_CXX11
+      bboxes.push_back( make_shared<BBox const>(
+        bxmin[ib], bymin[ib], bxmax[ib], bymax[ib], G2LIB_BIARC, int_type(ib)
+      ) );
+      #else
+      bboxes.push_back(
+        new BBox( bxmin[ib], bymin[ib], bxmax[ib], bymax[ib], G2LIB_BIARC, int_type(ib) )
+      );
+      #endif
+    }
+    arcs_tree.clear();
+    arcs_tree.build( bboxes );
+    arcs_last_block = 0;
+    arcs_done       = true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BiarcList::distArcs_ISO(
+    int_type  iblock,
+    real_type qx,
+    real_type qy,
+    real_type offs,
+    real_type dst[]
+  ) const {
+    size_t i0 = size_t(iblock*arc_block);
+    real_type const * X0  = &arcs.x0[i0];
+    real_type const * Y0  = &arcs.y0[i0];
+    real_type const * C0  = &arcs.c0[i0];
+    real_type const * S0  = &arcs.s0[i0];
+    real_type const * K   = &arcs.k[i0];
+    real_type const * X1  = &arcs.x1[i0];
+    real_type const * Y1  = &arcs.y1[i0];
+    real_type const * NX1 = &arcs.nx1[i0];
+    real_type const * NY1 = &arcs.ny1[i0];
+    real_type const * U1  = &arcs.u1[i0];
+    real_type const * V1  = &arcs.v1[i0];
+    real_type const * BIG = &arcs.big[i0];
+    // same operations for all the arcs (no branches) so that the
+    // loop on the block can be vectorized
+    for ( int_type j = 0; j < arc_block; ++j ) {
+      real_type dx = qx - X0[j];
+      real_type dy = qy - Y0[j];
+      real_type u  = dx*C0[j] + dy*S0[j];
+      real_type v  = dy*C0[j] - dx*S0[j];
+      real_type k  = K[j];
+      real_type ff = 1-k*offs;
+      real_type vo = v-offs;
+      // distance from the circle (line if k = 0) of the arc with offset
+      real_type ak  = abs(k);
+      real_type sk  = k < 0 ? -1 : 1;
+      real_type num = ak*(u*u+v*v-offs*offs) - 2*sk*vo;
+      real_type den = sqrt( (k*u)*(k*u) + (k*v-1)*(k*v-1) ) + abs(ff);
+      real_type dc  = abs(num)/den;
+      // the projection on the circle is inside the angle of the arc
+      // (the arc is on the other side of the center if ff < 0)
+      real_type sf = ff < 0 ? -1 : 1;
+      real_type g  = u*(k*V1[j]-1) - (k*v-1)*U1[j];
+      bool      a  = sf*u >= 0;
+      bool      b  = sf*g >= 0;
+      bool      in = (a & b) | ( (BIG[j] > 0) & (a | b) );
+      // distance from the extrema of the arc with offset
+      real_type ex = qx - X1[j] - offs*NX1[j];
+      real_type ey = qy - Y1[j] - offs*NY1[j];
+      real_type d0 = sqrt( u*u + vo*vo );
+      real_type d1 = sqrt( ex*ex + ey*ey );
+      real_type de = std::min( d0, d1 );
+      dst[j] = in ? dc : de;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // closest arc on the blocks, `distance` computes the distance of the
+  // arcs of a block and returns the best distance found plus |offs|: the
+  // bbox of the blocks do not contain the offset arcs, the shift keeps the
+  // distance of the leaves not less than the distance of their bbox.
+  // The block `skip` is already done (search started from the last block)
+  class BiarcList::Nearest_block {
+    BiarcList const * pList;
+    real_type const   qx;
+    real_type const   qy;
+    real_type const   offs;
+    real_type const   aoffs;
+    int_type  const   skip;
+
+  public:
+    int_type  iarc;
+    real_type DST;
+
+    Nearest_block(
+      BiarcList const * _pList,
+      real_type         _qx,
+      real_type         _qy,
+      real_type         _offs,
+      int_type          _skip,
+      int_type          _iarc,
+      real_type         _DST
+    )
+    : pList(_pList)
+    , qx(_qx)
+    , qy(_qy)
+    , offs(_offs)
+    , aoffs(abs(_offs))
+    , skip(_skip)
+    , iarc(_iarc)
+    , DST(_DST)
+    {}
+
+    real_type
+    distance( BBox::PtrBBox ptr ) {
+      int_type ib = ptr->Ipos();
+      if ( ib != skip ) {
+        real_type dst[arc_block];
+        pList->distArcs_ISO( ib, qx, qy, offs, dst );
+        for ( int_type j = 0; j < arc_block; ++j ) {
+          if ( dst[j] < DST ) {
+            DST  = dst[j];
+            iarc = ib*arc_block+j;
+          }
         }
       }
+      return DST + aoffs;
     }
 
+    bool
+    visit( BBox::PtrBBox, real_type )
+    { return false; } // the best arc is already stored
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  BiarcList::closestArc_ISO(
+    real_type                qx,
+    real_type                qy,
+    real_type                offs,
+    AABBtree::NearestQueue & queue
+  ) const {
+    build_arcs();
+    int_type  nb = int_type(arcs.x0.size())/arc_block;
+    real_type dst[arc_block];
+
+    // start from the block of the last projection (consecutive points
+    // of a trajectory), its distance prunes the search on the tree
+    int_type ib0 = arcs_last_block < nb ? arcs_last_block : 0;
+    distArcs_ISO( ib0, qx, qy, offs, dst );
+    int_type  iarc = 0;
+    real_type DST  = dst[0];
+    for ( int_type j = 1; j < arc_block; ++j )
+      if ( dst[j] < DST ) { DST = dst[j]; iarc = j; }
+    iarc += ib0*arc_block;
+
+    Nearest_block fun( this, qx, qy, offs, ib0, iarc, DST );
+    arcs_tree.nearest( qx, qy, fun, queue );
+    iarc = fun.iarc;
+
+    int_type na = 2*int_type(biarcList.size());
+    if ( iarc >= na ) iarc = na-1; // padding of the last block
+    arcs_last_block = iarc/arc_block;
+    return iarc;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  BiarcList::closestPoint_ISO(
+    real_type   qx,
+    real_type   qy,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & t,
+    real_type & DST,
+    AABBworkspace & ws
+  ) const {
+
+    int_type  iarc   = closestArc_ISO( qx, qy, offs, ws.queue );
+    int_type  icurve = iarc/2;
+    size_t    i      = size_t(iarc);
+    Biarc     const & b = biarcList[size_t(icurve)];
+    CircleArc const & C = (iarc%2) == 0 ? b.getC0() : b.getC1();
+
+    // the arc with offset on the other side of the center is
+    // projected as the point symmetric with respect to the center
+    real_type k  = arcs.k[i];
+    real_type px = qx;
+    real_type py = qy;
+    if ( 1-k*offs < 0 ) {
+      px = 2*(arcs.x0[i]-arcs.s0[i]/k) - qx;
+      py = 2*(arcs.y0[i]+arcs.c0[i]/k) - qy;
+    }
+    real_type ss = projectPointOnCircleArc(
+      arcs.x0[i], arcs.y0[i], arcs.c0[i], arcs.s0[i], k, arcs.L[i], px, py
+    );
+    if ( ss < 0 || ss > arcs.L[i] ) {
+      // nearest extremum of the arc with offset
+      real_type xx0, yy0, xx1, yy1;
+      C.eval_ISO( 0,         offs, xx0, yy0 );
+      C.eval_ISO( arcs.L[i], offs, xx1, yy1 );
+      ss = hypot( qx-xx0, qy-yy0 ) <= hypot( qx-xx1, qy-yy1 ) ? 0 : arcs.L[i];
+    }
+    C.eval_ISO( ss, offs, x, y );
+    DST = hypot( qx-x, qy-y );
+    s   = s0[size_t(icurve)] + ss;
+    if ( (iarc%2) == 1 ) s += b.getC0().length();
+
     real_type nx, ny;
-    biarcList[icurve].nor_ISO( s - s0[icurve], nx, ny );
+    b.nor_ISO( s - s0[size_t(icurve)], nx, ny );
     t = (qx-x) * nx + (qy-y) * ny - offs;
     real_type err = abs( abs(t) - DST );
     if ( err > DST*machepsi1000 ) return -1;
@@ -1227,6 +1933,28 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  int_type
+  BiarcList::closestPoint_ISO(
+    int_type        n,
+    real_type const qx[],
+    real_type const qy[],
+    real_type       offs,
+    real_type       x[],
+    real_type       y[],
+    real_type       s[],
+    real_type       t[],
+    real_type       dst[]
+  ) const {
+    AABBworkspace ws; // the queue of the search is reused by all the points
+    int_type northo = 0;
+    for ( int_type i = 0; i < n; ++i )
+      if ( closestPoint_ISO( qx[i], qy[i], offs, x[i], y[i], s[i], t[i], dst[i], ws ) == 1 )
+        ++northo;
+    return northo;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   int_type
   BiarcList::closestPoint_ISO(
     real_type   qx,
@@ -1240,6 +1968,131 @@ namespace G2lib {
     return closestPoint_ISO( qx, qy, 0, x, y, s, t, dst );
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BiarcList::segmentsInRadius_ISO(
+    real_type           qx,
+    real_type           qy,
+    real_type           offs,
+    real_type           r,
+    vector<int_type>  & segments,
+    vector<real_type> & dsts
+  ) const {
+    segments.clear();
+    dsts.clear();
+    this->build_AABBtree_ISO( offs );
+    T2D_nearest_list_ISO fun(
+      this, qx, qy, offs, r, numeric_limits<size_t>::max(), segments, dsts
+    );
+    aabb_tree.nearest( qx, qy, fun );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BiarcList::closestSegments_ISO(
+    real_type           qx,
+    real_type           qy,
+    real_type           offs,
+    int_type            k,
+    vector<int_type>  & segments,
+    vector<real_type> & dsts
+  ) const {
+    segments.clear();
+    dsts.clear();
+    if ( k <= 0 ) return;
+    this->build_AABBtree_ISO( offs );
+    T2D_nearest_list_ISO fun(
+      this, qx, qy, offs, numeric_limits<real_type>::infinity(),
+      size_t(k), segments, dsts
+    );
+    aabb_tree.nearest( qx, qy, fun );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  BiarcList::rayCast_ISO(
+    real_type   qx,
+    real_type   qy,
+    real_type   dx,
+    real_type   dy,
+    real_type   max_range,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & dst
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    return rayCast_ISO( qx, qy, dx, dy, max_range, offs, x, y, s, dst, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  BiarcList::rayCast_ISO(
+    real_type       qx,
+    real_type       qy,
+    real_type       dx,
+    real_type       dy,
+    real_type       max_range,
+    real_type       offs,
+    real_type     & x,
+    real_type     & y,
+    real_type     & s,
+    real_type     & dst,
+    AABBworkspace & ws
+  ) const {
+    real_type len = hypot( dx, dy );
+    G2LIB_ASSERT(
+      len > 0, "BiarcList::rayCast_ISO, null direction of the ray"
+    );
+    real_type ux = dx/len;
+    real_type uy = dy/len;
+    this->build_AABBtree_ISO( offs );
+    T2D_raycast_list_ISO fun( this, qx, qy, ux, uy, offs, s, dst );
+    if ( !aabb_tree.raycast( qx, qy, ux, uy, max_range, fun, ws.queue ) )
+      return false;
+    x = qx + dst*ux;
+    y = qy + dst*uy;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  BiarcList::rayCast_ISO(
+    int_type        n,
+    real_type const qx[],
+    real_type const qy[],
+    real_type const dx[],
+    real_type const dy[],
+    real_type       max_range,
+    real_type       offs,
+    real_type       s[],
+    real_type       dst[]
+  ) const {
+    AABBworkspace ws; // the queue of the search is reused by all the rays
+    int_type      nhit = 0;
+    for ( int_type i = 0; i < n; ++i ) {
+      real_type x, y;
+      if ( rayCast_ISO( qx[i], qy[i], dx[i], dy[i], max_range, offs,
+                        x, y, s[i], dst[i], ws ) ) {
+        ++nhit;
+      } else {
+        s[i]   = 0;
+        dst[i] = -1;
+      }
+    }
+    return nhit;
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -26,6 +26,10 @@
 
 #include "PolyLine.hh"
 #include "Biarc.hh"
+#include "CurveStatic.hh"
+
+#include <algorithm> // sort
+#include <set>
 
 //! Clothoid computations routine
 namespace G2lib {
@@ -57,6 +61,46 @@ namespace G2lib {
     mutable real_type          aabb_max_size;
     mutable vector<Triangle2D> aabb_tri;
 
+    // the arcs of the biarcs (two for each biarc) as structure of arrays
+    // for the closed form projection, grouped in blocks of `arc_block`
+    // consecutive arcs, the bbox of the blocks (offset 0) are in `arcs_tree`
+    class ArcTable {
+    public:
+      vector<real_type> x0, y0, c0, s0, k, L; // begin point and angle, curvature, length
+      vector<real_type> x1, y1, nx1, ny1;     // end point and ISO normal at the end
+      vector<real_type> u1, v1;               // end point in the frame of the begin
+      vector<real_type> big;                  // 1 if the arc angle is greater than pi
+    };
+
+    static int_type const arc_block = 16;
+
+    mutable bool     arcs_done;
+    mutable ArcTable arcs;
+    mutable AABBtree arcs_tree;       // tree of the bbox of the blocks
+    mutable int_type arcs_last_block; // block of the last projection
+
+    // best-first search of the closest arc on the blocks
+    class Nearest_block;
+
+    void build_arcs() const;
+
+    void
+    distArcs_ISO(
+      int_type  iblock,
+      real_type qx,
+      real_type qy,
+      real_type offs,
+      real_type dst[]
+    ) const;
+
+    int_type
+    closestArc_ISO(
+      real_type                qx,
+      real_type                qy,
+      real_type                offs,
+      AABBtree::NearestQueue & queue
+    ) const;
+
     class T2D_collision_list_ISO {
       BiarcList const * pList1;
       real_type const   offs1;
@@ -81,10 +125,187 @@ namespace G2lib {
         Triangle2D const & T2 = pList2->aabb_tri[size_t(ptr2->Ipos())];
         Biarc      const & C1 = pList1->get(T1.Icurve());
         Biarc      const & C2 = pList2->get(T2.Icurve());
-        return C1.collision_ISO( offs1, C2, offs2 );
+        return CurveStatic<Biarc>::collision_ISO( C1, offs1, C2, offs2 );
       }
     };
 
+    // intersect the biarcs of the pairs of triangles (each pair of
+    // biarcs only once) and pass the intersections to `fun`
+    template <typename INTERSECT_fun>
+    class T2D_intersect_visit_ISO {
+      BiarcList const * pList1;
+      real_type const   offs1;
+      BiarcList const * pList2;
+      real_type const   offs2;
+      INTERSECT_fun   & fun;
+      vector<std::pair<int_type,int_type> > done;  // pairs of biarcs already intersected
+      IntersectList                         ilist;
+    public:
+      T2D_intersect_visit_ISO(
+        BiarcList const * _pList1,
+        real_type const   _offs1,
+        BiarcList const * _pList2,
+        real_type const   _offs2,
+        INTERSECT_fun   & _fun
+      )
+      : pList1(_pList1)
+      , offs1(_offs1)
+      , pList2(_pList2)
+      , offs2(_offs2)
+      , fun(_fun)
+      {}
+
+      bool
+      operator () ( BBox::PtrBBox const & ptr1, BBox::PtrBBox const & ptr2 ) {
+        int_type i1 = pList1->aabb_tri[size_t(ptr1->Ipos())].Icurve();
+        int_type i2 = pList2->aabb_tri[size_t(ptr2->Ipos())].Icurve();
+        std::pair<int_type,int_type> ij( i1, i2 );
+        vector<std::pair<int_type,int_type> >::iterator it =
+          std::lower_bound( done.begin(), done.end(), ij );
+        if ( it != done.end() && *it == ij ) return true;
+        done.insert( it, ij );
+        ilist.clear();
+        CurveStatic<Biarc>::intersect_ISO(
+          pList1->get(i1), pList1->s0[size_t(i1)], offs1,
+          pList2->get(i2), pList2->s0[size_t(i2)], offs2,
+          ilist, false
+        );
+        IntersectList::const_iterator ii;
+        for ( ii = ilist.begin(); ii != ilist.end(); ++ii )
+          if ( !fun( ii->first, ii->second ) ) return false;
+        return true;
+      }
+    };
+
+    // order the pairs of bbox by the biarcs of the triangles
+    class Pair_biarc_less {
+      BiarcList const * pList1;
+      BiarcList const * pList2;
+    public:
+      Pair_biarc_less( BiarcList const * _pList1, BiarcList const * _pList2 )
+      : pList1(_pList1), pList2(_pList2) {}
+
+      bool
+      operator () (
+        AABBtree::PairPtrBBox const & a,
+        AABBtree::PairPtrBBox const & b
+      ) const {
+        int_type a1 = pList1->aabb_tri[size_t(a.first->Ipos())].Icurve();
+        int_type b1 = pList1->aabb_tri[size_t(b.first->Ipos())].Icurve();
+        if ( a1 != b1 ) return a1 < b1;
+        return pList2->aabb_tri[size_t(a.second->Ipos())].Icurve() <
+               pList2->aabb_tri[size_t(b.second->Ipos())].Icurve();
+      }
+    };
+
+
+    // collect the segments by increasing distance from the point (qx,qy)
+    class T2D_nearest_list_ISO {
+      BiarcList const * pList;   
+      real_type    const   qx;
+      real_type    const   qy;
+      real_type    const   offs;
+      real_type    const   r;
+      size_t       const   kmax;
+      vector<int_type>  & segments;
+      vector<real_type> & dsts;
+      std::set<int_type>  visited; // segments already collected
+    public:
+      T2D_nearest_list_ISO(
+        BiarcList const * _pList,
+        real_type    const   _qx,
+        real_type    const   _qy,
+        real_type    const   _offs,
+        real_type    const   _r,
+        size_t       const   _kmax,
+        vector<int_type>  & _segments,
+        vector<real_type> & _dsts
+      )
+      : pList(_pList)
+      , qx(_qx)
+      , qy(_qy)
+      , offs(_offs)
+      , r(_r)
+      , kmax(_kmax)
+      , segments(_segments)
+      , dsts(_dsts)
+      {}
+
+      real_type
+      distance( BBox::PtrBBox ptr ) const {
+        Triangle2D const & T = pList->aabb_tri[size_t(ptr->Ipos())];
+        real_type x, y, s, t, dst;
+        CurveStatic<Biarc>::closestPoint_ISO(
+          pList->biarcList[size_t(T.Icurve())], qx, qy, offs, x, y, s, t, dst
+        );
+        return dst;
+      }
+
+      bool
+      visit( BBox::PtrBBox ptr, real_type dst ) {
+        if ( dst > r ) return false;
+        int_type icurve = pList->aabb_tri[size_t(ptr->Ipos())].Icurve();
+        // a segment is covered by many triangles, keep the nearest
+        if ( visited.insert( icurve ).second ) {
+          segments.push_back( icurve );
+          dsts.push_back( dst );
+        }
+        return segments.size() < kmax;
+      }
+    };
+
+    // first hit of the ray (qx,qy)+t*(ux,uy) with the segments
+    class T2D_raycast_list_ISO {
+      BiarcList const * pList;
+      real_type const   qx;
+      real_type const   qy;
+      real_type const   ux;
+      real_type const   uy;
+      real_type const   offs;
+      real_type       & s;
+      real_type       & dst;
+    public:
+      T2D_raycast_list_ISO(
+        BiarcList const * _pList,
+        real_type const   _qx,
+        real_type const   _qy,
+        real_type const   _ux,
+        real_type const   _uy,
+        real_type const   _offs,
+        real_type       & _s,
+        real_type       & _dst
+      )
+      : pList(_pList)
+      , qx(_qx)
+      , qy(_qy)
+      , ux(_ux)
+      , uy(_uy)
+      , offs(_offs)
+      , s(_s)
+      , dst(_dst)
+      {}
+
+      bool
+      hit( BBox::PtrBBox ptr, real_type tmax, real_type & t ) const {
+        // the triangles of the arcs do not store the curvilinear
+        // coordinate, the ray is intersected with the whole biarc
+        int_type      icurve = pList->aabb_tri[size_t(ptr->Ipos())].Icurve();
+        Biarc const & B      = pList->biarcList[size_t(icurve)];
+        real_type x, y, ss, ss1, t1;
+        bool ok0 = B.getC0().rayCast_ISO(
+          qx, qy, ux, uy, tmax, offs, x, y, ss, t
+        );
+        if ( ok0 ) tmax = t;
+        bool ok1 = B.getC1().rayCast_ISO(
+          qx, qy, ux, uy, tmax, offs, x, y, ss1, t1
+        );
+        if ( ok1 ) { ss = B.getC0().length() + ss1; t = t1; }
+        if ( !ok0 && !ok1 ) return false;
+        s   = pList->s0[size_t(icurve)] + ss;
+        dst = t;
+        return true;
+      }
+    };
   public:
 
     #include "BaseCurve_using.hxx"
@@ -94,6 +315,8 @@ namespace G2lib {
     : BaseCurve(G2LIB_BIARC_LIST)
     , last_idx(0)
     , aabb_done(false)
+    , arcs_done(false)
+    , arcs_last_block(0)
     {}
 
     virtual
@@ -108,6 +331,8 @@ namespace G2lib {
     : BaseCurve(G2LIB_BIARC_LIST)
     , last_idx(0)
     , aabb_done(false)
+    , arcs_done(false)
+    , arcs_last_block(0)
     { copy(s); }
 
     void init();
@@ -156,6 +381,31 @@ namespace G2lib {
       real_type const theta[]
     );
 
+    /*!
+     * Approximate the clothoid list `CL` with biarcs.
+     * Each segment of `CL` is split by bisection until the biarc
+     * interpolating (G1) the extrema of the pieces has distance less
+     * than `tol` from the clothoid. The distance is bounded from the
+     * distance of `nsamples` points of the piece and from the curvature
+     * of the clothoid and of the biarc (the samples are refined where
+     * the bound is greater than `tol`). The segments of `CL` are
+     * approximated by `nthreads` threads in parallel.
+     *
+     * \param[in] CL       the clothoid list
+     * \param[in] tol      maximum distance of the biarcs from `CL`
+     * \param[in] nthreads number of threads used
+     * \param[in] nsamples number of points of each piece where the distance is computed first
+     * \return a bound of the distance of the points of `CL` from the biarcs
+     *         (greater than `tol` only if a piece cannot be split further)
+     */
+    real_type
+    build(
+      ClothoidList const & CL,
+      real_type            tol,
+      int_type             nthreads = 1,
+      int_type             nsamples = 16
+    );
+
     Biarc const & get( int_type idx ) const;
     Biarc const & getAtS( real_type s ) const;
 
@@ -627,6 +877,33 @@ namespace G2lib {
       real_type & y_DDD
     ) const G2LIB_OVERRIDE;
 
+    /*!
+     * Evaluate at `s[i]`, `i=0..n-1`, with offset `offs` (batched).
+     * The segments are searched from the previous one (increasing
+     * abscissa are the fastest), the list is not modified so that
+     * the method can be called concurrently on the same object.
+     */
+    void
+    eval_ISO(
+      int_type        n,
+      real_type const s[],
+      real_type       offs,
+      real_type       x[],
+      real_type       y[]
+    ) const;
+
+    //! as the batched `eval_ISO` computing also angle and curvature
+    void
+    evaluate_ISO(
+      int_type        n,
+      real_type const s[],
+      real_type       offs,
+      real_type       theta[],
+      real_type       kappa[],
+      real_type       x[],
+      real_type       y[]
+    ) const;
+
     /*\
      |  _                        __
      | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -717,6 +994,243 @@ namespace G2lib {
       real_type & dst
     ) const G2LIB_OVERRIDE;
 
+    //! as `closestPoint_ISO` using the scratch space `ws` (only the
+    //! queue of the search on the blocks of arcs is used)
+    int_type
+    closestPoint_ISO(
+      real_type       qx,
+      real_type       qy,
+      real_type       offs,
+      real_type     & x,
+      real_type     & y,
+      real_type     & s,
+      real_type     & t,
+      real_type     & dst,
+      AABBworkspace & ws
+    ) const;
+
+    int_type
+    closestPoint_SAE(
+      real_type       qx,
+      real_type       qy,
+      real_type       offs,
+      real_type     & x,
+      real_type     & y,
+      real_type     & s,
+      real_type     & t,
+      real_type     & dst,
+      AABBworkspace & ws
+    ) const {
+      int_type res = closestPoint_ISO( qx, qy, -offs, x, y, s, t, dst, ws );
+      t = -t;
+      return res;
+    }
+
+    /*!
+     * \brief project `n` points on the curve with offset `offs`
+     *
+     * The points are projected in sequence, the search of each point
+     * starts from the arcs of the projection of the previous one,
+     * so the sequences of near points (e.g. a trajectory) are faster.
+     *
+     * \return the number of points projected orthogonally
+     */
+    int_type
+    closestPoint_ISO(
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type       offs,
+      real_type       x[],
+      real_type       y[],
+      real_type       s[],
+      real_type       t[],
+      real_type       dst[]
+    ) const;
+
+    int_type
+    closestPoint_SAE(
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type       offs,
+      real_type       x[],
+      real_type       y[],
+      real_type       s[],
+      real_type       t[],
+      real_type       dst[]
+    ) const {
+      int_type res = closestPoint_ISO( n, qx, qy, -offs, x, y, s, t, dst );
+      for ( int_type i = 0; i < n; ++i ) t[i] = -t[i];
+      return res;
+    }
+
+    /*!
+     *  Segments of the curve with offset `offs` with distance from the
+     *  point `(qx,qy)` not greater than `r`, ordered by increasing distance.
+     *
+     *  \param  qx       x-coordinate of the point
+     *  \param  qy       y-coordinate of the point
+     *  \param  offs     offset of the curve
+     *  \param  r        search radius
+     *  \param  segments index of the segments found
+     *  \param  dsts     distance of the point from the segments found
+     */
+    void
+    segmentsInRadius_ISO(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      real_type           r,
+      vector<int_type>  & segments,
+      vector<real_type> & dsts
+    ) const;
+
+    /*!
+     *  The `k` segments of the curve with offset `offs` nearest to the
+     *  point `(qx,qy)`, ordered by increasing distance.
+     *
+     *  \param  qx       x-coordinate of the point
+     *  \param  qy       y-coordinate of the point
+     *  \param  offs     offset of the curve
+     *  \param  k        number of segments to be found
+     *  \param  segments index of the segments found
+     *  \param  dsts     distance of the point from the segments found
+     */
+    void
+    closestSegments_ISO(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      int_type            k,
+      vector<int_type>  & segments,
+      vector<real_type> & dsts
+    ) const;
+
+    void
+    segmentsInRadius_SAE(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      real_type           r,
+      vector<int_type>  & segments,
+      vector<real_type> & dsts
+    ) const {
+      segmentsInRadius_ISO( qx, qy, -offs, r, segments, dsts );
+    }
+
+    void
+    closestSegments_SAE(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      int_type            k,
+      vector<int_type>  & segments,
+      vector<real_type> & dsts
+    ) const {
+      closestSegments_ISO( qx, qy, -offs, k, segments, dsts );
+    }
+
+    /*!
+     * \brief first intersection of a ray with the list
+     *
+     * The ray is `(qx,qy)+t*(dx,dy)/|(dx,dy)|` with `0 <= t <= max_range`,
+     * a segment casting is a ray with `max_range` equal to the length
+     * of the segment.
+     *
+     * \param[in]  qx        x-coordinate of the origin of the ray
+     * \param[in]  qy        y-coordinate of the origin of the ray
+     * \param[in]  dx        x-component of the direction of the ray
+     * \param[in]  dy        y-component of the direction of the ray
+     * \param[in]  max_range maximum distance along the ray
+     * \param[in]  offs      offset of the curve
+     * \param[out] x         x-coordinate of the hit point
+     * \param[out] y         y-coordinate of the hit point
+     * \param[out] s         curvilinear coordinate of the hit point
+     * \param[out] dst       distance of the hit point from the origin
+     * \return true if the ray hit the list
+     */
+    bool
+    rayCast_ISO(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const;
+
+    bool
+    rayCast_SAE(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const {
+      return rayCast_ISO( qx, qy, dx, dy, max_range, -offs, x, y, s, dst );
+    }
+
+    //! as `rayCast_ISO` using the scratch space `ws` (no allocation)
+    bool
+    rayCast_ISO(
+      real_type       qx,
+      real_type       qy,
+      real_type       dx,
+      real_type       dy,
+      real_type       max_range,
+      real_type       offs,
+      real_type     & x,
+      real_type     & y,
+      real_type     & s,
+      real_type     & dst,
+      AABBworkspace & ws
+    ) const;
+
+    /*!
+     * \brief cast `n` rays `(qx[i],qy[i])+t*(dx[i],dy[i])`
+     *
+     * \param[out] s   curvilinear coordinate of the hits
+     * \param[out] dst distance of the hits, `-1` if the ray miss the list
+     * \return the number of rays that hit the list
+     */
+    int_type
+    rayCast_ISO(
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type const dx[],
+      real_type const dy[],
+      real_type       max_range,
+      real_type       offs,
+      real_type       s[],
+      real_type       dst[]
+    ) const;
+
+    int_type
+    rayCast_SAE(
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type const dx[],
+      real_type const dy[],
+      real_type       max_range,
+      real_type       offs,
+      real_type       s[],
+      real_type       dst[]
+    ) const {
+      return rayCast_ISO( n, qx, qy, dx, dy, max_range, -offs, s, dst );
+    }
+
     virtual
     void
     info( ostream_type & stream ) const G2LIB_OVERRIDE
@@ -821,6 +1335,97 @@ namespace G2lib {
       bool              swap_s_vals
     ) const;
 
+    //! as `intersect_ISO` using the scratch space `ws` (no allocation)
+    void
+    intersect_ISO(
+      real_type         offs,
+      BiarcList const & CL,
+      real_type         offs_obj,
+      IntersectList   & ilist,
+      bool              swap_s_vals,
+      AABBworkspace   & ws
+    ) const;
+
+    /*!
+     * Intersect the list (with offset `offs`) with `CL` (with offset
+     * `offs_CL`) passing the intersections to the functor as soon as
+     * they are found (in no particular order, the AABB tree is always used).
+     * The functor `fun` must implement
+     *
+     * - `bool fun( real_type s1, real_type s2 )` called for each intersection,
+     *   `s1` on this list and `s2` on `CL`, return `false` to stop the search
+     *
+     * \return false if the search was stopped by `fun`
+     */
+    template <typename INTERSECT_fun>
+    bool
+    intersect_visit_ISO(
+      real_type         offs,
+      BiarcList const & CL,
+      real_type         offs_CL,
+      INTERSECT_fun   & fun
+    ) const {
+      this->build_AABBtree_ISO( offs );
+      CL.build_AABBtree_ISO( offs_CL );
+      T2D_intersect_visit_ISO<INTERSECT_fun> visitor( this, offs, &CL, offs_CL, fun );
+      return aabb_tree.intersect_visit( CL.aabb_tree, visitor );
+    }
+
+    /*!
+     * First intersection along the list (minimum `s1`) of the list
+     * (with offset `offs`) with `CL` (with offset `offs_CL`).
+     * The candidate pairs of biarcs are intersected by increasing `s1`
+     * and the search stops when the remaining candidates start after
+     * the intersection found.
+     *
+     * \param[out] s1 curvilinear abscissa of the intersection on the list
+     * \param[out] s2 curvilinear abscissa of the intersection on `CL`
+     * \return true if an intersection is found
+     */
+    bool
+    intersect_first_ISO(
+      real_type         offs,
+      BiarcList const & CL,
+      real_type         offs_CL,
+      real_type       & s1,
+      real_type       & s2
+    ) const;
+
+    //! as `intersect_first_ISO` using the scratch space `ws` (no allocation)
+    bool
+    intersect_first_ISO(
+      real_type         offs,
+      BiarcList const & CL,
+      real_type         offs_CL,
+      real_type       & s1,
+      real_type       & s2,
+      AABBworkspace   & ws
+    ) const;
+
+    /*!
+     * Self intersections of the list (with offset `offs`).
+     * The AABB tree of the list is traversed against itself once,
+     * the common points of consecutive pieces (and the closure point
+     * of a closed list) are not reported.
+     *
+     * \param[out] ilist pairs `(s1,s2)` with `s1 < s2` of the
+     *                   self intersections (appended)
+     */
+    void
+    intersect_self_ISO( real_type offs, IntersectList & ilist ) const;
+
+    //! as `intersect_self_ISO` using the scratch space `ws` (no allocation)
+    void
+    intersect_self_ISO(
+      real_type       offs,
+      IntersectList & ilist,
+      AABBworkspace & ws
+    ) const;
+
+    void
+    intersect_self( IntersectList & ilist ) const
+    { intersect_self_ISO( 0, ilist ); }
+
   };
 
 }
@@ -44,6 +44,7 @@ namespace G2lib {
   using std::abs;
   using std::ceil;
   using std::floor;
+  using std::fmod;
   using std::swap;
   using std::vector;
 
@@ -106,6 +107,8 @@ namespace G2lib {
       x0     = _x0;
       y0     = _y0;
       theta0 = _theta0;
+      c0     = cos(_theta0);
+      s0     = sin(_theta0);
       k      = 2*sin(th)/d;
       L      = d/Sinc(th);
       return true;
@@ -278,6 +281,23 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  CircleArc::eval_ISO(
+    real_type   s,
+    real_type   offs,
+    real_type & x,
+    real_type & y
+  ) const {
+    real_type sk  = (s*k)/2;
+    real_type LS  = s*Sinc(sk);
+    real_type arg = theta0+sk;
+    real_type th  = theta0+s*k;
+    x = x0+LS*cos(arg)-offs*sin(th);
+    y = y0+LS*sin(arg)+offs*cos(th);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   CircleArc::eval_D(
     real_type   s,
@@ -395,6 +415,8 @@ namespace G2lib {
     x0      = new_x0;
     y0      = new_y0;
     theta0 += k*new_s0;
+    c0      = cos(theta0);
+    s0      = sin(theta0);
     L       = newL;
   }
 
@@ -496,8 +518,8 @@ namespace G2lib {
     real_type            max_size,
     int_type             icurve
   ) const {
-    real_type scale  = 1+k*offs;
-    real_type dtheta = abs( min(L,max_size/scale) * k );
+    real_type scale  = 1-k*offs;
+    real_type dtheta = abs( min(L,max_size/abs(scale)) * k );
     int_type  n      = 1;
     if ( dtheta > max_angle ) {
       n       = int_type(ceil( dtheta/max_angle ));
@@ -506,7 +528,8 @@ namespace G2lib {
     tvec.reserve( size_t(n) );
     real_type ds = L/n;
     real_type ss = ds;
-    real_type tg = scale * tan(dtheta/2)/2;
+    // the apex is computed from the chord of the offset arc
+    real_type tg = tan(dtheta/2)/2;
     if ( k < 0 ) tg = -tg;
     real_type xx0, yy0;
     eval_ISO( 0, offs, xx0, yy0 );
@@ -596,7 +619,7 @@ namespace G2lib {
     real_type eps2 = machepsi100*C.L;
     for ( int_type i = 0; i < ni; ++i ) {
       if ( s1[i] >= -eps1 && s1[i] <= L+eps1 &&
-           s2[i] >= -eps2 && s2[i] <= L+eps2 )
+           s2[i] >= -eps2 && s2[i] <= C.L+eps2 )
         return true;
     }
     return false;
@@ -604,6 +627,26 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  // initial angle, curvature and length factor of the arc with offset
+  // `offs`, the offset arc is run backward if the offset is beyond the center
+  static
+  void
+  offsetArc(
+    real_type   theta0,
+    real_type   k,
+    real_type   offs,
+    real_type & th,
+    real_type & kk,
+    real_type & sc
+  ) {
+    real_type ff = 1-k*offs;
+    sc = abs(ff);
+    kk = k/sc;
+    th = ff < 0 ? theta0+m_pi : theta0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   bool
   CircleArc::collision_ISO(
     real_type         offs,
@@ -611,17 +654,16 @@ namespace G2lib {
     real_type         offs_C
   ) const {
     real_type s1[2], s2[2];
-    real_type sc1 = 1+k*offs;
-    real_type sc2 = 1+C.k*offs_C;
+    real_type th1, k1, sc1, th2, k2, sc2;
+    offsetArc( theta0, k, offs, th1, k1, sc1 );
+    offsetArc( C.theta0, C.k, offs_C, th2, k2, sc2 );
     int_type ni = intersectCircleCircle(
       this->X_ISO(0,offs),
       this->Y_ISO(0,offs),
-      this->theta0,
-      this->k/sc2,
+      th1, k1,
       C.X_ISO(0,offs_C),
       C.Y_ISO(0,offs_C),
-      C.theta0,
-      C.k/sc2,
+      th2, k2,
       s1, s2
     );
     real_type eps1 = machepsi100*L;
@@ -638,6 +680,70 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool
+  CircleArc::rayCast_ISO(
+    real_type   qx,
+    real_type   qy,
+    real_type   dx,
+    real_type   dy,
+    real_type   max_range,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & dst
+  ) const {
+    if ( isZero(k) ) {
+      LineSegment LS;
+      LS.build( x0, y0, theta0, L );
+      return LS.rayCast_ISO( qx, qy, dx, dy, max_range, offs, x, y, s, dst );
+    }
+    real_type len = hypot( dx, dy );
+    G2LIB_ASSERT(
+      len > 0, "CircleArc::rayCast_ISO, null direction of the ray"
+    );
+    real_type ux = dx/len;
+    real_type uy = dy/len;
+    // center and (signed) radius of the offset circle
+    real_type cx = x0 - s0/k;
+    real_type cy = y0 + c0/k;
+    real_type R  = 1/k - offs;
+    if ( isZero(R) ) return false;
+    // |(qx,qy) + t * (ux,uy) - (cx,cy)| = |R|
+    real_type wx   = qx - cx;
+    real_type wy   = qy - cy;
+    real_type b    = wx*ux + wy*uy;
+    real_type c    = wx*wx + wy*wy - R*R;
+    real_type disc = b*b - c;
+    if ( disc < 0 ) return false;
+    real_type sq    = sqrt(disc);
+    real_type tt[2] = { -b-sq, -b+sq };
+    real_type per   = m_2pi/abs(k);
+    real_type eps   = machepsi100*max(L,real_type(1));
+    for ( int_type i = 0; i < 2; ++i ) {
+      real_type t = tt[i];
+      if ( t < 0 ) continue;
+      if ( t > max_range ) break;
+      // the point is C + R * ( sin(theta), -cos(theta) )
+      real_type px = (wx + t*ux)/R;
+      real_type py = (wy + t*uy)/R;
+      real_type ss = fmod( (atan2( px, -py ) - theta0)/k, per );
+      if ( ss < 0 ) ss += per;
+      if ( ss > L+eps ) {
+        if ( per-ss > eps ) continue;
+        ss = 0;
+      }
+      s   = ss > L ? L : ss;
+      dst = t;
+      x   = qx + t*ux;
+      y   = qy + t*uy;
+      return true;
+    }
+    return false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   CircleArc::intersect(
     CircleArc const & C,
@@ -678,17 +784,16 @@ namespace G2lib {
     bool              swap_s_vals
   ) const {
     real_type s1[2], s2[2];
-    real_type sc1 = 1+k*offs;
-    real_type sc2 = 1+C.k*offs_C;
+    real_type th1, k1, sc1, th2, k2, sc2;
+    offsetArc( theta0, k, offs, th1, k1, sc1 );
+    offsetArc( C.theta0, C.k, offs_C, th2, k2, sc2 );
     int_type ni = intersectCircleCircle(
       this->X_ISO(0,offs),
       this->Y_ISO(0,offs),
-      this->theta0,
-      this->k/sc2,
+      th1, k1,
       C.X_ISO(0,offs_C),
       C.Y_ISO(0,offs_C),
-      C.theta0,
-      C.k/sc2,
+      th2, k2,
       s1, s2
     );
     real_type eps1 = machepsi100*L;
@@ -766,13 +871,14 @@ namespace G2lib {
     real_type & t,
     real_type & dst
   ) const  {
-    real_type cc0 = cos(theta0);
-    real_type ss0 = sin(theta0);
+    real_type th, kk, ff;
+    offsetArc( theta0, k, offs, th, kk, ff );
+    real_type cc0 = cos(th);
+    real_type ss0 = sin(th);
     real_type xx0 = x0+offs*nx_Begin_ISO();
     real_type yy0 = y0+offs*ny_Begin_ISO();
-    real_type ff  = 1+k*offs;
     real_type LL  = L*ff;
-    s = projectPointOnCircleArc( xx0, yy0, cc0, ss0, k/ff, LL, qx, qy );
+    s = projectPointOnCircleArc( xx0, yy0, cc0, ss0, kk, LL, qx, qy );
     int_type res = 1;
     if ( s < 0 || s > LL ) {
       s = L;
@@ -789,6 +895,7 @@ namespace G2lib {
       }
       res = -1;
     } else {
+      s /= ff; // abscissa of the arc
       eval_ISO( s, offs, x, y );
     }
     real_type nx, ny;
@@ -136,6 +136,8 @@ namespace G2lib {
       x0     = _x0;
       y0     = _y0;
       theta0 = _theta0;
+      c0     = cos(_theta0);
+      s0     = sin(_theta0);
       k      = _k;
       L      = _L;
     }
@@ -317,7 +319,7 @@ namespace G2lib {
     virtual
     real_type
     length_ISO( real_type offs ) const G2LIB_OVERRIDE
-    { return L*(1+k*offs); }
+    { return L*std::abs(1-k*offs); }
 
     virtual
     real_type
@@ -347,12 +349,12 @@ namespace G2lib {
     virtual
     real_type
     nx_Begin_ISO() const G2LIB_OVERRIDE
-    { return s0; }
+    { return -s0; }
 
     virtual
     real_type
     ny_Begin_ISO() const G2LIB_OVERRIDE
-    { return -c0; }
+    { return c0; }
 
     // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
 
@@ -440,6 +442,15 @@ namespace G2lib {
       real_type & y_DDD
     ) const G2LIB_OVERRIDE;
 
+    virtual
+    void
+    eval_ISO(
+      real_type   s,
+      real_type   offs,
+      real_type & x,
+      real_type & y
+    ) const G2LIB_OVERRIDE;
+
     /*\
      |  _____                   _   _   _
      | |_   _|   __ _ _ __   __| | | \ | |
@@ -601,6 +612,40 @@ namespace G2lib {
       real_type         offs_obj
     ) const;
 
+    /*!
+     * \brief first intersection of a ray with the arc
+     *        (see `LineSegment::rayCast_ISO`)
+     */
+    bool
+    rayCast_ISO(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const;
+
+    bool
+    rayCast_SAE(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const {
+      return rayCast_ISO( qx, qy, dx, dy, max_range, -offs, x, y, s, dst );
+    }
+
     /*\
      |   _       _                          _
      |  (_)_ __ | |_ ___ _ __ ___  ___  ___| |_
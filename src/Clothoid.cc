@@ -276,19 +276,19 @@ namespace G2lib {
     vector<Triangle2D>::const_iterator it;
     for ( it = tvec.begin(); it != tvec.end(); ++it ) {
       // - - - - - - - - - - - - - - - - - - - -
-      if      ( it->x1() < xmin ) xmin = it->x1();
-      else if ( it->x1() > xmax ) xmax = it->x1();
-      if      ( it->x2() < xmin ) xmin = it->x2();
-      else if ( it->x2() > xmax ) xmax = it->x2();
-      if      ( it->x3() < xmin ) xmin = it->x3();
-      else if ( it->x3() > xmax ) xmax = it->x3();
+      if ( it->x1() < xmin ) xmin = it->x1();
+      if ( it->x1() > xmax ) xmax = it->x1();
+      if ( it->x2() < xmin ) xmin = it->x2();
+      if ( it->x2() > xmax ) xmax = it->x2();
+      if ( it->x3() < xmin ) xmin = it->x3();
+      if ( it->x3() > xmax ) xmax = it->x3();
       // - - - - - - - - - - - - - - - - - - - -
-      if      ( it->y1() < ymin ) ymin = it->y1();
-      else if ( it->y1() > ymax ) ymax = it->y1();
-      if      ( it->y2() < ymin ) ymin = it->y2();
-      else if ( it->y2() > ymax ) ymax = it->y2();
-      if      ( it->y3() < ymin ) ymin = it->y3();
-      else if ( it->y3() > ymax ) ymax = it->y3();
+      if ( it->y1() < ymin ) ymin = it->y1();
+      if ( it->y1() > ymax ) ymax = it->y1();
+      if ( it->y2() < ymin ) ymin = it->y2();
+      if ( it->y2() > ymax ) ymax = it->y2();
+      if ( it->y3() < ymin ) ymin = it->y3();
+      if ( it->y3() > ymax ) ymax = it->y3();
     }
   }
 
@@ -318,6 +318,7 @@ namespace G2lib {
     vector<BBox const *> bboxes;
     #endif
 
+    aabb_tri.clear();
     bbTriangles_ISO( offs, aabb_tri, max_angle, max_size );
     bboxes.reserve(aabb_tri.size());
     vector<Triangle2D>::const_iterator it;
@@ -336,6 +337,7 @@ namespace G2lib {
       #endif
     }
     aabb_tree.build(bboxes);
+    G2LIB_PERF_COUNT(aabb_rebuilds);
     aabb_done      = true;
     aabb_offs      = offs;
     aabb_max_angle = max_angle;
@@ -424,12 +426,12 @@ namespace G2lib {
 
     ss1 = (s1_min+s1_max)/2;
     ss2 = (s2_min+s2_max)/2;
+    G2LIB_PERF_COUNT(intersect_calls);
     for ( int_type i = 0; i < max_iter && !converged; ++i ) {
+      G2LIB_PERF_COUNT(intersect_iter);
       real_type t1[2], t2[2], p1[2], p2[2];
-      CD.eval_ISO  ( ss1, offs, p1[0], p1[1] );
-      CD.eval_ISO_D( ss1, offs, t1[0], t1[1] );
-      pC->CD.eval_ISO  ( ss2, offs_C, p2[0], p2[1] );
-      pC->CD.eval_ISO_D( ss2, offs_C, t2[0], t2[1] );
+      CD.eval_ISO( ss1, offs, p1[0], p1[1], t1[0], t1[1] );
+      pC->CD.eval_ISO( ss2, offs_C, p2[0], p2[1], t2[0], t2[1] );
       /*
       // risolvo il sistema
       // p1 + alpha * t1 = p2 + beta * t2
@@ -455,6 +457,7 @@ namespace G2lib {
         converged = abs(px) <= tolerance && abs(py) <= tolerance;
       }
     }
+    if ( !converged ) G2LIB_PERF_COUNT(intersect_fail);
     if ( converged ) {
       if      ( ss1 < T1.S0() ) ss1 = T1.S0();
       else if ( ss1 > T1.S1() ) ss1 = T1.S1();
@@ -466,6 +469,322 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  // abscissa in [a,b] where the angle of the clothoid is `th`,
+  // the angle must be monotone on [a,b] and th between theta(a) and theta(b)
+  static
+  real_type
+  theta_inverse(
+    ClothoidData const & CD,
+    real_type            a,
+    real_type            b,
+    real_type            th
+  ) {
+    bool inc = CD.theta(b) > CD.theta(a);
+    for ( int_type i = 0; i < 60 && b-a > machepsi*(abs(a)+abs(b)); ++i ) {
+      real_type m = (a+b)/2;
+      if ( (CD.theta(m) < th) == inc ) a = m;
+      else                             b = m;
+    }
+    return (a+b)/2;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // Between two crossings the arc of T1 has a tangent parallel to the arc
+  // of T2 (mean value theorem on the common chord). The arc of T1 is split
+  // at the inflection and where its angle enters or leaves the range of the
+  // angles of the arc of T2 (modulo pi): a piece with no parallel tangent
+  // has at most one crossing and the pieces are searched by increasing s
+  bool
+  ClothoidCurve::aabb_intersect_first_ISO(
+    Triangle2D    const & T1,
+    real_type             offs,
+    ClothoidCurve const * pC,
+    Triangle2D    const & T2,
+    real_type             offs_C,
+    real_type           & ss1,
+    real_type           & ss2
+  ) const {
+    real_type a = T1.S0(), b = T1.S1();
+
+    // range of the angle of the arc of T2
+    real_type th2_min = pC->CD.theta( T2.S0() );
+    real_type th2_max = pC->CD.theta( T2.S1() );
+    if ( th2_min > th2_max ) swap( th2_min, th2_max );
+    if ( pC->CD.dk != 0 ) {
+      real_type sk = -pC->CD.kappa0/pC->CD.dk;
+      if ( sk > T2.S0() && sk < T2.S1() ) {
+        real_type th = pC->CD.theta( sk );
+        th2_min = min( th2_min, th );
+        th2_max = max( th2_max, th );
+      }
+    }
+
+    // split points, the arc of the triangle turns less than pi
+    real_type split[16];
+    int_type  ns = 0;
+    real_type mono[3] = { a, b, b };
+    int_type  nm = 1;
+    if ( CD.dk != 0 ) {
+      real_type sk = -CD.kappa0/CD.dk;
+      if ( sk > a && sk < b ) { mono[1] = sk; nm = 2; }
+    }
+    split[ns++] = a;
+    for ( int_type j = 0; j < nm; ++j ) {
+      real_type l = mono[j], r = mono[j+1];
+      real_type lo = CD.theta(l), hi = CD.theta(r);
+      if ( lo > hi ) swap( lo, hi );
+      real_type const tau[2] = { th2_min, th2_max };
+      for ( int_type i = 0; i < 2; ++i ) {
+        real_type k  = ceil( (lo-tau[i])/m_pi );
+        real_type ke = floor( (hi-tau[i])/m_pi );
+        for ( ; k <= ke && ns < 14; ++k )
+          split[ns++] = theta_inverse( CD, l, r, tau[i]+k*m_pi );
+      }
+      split[ns++] = r;
+    }
+    std::sort( split, split+ns );
+
+    for ( int_type i = 1; i < ns; ++i ) {
+      if ( split[i] <= split[i-1] ) continue;
+      Triangle2D T( T1.P1(), T1.P2(), T1.P3(), split[i-1], split[i], T1.Icurve() );
+      if ( aabb_intersect_ISO( T, offs, pC, T2, offs_C, ss1, ss2 ) ) return true;
+    }
+    return false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // nearest crossing of the ray with the arc [a,b] of the offset clothoid
+  // by bisection, used when the arc may cross the ray twice or when the
+  // Newton iteration of aabb_raycast_ISO fails (e.g. near tangent hits).
+  // The tangent must rotate monotonically on [a,b]. g(s) = (P(s)-q) x u
+  // is zero on the line of the ray, the arc is split where the tangent
+  // is parallel to the ray (g'(s) = 0) so that g is monotone on each part
+  static
+  bool
+  raycast_bisect(
+    ClothoidData const & CD,
+    real_type            offs,
+    real_type            a,
+    real_type            b,
+    real_type            qx,
+    real_type            qy,
+    real_type            ux,
+    real_type            uy,
+    real_type            tmax,
+    real_type          & ss,
+    real_type          & tt
+  ) {
+    real_type eps = machepsi100*max(real_type(1),b-a);
+    real_type x, y, tx, ty;
+    real_type part[3] = { a, b, b };
+    int_type  npart   = 1;
+
+    // point where the tangent is parallel to the ray
+    CD.eval_ISO( a, offs, x, y, tx, ty );
+    real_type da = tx*uy - ty*ux;
+    CD.eval_ISO( b, offs, x, y, tx, ty );
+    real_type db = tx*uy - ty*ux;
+    if ( da*db < 0 ) {
+      real_type l = a, r = b;
+      for ( int_type i = 0; i < 100 && r-l > eps; ++i ) {
+        real_type m = (l+r)/2;
+        CD.eval_ISO( m, offs, x, y, tx, ty );
+        real_type dm = tx*uy - ty*ux;
+        if ( da*dm <= 0 ) r = m;
+        else            { l = m; da = dm; }
+      }
+      part[1] = (l+r)/2;
+      npart   = 2;
+    }
+
+    bool found = false;
+    for ( int_type k = 0; k < npart; ++k ) {
+      real_type l = part[k], r = part[k+1];
+      CD.eval_ISO( l, offs, x, y );
+      real_type gl = (x-qx)*uy - (y-qy)*ux;
+      CD.eval_ISO( r, offs, x, y );
+      real_type gr = (x-qx)*uy - (y-qy)*ux;
+      if ( gl*gr > 0 ) continue;
+      for ( int_type i = 0; i < 100 && r-l > eps; ++i ) {
+        real_type m = (l+r)/2;
+        CD.eval_ISO( m, offs, x, y );
+        real_type gm = (x-qx)*uy - (y-qy)*ux;
+        if ( gl*gm <= 0 ) r = m;
+        else            { l = m; gl = gm; }
+      }
+      real_type s = (l+r)/2;
+      CD.eval_ISO( s, offs, x, y );
+      real_type t = (x-qx)*ux + (y-qy)*uy;
+      if ( t < 0 || t > tmax ) continue;
+      if ( !found || t < tt ) { ss = s; tt = t; found = true; }
+    }
+    return found;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidCurve::aabb_raycast_ISO(
+    Triangle2D const & T,
+    real_type          offs,
+    real_type          qx,
+    real_type          qy,
+    real_type          ux,
+    real_type          uy,
+    real_type          tmax,
+    real_type        & ss,
+    real_type        & tt
+  ) const {
+    // g(s) = (P(s)-q) x u has at most one root where the tangent does not
+    // turn parallel to the ray, otherwise the crossings are bisected on
+    // the parts where g is monotone and the nearest one is taken; the
+    // tangent is monotone on the two sides of the inflection point
+    real_type a = T.S0(), b = T.S1();
+    real_type sk = CD.dk != 0 ? -CD.kappa0/CD.dk : a;
+    if ( sk > a && sk < b ) {
+      real_type s1, t1;
+      bool ok0 = raycast_bisect( CD, offs, a, sk, qx, qy, ux, uy, tmax, ss, tt );
+      bool ok1 = raycast_bisect( CD, offs, sk, b, qx, qy, ux, uy, tmax, s1, t1 );
+      if ( ok1 && ( !ok0 || t1 < tt ) ) { ss = s1; tt = t1; }
+      return ok0 || ok1;
+    }
+    {
+      real_type x, y, tx, ty;
+      CD.eval_ISO( a, offs, x, y, tx, ty );
+      real_type da = tx*uy - ty*ux;
+      CD.eval_ISO( b, offs, x, y, tx, ty );
+      real_type db = tx*uy - ty*ux;
+      if ( da*db <= 0 )
+        return raycast_bisect( CD, offs, a, b, qx, qy, ux, uy, tmax, ss, tt );
+    }
+
+    real_type eps   = machepsi1000*L;
+    real_type s_min = a-eps;
+    real_type s_max = b+eps;
+    int_type  nout  = 0;
+    bool converged  = false;
+
+    // g is monotone, a single crossing: the ray is a curve with constant
+    // tangent (ux,uy), same Newton
+    // iteration of aabb_intersect_ISO with (ss,tt) as unknowns
+    real_type p1[2], t1[2];
+    ss = (s_min+s_max)/2;
+    CD.eval_ISO( ss, offs, p1[0], p1[1] );
+    tt = (p1[0]-qx)*ux + (p1[1]-qy)*uy;
+    for ( int_type i = 0; i < max_iter && !converged; ++i ) {
+      CD.eval_ISO( ss, offs, p1[0], p1[1], t1[0], t1[1] );
+      real_type det = ux*t1[1]-t1[0]*uy;
+      real_type px  = qx+tt*ux-p1[0];
+      real_type py  = qy+tt*uy-p1[1];
+      ss += (py*ux - px*uy)/det;
+      tt += (t1[0]*py - t1[1]*px)/det;
+      if ( ! ( isfinite(ss) && isfinite(tt) ) ) break;
+      bool out = false;
+      if      ( ss < s_min ) { out = true; ss = s_min; }
+      else if ( ss > s_max ) { out = true; ss = s_max; }
+      if      ( tt < -eps      ) { out = true; tt = -eps; }
+      else if ( tt > tmax+eps  ) { out = true; tt = tmax+eps; }
+      if ( out ) {
+        if ( ++nout > 3 ) break;
+      } else {
+        converged = abs(px) <= tolerance && abs(py) <= tolerance;
+      }
+    }
+    if ( !converged )
+      return raycast_bisect( CD, offs, a, b, qx, qy, ux, uy, tmax, ss, tt );
+    if      ( ss < a ) ss = a;
+    else if ( ss > b ) ss = b;
+    if ( tt < 0 ) tt = 0;
+    return tt <= tmax;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidCurve::rayCast_ISO(
+    real_type   qx,
+    real_type   qy,
+    real_type   dx,
+    real_type   dy,
+    real_type   max_range,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & dst
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    return rayCast_ISO( qx, qy, dx, dy, max_range, offs, x, y, s, dst, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidCurve::rayCast_ISO(
+    real_type       qx,
+    real_type       qy,
+    real_type       dx,
+    real_type       dy,
+    real_type       max_range,
+    real_type       offs,
+    real_type     & x,
+    real_type     & y,
+    real_type     & s,
+    real_type     & dst,
+    AABBworkspace & ws
+  ) const {
+    real_type len = hypot( dx, dy );
+    G2LIB_ASSERT(
+      len > 0, "ClothoidCurve::rayCast_ISO, null direction of the ray"
+    );
+    real_type ux = dx/len;
+    real_type uy = dy/len;
+    this->build_AABBtree_ISO( offs );
+    T2D_raycast_ISO fun( this, qx, qy, ux, uy, offs, s, dst );
+    if ( !aabb_tree.raycast( qx, qy, ux, uy, max_range, fun, ws.queue ) )
+      return false;
+    x = qx + dst*ux;
+    y = qy + dst*uy;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidCurve::rayCast_ISO(
+    int_type        n,
+    real_type const qx[],
+    real_type const qy[],
+    real_type const dx[],
+    real_type const dy[],
+    real_type       max_range,
+    real_type       offs,
+    real_type       s[],
+    real_type       dst[]
+  ) const {
+    AABBworkspace ws; // the queue of the search is reused by all the rays
+    int_type      nhit = 0;
+    for ( int_type i = 0; i < n; ++i ) {
+      real_type x, y;
+      if ( rayCast_ISO( qx[i], qy[i], dx[i], dy[i], max_range, offs,
+                        x, y, s[i], dst[i], ws ) ) {
+        ++nhit;
+      } else {
+        s[i]   = 0;
+        dst[i] = -1;
+      }
+    }
+    return nhit;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   ClothoidCurve::intersect_ISO(
     real_type             offs,
@@ -473,11 +792,31 @@ namespace G2lib {
     real_type             offs_C,
     IntersectList       & ilist,
     bool                  swap_s_vals
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    intersect_ISO( offs, C, offs_C, ilist, swap_s_vals, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidCurve::intersect_ISO(
+    real_type             offs,
+    ClothoidCurve const & C,
+    real_type             offs_C,
+    IntersectList       & ilist,
+    bool                  swap_s_vals,
+    AABBworkspace       & ws
   ) const {
     if ( intersect_with_AABBtree ) {
       this->build_AABBtree_ISO( offs );
       C.build_AABBtree_ISO( offs_C );
-      AABBtree::VecPairPtrBBox iList;
+      AABBtree::VecPairPtrBBox & iList = ws.intersectionList;
+      iList.clear();
       aabb_tree.intersect( C.aabb_tree, iList );
       AABBtree::VecPairPtrBBox::const_iterator ip;
 
@@ -496,7 +835,12 @@ namespace G2lib {
           ilist.push_back( Ipair( ss1, ss2 ) );
         }
       }
+      iList.clear(); // release the bbox
     } else {
+      // triangles overwritten, the AABB tree is no more valid
+      aabb_done = C.aabb_done = false;
+      aabb_tri.clear();
+      C.aabb_tri.clear();
       bbTriangles_ISO( offs, aabb_tri, m_pi/18, 1e100 );
       C.bbTriangles_ISO( offs_C, C.aabb_tri, m_pi/18, 1e100 );
       for ( vector<Triangle2D>::const_iterator i1 = aabb_tri.begin();
@@ -542,13 +886,15 @@ namespace G2lib {
     // minimize using circle approximation
     s = (s_begin + s_end)/2;
     int_type nout = 0;
+    bool     converged = false;
+    G2LIB_PERF_COUNT(closest_calls);
     for ( int_type iter = 0; iter < max_iter; ++iter ) {
+      G2LIB_PERF_COUNT(closest_iter);
       // osculating circle
-      CD.eval_ISO( s, offs, x, y );
-      real_type th = CD.theta( s );
-      real_type kk = CD.kappa( s );
+      real_type tx, ty, kk;
+      CD.evaluate_ISO( s, offs, x, y, tx, ty, kk );
       real_type sc = 1+kk*offs;
-      real_type ds = projectPointOnCircle( x, y, th, kk/sc, qx, qy )/sc;
+      real_type ds = projectPointOnCircle( x, y, tx, ty, kk/sc, qx, qy )/sc;
 
       s += ds;
 
@@ -557,11 +903,14 @@ namespace G2lib {
       else if ( s >= s_end   ) { out = true; s = s_end; }
 
       if ( out ) {
-        if ( ++nout > 3 ) break;
+        converged = ++nout > 3; // minimum at the border
+        if ( converged ) break;
       } else {
-        if ( abs(ds) <= tolerance ) break;
+        converged = abs(ds) <= tolerance;
+        if ( converged ) break;
       }
     }
+    if ( !converged ) G2LIB_PERF_COUNT(closest_fail);
     dst = hypot( qx-x, qy-y );
     #else
     real_type ds = (s_end-s_begin)/10;
@@ -594,11 +943,34 @@ namespace G2lib {
     real_type & s,
     real_type & t,
     real_type & DST
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    return closestPoint_ISO( qx, qy, offs, x, y, s, t, DST, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidCurve::closestPoint_ISO(
+    real_type       qx,
+    real_type       qy,
+    real_type       offs,
+    real_type     & x,
+    real_type     & y,
+    real_type     & s,
+    real_type     & t,
+    real_type     & DST,
+    AABBworkspace & ws
   ) const {
     DST = numeric_limits<real_type>::infinity();
     this->build_AABBtree_ISO( offs );
 
-    AABBtree::VecPtrBBox candidateList;
+    AABBtree::VecPtrBBox & candidateList = ws.candidateList;
+    candidateList.clear();
     aabb_tree.min_distance( qx, qy, candidateList );
     AABBtree::VecPtrBBox::const_iterator ic;
     G2LIB_ASSERT(
@@ -623,6 +995,8 @@ namespace G2lib {
         }
       }
     }
+    candidateList.clear(); // release the bbox
+
     real_type nx, ny;
     nor_ISO( s, nx, ny );
     t = (qx-x) * nx + (qy-y) * ny - offs;
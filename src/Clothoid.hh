@@ -51,6 +51,7 @@ namespace G2lib {
   //! \brief Class to manage Clothoid Curve
   class ClothoidCurve : public BaseCurve {
     friend class ClothoidList;
+    friend class ClothoidListCompact;
   private:
 
     ClothoidData CD;  //!< clothoid data
@@ -111,6 +112,31 @@ namespace G2lib {
       real_type           & ss2
     ) const;
 
+    // as `aabb_intersect_ISO` but the intersection with minimum `ss1`
+    bool
+    aabb_intersect_first_ISO(
+      Triangle2D    const & T1,
+      real_type             offs,
+      ClothoidCurve const * pC,
+      Triangle2D    const & T2,
+      real_type             C_offs,
+      real_type           & ss1,
+      real_type           & ss2
+    ) const;
+
+    bool
+    aabb_raycast_ISO(
+      Triangle2D const & T,
+      real_type          offs,
+      real_type          qx,
+      real_type          qy,
+      real_type          ux,
+      real_type          uy,
+      real_type          tmax,
+      real_type        & ss,
+      real_type        & tt
+    ) const;
+
     class T2D_approximate_collision {
       ClothoidCurve const * pC1;
       ClothoidCurve const * pC2;
@@ -158,6 +184,49 @@ namespace G2lib {
       }
     };
 
+    // first hit of the ray (qx,qy)+t*(ux,uy) with the curve
+    class T2D_raycast_ISO {
+      ClothoidCurve const * pC;
+      real_type     const   qx;
+      real_type     const   qy;
+      real_type     const   ux;
+      real_type     const   uy;
+      real_type     const   offs;
+      real_type           & s;
+      real_type           & dst;
+    public:
+      T2D_raycast_ISO(
+        ClothoidCurve const * _pC,
+        real_type     const   _qx,
+        real_type     const   _qy,
+        real_type     const   _ux,
+        real_type     const   _uy,
+        real_type     const   _offs,
+        real_type           & _s,
+        real_type           & _dst
+      )
+      : pC(_pC)
+      , qx(_qx)
+      , qy(_qy)
+      , ux(_ux)
+      , uy(_uy)
+      , offs(_offs)
+      , s(_s)
+      , dst(_dst)
+      {}
+
+      bool
+      hit( BBox::PtrBBox ptr, real_type tmax, real_type & t ) const {
+        Triangle2D const & T = pC->aabb_tri[size_t(ptr->Ipos())];
+        real_type ss;
+        if ( !pC->aabb_raycast_ISO( T, offs, qx, qy, ux, uy, tmax, ss, t ) )
+          return false;
+        s   = ss;
+        dst = t;
+        return true;
+      }
+    };
+
   public:
 
     #include "BaseCurve_using.hxx"
@@ -1009,12 +1078,12 @@ namespace G2lib {
     virtual
     void
     translate( real_type tx, real_type ty ) G2LIB_OVERRIDE
-    { CD.x0 += tx; CD.y0 += ty; }
+    { CD.x0 += tx; CD.y0 += ty; aabb_done = false; }
 
     virtual
     void
     rotate( real_type angle, real_type cx, real_type cy ) G2LIB_OVERRIDE
-    { CD.rotate( angle, cx, cy ); }
+    { CD.rotate( angle, cx, cy ); aabb_done = false; }
 
     virtual
     void
@@ -1022,29 +1091,32 @@ namespace G2lib {
       CD.kappa0 /= s;
       CD.dk     /= s*s;
       L         *= s;
+      aabb_done  = false;
     }
 
     virtual
     void
     reverse() G2LIB_OVERRIDE
-    { CD.reverse(L); }
+    { CD.reverse(L); aabb_done = false; }
 
     virtual
     void
     changeOrigin( real_type newx0, real_type newy0 ) G2LIB_OVERRIDE
-    { CD.x0 = newx0; CD.y0 = newy0; }
+    { CD.x0 = newx0; CD.y0 = newy0; aabb_done = false; }
 
     virtual
     void
     trim( real_type s_begin, real_type s_end ) G2LIB_OVERRIDE {
       CD.origin_at( s_begin );
-      L = s_end - s_begin;
+      L         = s_end - s_begin;
+      aabb_done = false;
     }
 
     void
     changeCurvilinearOrigin( real_type s0, real_type newL ) {
       CD.origin_at( s0 );
-      L = newL;
+      L         = newL;
+      aabb_done = false;
     }
 
     /*\
@@ -1080,6 +1152,37 @@ namespace G2lib {
       real_type & dst
     ) const G2LIB_OVERRIDE;
 
+    //! as `closestPoint_ISO` using the scratch space `ws` (no allocation)
+    int_type
+    closestPoint_ISO(
+      real_type       qx,
+      real_type       qy,
+      real_type       offs,
+      real_type     & x,
+      real_type     & y,
+      real_type     & s,
+      real_type     & t,
+      real_type     & dst,
+      AABBworkspace & ws
+    ) const;
+
+    int_type
+    closestPoint_SAE(
+      real_type       qx,
+      real_type       qy,
+      real_type       offs,
+      real_type     & x,
+      real_type     & y,
+      real_type     & s,
+      real_type     & t,
+      real_type     & dst,
+      AABBworkspace & ws
+    ) const {
+      int_type res = closestPoint_ISO( qx, qy, -offs, x, y, s, t, dst, ws );
+      t = -t;
+      return res;
+    }
+
     // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
     // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
 
@@ -1144,6 +1247,127 @@ namespace G2lib {
       bool                    swap_s_vals
     ) const;
 
+    //! as `intersect_ISO` using the scratch space `ws` (no allocation)
+    void
+    intersect_ISO(
+      real_type               offs,
+      ClothoidCurve const   & C,
+      real_type               offs_C,
+      IntersectList         & ilist,
+      bool                    swap_s_vals,
+      AABBworkspace         & ws
+    ) const;
+
+    /*\
+     |                                   _
+     |   _ __ __ _ _   _  ___ __ _ ___| |_
+     |  | '__/ _` | | | |/ __/ _` / __| __|
+     |  | | | (_| | |_| | (_| (_| \__ \ |_
+     |  |_|  \__,_|\__, |\___\__,_|___/\__|
+     |            |___/
+    \*/
+
+    /*!
+     * \brief first intersection of a ray with the clothoid
+     *
+     * The ray is `(qx,qy)+t*(dx,dy)/|(dx,dy)|` with `0 <= t <= max_range`,
+     * a segment casting is a ray with `max_range` equal to the length
+     * of the segment. The AABB tree of the curve with offset `offs`
+     * select the candidate triangles and the hit is refined by Newton.
+     *
+     * \param[in]  qx        x-coordinate of the origin of the ray
+     * \param[in]  qy        y-coordinate of the origin of the ray
+     * \param[in]  dx        x-component of the direction of the ray
+     * \param[in]  dy        y-component of the direction of the ray
+     * \param[in]  max_range maximum distance along the ray
+     * \param[in]  offs      offset of the curve
+     * \param[out] x         x-coordinate of the hit point
+     * \param[out] y         y-coordinate of the hit point
+     * \param[out] s         curvilinear coordinate of the hit point
+     * \param[out] dst       distance of the hit point from the origin
+     * \return true if the ray hit the curve
+     */
+    bool
+    rayCast_ISO(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const;
+
+    bool
+    rayCast_SAE(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const {
+      return rayCast_ISO( qx, qy, dx, dy, max_range, -offs, x, y, s, dst );
+    }
+
+    //! as `rayCast_ISO` using the scratch space `ws` (no allocation)
+    bool
+    rayCast_ISO(
+      real_type       qx,
+      real_type       qy,
+      real_type       dx,
+      real_type       dy,
+      real_type       max_range,
+      real_type       offs,
+      real_type     & x,
+      real_type     & y,
+      real_type     & s,
+      real_type     & dst,
+      AABBworkspace & ws
+    ) const;
+
+    /*!
+     * \brief cast `n` rays `(qx[i],qy[i])+t*(dx[i],dy[i])`
+     *
+     * \param[out] s   curvilinear coordinate of the hits
+     * \param[out] dst distance of the hits, `-1` if the ray miss the curve
+     * \return the number of rays that hit the curve
+     */
+    int_type
+    rayCast_ISO(
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type const dx[],
+      real_type const dy[],
+      real_type       max_range,
+      real_type       offs,
+      real_type       s[],
+      real_type       dst[]
+    ) const;
+
+    int_type
+    rayCast_SAE(
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type const dx[],
+      real_type const dy[],
+      real_type       max_range,
+      real_type       offs,
+      real_type       s[],
+      real_type       dst[]
+    ) const {
+      return rayCast_ISO( n, qx, qy, dx, dy, max_range, -offs, s, dst );
+    }
+
     void
     info( ostream_type & stream ) const G2LIB_OVERRIDE
     { stream << "Clothoid\n" << *this << '\n'; }
@@ -514,92 +514,10 @@ namespace G2lib {
     real_type dmax
   ) {
     try {
-      // save data
-      x0     = _x0;
-      y0     = _y0;
-      theta0 = _theta0;
-      kappa0 = _kappa0;
-      x1     = _x1;
-      y1     = _y1;
-      theta1 = _theta1;
-      kappa1 = _kappa1;
-
-      // transform to reference frame
-      real_type dx = x1 - x0;
-      real_type dy = y1 - y0;
-      phi    = atan2( dy, dx );
-      Lscale = 2/hypot( dx, dy );
-
-      th0 = theta0 - phi;
-      th1 = theta1 - phi;
-
-      // put in range
-      rangeSymm(th0);
-      rangeSymm(th1);
-
-      K0 = (kappa0/Lscale); // k0
-      K1 = (kappa1/Lscale); // k1
-
-      if ( Dmax <= 0 ) Dmax = m_pi;
-      if ( dmax <= 0 ) dmax = m_pi/8;
-
-      if ( Dmax > m_2pi  ) Dmax = m_2pi;
-      if ( dmax > m_pi/4 ) dmax = m_pi/4;
-
-      // compute guess G1
-      ClothoidCurve SG;
-      SG.build_G1( -1, 0, th0, 1, 0, th1 );
-
-      real_type kA = SG.kappaBegin();
-      real_type kB = SG.kappaEnd();
-      real_type dk = abs(SG.dkappa());
-      real_type L3 = SG.length()/3;
-
-      real_type tmp = 0.5*abs(K0-kA)/dmax;
-      s0 = L3;
-      if ( tmp*s0 > 1 ) s0 = 1/tmp;
-      tmp = (abs(K0+kA)+s0*dk)/(2*Dmax);
-      if ( tmp*s0 > 1 ) s0 = 1/tmp;
-
-      tmp = 0.5*abs(K1-kB)/dmax;
-      s1 = L3;
-      if ( tmp*s1 > 1 ) s1 = 1/tmp;
-      tmp = (abs(K1+kB)+s1*dk)/(2*Dmax);
-      if ( tmp*s1 > 1 ) s1 = 1/tmp;
-
-      real_type dth   = abs(th0-th1) / m_2pi;
-      real_type scale = power3(cos( power4(dth)*m_pi_2 ));
-      s0 *= scale;
-      s1 *= scale;
-
-      real_type L   = (3*L3-s0-s1)/2;
-      real_type thM = SG.theta(s0+L);
-      th0 = SG.thetaBegin();
-      th1 = SG.thetaEnd();
-
-      // setup
-
-      K0 *= s0;
-      K1 *= s1;
-
-      real_type t0 = 2*th0+K0;
-      real_type t1 = 2*th1-K1;
-
-      c0  = s0*s1;
-      c1  = 2 * s0;
-      c2  = 0.25*((K1-6*(K0+th0)-2*th1)*s0 - 3*K0*s1);
-      c3  = -c0 * (K0 + th0);
-      c4  = 2 * s1;
-      c5  = 0.25*((6*(K1-th1)-K0-2*th0)*s1 + 3*K1*s0);
-      c6  = c0 * (K1 - th1);
-      c7  = -0.5*(s0 + s1);
-      c8  = th0 + th1 + 0.5*(K0 - K1);
-      c9  = 0.25*(t1*s0 + t0*s1);
-      c10 = 0.5*(s1 - s0);
-      c11 = 0.5*(th1 - th0) - 0.25*(K0 + K1);
-      c12 = 0.25*(t1*s0 - t0*s1);
-      c13 = 0.5*s0*s1;
-      c14 = 0.75*(s0 + s1);
+      real_type L, thM;
+      setup(
+        _x0, _y0, _theta0, _kappa0, _x1, _y1, _theta1, _kappa1, Dmax, dmax, L, thM
+      );
       return solve( L, thM );
     } catch (...) {
       return -1;
@@ -609,6 +527,111 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  G2solve3arc::setup(
+    real_type   _x0,
+    real_type   _y0,
+    real_type   _theta0,
+    real_type   _kappa0,
+    real_type   _x1,
+    real_type   _y1,
+    real_type   _theta1,
+    real_type   _kappa1,
+    real_type   Dmax,
+    real_type   dmax,
+    real_type & L,
+    real_type & thM
+  ) {
+    // save data
+    x0     = _x0;
+    y0     = _y0;
+    theta0 = _theta0;
+    kappa0 = _kappa0;
+    x1     = _x1;
+    y1     = _y1;
+    theta1 = _theta1;
+    kappa1 = _kappa1;
+
+    // transform to reference frame
+    real_type dx = x1 - x0;
+    real_type dy = y1 - y0;
+    phi    = atan2( dy, dx );
+    Lscale = 2/hypot( dx, dy );
+
+    th0 = theta0 - phi;
+    th1 = theta1 - phi;
+
+    // put in range
+    rangeSymm(th0);
+    rangeSymm(th1);
+
+    K0 = (kappa0/Lscale); // k0
+    K1 = (kappa1/Lscale); // k1
+
+    if ( Dmax <= 0 ) Dmax = m_pi;
+    if ( dmax <= 0 ) dmax = m_pi/8;
+
+    if ( Dmax > m_2pi  ) Dmax = m_2pi;
+    if ( dmax > m_pi/4 ) dmax = m_pi/4;
+
+    // compute guess G1
+    ClothoidCurve SG;
+    SG.build_G1( -1, 0, th0, 1, 0, th1 );
+
+    real_type kA = SG.kappaBegin();
+    real_type kB = SG.kappaEnd();
+    real_type dk = abs(SG.dkappa());
+    real_type L3 = SG.length()/3;
+
+    real_type tmp = 0.5*abs(K0-kA)/dmax;
+    s0 = L3;
+    if ( tmp*s0 > 1 ) s0 = 1/tmp;
+    tmp = (abs(K0+kA)+s0*dk)/(2*Dmax);
+    if ( tmp*s0 > 1 ) s0 = 1/tmp;
+
+    tmp = 0.5*abs(K1-kB)/dmax;
+    s1 = L3;
+    if ( tmp*s1 > 1 ) s1 = 1/tmp;
+    tmp = (abs(K1+kB)+s1*dk)/(2*Dmax);
+    if ( tmp*s1 > 1 ) s1 = 1/tmp;
+
+    real_type dth   = abs(th0-th1) / m_2pi;
+    real_type scale = power3(cos( power4(dth)*m_pi_2 ));
+    s0 *= scale;
+    s1 *= scale;
+
+    L   = (3*L3-s0-s1)/2;
+    thM = SG.theta(s0+L);
+    th0 = SG.thetaBegin();
+    th1 = SG.thetaEnd();
+
+    // setup
+
+    K0 *= s0;
+    K1 *= s1;
+
+    real_type t0 = 2*th0+K0;
+    real_type t1 = 2*th1-K1;
+
+    c0  = s0*s1;
+    c1  = 2 * s0;
+    c2  = 0.25*((K1-6*(K0+th0)-2*th1)*s0 - 3*K0*s1);
+    c3  = -c0 * (K0 + th0);
+    c4  = 2 * s1;
+    c5  = 0.25*((6*(K1-th1)-K0-2*th0)*s1 + 3*K1*s0);
+    c6  = c0 * (K1 - th1);
+    c7  = -0.5*(s0 + s1);
+    c8  = th0 + th1 + 0.5*(K0 - K1);
+    c9  = 0.25*(t1*s0 + t0*s1);
+    c10 = 0.5*(s1 - s0);
+    c11 = 0.5*(th1 - th0) - 0.25*(K0 + K1);
+    c12 = 0.25*(t1*s0 - t0*s1);
+    c13 = 0.5*s0*s1;
+    c14 = 0.75*(s0 + s1);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   int
   G2solve3arc::build_fixed_length(
     real_type _s0,
@@ -722,10 +745,11 @@ namespace G2lib {
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
-  G2solve3arc::evalFJ(
+  G2solve3arc::evalFJ_args(
     real_type const vars[2],
-    real_type       F[2],
-    real_type       J[2][2]
+    real_type       a[4],
+    real_type       b[4],
+    real_type       c[4]
   ) const {
 
     real_type sM  = vars[0];
@@ -738,14 +762,33 @@ namespace G2lib {
     real_type dKM   = dsMsM*(thM*(c7-2*sM) + c8*sM + c9);
     real_type KM    = dsMsM*(c10*thM + c11*sM + c12);
 
-    real_type X0[3],  Y0[3],
-              X1[3],  Y1[3],
-              XMp[3], YMp[3],
-              XMm[3], YMm[3];
-    GeneralizedFresnelCS( 3, dK0,  K0, th0, X0,  Y0);
-    GeneralizedFresnelCS( 3, dK1, -K1, th1, X1,  Y1);
-    GeneralizedFresnelCS( 3, dKM,  KM, thM, XMp, YMp);
-    GeneralizedFresnelCS( 3, dKM, -KM, thM, XMm, YMm);
+    a[0] = dK0; b[0] =  K0; c[0] = th0;
+    a[1] = dK1; b[1] = -K1; c[1] = th1;
+    a[2] = dKM; b[2] =  KM; c[2] = thM;
+    a[3] = dKM; b[3] = -KM; c[3] = thM;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  G2solve3arc::evalFJ_assemble(
+    real_type const vars[2],
+    real_type const X[12],
+    real_type const Y[12],
+    real_type       F[2],
+    real_type       J[2][2]
+  ) const {
+
+    real_type sM  = vars[0];
+    real_type thM = vars[1];
+
+    real_type dsM   = 1.0 / (c13+(c14+sM)*sM);
+    real_type dsMsM = dsM*sM;
+
+    real_type const * X0  = X;   real_type const * Y0  = Y;
+    real_type const * X1  = X+3; real_type const * Y1  = Y+3;
+    real_type const * XMp = X+6; real_type const * YMp = Y+6;
+    real_type const * XMm = X+9; real_type const * YMm = Y+9;
 
     // in the standard problem dx = 2, dy = 0
     real_type t0 = XMp[0]+XMm[0];
@@ -787,6 +830,21 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  G2solve3arc::evalFJ(
+    real_type const vars[2],
+    real_type       F[2],
+    real_type       J[2][2]
+  ) const {
+    real_type a[4], b[4], c[4], X[12], Y[12];
+    evalFJ_args( vars, a, b, c );
+    for ( int_type k = 0; k < 4; ++k )
+      GeneralizedFresnelCS( 3, a[k], b[k], c[k], X+3*k, Y+3*k );
+    evalFJ_assemble( vars, X, Y, F, J );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   int
   G2solve3arc::solve( real_type sM_guess, real_type thM_guess ) {
 
@@ -844,6 +902,9 @@ namespace G2lib {
       std::cerr << "G2solve3arc::solve, something go wrong\n";
       // nothing to do
     }
+    G2LIB_PERF_COUNT(G2solve3arc_calls);
+    G2LIB_PERF_ADD(G2solve3arc_iter,iter);
+    if ( !converged ) G2LIB_PERF_COUNT(G2solve3arc_fail);
     if ( converged ) buildSolution(X[0], X[1]); // costruisco comunque soluzione
     return converged ? iter : -1;
   }
@@ -1194,6 +1255,132 @@ namespace G2lib {
     }
   }
 
+  /*\
+   |    ____ ____            _           _____                 ____        _       _
+   |   / ___|___ \ ___  ___ | |_   _____|___ /  __ _ _ __ ___| __ )  __ _| |_ ___| |__
+   |  | |  _  __) / __|/ _ \| \ \ / / _ \ |_ \ / _` | '__/ __|  _ \ / _` | __/ __| '_ \
+   |  | |_| |/ __/\__ \ (_) | |\ V /  __/___) | (_| | | | (__| |_) | (_| | || (__| | | |
+   |   \____|_____|___/\___/|_| \_/ \___|____/ \__,_|_|  \___|____/ \__,_|\__\___|_| |_|
+  \*/
+
+  void
+  G2solve3arcBatch::setTolerance( real_type tol ) {
+    for ( int_type l = 0; l < lanes; ++l ) lane[l].setTolerance( tol );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  G2solve3arcBatch::setMaxIter( int miter ) {
+    for ( int_type l = 0; l < lanes; ++l ) lane[l].setMaxIter( miter );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  G2solve3arcBatch::build(
+    int_type        n,
+    real_type const x0[],
+    real_type const y0[],
+    real_type const theta0[],
+    real_type const kappa0[],
+    real_type const x1[],
+    real_type const y1[],
+    real_type const theta1[],
+    real_type const kappa1[],
+    int_type        iter[],
+    ClothoidCurve   S0[],
+    ClothoidCurve   SM[],
+    ClothoidCurve   S1[]
+  ) {
+    int_type  active[lanes];    // lanes with a problem (the first na)
+    int_type  idle[lanes];      // lanes without a problem (the first nidle)
+    int_type  prob[lanes];      // problem of the lane
+    int_type  it[lanes];        // iterations done on the lane
+    real_type X[lanes][2];      // unknowns (sM,thM) of the lane
+    real_type fa[4*lanes], fb[4*lanes], fc[4*lanes];   // Fresnel arguments
+    real_type fX[12*lanes], fY[12*lanes];              // Fresnel integrals
+
+    int_type na = 0, nidle = lanes, next = 0, nsolved = 0;
+    for ( int_type l = 0; l < lanes; ++l ) idle[l] = lanes-1-l;
+
+    while ( true ) {
+
+      // give a problem to the idle lanes
+      while ( nidle > 0 && next < n ) {
+        int_type      i = next++;
+        int_type      l = idle[nidle-1];
+        G2solve3arc & g = lane[l];
+        try {
+          g.setup(
+            x0[i], y0[i], theta0[i], kappa0[i],
+            x1[i], y1[i], theta1[i], kappa1[i],
+            0, 0, X[l][0], X[l][1]
+          );
+        } catch (...) {
+          iter[i] = -1;
+          continue;
+        }
+        --nidle;
+        prob[l]      = i;
+        it[l]        = 0;
+        active[na++] = l;
+      }
+      if ( na == 0 ) break;
+
+      // the Fresnel integrals of all the lanes with one call
+      for ( int_type k = 0; k < na; ++k ) {
+        int_type l = active[k];
+        lane[l].evalFJ_args( X[l], fa+4*k, fb+4*k, fc+4*k );
+      }
+      GeneralizedFresnelCS( 4*na, 3, fa, fb, fc, fX, fY );
+
+      // Newton step on each lane (as G2solve3arc::solve),
+      // the lanes done are masked off
+      int_type nk = 0;
+      for ( int_type k = 0; k < na; ++k ) {
+        int_type      l = active[k];
+        G2solve3arc & g = lane[l];
+        Solve2x2      solver;
+        real_type     F[2], J[2][2], d[2];
+        g.evalFJ_assemble( X[l], fX+12*k, fY+12*k, F, J );
+        bool converged = hypot( F[0], F[1] ) < g.tolerance;
+        bool done      = converged || !solver.factorize( J );
+        if ( !done ) {
+          solver.solve( F, d );
+          X[l][0] -= d[0];
+          X[l][1] -= d[1];
+          done = ++it[l] >= g.maxIter;
+        }
+        if ( !done ) { active[nk++] = l; continue; }
+
+        // re-check solution
+        if ( converged )
+          converged = FP_INFINITE != fpclassify(X[l][0]) &&
+                      FP_NAN      != fpclassify(X[l][0]) &&
+                      FP_INFINITE != fpclassify(X[l][1]) &&
+                      FP_NAN      != fpclassify(X[l][1]);
+        G2LIB_PERF_COUNT(G2solve3arc_calls);
+        G2LIB_PERF_ADD(G2solve3arc_iter,it[l]);
+        int_type i = prob[l];
+        if ( converged ) {
+          g.buildSolution( X[l][0], X[l][1] );
+          S0[i].copy( g.S0 );
+          SM[i].copy( g.SM );
+          S1[i].copy( g.S1 );
+          iter[i] = it[l];
+          ++nsolved;
+        } else {
+          G2LIB_PERF_COUNT(G2solve3arc_fail);
+          iter[i] = -1;
+        }
+        idle[nidle++] = l;
+      }
+      na = nk;
+    }
+    return nsolved;
+  }
+
   /*\
    |
    |    ___ _     _   _        _    _ ___      _ _           ___ ___
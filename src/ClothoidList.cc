@@ -20,6 +20,7 @@
 #include "ClothoidList.hh"
 #include "Biarc.hh"
 #include "BiarcList.hh"
+#include "CurveStatic.hh"
 
 #include <cmath>
 #include <cfloat>
@@ -57,6 +58,7 @@ namespace G2lib {
   : BaseCurve(G2LIB_CLOTHOID_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , aabb_cache_capacity(4)
   {
     init();
     push_back( LS );
@@ -66,6 +68,7 @@ namespace G2lib {
   : BaseCurve(G2LIB_CLOTHOID_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , aabb_cache_capacity(4)
   {
     init();
     push_back( C );
@@ -75,6 +78,7 @@ namespace G2lib {
   : BaseCurve(G2LIB_CLOTHOID_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , aabb_cache_capacity(4)
   {
     init();
     push_back( C.getC0() );
@@ -85,6 +89,7 @@ namespace G2lib {
   : BaseCurve(G2LIB_CLOTHOID_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , aabb_cache_capacity(4)
   {
     init();
     push_back( c );
@@ -94,6 +99,7 @@ namespace G2lib {
   : BaseCurve(G2LIB_CLOTHOID_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , aabb_cache_capacity(4)
   {
     init();
     push_back( c );
@@ -103,6 +109,7 @@ namespace G2lib {
   : BaseCurve(G2LIB_CLOTHOID_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , aabb_cache_capacity(4)
   {
     init();
     push_back( pl );
@@ -112,6 +119,7 @@ namespace G2lib {
   : BaseCurve(G2LIB_CLOTHOID_LIST)
   , last_idx(0)
   , aabb_done(false)
+  , aabb_cache_capacity(4)
   {
     init();
     switch ( C.type() ) {
@@ -145,13 +153,17 @@ namespace G2lib {
   ClothoidList::init() {
     s0.clear();
     clotoidList.clear();
-    last_idx = 0;
+    last_idx  = 0;
+    aabb_done = false;
+    aabb_cache_clear();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
   ClothoidList::copy( ClothoidList const & L ) {
+    aabb_done = false;
+    aabb_cache_clear();
     clotoidList.clear();
     clotoidList.reserve(L.clotoidList.size());
     std::copy( L.clotoidList.begin(),
@@ -176,6 +188,8 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( LineSegment const & LS ) {
+    aabb_done = false;
+    aabb_cache_clear();
     if ( clotoidList.empty() ) {
       s0.push_back(0);
       s0.push_back(LS.length());
@@ -189,6 +203,8 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( CircleArc const & C ) {
+    aabb_done = false;
+    aabb_cache_clear();
     if ( clotoidList.empty() ) {
       s0.push_back(0);
       s0.push_back(C.length());
@@ -202,13 +218,11 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( Biarc const & c ) {
-    if ( clotoidList.empty() ) {
-      s0.push_back(0);
-      s0.push_back(c.length());
-    } else {
-      s0.push_back(s0.back()+c.getC0().length());
-      s0.push_back(s0.back()+c.getC1().length());
-    }
+    aabb_done = false;
+    aabb_cache_clear();
+    if ( clotoidList.empty() ) s0.push_back(0);
+    s0.push_back(s0.back()+c.getC0().length());
+    s0.push_back(s0.back()+c.getC1().length());
     clotoidList.push_back(ClothoidCurve(c.getC0()));
     clotoidList.push_back(ClothoidCurve(c.getC1()));
   }
@@ -217,6 +231,8 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( ClothoidCurve const & c ) {
+    aabb_done = false;
+    aabb_cache_clear();
     if ( clotoidList.empty() ) {
       s0.push_back(0);
       s0.push_back(c.length());
@@ -230,15 +246,19 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( BiarcList const & c ) {
-    s0.reserve( s0.size() + c.biarcList.size() + 1 );
+    aabb_done = false;
+    aabb_cache_clear();
+    s0.reserve( s0.size() + 2*c.biarcList.size() + 1 );
     clotoidList.reserve( clotoidList.size() + 2*c.biarcList.size() );
 
     if ( s0.empty() ) s0.push_back(0);
 
     vector<Biarc>::const_iterator ip = c.biarcList.begin();
     for (; ip != c.biarcList.end(); ++ip ) {
-      s0.push_back(s0.back()+ip->length());
       Biarc const & b = *ip;
+      // one abscissa for each of the two arcs
+      s0.push_back(s0.back()+b.getC0().length());
+      s0.push_back(s0.back()+b.getC1().length());
       clotoidList.push_back(ClothoidCurve(b.getC0()));
       clotoidList.push_back(ClothoidCurve(b.getC1()));
     }
@@ -248,6 +268,8 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( PolyLine const & c ) {
+    aabb_done = false;
+    aabb_cache_clear();
     s0.reserve( s0.size() + c.polylineList.size() + 1 );
     clotoidList.reserve( clotoidList.size() + c.polylineList.size() );
 
@@ -571,27 +593,7 @@ namespace G2lib {
     real_type & xmax,
     real_type & ymax
   ) const {
-    vector<Triangle2D> tvec;
-    bbTriangles_ISO( offs, tvec, m_pi/18, 1e100 );
-    xmin = ymin = numeric_limits<real_type>::infinity();
-    xmax = ymax = -xmin;
-    vector<Triangle2D>::const_iterator it;
-    for ( it = tvec.begin(); it != tvec.end(); ++it ) {
-      // - - - - - - - - - - - - - - - - - - - -
-      if      ( it->x1() < xmin ) xmin = it->x1();
-      else if ( it->x1() > xmax ) xmax = it->x1();
-      if      ( it->x2() < xmin ) xmin = it->x2();
-      else if ( it->x2() > xmax ) xmax = it->x2();
-      if      ( it->x3() < xmin ) xmin = it->x3();
-      else if ( it->x3() > xmax ) xmax = it->x3();
-      // - - - - - - - - - - - - - - - - - - - -
-      if      ( it->y1() < ymin ) ymin = it->y1();
-      else if ( it->y1() > ymax ) ymax = it->y1();
-      if      ( it->y2() < ymin ) ymin = it->y2();
-      else if ( it->y2() > ymax ) ymax = it->y2();
-      if      ( it->y3() < ymin ) ymin = it->y3();
-      else if ( it->y3() > ymax ) ymax = it->y3();
-    }
+    CurveStatic<ClothoidCurve>::bbox_ISO( clotoidList, offs, xmin, ymin, xmax, ymax );
   }
 
   /*\
@@ -1055,6 +1057,38 @@ namespace G2lib {
     return c.eval_ISO_DDD( s - s0[last_idx], offs, x_DDD, y_DDD );
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::eval_ISO(
+    int_type        n,
+    real_type const s[],
+    real_type       offs,
+    real_type       x[],
+    real_type       y[]
+  ) const {
+    G2LIB_ASSERT( !clotoidList.empty(), "ClothoidList::eval_ISO, empty list" );
+    CurveStatic<ClothoidCurve>::sample_ISO( clotoidList, s0, offs, n, s, x, y );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::evaluate_ISO(
+    int_type        n,
+    real_type const s[],
+    real_type       offs,
+    real_type       theta[],
+    real_type       kappa[],
+    real_type       x[],
+    real_type       y[]
+  ) const {
+    G2LIB_ASSERT( !clotoidList.empty(), "ClothoidList::evaluate_ISO, empty list" );
+    CurveStatic<ClothoidCurve>::sample_ISO(
+      clotoidList, s0, offs, n, s, theta, kappa, x, y
+    );
+  }
+
   /*\
    |  _                        __
    | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -1065,6 +1099,8 @@ namespace G2lib {
 
   void
   ClothoidList::translate( real_type tx, real_type ty ) {
+    aabb_done = false;
+    aabb_cache_clear();
     vector<ClothoidCurve>::iterator ic = clotoidList.begin();
     for (; ic != clotoidList.end(); ++ic ) ic->translate( tx, ty );
   }
@@ -1073,6 +1109,8 @@ namespace G2lib {
 
   void
   ClothoidList::rotate( real_type angle, real_type cx, real_type cy ) {
+    aabb_done = false;
+    aabb_cache_clear();
     vector<ClothoidCurve>::iterator ic = clotoidList.begin();
     for (; ic != clotoidList.end(); ++ic ) ic->rotate( angle, cx, cy );
   }
@@ -1081,6 +1119,8 @@ namespace G2lib {
 
   void
   ClothoidList::scale( real_type sfactor ) {
+    aabb_done = false;
+    aabb_cache_clear();
     vector<ClothoidCurve>::iterator ic = clotoidList.begin();
     real_type newx0 = ic->xBegin();
     real_type newy0 = ic->yBegin();
@@ -1098,6 +1138,8 @@ namespace G2lib {
 
   void
   ClothoidList::reverse() {
+    aabb_done = false;
+    aabb_cache_clear();
     std::reverse( clotoidList.begin(), clotoidList.end() );
     vector<ClothoidCurve>::iterator ic = clotoidList.begin();
     ic->reverse();
@@ -1119,6 +1161,8 @@ namespace G2lib {
 
   void
   ClothoidList::changeOrigin( real_type newx0, real_type newy0 ) {
+    aabb_done = false;
+    aabb_cache_clear();
     vector<ClothoidCurve>::iterator ic = clotoidList.begin();
     for (; ic != clotoidList.end(); ++ic ) {
       ic->changeOrigin( newx0, newy0 );
@@ -1131,6 +1175,8 @@ namespace G2lib {
 
   void
   ClothoidList::trim( real_type s_begin, real_type s_end ) {
+    aabb_done = false;
+    aabb_cache_clear();
     G2LIB_ASSERT(
       s_begin >= s0.front() && s_end <= s0.back() && s_end > s_begin,
       "ClothoidList::trim( s_begin=" << s_begin << ", s_end=" << s_end <<
@@ -1177,12 +1223,54 @@ namespace G2lib {
          isZero( max_angle-aabb_max_angle ) &&
          isZero( max_size-aabb_max_size ) ) return;
 
+    // search the tree in the cache, the slot used is moved in front
+    size_t nc = aabb_cache.size(), k = 0;
+    while ( k < nc ) {
+      AABBslot const & S = *aabb_cache[k];
+      if ( isZero( offs-S.offs ) &&
+           isZero( max_angle-S.max_angle ) &&
+           isZero( max_size-S.max_size ) ) break;
+      ++k;
+    }
+
+    bool use_slot = true;
+    if ( k < nc ) {
+      std::rotate( aabb_cache.begin(), aabb_cache.begin()+k, aabb_cache.begin()+k+1 );
+    } else if ( aabb_done && aabb_cache_capacity > 0 ) {
+      // store the active tree, evict the least recently used
+      if ( nc < size_t(aabb_cache_capacity) )
+        aabb_cache.push_back( PtrAABBslot( new AABBslot() ) );
+      std::rotate( aabb_cache.begin(), aabb_cache.end()-1, aabb_cache.end() );
+      aabb_cache.front()->tree.clear();
+      aabb_cache.front()->tri.clear();
+    } else {
+      use_slot = false;
+    }
+
+    if ( use_slot ) {
+      AABBslot & S = *aabb_cache.front();
+      bool found = !S.tree.empty();
+      // exchange active tree with the slot (no copy)
+      aabb_tree.swap( S.tree );
+      aabb_tri.swap( S.tri );
+      std::swap( aabb_offs,      S.offs );
+      std::swap( aabb_max_angle, S.max_angle );
+      std::swap( aabb_max_size,  S.max_size );
+      if ( !aabb_done ) { // nothing to store, drop the slot
+        std::rotate( aabb_cache.begin(), aabb_cache.begin()+1, aabb_cache.end() );
+        aabb_cache_resize( aabb_cache.size()-1 );
+      }
+      aabb_done = found;
+      if ( found ) return;
+    }
+
     #ifdef G2LIB_USE_CXX11
     vector<shared_ptr<BBox const> > bboxes;
     #else
     vector<BBox const *> bboxes;
     #endif
 
+    aabb_tri.clear();
     bbTriangles_ISO( offs, aabb_tri, max_angle, max_size );
     bboxes.reserve(aabb_tri.size());
     vector<Triangle2D>::const_iterator it;
@@ -1201,12 +1289,37 @@ namespace G2lib {
       #endif
     }
     aabb_tree.build(bboxes);
+    G2LIB_PERF_COUNT(aabb_rebuilds);
     aabb_done      = true;
     aabb_offs      = offs;
     aabb_max_angle = max_angle;
     aabb_max_size  = max_size;
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::aabb_cache_resize( size_t n ) const {
+    if ( aabb_cache.size() <= n ) return;
+    #ifndef G2LIB_USE_CXX11
+    vector<PtrAABBslot>::iterator is;
+    for ( is = aabb_cache.begin()+n; is != aabb_cache.end(); ++is ) delete *is;
+    #endif
+    aabb_cache.resize( n );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::setAABBcacheCapacity( int_type n ) {
+    G2LIB_ASSERT(
+      n >= 0,
+      "ClothoidList::setAABBcacheCapacity( n = " << n << " ) n must be >= 0"
+    );
+    aabb_cache_capacity = n;
+    aabb_cache_resize( size_t(n) );
+  }
+
   /*\
    |   _       _                          _
    |  (_)_ __ | |_ ___ _ __ ___  ___  ___| |_
@@ -1255,11 +1368,31 @@ namespace G2lib {
     real_type            offs_CL,
     IntersectList      & ilist,
     bool                 swap_s_vals
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    intersect_ISO( offs, CL, offs_CL, ilist, swap_s_vals, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::intersect_ISO(
+    real_type            offs,
+    ClothoidList const & CL,
+    real_type            offs_CL,
+    IntersectList      & ilist,
+    bool                 swap_s_vals,
+    AABBworkspace      & ws
   ) const {
     if ( intersect_with_AABBtree ) {
       this->build_AABBtree_ISO( offs );
       CL.build_AABBtree_ISO( offs_CL );
-      AABBtree::VecPairPtrBBox iList;
+      AABBtree::VecPairPtrBBox & iList = ws.intersectionList;
+      iList.clear();
       aabb_tree.intersect( CL.aabb_tree, iList );
 
       AABBtree::VecPairPtrBBox::const_iterator ip;
@@ -1283,8 +1416,13 @@ namespace G2lib {
           ilist.push_back( Ipair( ss1, ss2 ) );
         }
       }
+      iList.clear(); // release the bbox
     } else {
+      // triangles overwritten, the active AABB tree is no more valid
+      aabb_done = CL.aabb_done = false;
+      aabb_tri.clear();
       bbTriangles_ISO( offs, aabb_tri, m_pi/18, 1e100 );
+      CL.aabb_tri.clear();
       CL.bbTriangles_ISO( offs_CL, CL.aabb_tri, m_pi/18, 1e100 );
       for ( vector<Triangle2D>::const_iterator i1 = aabb_tri.begin();
             i1 != aabb_tri.end(); ++i1 ) {
@@ -1311,6 +1449,140 @@ namespace G2lib {
     }
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidList::intersect_first_ISO(
+    real_type            offs,
+    ClothoidList const & CL,
+    real_type            offs_CL,
+    real_type          & s1,
+    real_type          & s2
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    return intersect_first_ISO( offs, CL, offs_CL, s1, s2, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidList::intersect_first_ISO(
+    real_type            offs,
+    ClothoidList const & CL,
+    real_type            offs_CL,
+    real_type          & s1,
+    real_type          & s2,
+    AABBworkspace      & ws
+  ) const {
+    this->build_AABBtree_ISO( offs );
+    CL.build_AABBtree_ISO( offs_CL );
+    AABBtree::VecPairPtrBBox & iList = ws.intersectionList;
+    iList.clear();
+    aabb_tree.intersect( CL.aabb_tree, iList );
+
+    // refine the candidates by increasing s1
+    std::sort( iList.begin(), iList.end(), Pair_first_less() );
+
+    bool found = false;
+    AABBtree::VecPairPtrBBox::const_iterator ip;
+    for ( ip = iList.begin(); ip != iList.end(); ++ip ) {
+      Triangle2D const & T1 = aabb_tri[size_t(ip->first->Ipos())];
+      Triangle2D const & T2 = CL.aabb_tri[size_t(ip->second->Ipos())];
+
+      // all the remaining candidates start after the intersection found
+      if ( found && T1.S0() + s0[T1.Icurve()] > s1 ) break;
+
+      ClothoidCurve const & C1 = clotoidList[T1.Icurve()];
+      ClothoidCurve const & C2 = CL.clotoidList[T2.Icurve()];
+
+      real_type ss1, ss2;
+      if ( C1.aabb_intersect_first_ISO( T1, offs, &C2, T2, offs_CL, ss1, ss2 ) ) {
+        ss1 += s0[T1.Icurve()];
+        if ( !found || ss1 < s1 ) {
+          s1    = ss1;
+          s2    = ss2 + CL.s0[T2.Icurve()];
+          found = true;
+        }
+      }
+    }
+    iList.clear(); // release the bbox
+    return found;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::intersect_self_ISO(
+    real_type       offs,
+    IntersectList & ilist
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    intersect_self_ISO( offs, ilist, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::intersect_self_ISO(
+    real_type       offs,
+    IntersectList & ilist,
+    AABBworkspace & ws
+  ) const {
+    this->build_AABBtree_ISO( offs );
+    AABBtree::VecPairPtrBBox & iList = ws.intersectionList;
+    iList.clear();
+    aabb_tree.intersect_self( iList );
+
+    // intersections closer than `eps` are the common point of two
+    // consecutive triangles (or of the begin and the end of a closed list)
+    real_type L   = length();
+    real_type eps = sqrt(machepsi)*L;
+    real_type xb, yb, xe, ye;
+    eval_ISO( 0, offs, xb, yb );
+    eval_ISO( L, offs, xe, ye );
+    bool closed = hypot( xe-xb, ye-yb ) <= eps;
+
+    AABBtree::VecPairPtrBBox::const_iterator ip;
+    for ( ip = iList.begin(); ip != iList.end(); ++ip ) {
+      int_type ipos1 = ip->first->Ipos();
+      int_type ipos2 = ip->second->Ipos();
+
+      Triangle2D const & T1 = aabb_tri[size_t(ipos1)];
+      Triangle2D const & T2 = aabb_tri[size_t(ipos2)];
+
+      ClothoidCurve const & C1 = clotoidList[T1.Icurve()];
+      ClothoidCurve const & C2 = clotoidList[T2.Icurve()];
+
+      // consecutive triangles (ordered by s) share only the common vertex
+      // unless the offset curve has a cusp (1-kappa*offs = 0) inside them
+      if ( ipos1 == ipos2+1 || ipos2 == ipos1+1 ) {
+        real_type a1 = 1-C1.kappa(T1.S0())*offs;
+        real_type b1 = 1-C1.kappa(T1.S1())*offs;
+        real_type a2 = 1-C2.kappa(T2.S0())*offs;
+        real_type b2 = 1-C2.kappa(T2.S1())*offs;
+        if ( a1*b1 > 0 && a2*b2 > 0 ) continue;
+      }
+
+      real_type ss1, ss2;
+      if ( !C1.aabb_intersect_ISO( T1, offs, &C2, T2, offs, ss1, ss2 ) ) continue;
+
+      ss1 += s0[T1.Icurve()];
+      ss2 += s0[T2.Icurve()];
+      if ( ss1 > ss2 ) swap( ss1, ss2 );
+      if ( ss2-ss1 <= eps || ( closed && ss1 <= eps && ss2 >= L-eps ) ) continue;
+      ilist.push_back( Ipair( ss1, ss2 ) );
+    }
+    iList.clear(); // release the bbox
+  }
+
   /*\
    |      _ _     _
    |   __| (_)___| |_ __ _ _ __   ___ ___
@@ -1330,10 +1602,33 @@ namespace G2lib {
     real_type & t,
     real_type & DST
   ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    return closestPoint_ISO( qx, qy, offs, x, y, s, t, DST, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidList::closestPoint_ISO(
+    real_type       qx,
+    real_type       qy,
+    real_type       offs,
+    real_type     & x,
+    real_type     & y,
+    real_type     & s,
+    real_type     & t,
+    real_type     & DST,
+    AABBworkspace & ws
+  ) const {
 
     this->build_AABBtree_ISO( offs );
 
-    AABBtree::VecPtrBBox candidateList;
+    AABBtree::VecPtrBBox & candidateList = ws.candidateList;
+    candidateList.clear();
     aabb_tree.min_distance( qx, qy, candidateList );
     AABBtree::VecPtrBBox::const_iterator ic;
     G2LIB_ASSERT(
@@ -1362,6 +1657,8 @@ namespace G2lib {
       }
     }
 
+    candidateList.clear(); // release the bbox
+
     real_type nx, ny;
     clotoidList[icurve].nor_ISO( s - s0[icurve], nx, ny );
     t = (qx-x) * nx + (qy-y) * ny - offs;
@@ -1385,6 +1682,131 @@ namespace G2lib {
     return closestPoint_ISO( qx, qy, 0, x, y, s, t, dst );
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::segmentsInRadius_ISO(
+    real_type           qx,
+    real_type           qy,
+    real_type           offs,
+    real_type           r,
+    vector<int_type>  & segments,
+    vector<real_type> & dsts
+  ) const {
+    segments.clear();
+    dsts.clear();
+    this->build_AABBtree_ISO( offs );
+    T2D_nearest_list_ISO fun(
+      this, qx, qy, offs, r, numeric_limits<size_t>::max(), segments, dsts
+    );
+    aabb_tree.nearest( qx, qy, fun );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::closestSegments_ISO(
+    real_type           qx,
+    real_type           qy,
+    real_type           offs,
+    int_type            k,
+    vector<int_type>  & segments,
+    vector<real_type> & dsts
+  ) const {
+    segments.clear();
+    dsts.clear();
+    if ( k <= 0 ) return;
+    this->build_AABBtree_ISO( offs );
+    T2D_nearest_list_ISO fun(
+      this, qx, qy, offs, numeric_limits<real_type>::infinity(),
+      size_t(k), segments, dsts
+    );
+    aabb_tree.nearest( qx, qy, fun );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidList::rayCast_ISO(
+    real_type   qx,
+    real_type   qy,
+    real_type   dx,
+    real_type   dy,
+    real_type   max_range,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & dst
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    return rayCast_ISO( qx, qy, dx, dy, max_range, offs, x, y, s, dst, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidList::rayCast_ISO(
+    real_type       qx,
+    real_type       qy,
+    real_type       dx,
+    real_type       dy,
+    real_type       max_range,
+    real_type       offs,
+    real_type     & x,
+    real_type     & y,
+    real_type     & s,
+    real_type     & dst,
+    AABBworkspace & ws
+  ) const {
+    real_type len = hypot( dx, dy );
+    G2LIB_ASSERT(
+      len > 0, "ClothoidList::rayCast_ISO, null direction of the ray"
+    );
+    real_type ux = dx/len;
+    real_type uy = dy/len;
+    this->build_AABBtree_ISO( offs );
+    T2D_raycast_list_ISO fun( this, qx, qy, ux, uy, offs, s, dst );
+    if ( !aabb_tree.raycast( qx, qy, ux, uy, max_range, fun, ws.queue ) )
+      return false;
+    x = qx + dst*ux;
+    y = qy + dst*uy;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidList::rayCast_ISO(
+    int_type        n,
+    real_type const qx[],
+    real_type const qy[],
+    real_type const dx[],
+    real_type const dy[],
+    real_type       max_range,
+    real_type       offs,
+    real_type       s[],
+    real_type       dst[]
+  ) const {
+    AABBworkspace ws; // the queue of the search is reused by all the rays
+    int_type      nhit = 0;
+    for ( int_type i = 0; i < n; ++i ) {
+      real_type x, y;
+      if ( rayCast_ISO( qx[i], qy[i], dx[i], dy[i], max_range, offs,
+                        x, y, s[i], dst[i], ws ) ) {
+        ++nhit;
+      } else {
+        s[i]   = 0;
+        dst[i] = -1;
+      }
+    }
+    return nhit;
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -30,11 +30,16 @@
 #include "Biarc.hh"
 #include "BiarcList.hh"
 
+#include <algorithm> // rotate
+#include <set>
+
 //! Clothoid computations routine
 namespace G2lib {
 
   using std::vector;
 
+  class Footprint;
+
   /*\
    |    ____ ____            _           ____
    |   / ___|___ \ ___  ___ | |_   _____|___ \ __ _ _ __ ___
@@ -275,6 +280,41 @@ namespace G2lib {
     // precomputed values
     real_type K0, K1, c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11, c12, c13, c14;
 
+    void
+    setup(
+      real_type   x0,
+      real_type   y0,
+      real_type   theta0,
+      real_type   kappa0,
+      real_type   x1,
+      real_type   y1,
+      real_type   theta1,
+      real_type   kappa1,
+      real_type   Dmax,
+      real_type   dmax,
+      real_type & sM_guess,
+      real_type & thM_guess
+    );
+
+    //! arguments `(a,b,c)` of the 4 generalized Fresnel integrals of `evalFJ`
+    void
+    evalFJ_args(
+      real_type const vars[2],
+      real_type       a[4],
+      real_type       b[4],
+      real_type       c[4]
+    ) const;
+
+    //! `F` and `J` from the 4 generalized Fresnel integrals (3 momenta each)
+    void
+    evalFJ_assemble(
+      real_type const vars[2],
+      real_type const X[12],
+      real_type const Y[12],
+      real_type       F[2],
+      real_type       J[2][2]
+    ) const;
+
     void
     evalFJ(
       real_type const vars[2],
@@ -291,6 +331,8 @@ namespace G2lib {
     int
     solve( real_type sM_guess, real_type thM_guess );
 
+    friend class G2solve3arcBatch;
+
   public:
 
     G2solve3arc()
@@ -568,6 +610,69 @@ namespace G2lib {
 
   };
 
+  /*\
+   |    ____ ____            _           _____                 ____        _       _
+   |   / ___|___ \ ___  ___ | |_   _____|___ /  __ _ _ __ ___| __ )  __ _| |_ ___| |__
+   |  | |  _  __) / __|/ _ \| \ \ / / _ \ |_ \ / _` | '__/ __|  _ \ / _` | __/ __| '_ \
+   |  | |_| |/ __/\__ \ (_) | |\ V /  __/___) | (_| | | | (__| |_) | (_| | || (__| | | |
+   |   \____|_____|___/\___/|_| \_/ \___|____/ \__,_|_|  \___|____/ \__,_|\__\___|_| |_|
+  \*/
+  //! G2 fitting with 3 clothoid arcs of many problems in lockstep
+  /*!
+   * The Newton iterations of `G2solve3arc` are advanced together for
+   * `lanes` problems: at each step the generalized Fresnel integrals
+   * of all the lanes are computed with one batched call (vectorized
+   * on the lanes, see `GeneralizedFresnelCS(n,nk,a,b,c,intC,intS)`),
+   * then the systems of the lanes are solved. A lane whose problem is
+   * solved (or failed) is masked off and refilled with the next problem.
+   * The solutions agree with `G2solve3arc::build` within the tolerance,
+   * the number of iterations may differ by one.
+   */
+  class G2solve3arcBatch {
+  public:
+
+    static int_type const lanes = 8; //!< problems solved together
+
+  private:
+
+    G2solve3arc lane[lanes]; //!< data and solution of the problem of each lane
+
+  public:
+
+    G2solve3arcBatch() {}
+    ~G2solve3arcBatch() {}
+
+    void setTolerance( real_type tol );
+    void setMaxIter( int miter );
+
+    /*!
+     * Solve the `n` problems
+     * `(x0[i],y0[i],theta0[i],kappa0[i])-(x1[i],y1[i],theta1[i],kappa1[i])`.
+     *
+     * \param[out] iter number of iterations of each problem, -1 if it fails
+     * \param[out] S0   first clothoid of each solution
+     * \param[out] SM   middle clothoid of each solution
+     * \param[out] S1   last clothoid of each solution
+     * \return the number of problems solved
+     */
+    int_type
+    build(
+      int_type        n,
+      real_type const x0[],
+      real_type const y0[],
+      real_type const theta0[],
+      real_type const kappa0[],
+      real_type const x1[],
+      real_type const y1[],
+      real_type const theta1[],
+      real_type const kappa1[],
+      int_type        iter[],
+      ClothoidCurve   S0[],
+      ClothoidCurve   SM[],
+      ClothoidCurve   S1[]
+    );
+  };
+
   /*\
    |   ____ _       _   _           _     _ _     _     _
    |  / ___| | ___ | |_| |__   ___ (_) __| | |   (_)___| |_
@@ -590,6 +695,28 @@ namespace G2lib {
     mutable real_type          aabb_max_size;
     mutable vector<Triangle2D> aabb_tri;
 
+    // AABB trees built for other offsets, most recently used first
+    class AABBslot {
+    public:
+      real_type          offs;
+      real_type          max_angle;
+      real_type          max_size;
+      AABBtree           tree;
+      vector<Triangle2D> tri;
+    };
+
+    #ifdef G2LIB_USE_CXX11
+    typedef std::unique_ptr<AABBslot> PtrAABBslot;
+    #else
+    typedef AABBslot *                PtrAABBslot;
+    #endif
+
+    mutable vector<PtrAABBslot> aabb_cache;
+    int_type                    aabb_cache_capacity;
+
+    void aabb_cache_resize( size_t n ) const;
+    void aabb_cache_clear() const { aabb_cache_resize(0); }
+
     class T2D_collision_list_ISO {
       ClothoidList const * pList1;
       real_type    const   offs1;
@@ -619,6 +746,155 @@ namespace G2lib {
       }
     };
 
+    // refine the pairs of triangles and pass the intersections to `fun`
+    template <typename INTERSECT_fun>
+    class T2D_intersect_visit_ISO {
+      ClothoidList const * pList1;
+      real_type    const   offs1;
+      ClothoidList const * pList2;
+      real_type    const   offs2;
+      INTERSECT_fun      & fun;
+    public:
+      T2D_intersect_visit_ISO(
+        ClothoidList const * _pList1,
+        real_type    const   _offs1,
+        ClothoidList const * _pList2,
+        real_type    const   _offs2,
+        INTERSECT_fun      & _fun
+      )
+      : pList1(_pList1)
+      , offs1(_offs1)
+      , pList2(_pList2)
+      , offs2(_offs2)
+      , fun(_fun)
+      {}
+
+      bool
+      operator () ( BBox::PtrBBox const & ptr1, BBox::PtrBBox const & ptr2 ) {
+        Triangle2D    const & T1 = pList1->aabb_tri[size_t(ptr1->Ipos())];
+        Triangle2D    const & T2 = pList2->aabb_tri[size_t(ptr2->Ipos())];
+        ClothoidCurve const & C1 = pList1->get(T1.Icurve());
+        ClothoidCurve const & C2 = pList2->get(T2.Icurve());
+        real_type ss1, ss2;
+        if ( !C1.aabb_intersect_ISO( T1, offs1, &C2, T2, offs2, ss1, ss2 ) )
+          return true;
+        return fun( ss1 + pList1->s0[size_t(T1.Icurve())],
+                    ss2 + pList2->s0[size_t(T2.Icurve())] );
+      }
+    };
+
+    // order the pairs of bbox by the position of the first triangle,
+    // the triangles are generated by increasing curvilinear abscissa
+    class Pair_first_less {
+    public:
+      bool
+      operator () (
+        AABBtree::PairPtrBBox const & a,
+        AABBtree::PairPtrBBox const & b
+      ) const {
+        return a.first->Ipos() < b.first->Ipos();
+      }
+    };
+
+
+    // collect the segments by increasing distance from the point (qx,qy)
+    class T2D_nearest_list_ISO {
+      ClothoidList const * pList;
+      real_type const   qx;
+      real_type const   qy;
+      real_type const   offs;
+      real_type const   r;
+      size_t    const   kmax;
+      vector<int_type>  & segments;
+      vector<real_type> & dsts;
+      std::set<int_type>  visited; // segments already collected
+    public:
+      T2D_nearest_list_ISO(
+        ClothoidList const * _pList,
+        real_type const   _qx,
+        real_type const   _qy,
+        real_type const   _offs,
+        real_type const   _r,
+        size_t    const   _kmax,
+        vector<int_type>  & _segments,
+        vector<real_type> & _dsts
+      )
+      : pList(_pList)
+      , qx(_qx)
+      , qy(_qy)
+      , offs(_offs)
+      , r(_r)
+      , kmax(_kmax)
+      , segments(_segments)
+      , dsts(_dsts)
+      {}
+
+      real_type
+      distance( BBox::PtrBBox ptr ) const {
+        Triangle2D const & T = pList->aabb_tri[size_t(ptr->Ipos())];
+        real_type x, y, s, dst;
+        pList->clotoidList[size_t(T.Icurve())].closestPoint_internal_ISO(
+          T.S0(), T.S1(), qx, qy, offs, x, y, s, dst
+        );
+        return dst;
+      }
+
+      bool
+      visit( BBox::PtrBBox ptr, real_type dst ) {
+        if ( dst > r ) return false;
+        int_type icurve = pList->aabb_tri[size_t(ptr->Ipos())].Icurve();
+        // a segment is covered by many triangles, keep the nearest
+        if ( visited.insert( icurve ).second ) {
+          segments.push_back( icurve );
+          dsts.push_back( dst );
+        }
+        return segments.size() < kmax;
+      }
+    };
+
+    // first hit of the ray (qx,qy)+t*(ux,uy) with the segments
+    class T2D_raycast_list_ISO {
+      ClothoidList const * pList;
+      real_type    const   qx;
+      real_type    const   qy;
+      real_type    const   ux;
+      real_type    const   uy;
+      real_type    const   offs;
+      real_type          & s;
+      real_type          & dst;
+    public:
+      T2D_raycast_list_ISO(
+        ClothoidList const * _pList,
+        real_type    const   _qx,
+        real_type    const   _qy,
+        real_type    const   _ux,
+        real_type    const   _uy,
+        real_type    const   _offs,
+        real_type          & _s,
+        real_type          & _dst
+      )
+      : pList(_pList)
+      , qx(_qx)
+      , qy(_qy)
+      , ux(_ux)
+      , uy(_uy)
+      , offs(_offs)
+      , s(_s)
+      , dst(_dst)
+      {}
+
+      bool
+      hit( BBox::PtrBBox ptr, real_type tmax, real_type & t ) const {
+        Triangle2D    const & T = pList->aabb_tri[size_t(ptr->Ipos())];
+        ClothoidCurve const & C = pList->clotoidList[size_t(T.Icurve())];
+        real_type ss;
+        if ( !C.aabb_raycast_ISO( T, offs, qx, qy, ux, uy, tmax, ss, t ) )
+          return false;
+        s   = pList->s0[size_t(T.Icurve())] + ss;
+        dst = t;
+        return true;
+      }
+    };
   public:
 
     #include "BaseCurve_using.hxx"
@@ -628,6 +904,7 @@ namespace G2lib {
     : BaseCurve(G2LIB_CLOTHOID_LIST)
     , last_idx(0)
     , aabb_done(false)
+    , aabb_cache_capacity(4)
     {}
 
     virtual
@@ -635,6 +912,7 @@ namespace G2lib {
       s0.clear();
       clotoidList.clear();
       aabb_tri.clear();
+      aabb_cache_clear();
     }
 
     //explicit
@@ -642,6 +920,7 @@ namespace G2lib {
     : BaseCurve(G2LIB_CLOTHOID_LIST)
     , last_idx(0)
     , aabb_done(false)
+    , aabb_cache_capacity(4)
     { copy(s); }
 
     void init();
@@ -791,6 +1070,13 @@ namespace G2lib {
       bbTriangles_ISO( 0, tvec, max_angle, max_size );
     }
 
+    /*!
+     * Build the AABB tree of the curve with offset `offs`.
+     * The trees built for up to `AABBcacheCapacity()` other
+     * offsets are kept, so that queries alternating between
+     * different offsets (e.g. the two borders of a lane)
+     * do not rebuild the tree at each call.
+     */
     void
     build_AABBtree_ISO(
       real_type offs,
@@ -798,6 +1084,15 @@ namespace G2lib {
       real_type max_size  = 1e100
     ) const;
 
+    //! number of AABB trees stored in the cache besides the active one
+    int_type
+    AABBcacheCapacity() const
+    { return aabb_cache_capacity; }
+
+    //! set the number of AABB trees stored besides the active one (0 = no cache)
+    void
+    setAABBcacheCapacity( int_type n );
+
     /*\
      |   _     _
      |  | |__ | |__   _____  __
@@ -1193,6 +1488,33 @@ namespace G2lib {
       real_type & y_DDD
     ) const G2LIB_OVERRIDE;
 
+    /*!
+     * Evaluate at `s[i]`, `i=0..n-1`, with offset `offs` (batched).
+     * The segments are searched from the previous one (increasing
+     * abscissa are the fastest), the list is not modified so that
+     * the method can be called concurrently on the same object.
+     */
+    void
+    eval_ISO(
+      int_type        n,
+      real_type const s[],
+      real_type       offs,
+      real_type       x[],
+      real_type       y[]
+    ) const;
+
+    //! as the batched `eval_ISO` computing also angle and curvature
+    void
+    evaluate_ISO(
+      int_type        n,
+      real_type const s[],
+      real_type       offs,
+      real_type       theta[],
+      real_type       kappa[],
+      real_type       x[],
+      real_type       y[]
+    ) const;
+
     /*\
      |  _                        __
      | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -1283,6 +1605,233 @@ namespace G2lib {
       real_type & dst
     ) const G2LIB_OVERRIDE;
 
+    //! as `closestPoint_ISO` using the scratch space `ws` (no allocation)
+    int_type
+    closestPoint_ISO(
+      real_type       qx,
+      real_type       qy,
+      real_type       offs,
+      real_type     & x,
+      real_type     & y,
+      real_type     & s,
+      real_type     & t,
+      real_type     & dst,
+      AABBworkspace & ws
+    ) const;
+
+    int_type
+    closestPoint_SAE(
+      real_type       qx,
+      real_type       qy,
+      real_type       offs,
+      real_type     & x,
+      real_type     & y,
+      real_type     & s,
+      real_type     & t,
+      real_type     & dst,
+      AABBworkspace & ws
+    ) const {
+      int_type res = closestPoint_ISO( qx, qy, -offs, x, y, s, t, dst, ws );
+      t = -t;
+      return res;
+    }
+
+    /*!
+     *  Segments of the curve with offset `offs` with distance from the
+     *  point `(qx,qy)` not greater than `r`, ordered by increasing distance.
+     *
+     *  \param  qx       x-coordinate of the point
+     *  \param  qy       y-coordinate of the point
+     *  \param  offs     offset of the curve
+     *  \param  r        search radius
+     *  \param  segments index of the segments found
+     *  \param  dsts     distance of the point from the segments found
+     */
+    void
+    segmentsInRadius_ISO(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      real_type           r,
+      vector<int_type>  & segments,
+      vector<real_type> & dsts
+    ) const;
+
+    /*!
+     *  The `k` segments of the curve with offset `offs` nearest to the
+     *  point `(qx,qy)`, ordered by increasing distance.
+     *
+     *  \param  qx       x-coordinate of the point
+     *  \param  qy       y-coordinate of the point
+     *  \param  offs     offset of the curve
+     *  \param  k        number of segments to be found
+     *  \param  segments index of the segments found
+     *  \param  dsts     distance of the point from the segments found
+     */
+    void
+    closestSegments_ISO(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      int_type            k,
+      vector<int_type>  & segments,
+      vector<real_type> & dsts
+    ) const;
+
+    void
+    segmentsInRadius_SAE(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      real_type           r,
+      vector<int_type>  & segments,
+      vector<real_type> & dsts
+    ) const {
+      segmentsInRadius_ISO( qx, qy, -offs, r, segments, dsts );
+    }
+
+    void
+    closestSegments_SAE(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      int_type            k,
+      vector<int_type>  & segments,
+      vector<real_type> & dsts
+    ) const {
+      closestSegments_ISO( qx, qy, -offs, k, segments, dsts );
+    }
+
+    /*!
+     * \brief first intersection of a ray with the list
+     *
+     * The ray is `(qx,qy)+t*(dx,dy)/|(dx,dy)|` with `0 <= t <= max_range`,
+     * a segment casting is a ray with `max_range` equal to the length
+     * of the segment.
+     *
+     * \param[in]  qx        x-coordinate of the origin of the ray
+     * \param[in]  qy        y-coordinate of the origin of the ray
+     * \param[in]  dx        x-component of the direction of the ray
+     * \param[in]  dy        y-component of the direction of the ray
+     * \param[in]  max_range maximum distance along the ray
+     * \param[in]  offs      offset of the curve
+     * \param[out] x         x-coordinate of the hit point
+     * \param[out] y         y-coordinate of the hit point
+     * \param[out] s         curvilinear coordinate of the hit point
+     * \param[out] dst       distance of the hit point from the origin
+     * \return true if the ray hit the list
+     */
+    bool
+    rayCast_ISO(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const;
+
+    bool
+    rayCast_SAE(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const {
+      return rayCast_ISO( qx, qy, dx, dy, max_range, -offs, x, y, s, dst );
+    }
+
+    //! as `rayCast_ISO` using the scratch space `ws` (no allocation)
+    bool
+    rayCast_ISO(
+      real_type       qx,
+      real_type       qy,
+      real_type       dx,
+      real_type       dy,
+      real_type       max_range,
+      real_type       offs,
+      real_type     & x,
+      real_type     & y,
+      real_type     & s,
+      real_type     & dst,
+      AABBworkspace & ws
+    ) const;
+
+    /*!
+     * \brief cast `n` rays `(qx[i],qy[i])+t*(dx[i],dy[i])`
+     *
+     * \param[out] s   curvilinear coordinate of the hits
+     * \param[out] dst distance of the hits, `-1` if the ray miss the list
+     * \return the number of rays that hit the list
+     */
+    int_type
+    rayCast_ISO(
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type const dx[],
+      real_type const dy[],
+      real_type       max_range,
+      real_type       offs,
+      real_type       s[],
+      real_type       dst[]
+    ) const;
+
+    int_type
+    rayCast_SAE(
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type const dx[],
+      real_type const dy[],
+      real_type       max_range,
+      real_type       offs,
+      real_type       s[],
+      real_type       dst[]
+    ) const {
+      return rayCast_ISO( n, qx, qy, dx, dy, max_range, -offs, s, dst );
+    }
+
+    /*!
+     *  Sweep the footprint `fp` along the curve and find the first
+     *  contact with the obstacles.
+     *  The search is conservative: the swept area is pruned with the
+     *  AABB trees of the obstacles and then bisected until the interval
+     *  is shorter than `tol`, so that a contact is never missed.
+     *  In the first interval not pruned the footprint is checked
+     *  exactly at the two ends and at the middle.
+     *
+     *  \param  fp        the footprint moving along the curve
+     *  \param  obstacles list of the obstacles
+     *  \param  tol       tolerance on the contact parameter
+     *  \param  s         parameter on the curve of the contact
+     *  \param  iobstacle index of the obstacle hit
+     *  \return 0 = no contact
+     *          1 = the footprint at `s` overlaps the obstacle, the first
+     *              contact is in `[s-tol,s]`
+     *          2 = possible contact in `[s,s+tol]`, the footprint comes
+     *              within the motion bound of the obstacle but does not
+     *              overlap it at the poses checked
+     */
+    int_type
+    footprintCollision(
+      Footprint                    const & fp,
+      vector<ClothoidList const *> const & obstacles,
+      real_type                            tol,
+      real_type                          & s,
+      int_type                           & iobstacle
+    ) const;
+
     virtual
     void
     info( ostream_type & stream ) const G2LIB_OVERRIDE
@@ -1393,6 +1942,97 @@ namespace G2lib {
       bool                 swap_s_vals
     ) const;
 
+    //! as `intersect_ISO` using the scratch space `ws` (no allocation)
+    void
+    intersect_ISO(
+      real_type            offs,
+      ClothoidList const & CL,
+      real_type            offs_obj,
+      IntersectList      & ilist,
+      bool                 swap_s_vals,
+      AABBworkspace      & ws
+    ) const;
+
+    /*!
+     * Intersect the list (with offset `offs`) with `CL` (with offset
+     * `offs_CL`) passing the intersections to the functor as soon as
+     * they are found (in no particular order, the AABB tree is always used).
+     * The functor `fun` must implement
+     *
+     * - `bool fun( real_type s1, real_type s2 )` called for each intersection,
+     *   `s1` on this list and `s2` on `CL`, return `false` to stop the search
+     *
+     * \return false if the search was stopped by `fun`
+     */
+    template <typename INTERSECT_fun>
+    bool
+    intersect_visit_ISO(
+      real_type            offs,
+      ClothoidList const & CL,
+      real_type            offs_CL,
+      INTERSECT_fun      & fun
+    ) const {
+      this->build_AABBtree_ISO( offs );
+      CL.build_AABBtree_ISO( offs_CL );
+      T2D_intersect_visit_ISO<INTERSECT_fun> visitor( this, offs, &CL, offs_CL, fun );
+      return aabb_tree.intersect_visit( CL.aabb_tree, visitor );
+    }
+
+    /*!
+     * First intersection along the list (minimum `s1`) of the list
+     * (with offset `offs`) with `CL` (with offset `offs_CL`).
+     * The candidate pairs of triangles are refined by increasing `s1`
+     * and the search stops when the remaining candidates start after
+     * the intersection found.
+     *
+     * \param[out] s1 curvilinear abscissa of the intersection on the list
+     * \param[out] s2 curvilinear abscissa of the intersection on `CL`
+     * \return true if an intersection is found
+     */
+    bool
+    intersect_first_ISO(
+      real_type            offs,
+      ClothoidList const & CL,
+      real_type            offs_CL,
+      real_type          & s1,
+      real_type          & s2
+    ) const;
+
+    //! as `intersect_first_ISO` using the scratch space `ws` (no allocation)
+    bool
+    intersect_first_ISO(
+      real_type            offs,
+      ClothoidList const & CL,
+      real_type            offs_CL,
+      real_type          & s1,
+      real_type          & s2,
+      AABBworkspace      & ws
+    ) const;
+
+    /*!
+     * Self intersections of the list (with offset `offs`).
+     * The AABB tree of the list is traversed against itself once,
+     * the common points of consecutive pieces (and the closure point
+     * of a closed list) are not reported.
+     *
+     * \param[out] ilist pairs `(s1,s2)` with `s1 < s2` of the
+     *                   self intersections (appended)
+     */
+    void
+    intersect_self_ISO( real_type offs, IntersectList & ilist ) const;
+
+    //! as `intersect_self_ISO` using the scratch space `ws` (no allocation)
+    void
+    intersect_self_ISO(
+      real_type       offs,
+      IntersectList & ilist,
+      AABBworkspace & ws
+    ) const;
+
+    void
+    intersect_self( IntersectList & ilist ) const
+    { intersect_self_ISO( 0, ilist ); }
+
     /*! \brief Save Clothoid list to a stream
      *
      * \param stream stream to save
@@ -0,0 +1,283 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "ClothoidListApprox.hh"
+
+#include <cmath>
+#include <algorithm>
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#endif
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#endif
+
+namespace G2lib {
+
+  using std::vector;
+  using std::upper_bound;
+  using std::abs;
+  using std::sqrt;
+  using std::pow;
+  using std::ceil;
+  using std::max;
+  using std::atan2;
+
+  /*\
+   |    ____ _       _   _           _     _ _     _     _
+   |   / ___| | ___ | |_| |__   ___ (_) __| | |   (_)___| |_
+   |  | |   | |/ _ \| __| '_ \ / _ \| |/ _` | |   | / __| __|
+   |  | |___| | (_) | |_| | | | (_) | | (_| | |___| \__ \ |_
+   |   \____|_|\___/ \__|_| |_|\___/|_|\__,_|_____|_|___/\__|
+   |      / \   _ __  _ __  _ __ _____  __
+   |     / _ \ | '_ \| '_ \| '__/ _ \ \/ /
+   |    / ___ \| |_) | |_) | | | (_) >  <
+   |   /_/   \_\ .__/| .__/|_|  \___/_/\_\
+   |           |_|   |_|
+  \*/
+
+  // max number of intervals for a single segment
+  static int_type const max_intervals = 1000000;
+
+  static real_type const sqrt2 = 1.41421356237309504880168872421;
+  static real_type const sqrt6 = 2.44948974278317809819728407471;
+
+  // bound of |r''''| = sqrt( (kappa^3)^2 + (3*kappa*dk)^2 ), for a
+  // clothoid |kappa| is maximum at one of the extrema
+  static
+  real_type
+  bound4( real_type kappa, real_type dk ) {
+    real_type k3  = kappa*kappa*kappa;
+    real_type kdk = 3*kappa*dk;
+    return sqrt( k3*k3 + kdk*kdk );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListApprox::build( ClothoidList const & CL, real_type tol ) {
+    G2LIB_ASSERT(
+      tol > 0, "ClothoidListApprox::build( CL, tol = " << tol << " ) tol must be > 0"
+    );
+    G2LIB_ASSERT(
+      CL.numSegment() > 0, "ClothoidListApprox::build( CL, tol ) empty list"
+    );
+
+    s_nodes.clear();
+    coeffs.clear();
+    theta_nodes.clear();
+    err_bound    = 0;
+    err_bound_D  = 0;
+    err_bound_DD = 0;
+    last_idx     = 0;
+
+    real_type s0 = 0;
+    s_nodes.push_back( s0 );
+    for ( int_type nseg = 0; nseg < CL.numSegment(); ++nseg ) {
+      ClothoidCurve const & C = CL.get( nseg );
+      real_type L  = C.length();
+      if ( L <= 0 ) continue; // degenerate segment, nothing to interpolate
+      real_type dk = C.dkappa();
+      real_type k0 = C.kappaBegin();
+      real_type k1 = C.kappaEnd();
+      real_type M4 = max( bound4( k0, dk ), bound4( k1, dk ) );
+      real_type KM = max( abs(k0), abs(k1) );
+
+      // sqrt(2) * h^4 * M4 / 384 <= tol and the tangent rotates at most
+      // of pi/2, the remainder bounds each component of the position
+      real_type h = L;
+      if ( M4 > 0 ) h = pow( 384*tol/(sqrt2*M4), 0.25 );
+      if ( KM*h > m_pi_2 ) h = m_pi_2/KM;
+      int_type n = 1;
+      if ( h < L ) n = int_type( ceil( L/h ) );
+      G2LIB_ASSERT(
+        n <= max_intervals,
+        "ClothoidListApprox::build( CL, tol = " << tol <<
+        " ) too many intervals (" << n << ") for segment " << nseg
+      );
+      h = L/n;
+      real_type e = sqrt2*h*h*h*h*M4/384;
+      if ( e > err_bound ) err_bound = e;
+      // max of the derivatives of the remainder t^2(t-h)^2/24
+      e = sqrt6*h*h*h*M4/216;
+      if ( e > err_bound_D ) err_bound_D = e;
+      e = sqrt2*h*h*M4/12;
+      if ( e > err_bound_DD ) err_bound_DD = e;
+
+      real_type th, k, xa, ya, xb, yb;
+      C.evaluate( 0, th, k, xa, ya );
+      real_type txa = cos(th);
+      real_type tya = sin(th);
+      for ( int_type i = 1; i <= n; ++i ) {
+        theta_nodes.push_back( th );
+        C.evaluate( i*h, th, k, xb, yb );
+        real_type txb = cos(th);
+        real_type tyb = sin(th);
+        // cubic Hermite in power basis of t = s - s_nodes[i]
+        real_type dx = (xb-xa)/h;
+        real_type dy = (yb-ya)/h;
+        coeffs.push_back( xa );
+        coeffs.push_back( txa );
+        coeffs.push_back( (3*dx-2*txa-txb)/h );
+        coeffs.push_back( (txa+txb-2*dx)/(h*h) );
+        coeffs.push_back( ya );
+        coeffs.push_back( tya );
+        coeffs.push_back( (3*dy-2*tya-tyb)/h );
+        coeffs.push_back( (tya+tyb-2*dy)/(h*h) );
+        s_nodes.push_back( i < n ? s0+i*h : s0+L );
+        xa  = xb;  ya  = yb;
+        txa = txb; tya = tyb;
+      }
+      s0 += L;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidListApprox::findAtS( real_type s ) const {
+    G2LIB_ASSERT(
+      numIntervals() > 0, "ClothoidListApprox::findAtS( " << s << " ) empty"
+    );
+    int_type ni = numIntervals();
+    // check the last used interval first
+    if ( s >= s_nodes[last_idx] && s <= s_nodes[last_idx+1] ) return last_idx;
+    if ( s <= s_nodes.front() ) {
+      last_idx = 0;
+    } else if ( s >= s_nodes.back() ) {
+      last_idx = ni-1;
+    } else {
+      vector<real_type>::const_iterator it =
+        upper_bound( s_nodes.begin(), s_nodes.end(), s );
+      last_idx = int_type( it - s_nodes.begin() ) - 1;
+    }
+    return last_idx;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListApprox::eval(
+    real_type   s,
+    real_type & x,
+    real_type & y
+  ) const {
+    int_type          idx = findAtS( s );
+    real_type const * c   = &coeffs[8*idx];
+    real_type         t   = s - s_nodes[idx];
+    x = c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+    y = c[4] + t*(c[5] + t*(c[6] + t*c[7]));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListApprox::eval_D(
+    real_type   s,
+    real_type & x_D,
+    real_type & y_D
+  ) const {
+    int_type          idx = findAtS( s );
+    real_type const * c   = &coeffs[8*idx];
+    real_type         t   = s - s_nodes[idx];
+    x_D = c[1] + t*(2*c[2] + t*3*c[3]);
+    y_D = c[5] + t*(2*c[6] + t*3*c[7]);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListApprox::eval_DD(
+    real_type   s,
+    real_type & x_DD,
+    real_type & y_DD
+  ) const {
+    int_type          idx = findAtS( s );
+    real_type const * c   = &coeffs[8*idx];
+    real_type         t   = s - s_nodes[idx];
+    x_DD = 2*c[2] + 6*t*c[3];
+    y_DD = 2*c[6] + 6*t*c[7];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListApprox::evaluate(
+    real_type   s,
+    real_type & theta,
+    real_type & kappa,
+    real_type & x,
+    real_type & y
+  ) const {
+    int_type          idx = findAtS( s );
+    real_type const * c   = &coeffs[8*idx];
+    real_type         t   = s - s_nodes[idx];
+    x = c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+    y = c[4] + t*(c[5] + t*(c[6] + t*c[7]));
+    real_type x_D  = c[1] + t*(2*c[2] + t*3*c[3]);
+    real_type y_D  = c[5] + t*(2*c[6] + t*3*c[7]);
+    real_type x_DD = 2*c[2] + 6*t*c[3];
+    real_type y_DD = 2*c[6] + 6*t*c[7];
+    // the tangent rotates less than pi/2 in the interval, the angle
+    // is obtained as a correction of the angle at the begin of the interval
+    theta = theta_nodes[idx] + atan2( c[1]*y_D - c[5]*x_D, c[1]*x_D + c[5]*y_D );
+    real_type v2 = x_D*x_D + y_D*y_D;
+    kappa = (x_D*y_DD - y_D*x_DD)/(v2*sqrt(v2));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListApprox::eval(
+    int_type        n,
+    real_type const s[],
+    real_type       x[],
+    real_type       y[]
+  ) const {
+    // when s[] is sorted the interval search is O(1) for most of the points
+    for ( int_type i = 0; i < n; ++i ) {
+      int_type          idx = findAtS( s[i] );
+      real_type const * c   = &coeffs[8*idx];
+      real_type         t   = s[i] - s_nodes[idx];
+      x[i] = c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+      y[i] = c[4] + t*(c[5] + t*(c[6] + t*c[7]));
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListApprox::info( ostream_type & stream ) const {
+    stream
+      << "ClothoidListApprox\n"
+      << "number of intervals = " << numIntervals() << '\n'
+      << "length              = " << length() << '\n'
+      << "error bound         = " << err_bound << '\n'
+      << "error bound D       = " << err_bound_D << '\n'
+      << "error bound DD      = " << err_bound_DD << '\n';
+  }
+
+}
+
+///
+/// eof: ClothoidListApprox.cc
+///
@@ -0,0 +1,164 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: ClothoidListApprox.hh
+///
+
+#ifndef CLOTHOID_LIST_APPROX_HH
+#define CLOTHOID_LIST_APPROX_HH
+
+#include "ClothoidList.hh"
+
+#include <vector>
+
+namespace G2lib {
+
+  using std::vector;
+
+  /*\
+   |    ____ _       _   _           _     _ _     _     _
+   |   / ___| | ___ | |_| |__   ___ (_) __| | |   (_)___| |_
+   |  | |   | |/ _ \| __| '_ \ / _ \| |/ _` | |   | / __| __|
+   |  | |___| | (_) | |_| | | | (_) | | (_| | |___| \__ \ |_
+   |   \____|_|\___/ \__|_| |_|\___/|_|\__,_|_____|_|___/\__|
+   |      / \   _ __  _ __  _ __ _____  __
+   |     / _ \ | '_ \| '_ \| '__/ _ \ \/ /
+   |    / ___ \| |_) | |_) | | | (_) >  <
+   |   /_/   \_\ .__/| .__/|_|  \___/_/\_\
+   |           |_|   |_|
+  \*/
+
+  //! \brief Piecewise cubic Hermite approximation of a `ClothoidList`
+  /*!
+   * Each clothoid segment is split in intervals where `(x(s),y(s))` is
+   * interpolated by a cubic Hermite polynomial (values and tangents at
+   * the extrema). The size of the intervals is chosen using the bound
+   *
+   * \f[ \|P(s)-(x(s),y(s))\| \leq \frac{\sqrt{2}h^4}{384}\max|\mathbf{r}''''|,
+   *     \qquad |\mathbf{r}''''| \leq |\kappa|^3+3|\kappa||\kappa'| \f]
+   *
+   * (the Hermite remainder bounds each component, hence the factor
+   * \f$ \sqrt{2} \f$ for the euclidean norm)
+   * so that the distance of the approximated point from the exact one
+   * is less than the requested tolerance (intervals are also limited
+   * to a rotation of the tangent of `pi/2`).
+   * The evaluation does not compute any Fresnel integral.
+   * The derivatives of the same remainder give the bounds
+   * \f$ \frac{\sqrt{6}h^3}{216}\max|\mathbf{r}''''| \f$ of the error of
+   * the tangent and \f$ \frac{\sqrt{2}h^2}{12}\max|\mathbf{r}''''| \f$
+   * of the error of the second derivative.
+   */
+  class ClothoidListApprox {
+
+    vector<real_type> s_nodes; //!< breakpoints of the intervals
+    vector<real_type> coeffs;  //!< `x` and `y` coefficients (4+4) for each interval
+    vector<real_type> theta_nodes; //!< angle at the begin of the intervals
+    real_type         err_bound;
+    real_type         err_bound_D;
+    real_type         err_bound_DD;
+    mutable int_type  last_idx;
+
+    int_type findAtS( real_type s ) const;
+
+  public:
+
+    ClothoidListApprox()
+    : err_bound(0)
+    , err_bound_D(0)
+    , err_bound_DD(0)
+    , last_idx(0)
+    {}
+
+    ClothoidListApprox( ClothoidList const & CL, real_type tol )
+    : err_bound(0)
+    , err_bound_D(0)
+    , err_bound_DD(0)
+    , last_idx(0)
+    { build( CL, tol ); }
+
+    /*!
+     * Build the approximation of the clothoid list `CL`
+     * with maximum error `tol` on the position
+     */
+    void
+    build( ClothoidList const & CL, real_type tol );
+
+    //! certified bound of the position error
+    real_type errorBound() const { return err_bound; }
+
+    //! certified bound of the error of the first derivative (`eval_D`)
+    real_type errorBound_D() const { return err_bound_D; }
+
+    //! certified bound of the error of the second derivative (`eval_DD`)
+    real_type errorBound_DD() const { return err_bound_DD; }
+
+    //! number of polynomial pieces
+    int_type
+    numIntervals() const
+    { return s_nodes.empty() ? 0 : int_type(s_nodes.size())-1; }
+
+    real_type
+    length() const
+    { return s_nodes.empty() ? 0 : s_nodes.back() - s_nodes.front(); }
+
+    void
+    eval( real_type s, real_type & x, real_type & y ) const;
+
+    void
+    eval_D( real_type s, real_type & x_D, real_type & y_D ) const;
+
+    void
+    eval_DD( real_type s, real_type & x_DD, real_type & y_DD ) const;
+
+    /*!
+     * Evaluate angle, curvature and position at `s`.
+     * Angle and curvature are computed from the derivatives
+     * of the polynomial approximation.
+     */
+    void
+    evaluate(
+      real_type   s,
+      real_type & theta,
+      real_type & kappa,
+      real_type & x,
+      real_type & y
+    ) const;
+
+    //! evaluate the points at `s[i]`, `i=0..n-1`
+    void
+    eval(
+      int_type        n,
+      real_type const s[],
+      real_type       x[],
+      real_type       y[]
+    ) const;
+
+    void
+    info( ostream_type & stream ) const;
+
+  };
+
+}
+
+#endif
+
+///
+/// eof: ClothoidListApprox.hh
+///
@@ -0,0 +1,556 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "ClothoidListCompact.hh"
+
+#include <cmath>
+#include <cfloat>
+#include <limits>
+#include <algorithm>
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#endif
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#endif
+
+// Microsoft visual studio Workaround
+#ifdef max
+  #undef max
+#endif
+
+#ifdef min
+  #undef min
+#endif
+
+namespace G2lib {
+
+  using std::vector;
+  using std::pair;
+  using std::numeric_limits;
+  using std::max;
+  using std::min;
+  using std::abs;
+  using std::hypot;
+
+  /*\
+   |    ____ _       _   _           _     _ _     _     _
+   |   / ___| | ___ | |_| |__   ___ (_) __| | |   (_)___| |_
+   |  | |   | |/ _ \| __| '_ \ / _ \| |/ _` | |   | / __| __|
+   |  | |___| | (_) | |_| | | | (_) | | (_| | |___| \__ \ |_
+   |   \____|_|\___/ \__|_| |_|\___/|_|\__,_|_____|_|___/\__|
+   |    ____                                 _
+   |   / ___|___  _ __ ___  _ __   __ _  ___| |_
+   |  | |   / _ \| '_ ` _ \| '_ \ / _` |/ __| __|
+   |  | |__| (_) | | | | | | |_) | (_| | (__| |_
+   |   \____\___/|_| |_| |_| .__/ \__,_|\___|\__|
+   |                       |_|
+  \*/
+
+  // single precision value not greater than `v`
+  static
+  float
+  round_down( real_type v ) {
+    float f = float(v);
+    if ( real_type(f) > v ) f = nextafterf( f, -FLT_MAX );
+    return f;
+  }
+
+  // single precision value not less than `v`
+  static
+  float
+  round_up( real_type v ) {
+    float f = float(v);
+    if ( real_type(f) < v ) f = nextafterf( f, FLT_MAX );
+    return f;
+  }
+
+  // distance of the point (x,y) from the box
+  static
+  real_type
+  box_distance(
+    real_type x,
+    real_type y,
+    float     xmin,
+    float     ymin,
+    float     xmax,
+    float     ymax
+  ) {
+    real_type dx = max( max( real_type(xmin)-x, x-real_type(xmax) ), real_type(0) );
+    real_type dy = max( max( real_type(ymin)-y, y-real_type(ymax) ), real_type(0) );
+    return hypot( dx, dy );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::build( ClothoidList const & CL, int_type nseg_tile ) {
+    G2LIB_ASSERT(
+      nseg_tile > 0,
+      "ClothoidListCompact::build( CL, nseg_tile = " << nseg_tile <<
+      " ) nseg_tile must be > 0"
+    );
+    G2LIB_ASSERT(
+      CL.numSegment() > 0, "ClothoidListCompact::build( CL, nseg_tile ) empty list"
+    );
+
+    int_type nseg = CL.numSegment();
+    seg_per_tile  = nseg_tile;
+    err_bound     = 0;
+    last_idx      = 0;
+    segments.clear();
+    tiles.clear();
+    aabb_tree.clear();
+    segments.reserve( nseg );
+    tiles.reserve( (nseg+nseg_tile-1)/nseg_tile );
+
+    real_type s0 = 0;
+    for ( int_type i = 0; i < nseg; ++i ) {
+      ClothoidCurve const & C = CL.get( i );
+      if ( i % nseg_tile == 0 ) {
+        Tile T;
+        T.x0     = C.xBegin();
+        T.y0     = C.yBegin();
+        T.theta0 = C.thetaBegin();
+        T.s0     = s0;
+        T.xmin   = T.ymin = FLT_MAX;
+        T.xmax   = T.ymax = -FLT_MAX;
+        tiles.push_back( T );
+      }
+      Tile & T = tiles.back();
+
+      Segment S;
+      S.x0     = float( C.xBegin() - T.x0 );
+      S.y0     = float( C.yBegin() - T.y0 );
+      S.theta0 = float( C.thetaBegin() - T.theta0 );
+      S.kappa0 = float( C.kappaBegin() );
+      S.dk     = float( C.dkappa() );
+      S.L      = float( C.length() );
+      S.s0     = float( s0 - T.s0 );
+      s0      += C.length();
+
+      segments.push_back( S );
+
+      // bbox and error of the segment widened from the stored parameters
+      // (as `get` does: the float values must not be replaced by the
+      // double ones they come from)
+      ClothoidCurve W;
+      get( i, W );
+      real_type xmin, ymin, xmax, ymax;
+      W.bbox( xmin, ymin, xmax, ymax );
+      Segment & SB = segments.back();
+      SB.xmin = round_down( xmin - T.x0 );
+      SB.ymin = round_down( ymin - T.y0 );
+      SB.xmax = round_up( xmax - T.x0 );
+      SB.ymax = round_up( ymax - T.y0 );
+
+      T.xmin = min( T.xmin, SB.xmin );
+      T.ymin = min( T.ymin, SB.ymin );
+      T.xmax = max( T.xmax, SB.xmax );
+      T.ymax = max( T.ymax, SB.ymax );
+
+      // error at the extrema and at the middle of the segment plus
+      // the rounding of the abscissa (the curves have unit speed)
+      real_type xa, ya, xb, yb;
+      C.eval( C.length()/2, xa, ya );
+      W.eval( W.length()/2, xb, yb );
+      real_type e0 = hypot( W.xBegin()-C.xBegin(), W.yBegin()-C.yBegin() );
+      real_type e1 = hypot( W.xEnd()-C.xEnd(),     W.yEnd()-C.yEnd() );
+      real_type e2 = hypot( xb-xa, yb-ya );
+      real_type es = abs( T.s0 + S.s0 - (s0-C.length()) );
+      err_bound = max( err_bound, max( max( e0, e1 ), e2 ) + es );
+    }
+    L_total = s0;
+
+    // tree of the bbox of the tiles, the leaves store the index of the tile
+    #ifdef G2LIB_USE_CXX11
+    vector<shared_ptr<BBox const> > bboxes;
+    #else
+    vector<BBox const *> bboxes;
+    #endif
+    bboxes.reserve( tiles.size() );
+    for ( size_t it = 0; it < tiles.size(); ++it ) {
+      Tile const & T = tiles[it];
+      #ifdef G2LIB_USE_CXX11
+      bboxes.push_back( make_shared<BBox const>(
+        T.x0 + T.xmin, T.y0 + T.ymin, T.x0 + T.xmax, T.y0 + T.ymax,
+        G2LIB_CLOTHOID, int_type(it)
+      ) );
+      #else
+      bboxes.push_back( new BBox(
+        T.x0 + T.xmin, T.y0 + T.ymin, T.x0 + T.xmax, T.y0 + T.ymax,
+        G2LIB_CLOTHOID, int_type(it)
+      ) );
+      #endif
+    }
+    aabb_tree.build( bboxes );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::widen(
+    int_type       idx,
+    ClothoidData & CD,
+    real_type    & L,
+    real_type    & s0
+  ) const {
+    Segment const & S = segments[idx];
+    Tile    const & T = tiles[idx/seg_per_tile];
+    CD.x0     = T.x0 + S.x0;
+    CD.y0     = T.y0 + S.y0;
+    CD.theta0 = T.theta0 + S.theta0;
+    CD.kappa0 = S.kappa0;
+    CD.dk     = S.dk;
+    L         = S.L;
+    s0        = T.s0 + S.s0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::get( int_type idx, ClothoidCurve & C ) const {
+    G2LIB_ASSERT(
+      idx >= 0 && idx < numSegment(),
+      "ClothoidListCompact::get( " << idx << " ) bad index, must be in [0," <<
+      numSegment()-1 << "]"
+    );
+    ClothoidData CD;
+    real_type    L, s0;
+    widen( idx, CD, L, s0 );
+    C.build( CD.x0, CD.y0, CD.theta0, CD.kappa0, CD.dk, L );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidListCompact::findAtS( real_type s ) const {
+    G2LIB_ASSERT(
+      !segments.empty(), "ClothoidListCompact::findAtS( " << s << " ) empty"
+    );
+    // check the last used segment first
+    {
+      Segment const & S  = segments[last_idx];
+      real_type       s0 = tiles[last_idx/seg_per_tile].s0 + S.s0;
+      if ( s >= s0 && s <= s0 + S.L ) return last_idx;
+    }
+    // search the tile then the segment in the tile
+    int_type itile = 0;
+    for ( int_type a = 0, b = numTiles(); b-a > 1; ) {
+      int_type m = (a+b)/2;
+      if ( tiles[m].s0 <= s ) a = itile = m;
+      else                    b = m;
+    }
+    real_type ds   = s - tiles[itile].s0;
+    int_type  ibeg = itile*seg_per_tile;
+    int_type  iend = min( ibeg+seg_per_tile, numSegment() );
+    last_idx = ibeg;
+    while ( last_idx+1 < iend && real_type(segments[last_idx+1].s0) <= ds )
+      ++last_idx;
+    return last_idx;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::bbox(
+    real_type & xmin,
+    real_type & ymin,
+    real_type & xmax,
+    real_type & ymax
+  ) const {
+    G2LIB_ASSERT( !tiles.empty(), "ClothoidListCompact::bbox empty" );
+    xmin = ymin = numeric_limits<real_type>::max();
+    xmax = ymax = -numeric_limits<real_type>::max();
+    vector<Tile>::const_iterator it;
+    for ( it = tiles.begin(); it != tiles.end(); ++it ) {
+      xmin = min( xmin, it->x0 + it->xmin );
+      ymin = min( ymin, it->y0 + it->ymin );
+      xmax = max( xmax, it->x0 + it->xmax );
+      ymax = max( ymax, it->y0 + it->ymax );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::segmentBBox(
+    int_type    idx,
+    real_type & xmin,
+    real_type & ymin,
+    real_type & xmax,
+    real_type & ymax
+  ) const {
+    G2LIB_ASSERT(
+      idx >= 0 && idx < numSegment(),
+      "ClothoidListCompact::segmentBBox( " << idx << " ) bad index, must be in [0," <<
+      numSegment()-1 << "]"
+    );
+    Segment const & S = segments[idx];
+    Tile    const & T = tiles[idx/seg_per_tile];
+    xmin = T.x0 + S.xmin;
+    ymin = T.y0 + S.ymin;
+    xmax = T.x0 + S.xmax;
+    ymax = T.y0 + S.ymax;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  ClothoidListCompact::theta( real_type s ) const {
+    ClothoidData CD;
+    real_type    L, s0;
+    widen( findAtS( s ), CD, L, s0 );
+    return CD.theta( s - s0 );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  ClothoidListCompact::kappa( real_type s ) const {
+    ClothoidData CD;
+    real_type    L, s0;
+    widen( findAtS( s ), CD, L, s0 );
+    return CD.kappa( s - s0 );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::eval(
+    real_type   s,
+    real_type & x,
+    real_type & y
+  ) const {
+    ClothoidData CD;
+    real_type    L, s0;
+    widen( findAtS( s ), CD, L, s0 );
+    CD.eval( s - s0, x, y );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::eval_D(
+    real_type   s,
+    real_type & x_D,
+    real_type & y_D
+  ) const {
+    ClothoidData CD;
+    real_type    L, s0;
+    widen( findAtS( s ), CD, L, s0 );
+    CD.eval_D( s - s0, x_D, y_D );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::eval_ISO(
+    real_type   s,
+    real_type   offs,
+    real_type & x,
+    real_type & y
+  ) const {
+    ClothoidData CD;
+    real_type    L, s0;
+    widen( findAtS( s ), CD, L, s0 );
+    CD.eval_ISO( s - s0, offs, x, y );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::evaluate(
+    real_type   s,
+    real_type & th,
+    real_type & k,
+    real_type & x,
+    real_type & y
+  ) const {
+    ClothoidData CD;
+    real_type    L, s0;
+    widen( findAtS( s ), CD, L, s0 );
+    CD.evaluate( s - s0, th, k, x, y );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // closest point on the tiles, `distance` refines the segments of a tile
+  // and returns the best distance found plus |offs|: the bbox of the tiles
+  // do not contain the offset curve, the shift keeps the distance of the
+  // leaves not less than the distance of their bbox
+  class ClothoidListCompact::Nearest_tile {
+    ClothoidListCompact const * pL;
+    real_type           const   qx;
+    real_type           const   qy;
+    real_type           const   offs;
+    real_type           const   aoffs;
+
+    vector<pair<real_type,int_type> > & order;
+    vector<Triangle2D>                & tvec;
+    ClothoidCurve                       C;
+
+  public:
+    real_type x, y, s, t, dst;
+
+    Nearest_tile(
+      ClothoidListCompact const *         _pL,
+      real_type                           _qx,
+      real_type                           _qy,
+      real_type                           _offs,
+      vector<pair<real_type,int_type> > & _order,
+      vector<Triangle2D>                & _tvec
+    )
+    : pL(_pL)
+    , qx(_qx)
+    , qy(_qy)
+    , offs(_offs)
+    , aoffs(abs(_offs))
+    , order(_order)
+    , tvec(_tvec)
+    , dst(numeric_limits<real_type>::infinity())
+    {}
+
+    real_type
+    distance( BBox::PtrBBox ptr ) {
+      int_type     it   = ptr->Ipos();
+      Tile const & T    = pL->tiles[size_t(it)];
+      real_type    qxl  = qx-T.x0;
+      real_type    qyl  = qy-T.y0;
+      int_type     ibeg = it*pL->seg_per_tile;
+      int_type     iend = min( ibeg+pL->seg_per_tile, pL->numSegment() );
+
+      // segments of the tile by increasing distance of the bbox
+      order.clear();
+      for ( int_type i = ibeg; i < iend; ++i ) {
+        Segment const & S = pL->segments[size_t(i)];
+        real_type d = box_distance( qxl, qyl, S.xmin, S.ymin, S.xmax, S.ymax ) - aoffs;
+        if ( d < dst ) order.push_back( pair<real_type,int_type>( d, i ) );
+      }
+      std::sort( order.begin(), order.end() );
+
+      vector<pair<real_type,int_type> >::const_iterator is;
+      for ( is = order.begin(); is != order.end(); ++is ) {
+        if ( is->first >= dst ) break; // the remaining segments are farther
+        int_type     i = is->second;
+        ClothoidData CD;
+        real_type    L, s0;
+        pL->widen( i, CD, L, s0 );
+        C.build( CD.x0, CD.y0, CD.theta0, CD.kappa0, CD.dk, L );
+        // refine on the triangles nearer than the best point
+        tvec.clear();
+        C.bbTriangles_ISO( offs, tvec, m_pi/18, 1e100 );
+        vector<Triangle2D>::const_iterator iT;
+        for ( iT = tvec.begin(); iT != tvec.end(); ++iT ) {
+          if ( iT->distMin( qx, qy ) >= dst ) continue;
+          real_type xx, yy, ss, dd;
+          C.closestPoint_internal_ISO( iT->S0(), iT->S1(), qx, qy, offs, xx, yy, ss, dd );
+          if ( dd < dst ) {
+            real_type nx, ny;
+            C.nor_ISO( ss, nx, ny );
+            dst = dd;
+            x   = xx;
+            y   = yy;
+            s   = ss + s0;
+            t   = (qx-xx) * nx + (qy-yy) * ny - offs;
+            pL->last_idx = i;
+          }
+        }
+      }
+      return dst + aoffs;
+    }
+
+    bool
+    visit( BBox::PtrBBox, real_type )
+    { return false; } // the best point is already stored
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidListCompact::closestPoint_ISO(
+    real_type   qx,
+    real_type   qy,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & t,
+    real_type & dst
+  ) const {
+    G2LIB_ASSERT(
+      !segments.empty(),
+      "ClothoidListCompact::closestPoint_ISO( " << qx << ", " << qy << " ) empty"
+    );
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBtree::NearestQueue            queue; // reused by the calls of the thread
+    static thread_local vector<pair<real_type,int_type> > order;
+    static thread_local vector<Triangle2D>                tvec;
+    #else
+    AABBtree::NearestQueue            queue;
+    vector<pair<real_type,int_type> > order;
+    vector<Triangle2D>                tvec;
+    #endif
+
+    Nearest_tile fun( this, qx, qy, offs, order, tvec );
+    aabb_tree.nearest( qx, qy, fun, queue );
+    x   = fun.x;
+    y   = fun.y;
+    s   = fun.s;
+    t   = fun.t;
+    dst = fun.dst;
+    real_type err = abs( abs(t) - dst );
+    if ( err > dst*machepsi1000 ) return -1;
+    return 1;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::getClothoidList( ClothoidList & CL ) const {
+    CL.init();
+    CL.reserve( numSegment() );
+    ClothoidCurve C;
+    for ( int_type i = 0; i < numSegment(); ++i ) {
+      get( i, C );
+      CL.push_back( C );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListCompact::info( ostream_type & stream ) const {
+    stream
+      << "ClothoidListCompact\n"
+      << "number of segments = " << numSegment() << '\n'
+      << "number of tiles    = " << numTiles() << '\n'
+      << "length             = " << length() << '\n'
+      << "error bound        = " << err_bound << '\n'
+      << "memory             = " << memory() << " bytes\n";
+  }
+
+}
+
+///
+/// eof: ClothoidListCompact.cc
+///
@@ -0,0 +1,247 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: ClothoidListCompact.hh
+///
+
+#ifndef CLOTHOID_LIST_COMPACT_HH
+#define CLOTHOID_LIST_COMPACT_HH
+
+#include "ClothoidList.hh"
+
+#include <vector>
+
+namespace G2lib {
+
+  using std::vector;
+
+  /*\
+   |    ____ _       _   _           _     _ _     _     _
+   |   / ___| | ___ | |_| |__   ___ (_) __| | |   (_)___| |_
+   |  | |   | |/ _ \| __| '_ \ / _ \| |/ _` | |   | / __| __|
+   |  | |___| | (_) | |_| | | | (_) | | (_| | |___| \__ \ |_
+   |   \____|_|\___/ \__|_| |_|\___/|_|\__,_|_____|_|___/\__|
+   |    ____                                 _
+   |   / ___|___  _ __ ___  _ __   __ _  ___| |_
+   |  | |   / _ \| '_ ` _ \| '_ \ / _` |/ __| __|
+   |  | |__| (_) | | | | | | |_) | (_| | (__| |_
+   |   \____\___/|_| |_| |_| .__/ \__,_|\___|\__|
+   |                       |_|
+  \*/
+
+  //! \brief Compact (mixed precision) storage of a `ClothoidList`
+  /*!
+   * The segments are grouped in tiles of consecutive segments.
+   * Each tile stores in double precision the origin (position, angle
+   * and curvilinear abscissa of its first segment), the parameters
+   * of the segments and their bounding boxes are stored in single
+   * precision relative to the origin of the tile.
+   * The bounding boxes are rounded outward so that they contain
+   * the segments evaluated from the stored parameters.
+   * The parameters are widened to double only inside the evaluation
+   * and the closest point computation.
+   * The segments are not exactly G0 at the joints, an estimate of the
+   * distance from the original list is returned by `errorBound`.
+   * The bounding boxes of the tiles are stored in an AABB tree
+   * used by the closest point queries.
+   */
+  class ClothoidListCompact {
+
+    // parameters of a segment relative to the origin of the tile
+    class Segment {
+    public:
+      float x0, y0, theta0, kappa0, dk, L, s0;
+      float xmin, ymin, xmax, ymax; // bbox (rounded outward)
+    };
+
+    // origin of a tile and bbox of its segments
+    class Tile {
+    public:
+      real_type x0, y0, theta0, s0;
+      float     xmin, ymin, xmax, ymax; // bbox (rounded outward)
+    };
+
+    vector<Segment>  segments;
+    vector<Tile>     tiles;
+    int_type         seg_per_tile;
+    real_type        L_total;
+    real_type        err_bound;
+    mutable int_type last_idx;
+    AABBtree         aabb_tree; //!< tree of the bbox of the tiles
+
+    // best-first search of the closest point on the tiles
+    class Nearest_tile;
+
+    void
+    widen(
+      int_type       idx,
+      ClothoidData & CD,
+      real_type    & L,
+      real_type    & s0
+    ) const;
+
+    ClothoidListCompact( ClothoidListCompact const & );
+    ClothoidListCompact const & operator = ( ClothoidListCompact const & );
+
+  public:
+
+    ClothoidListCompact()
+    : seg_per_tile(32)
+    , L_total(0)
+    , err_bound(0)
+    , last_idx(0)
+    {}
+
+    ClothoidListCompact( ClothoidList const & CL, int_type nseg_tile = 32 )
+    : seg_per_tile(32)
+    , L_total(0)
+    , err_bound(0)
+    , last_idx(0)
+    { build( CL, nseg_tile ); }
+
+    /*!
+     * Build the compact storage of `CL` using tiles of
+     * `nseg_tile` consecutive segments
+     */
+    void
+    build( ClothoidList const & CL, int_type nseg_tile = 32 );
+
+    /*!
+     * Estimate of the distance of the segments from the original ones:
+     * the maximum distance at 3 samples of each segment (the extrema and
+     * the middle point) plus the rounding of the abscissa.
+     * It is not a rigorous bound of the distance between the samples.
+     */
+    real_type errorBound() const { return err_bound; }
+
+    int_type numSegment() const { return int_type(segments.size()); }
+    int_type numTiles()   const { return int_type(tiles.size()); }
+
+    real_type length() const { return L_total; }
+
+    //! bytes used to store segments and tiles
+    size_t
+    memory() const
+    { return segments.size()*sizeof(Segment) + tiles.size()*sizeof(Tile); }
+
+    //! the `idx`-th segment widened to double precision
+    void
+    get( int_type idx, ClothoidCurve & C ) const;
+
+    //! the index of the segment at abscissa `s`
+    int_type findAtS( real_type s ) const;
+
+    void
+    bbox(
+      real_type & xmin,
+      real_type & ymin,
+      real_type & xmax,
+      real_type & ymax
+    ) const;
+
+    //! the (rounded outward) bbox of the `idx`-th segment
+    void
+    segmentBBox(
+      int_type    idx,
+      real_type & xmin,
+      real_type & ymin,
+      real_type & xmax,
+      real_type & ymax
+    ) const;
+
+    real_type theta( real_type s ) const;
+    real_type kappa( real_type s ) const;
+
+    void
+    eval( real_type s, real_type & x, real_type & y ) const;
+
+    void
+    eval_D( real_type s, real_type & x_D, real_type & y_D ) const;
+
+    void
+    eval_ISO(
+      real_type   s,
+      real_type   offs,
+      real_type & x,
+      real_type & y
+    ) const;
+
+    void
+    evaluate(
+      real_type   s,
+      real_type & th,
+      real_type & k,
+      real_type & x,
+      real_type & y
+    ) const;
+
+    /*!
+     * Point at minimum distance from `(qx,qy)`, same meaning of the
+     * arguments of `ClothoidList::closestPoint_ISO`.
+     * The tiles are visited best-first in the AABB tree of their bbox,
+     * the segments of a tile by increasing distance of their bbox, and
+     * discarded when the bbox is farther than the best point found.
+     * The segments are refined on their bounding triangles, no AABB
+     * tree is built for the segments.
+     */
+    int_type
+    closestPoint_ISO(
+      real_type   qx,
+      real_type   qy,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & t,
+      real_type & dst
+    ) const;
+
+    int_type
+    closestPoint_SAE(
+      real_type   qx,
+      real_type   qy,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & t,
+      real_type & dst
+    ) const {
+      int_type res = closestPoint_ISO( qx, qy, -offs, x, y, s, t, dst );
+      t = -t;
+      return res;
+    }
+
+    //! widen all the segments in a `ClothoidList`
+    void
+    getClothoidList( ClothoidList & CL ) const;
+
+    void
+    info( ostream_type & stream ) const;
+
+  };
+
+}
+
+#endif
+
+///
+/// eof: ClothoidListCompact.hh
+///
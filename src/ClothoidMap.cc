@@ -0,0 +1,495 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "ClothoidMap.hh"
+
+#include <cmath>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#endif
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#endif
+
+// Microsoft visual studio Workaround
+#ifdef max
+  #undef max
+#endif
+
+#ifdef min
+  #undef min
+#endif
+
+namespace G2lib {
+
+  using std::vector;
+  using std::string;
+  using std::pair;
+  using std::numeric_limits;
+  using std::max;
+  using std::min;
+  using std::abs;
+  using std::floor;
+  using std::hypot;
+
+  /*\
+   |    ____ _       _   _           _     _ __  __
+   |   / ___| | ___ | |_| |__   ___ (_) __| |  \/  | __ _ _ __
+   |  | |   | |/ _ \| __| '_ \ / _ \| |/ _` | |\/| |/ _` | '_ \
+   |  | |___| | (_) | |_| | | | (_) | | (_| | |  | | (_| | |_) |
+   |   \____|_|\___/ \__|_| |_|\___/|_|\__,_|_|  |_|\__,_| .__/
+   |                                                     |_|
+  \*/
+
+  static
+  string
+  tile_filename( string const & dir, int_type ix, int_type iy ) {
+    std::ostringstream fname;
+    fname << dir << "/tile_" << ix << '_' << iy << ".txt";
+    return fname.str();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  ClothoidMapWriter::ClothoidMapWriter( real_type _tile_size )
+  : tile_size(_tile_size)
+  , nlists(0)
+  {
+    G2LIB_ASSERT(
+      tile_size > 0,
+      "ClothoidMapWriter( tile_size = " << tile_size << " ) tile_size must be > 0"
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidMapWriter::add( ClothoidList const & CL ) {
+    int_type  id = nlists++;
+    real_type s  = 0;
+    TileKey   last(0,0);
+    for ( int_type i = 0; i < CL.numSegment(); ++i ) {
+      ClothoidCurve const & C = CL.get( i );
+      real_type xm, ym;
+      C.eval( C.length()/2, xm, ym );
+      TileKey key( int_type(floor(xm/tile_size)), int_type(floor(ym/tile_size)) );
+      vector<Piece> & pieces = tiles[key];
+      // a new piece when the curve enters the tile
+      if ( i == 0 || key != last ) pieces.push_back( Piece( id, s ) );
+      pieces.back().CL.push_back( C );
+      s   += C.length();
+      last = key;
+    }
+    return id;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidMapWriter::add( BiarcList const & BL ) {
+    ClothoidList CL;
+    CL.push_back( BL );
+    return add( CL );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidMapWriter::write( string const & dir ) const {
+    string        iname = dir + "/index.txt";
+    std::ofstream ifile( iname.c_str() );
+    G2LIB_ASSERT(
+      ifile.good(), "ClothoidMapWriter::write, cannot open `" << iname << "`"
+    );
+    ifile << std::setprecision(17)
+          << "# ClothoidMap index: tile_size nlists ntiles, then ix iy xmin ymin xmax ymax\n"
+          << tile_size << ' ' << nlists << ' ' << tiles.size() << '\n';
+
+    std::map<TileKey,vector<Piece> >::const_iterator it;
+    for ( it = tiles.begin(); it != tiles.end(); ++it ) {
+      int_type ix = it->first.first;
+      int_type iy = it->first.second;
+      string        tname = tile_filename( dir, ix, iy );
+      std::ofstream tfile( tname.c_str() );
+      G2LIB_ASSERT(
+        tfile.good(), "ClothoidMapWriter::write, cannot open `" << tname << "`"
+      );
+      tfile << std::setprecision(17) << it->second.size() << '\n';
+
+      real_type xmin = numeric_limits<real_type>::max();
+      real_type ymin = numeric_limits<real_type>::max();
+      real_type xmax = -numeric_limits<real_type>::max();
+      real_type ymax = -numeric_limits<real_type>::max();
+      vector<Piece>::const_iterator ip;
+      for ( ip = it->second.begin(); ip != it->second.end(); ++ip ) {
+        tfile << ip->id << ' ' << ip->s0 << ' ' << ip->CL.numSegment() << '\n';
+        for ( int_type i = 0; i < ip->CL.numSegment(); ++i ) {
+          ClothoidCurve const & C = ip->CL.get( i );
+          tfile
+            << C.xBegin()     << ' '
+            << C.yBegin()     << ' '
+            << C.thetaBegin() << ' '
+            << C.kappaBegin() << ' '
+            << C.dkappa()     << ' '
+            << C.length()     << '\n';
+        }
+        real_type bx0, by0, bx1, by1;
+        ip->CL.bbox( bx0, by0, bx1, by1 );
+        xmin = min( xmin, bx0 ); ymin = min( ymin, by0 );
+        xmax = max( xmax, bx1 ); ymax = max( ymax, by1 );
+      }
+      G2LIB_ASSERT(
+        tfile.good(), "ClothoidMapWriter::write, failed writing `" << tname << "`"
+      );
+      ifile << ix << ' ' << iy << ' '
+            << xmin << ' ' << ymin << ' ' << xmax << ' ' << ymax << '\n';
+    }
+    G2LIB_ASSERT(
+      ifile.good(), "ClothoidMapWriter::write, failed writing `" << iname << "`"
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidMap::open( string const & dir, int_type capacity ) {
+    string        iname = dir + "/index.txt";
+    std::ifstream ifile( iname.c_str() );
+    G2LIB_ASSERT(
+      ifile.good(), "ClothoidMap::open, cannot open `" << iname << "`"
+    );
+    string line;
+    std::getline( ifile, line ); // skip comment
+    int_type ntiles = 0;
+    ifile >> tile_size >> nlists >> ntiles;
+    G2LIB_ASSERT(
+      ifile.good() && ntiles >= 0,
+      "ClothoidMap::open, bad header in `" << iname << "`"
+    );
+    dirname = dir;
+    index.resize( size_t(ntiles) );
+    vector<TileInfo>::iterator it;
+    for ( it = index.begin(); it != index.end(); ++it ) {
+      ifile >> it->ix >> it->iy >> it->xmin >> it->ymin >> it->xmax >> it->ymax;
+      it->slot = -1;
+    }
+    G2LIB_ASSERT(
+      !ifile.fail(), "ClothoidMap::open, bad index in `" << iname << "`"
+    );
+
+    // tree of the bbox of the tiles, the leaves store the index of the tile
+    #ifdef G2LIB_USE_CXX11
+    vector<shared_ptr<BBox const> > bboxes;
+    #else
+    vector<BBox const *> bboxes;
+    #endif
+    bboxes.reserve( index.size() );
+    for ( size_t i = 0; i < index.size(); ++i ) {
+      TileInfo const & TI = index[i];
+      #ifdef G2LIB_USE_CXX11
+      bboxes.push_back( make_shared<BBox const>(
+        TI.xmin, TI.ymin, TI.xmax, TI.ymax, G2LIB_CLOTHOID, int_type(i)
+      ) );
+      #else
+      bboxes.push_back(
+        new BBox( TI.xmin, TI.ymin, TI.xmax, TI.ymax, G2LIB_CLOTHOID, int_type(i) )
+      );
+      #endif
+    }
+    aabb_tree.clear();
+    aabb_tree.build( bboxes );
+
+    nloads = 0;
+    setCapacity( capacity );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidMap::setCapacity( int_type capacity ) {
+    G2LIB_ASSERT(
+      capacity > 0,
+      "ClothoidMap::setCapacity( " << capacity << " ) capacity must be > 0"
+    );
+    slots.clear();
+    slots.resize( size_t(capacity) );
+    vector<TileInfo>::iterator it;
+    for ( it = index.begin(); it != index.end(); ++it ) it->slot = -1;
+    clock = 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidMap::numLoaded() const {
+    int_type n = 0;
+    vector<Tile>::const_iterator is;
+    for ( is = slots.begin(); is != slots.end(); ++is )
+      if ( is->itile >= 0 ) ++n;
+    return n;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  ClothoidMap::Tile const &
+  ClothoidMap::load( int_type itile ) const {
+    TileInfo const & TI = index[itile];
+    if ( TI.slot >= 0 ) {
+      Tile & T = slots[TI.slot];
+      T.stamp = ++clock;
+      return T;
+    }
+
+    // evict the least recently used tile
+    int_type islot = 0;
+    for ( int_type i = 1; i < int_type(slots.size()); ++i )
+      if ( slots[i].stamp < slots[islot].stamp ) islot = i;
+    Tile & T = slots[islot];
+    if ( T.itile >= 0 ) index[T.itile].slot = -1;
+
+    string        tname = tile_filename( dirname, TI.ix, TI.iy );
+    std::ifstream tfile( tname.c_str() );
+    G2LIB_ASSERT(
+      tfile.good(), "ClothoidMap::load, cannot open `" << tname << "`"
+    );
+    int_type npieces = 0;
+    tfile >> npieces;
+    T.ids.resize( size_t(npieces) );
+    T.s0.resize( size_t(npieces) );
+    T.lists.clear();
+    T.lists.resize( size_t(npieces) );
+    for ( int_type ip = 0; ip < npieces; ++ip ) {
+      int_type nseg = 0;
+      tfile >> T.ids[ip] >> T.s0[ip] >> nseg;
+      ClothoidList & CL = T.lists[ip];
+      CL.reserve( nseg );
+      for ( int_type i = 0; i < nseg; ++i ) {
+        real_type x0, y0, theta0, kappa0, dk, L;
+        tfile >> x0 >> y0 >> theta0 >> kappa0 >> dk >> L;
+        CL.push_back( x0, y0, theta0, kappa0, dk, L );
+      }
+      CL.build_AABBtree_ISO( 0 );
+    }
+    G2LIB_ASSERT(
+      !tfile.fail(), "ClothoidMap::load, bad tile `" << tname << "`"
+    );
+    T.itile = itile;
+    T.stamp = ++clock;
+    TI.slot = islot;
+    ++nloads;
+    return T;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // closest point on the tiles, `distance` loads a tile and returns the
+  // best distance found plus |offs|: the bbox of the tiles do not contain
+  // the offset curves, the shift keeps the distance of the leaves not less
+  // than the distance of their bbox
+  class ClothoidMap::Nearest_tile {
+    ClothoidMap const * pM;
+    real_type   const   qx;
+    real_type   const   qy;
+    real_type   const   offs;
+    real_type   const   aoffs;
+
+  public:
+    int_type  res, id;
+    real_type x, y, s, t, dst;
+
+    Nearest_tile(
+      ClothoidMap const * _pM,
+      real_type           _qx,
+      real_type           _qy,
+      real_type           _offs
+    )
+    : pM(_pM)
+    , qx(_qx)
+    , qy(_qy)
+    , offs(_offs)
+    , aoffs(abs(_offs))
+    , res(-1)
+    , id(-1)
+    , dst(numeric_limits<real_type>::infinity())
+    {}
+
+    real_type
+    distance( BBox::PtrBBox ptr ) {
+      Tile const & T = pM->load( ptr->Ipos() );
+      for ( size_t ip = 0; ip < T.lists.size(); ++ip ) {
+        real_type xx, yy, ss, tt, dd;
+        int_type  rr = T.lists[ip].closestPoint_ISO( qx, qy, offs, xx, yy, ss, tt, dd );
+        if ( dd < dst ) {
+          id  = T.ids[ip];
+          x   = xx;
+          y   = yy;
+          s   = ss + T.s0[ip];
+          t   = tt;
+          dst = dd;
+          res = rr;
+        }
+      }
+      return dst + aoffs;
+    }
+
+    bool
+    visit( BBox::PtrBBox, real_type )
+    { return false; } // the best point is already stored
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidMap::tilesNear(
+    BBox const       & box,
+    real_type          r,
+    vector<int_type> & itiles
+  ) const {
+    AABBtree::VecPtrBBox candidates;
+    aabb_tree.within_distance( box, r, candidates );
+    itiles.clear();
+    itiles.reserve( candidates.size() );
+    AABBtree::VecPtrBBox::const_iterator ic;
+    for ( ic = candidates.begin(); ic != candidates.end(); ++ic )
+      itiles.push_back( (*ic)->Ipos() );
+    // the tiles in the order of the index (the results do not depend on the tree)
+    std::sort( itiles.begin(), itiles.end() );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidMap::closestPoint_ISO(
+    real_type   qx,
+    real_type   qy,
+    real_type   offs,
+    int_type  & id,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & t,
+    real_type & dst
+  ) const {
+    Nearest_tile fun( this, qx, qy, offs );
+    aabb_tree.nearest( qx, qy, fun );
+    id  = fun.id;
+    x   = fun.x;
+    y   = fun.y;
+    s   = fun.s;
+    t   = fun.t;
+    dst = fun.dst;
+    return fun.res;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidMap::listsInRadius_ISO(
+    real_type           qx,
+    real_type           qy,
+    real_type           offs,
+    real_type           r,
+    vector<int_type>  & ids,
+    vector<real_type> & dsts
+  ) const {
+    // the offset curves are inside the bbox enlarged by |offs|
+    vector<int_type> itiles;
+    tilesNear( BBox( qx, qy, qx, qy, G2LIB_CLOTHOID, 0 ), r+abs(offs), itiles );
+
+    // the pieces of a curve can be in many tiles, keep the nearest
+    vector<pair<real_type,int_type> > found;
+    vector<int_type>::const_iterator io;
+    for ( io = itiles.begin(); io != itiles.end(); ++io ) {
+      Tile const & T = load( *io );
+      for ( size_t ip = 0; ip < T.lists.size(); ++ip ) {
+        real_type xx, yy, ss, tt, dd;
+        T.lists[ip].closestPoint_ISO( qx, qy, offs, xx, yy, ss, tt, dd );
+        if ( dd > r ) continue;
+        vector<pair<real_type,int_type> >::iterator it;
+        for ( it = found.begin(); it != found.end(); ++it )
+          if ( it->second == T.ids[ip] ) break;
+        if      ( it == found.end() ) found.push_back( pair<real_type,int_type>( dd, T.ids[ip] ) );
+        else if ( dd < it->first    ) it->first = dd;
+      }
+    }
+    std::sort( found.begin(), found.end() );
+
+    ids.clear();
+    dsts.clear();
+    vector<pair<real_type,int_type> >::const_iterator it;
+    for ( it = found.begin(); it != found.end(); ++it ) {
+      ids.push_back( it->second );
+      dsts.push_back( it->first );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidMap::intersect_ISO(
+    real_type            offs,
+    ClothoidList const & CL,
+    real_type            offs_CL,
+    vector<int_type>   & ids,
+    IntersectList      & ilist
+  ) const {
+    real_type xmin, ymin, xmax, ymax;
+    CL.bbox_ISO( offs_CL, xmin, ymin, xmax, ymax );
+    vector<int_type> itiles;
+    tilesNear( BBox( xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, 0 ), abs(offs), itiles );
+    vector<int_type>::const_iterator io;
+    for ( io = itiles.begin(); io != itiles.end(); ++io ) {
+      Tile const & T = load( *io );
+      for ( size_t ip = 0; ip < T.lists.size(); ++ip ) {
+        size_t n0 = ilist.size();
+        T.lists[ip].intersect_ISO( offs, CL, offs_CL, ilist, false );
+        for ( size_t k = n0; k < ilist.size(); ++k ) {
+          ilist[k].first += T.s0[ip];
+          ids.push_back( T.ids[ip] );
+        }
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidMap::info( ostream_type & stream ) const {
+    stream
+      << "ClothoidMap `" << dirname << "`\n"
+      << "number of curves = " << nlists << '\n'
+      << "number of tiles  = " << numTiles()
+      << " (loaded " << numLoaded() << ", capacity " << capacity() << ")\n"
+      << "tile size        = " << tile_size << '\n'
+      << "tiles read       = " << nloads << '\n';
+  }
+
+}
+
+///
+/// eof: ClothoidMap.cc
+///
@@ -0,0 +1,295 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: ClothoidMap.hh
+///
+
+#ifndef CLOTHOID_MAP_HH
+#define CLOTHOID_MAP_HH
+
+#include "ClothoidList.hh"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <utility> // pair
+
+namespace G2lib {
+
+  using std::vector;
+  using std::string;
+  using std::pair;
+
+  /*\
+   |    ____ _       _   _           _     _ __  __
+   |   / ___| | ___ | |_| |__   ___ (_) __| |  \/  | __ _ _ __
+   |  | |   | |/ _ \| __| '_ \ / _ \| |/ _` | |\/| |/ _` | '_ \
+   |  | |___| | (_) | |_| | | | (_) | | (_| | |  | | (_| | |_) |
+   |   \____|_|\___/ \__|_| |_|\___/|_|\__,_|_|  |_|\__,_| .__/
+   |                                                     |_|
+  \*/
+
+  //! \brief Partition a set of curves in square tiles saved on disk
+  /*!
+   * Each segment is assigned to the tile containing its middle point,
+   * the consecutive segments of a curve in the same tile are stored
+   * as a piece with the id of the curve and the abscissa of its begin.
+   * The files are written by `write` in an existing directory:
+   * `index.txt` (the list of the tiles with their bbox) and a file
+   * `tile_<ix>_<iy>.txt` for each tile, to be read by `ClothoidMap`.
+   */
+  class ClothoidMapWriter {
+
+    class Piece {
+    public:
+      int_type     id;
+      real_type    s0;
+      ClothoidList CL;
+      Piece( int_type _id, real_type _s0 ) : id(_id), s0(_s0) {}
+    };
+
+    typedef pair<int_type,int_type> TileKey;
+
+    real_type                       tile_size;
+    int_type                        nlists;
+    std::map<TileKey,vector<Piece> > tiles;
+
+    ClothoidMapWriter( ClothoidMapWriter const & );
+    ClothoidMapWriter const & operator = ( ClothoidMapWriter const & );
+
+  public:
+
+    explicit
+    ClothoidMapWriter( real_type _tile_size );
+
+    /*!
+     * Add a curve to the map
+     * \return the id of the curve in the map
+     */
+    int_type add( ClothoidList const & CL );
+
+    //! add a biarc list (converted to a `ClothoidList`)
+    int_type add( BiarcList const & BL );
+
+    int_type numLists() const { return nlists; }
+    int_type numTiles() const { return int_type(tiles.size()); }
+
+    //! write index and tiles in the (existing) directory `dir`
+    void write( string const & dir ) const;
+
+  };
+
+  //! \brief Map of curves partitioned in tiles loaded on demand
+  /*!
+   * Only the index of the tiles (their bbox) is kept in memory, the
+   * tiles written by `ClothoidMapWriter` are loaded when a query needs
+   * them and at most `capacity` tiles are kept in memory: the least
+   * recently used is evicted when a new tile is loaded.
+   * The AABB tree of the pieces of a tile is built when the tile is loaded,
+   * the AABB tree of the bbox of the tiles is built by `open`.
+   * The queries select the tiles with this tree (the closest point visits
+   * them best-first), so the results are the same of the queries on the
+   * whole set of curves. The abscissa returned are relative to the curve added
+   * to `ClothoidMapWriter` with id `id`.
+   */
+  class ClothoidMap {
+
+    class TileInfo {
+    public:
+      int_type  ix, iy;
+      real_type xmin, ymin, xmax, ymax; // bbox of the segments of the tile
+      mutable int_type slot;            // slot where the tile is loaded or -1
+    };
+
+    class Tile {
+    public:
+      int_type             itile; // tile loaded in the slot or -1
+      unsigned long        stamp; // last use
+      vector<int_type>     ids;
+      vector<real_type>    s0;
+      vector<ClothoidList> lists;
+      Tile() : itile(-1), stamp(0) {}
+    };
+
+    string           dirname;
+    real_type        tile_size;
+    int_type         nlists;
+    vector<TileInfo> index;
+    AABBtree         aabb_tree; //!< tree of the bbox of the tiles
+
+    mutable vector<Tile>  slots;
+    mutable unsigned long clock;
+    mutable unsigned long nloads;
+
+    ClothoidMap( ClothoidMap const & );
+    ClothoidMap const & operator = ( ClothoidMap const & );
+
+    Tile const & load( int_type itile ) const;
+
+    // best-first search of the closest point on the tiles
+    class Nearest_tile;
+
+    // tiles with bbox at distance not greater than `r` from `box`
+    void
+    tilesNear(
+      BBox const       & box,
+      real_type          r,
+      vector<int_type> & itiles
+    ) const;
+
+  public:
+
+    ClothoidMap()
+    : tile_size(0)
+    , nlists(0)
+    , clock(0)
+    , nloads(0)
+    {}
+
+    //! open the map in the directory `dir` keeping at most `capacity` tiles in memory
+    explicit
+    ClothoidMap( string const & dir, int_type capacity = 16 )
+    : tile_size(0)
+    , nlists(0)
+    , clock(0)
+    , nloads(0)
+    { open( dir, capacity ); }
+
+    void open( string const & dir, int_type capacity = 16 );
+
+    //! maximum number of tiles in memory
+    int_type capacity() const { return int_type(slots.size()); }
+
+    //! set the maximum number of tiles in memory (the loaded tiles are evicted)
+    void setCapacity( int_type capacity );
+
+    int_type numTiles()  const { return int_type(index.size()); }
+    int_type numLists()  const { return nlists; }
+    int_type numLoaded() const;
+
+    //! number of tiles read from disk since the map was opened
+    unsigned long numLoads() const { return nloads; }
+
+    /*!
+     * Point of the map with offset `offs` at minimum distance from `(qx,qy)`
+     *
+     * \param[in]  qx  x-coordinate of the point
+     * \param[in]  qy  y-coordinate of the point
+     * \param[in]  offs offset of the curves
+     * \param[out] id  id of the curve of the closest point
+     * \param[out] x   x-coordinate of the closest point
+     * \param[out] y   y-coordinate of the closest point
+     * \param[out] s   curvilinear abscissa of the closest point on the curve `id`
+     * \param[out] t   normal coordinate of `(qx,qy)`
+     * \param[out] dst distance of `(qx,qy)` from the closest point
+     * \return the result of `closestPoint_ISO` of the curve, -1 if the map is empty
+     */
+    int_type
+    closestPoint_ISO(
+      real_type   qx,
+      real_type   qy,
+      real_type   offs,
+      int_type  & id,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & t,
+      real_type & dst
+    ) const;
+
+    int_type
+    closestPoint_SAE(
+      real_type   qx,
+      real_type   qy,
+      real_type   offs,
+      int_type  & id,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & t,
+      real_type & dst
+    ) const {
+      int_type res = closestPoint_ISO( qx, qy, -offs, id, x, y, s, t, dst );
+      t = -t;
+      return res;
+    }
+
+    /*!
+     * Curves of the map with offset `offs` with distance from the
+     * point `(qx,qy)` not greater than `r`, ordered by increasing distance.
+     *
+     * \param[in]  qx   x-coordinate of the point
+     * \param[in]  qy   y-coordinate of the point
+     * \param[in]  offs offset of the curves
+     * \param[in]  r    search radius
+     * \param[out] ids  id of the curves found
+     * \param[out] dsts distance of the point from the curves found
+     */
+    void
+    listsInRadius_ISO(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      real_type           r,
+      vector<int_type>  & ids,
+      vector<real_type> & dsts
+    ) const;
+
+    void
+    listsInRadius_SAE(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      real_type           r,
+      vector<int_type>  & ids,
+      vector<real_type> & dsts
+    ) const {
+      listsInRadius_ISO( qx, qy, -offs, r, ids, dsts );
+    }
+
+    /*!
+     * Intersect the curves of the map (with offset `offs`) with `CL`
+     * (with offset `offs_CL`)
+     *
+     * \param[out] ids   id of the curve of the map of each intersection (appended)
+     * \param[out] ilist pairs `(s1,s2)`, `s1` on the curve of the map
+     *                   and `s2` on `CL` (appended)
+     */
+    void
+    intersect_ISO(
+      real_type            offs,
+      ClothoidList const & CL,
+      real_type            offs_CL,
+      vector<int_type>   & ids,
+      IntersectList      & ilist
+    ) const;
+
+    void
+    info( ostream_type & stream ) const;
+
+  };
+
+}
+
+#endif
+
+///
+/// eof: ClothoidMap.hh
+///
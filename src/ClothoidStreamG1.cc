@@ -0,0 +1,103 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "ClothoidStreamG1.hh"
+#include "Biarc.hh"
+
+#include <cmath>
+
+namespace G2lib {
+
+  using std::hypot;
+  using std::atan2;
+
+  /*\
+   |    ____ _       _   _           _     _ ____  _                            ____ _
+   |   / ___| | ___ | |_| |__   ___ (_) __| / ___|| |_ _ __ ___  __ _ _ __ ___ / ___/ |
+   |  | |   | |/ _ \| __| '_ \ / _ \| |/ _` \___ \| __| '__/ _ \/ _` | '_ ` _ \ |  _| |
+   |  | |___| | (_) | |_| | | | (_) | | (_| |___) | |_| | |  __/ (_| | | | | | | |_| | |
+   |   \____|_|\___/ \__|_| |_|\___/|_|\__,_|____/ \__|_|  \___|\__,_|_| |_| |_|\____|_|
+  \*/
+
+  void
+  ClothoidStreamG1::clear() {
+    npts       = 0;
+    nseg       = 0;
+    theta_last = 0;
+    closed     = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidStreamG1::push_back( real_type x, real_type y ) {
+    G2LIB_ASSERT(
+      !closed, "ClothoidStreamG1::push_back( " << x << ", " << y << " ) after finish"
+    );
+    // skip the duplicated points
+    if ( npts > 0 && hypot( x-xp[npts-1], y-yp[npts-1] ) < 1e-10 ) return false;
+
+    if ( npts < 3 ) {
+      xp[npts] = x;
+      yp[npts] = y;
+      ++npts;
+      if ( npts < 3 ) return false;
+    } else {
+      xp[0] = xp[1]; yp[0] = yp[1];
+      xp[1] = xp[2]; yp[1] = yp[2];
+      xp[2] = x;     yp[2] = y;
+    }
+
+    // angle at the middle point, the segment that ends there is finalized
+    Biarc b;
+    bool ok = b.build_3P( xp[0], yp[0], xp[1], yp[1], xp[2], yp[2] );
+    G2LIB_ASSERT( ok, "ClothoidStreamG1::push_back, failed" );
+    real_type theta0 = nseg == 0 ? b.thetaBegin() : theta_last;
+    theta_last = b.thetaMiddle();
+    seg.build_G1( xp[0], yp[0], theta0, xp[1], yp[1], theta_last );
+    ++nseg;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidStreamG1::finish() {
+    if ( closed ) return false;
+    closed = true;
+    if ( npts < 2 ) return false;
+    if ( npts == 2 ) {
+      real_type theta = atan2( yp[1] - yp[0], xp[1] - xp[0] );
+      seg.build_G1( xp[0], yp[0], theta, xp[1], yp[1], theta );
+    } else {
+      // end angle of the last biarc
+      Biarc b;
+      bool ok = b.build_3P( xp[0], yp[0], xp[1], yp[1], xp[2], yp[2] );
+      G2LIB_ASSERT( ok, "ClothoidStreamG1::finish, failed" );
+      seg.build_G1( xp[1], yp[1], theta_last, xp[2], yp[2], b.thetaEnd() );
+    }
+    ++nseg;
+    return true;
+  }
+
+}
+
+///
+/// eof: ClothoidStreamG1.cc
+///
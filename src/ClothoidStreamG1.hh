@@ -0,0 +1,114 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: ClothoidStreamG1.hh
+///
+
+#ifndef CLOTHOID_STREAM_G1_HH
+#define CLOTHOID_STREAM_G1_HH
+
+#include "Clothoid.hh"
+
+namespace G2lib {
+
+  /*\
+   |    ____ _       _   _           _     _ ____  _                            ____ _
+   |   / ___| | ___ | |_| |__   ___ (_) __| / ___|| |_ _ __ ___  __ _ _ __ ___ / ___/ |
+   |  | |   | |/ _ \| __| '_ \ / _ \| |/ _` \___ \| __| '__/ _ \/ _` | '_ ` _ \ |  _| |
+   |  | |___| | (_) | |_| | | | (_) | | (_| |___) | |_| | |  __/ (_| | | | | | | |_| | |
+   |   \____|_|\___/ \__|_| |_|\___/|_|\__,_|____/ \__|_|  \___|\__,_|_| |_| |_|\____|_|
+  \*/
+
+  //! \brief Streaming G1 interpolation of a sequence of points
+  /*!
+   * The points are added one at a time, the angles are computed as in
+   * `ClothoidList::build_G1(n,x,y)` (the angle at the middle of the biarc
+   * through three consecutive points, the begin and the end angle of the
+   * first and last biarc at the extrema) so that the segments are the
+   * same of the batch interpolation (open curves only).
+   * A segment is finalized when the point after its end is known
+   * (one point of look-ahead), only the last three points are stored.
+   * The points coincident with the previous one are skipped.
+   *
+   * The finalized segments can be sent to a sink with a
+   * `push_back( ClothoidCurve const & )` method, e.g. a `ClothoidList`
+   * or a `ClothoidWindow` (that keeps the AABB tree of each segment and
+   * allows to drop the old segments).
+   */
+  class ClothoidStreamG1 {
+
+    real_type     xp[3], yp[3]; //!< last three points
+    int_type      npts;         //!< number of points stored (at most 3)
+    real_type     theta_last;   //!< angle at the middle point of the stored ones
+    int_type      nseg;         //!< number of segments finalized
+    bool          closed;       //!< `finish` already called
+    ClothoidCurve seg;          //!< last segment finalized
+
+  public:
+
+    ClothoidStreamG1() { clear(); }
+
+    void clear();
+
+    /*!
+     * Add the point `(x,y)`
+     * \return true if a segment is finalized (available with `segment()`)
+     */
+    bool push_back( real_type x, real_type y );
+
+    /*!
+     * No more points: finalize the last segment
+     * \return true if a segment is finalized (available with `segment()`)
+     */
+    bool finish();
+
+    //! the last segment finalized
+    ClothoidCurve const & segment() const { return seg; }
+
+    //! number of segments finalized
+    int_type numSegment() const { return nseg; }
+
+    //! add the point `(x,y)` and send the finalized segment to `sink`
+    template <typename SINK>
+    bool
+    push_back( real_type x, real_type y, SINK & sink ) {
+      bool ok = push_back( x, y );
+      if ( ok ) sink.push_back( seg );
+      return ok;
+    }
+
+    //! finalize the last segment and send it to `sink`
+    template <typename SINK>
+    bool
+    finish( SINK & sink ) {
+      bool ok = finish();
+      if ( ok ) sink.push_back( seg );
+      return ok;
+    }
+
+  };
+
+}
+
+#endif
+
+///
+/// eof: ClothoidStreamG1.hh
+///
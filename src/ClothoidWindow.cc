@@ -0,0 +1,590 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "ClothoidWindow.hh"
+
+#include <algorithm>
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#endif
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#endif
+
+// Microsoft visual studio Workaround
+#ifdef max
+  #undef max
+#endif
+
+#ifdef min
+  #undef min
+#endif
+
+namespace G2lib {
+
+  using std::vector;
+  using std::max;
+  using std::min;
+  using std::abs;
+
+  /*\
+   |    ____ _       _   _           _     ___        ___           _
+   |   / ___| | ___ | |_| |__   ___ (_) __| \ \      / (_)_ __   __| | _____      __
+   |  | |   | |/ _ \| __| '_ \ / _ \| |/ _` |\ \ /\ / /| | '_ \ / _` |/ _ \ \ /\ / /
+   |  | |___| | (_) | |_| | | | (_) | | (_| | \ V  V / | | | | | (_| | (_) \ V  V /
+   |   \____|_|\___/ \__|_| |_|\___/|_|\__,_|  \_/\_/  |_|_| |_|\__,_|\___/ \_/\_/
+  \*/
+
+  // the absolute abscissa is rebased when the origin is greater than
+  // rebase_factor times the length of the window
+  static real_type const rebase_factor = 1000;
+
+  // distance of the point (x,y) from the bbox bb = [xmin,ymin,xmax,ymax]
+  static
+  inline
+  real_type
+  bbox_distance( real_type const bb[4], real_type x, real_type y ) {
+    real_type dx = max( real_type(0), max( bb[0]-x, x-bb[2] ) );
+    real_type dy = max( real_type(0), max( bb[1]-y, y-bb[3] ) );
+    return hypot( dx, dy );
+  }
+
+  void
+  ClothoidWindow::clear() {
+    ring.clear();
+    ring_s.clear();
+    ring_bb.clear();
+    ring_intree.clear();
+    pending.clear();
+    nstale    = 0;
+    head      = 0;
+    nseg      = 0;
+    s_origin  = 0;
+    s_end     = 0;
+    s_base    = 0;
+    last_idx  = 0;
+    aabb_done = false;
+    aabb_tree.clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::reserve( int_type n ) {
+    if ( n <= int_type(ring.size()) ) return;
+    // unroll the ring in a new buffer
+    size_t nn = size_t(n);
+    vector<ClothoidCurve> new_ring( nn );
+    vector<real_type>     new_s( nn ), new_bb( 4*nn );
+    for ( int_type i = 0; i < nseg; ++i ) {
+      int_type is = slot(i);
+      new_ring[size_t(i)] = ring[size_t(is)];
+      new_s[size_t(i)]    = ring_s[size_t(is)];
+      std::copy_n( &ring_bb[size_t(4*is)], 4, &new_bb[size_t(4*i)] );
+    }
+    ring.swap( new_ring );
+    ring_s.swap( new_s );
+    ring_bb.swap( new_bb );
+    // the slots are changed, the tree must be rebuilt
+    ring_intree.assign( nn, false );
+    pending.clear();
+    nstale    = 0;
+    head      = 0;
+    aabb_done = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::grow() {
+    reserve( max( int_type(8), 2*int_type(ring.size()) ) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::rebase() {
+    for ( int_type i = 0; i < nseg; ++i ) ring_s[size_t(slot(i))] -= s_origin;
+    s_base   += s_origin;
+    s_end    -= s_origin;
+    s_origin  = 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::setBBox( int_type is ) const {
+    real_type * bb = &ring_bb[size_t(4*is)];
+    ring[size_t(is)].bbox_ISO( bb_offs, bb[0], bb[1], bb[2], bb[3] );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::push_back( ClothoidCurve const & c ) {
+    if ( nseg == int_type(ring.size()) ) grow();
+    int_type is = slot(nseg);
+    ring[size_t(is)]   = c;
+    ring_s[size_t(is)] = s_end;
+    s_end += c.length();
+    ++nseg;
+    // the new segment is checked apart up to the next rebuild of the tree
+    setBBox( is );
+    ring_intree[size_t(is)] = false;
+    pending.push_back( is );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::push_back(
+    real_type kappa0,
+    real_type dkappa,
+    real_type L
+  ) {
+    G2LIB_ASSERT( nseg > 0, "ClothoidWindow::push_back(...) empty window!" );
+    ClothoidCurve const & c = back();
+    ClothoidCurve cc;
+    cc.build( c.xEnd(), c.yEnd(), c.thetaEnd(), kappa0, dkappa, L );
+    push_back( cc );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::push_back(
+    real_type x0,
+    real_type y0,
+    real_type theta0,
+    real_type kappa0,
+    real_type dkappa,
+    real_type L
+  ) {
+    ClothoidCurve c;
+    c.build( x0, y0, theta0, kappa0, dkappa, L );
+    push_back( c );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::push_back_G1(
+    real_type x1,
+    real_type y1,
+    real_type theta1
+  ) {
+    G2LIB_ASSERT( nseg > 0, "ClothoidWindow::push_back_G1(...) empty window!" );
+    ClothoidCurve const & c = back();
+    ClothoidCurve cc;
+    cc.build_G1( c.xEnd(), c.yEnd(), c.thetaEnd(), x1, y1, theta1 );
+    push_back( cc );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::pop_front() {
+    G2LIB_ASSERT( nseg > 0, "ClothoidWindow::pop_front() empty window!" );
+    if ( ring_intree[size_t(head)] ) {
+      ring_intree[size_t(head)] = false; // the leaf is skipped by the queries
+      ++nstale;
+    } else {
+      // after a reserve the segments are neither in the tree nor pending
+      vector<int_type>::iterator it = std::find( pending.begin(), pending.end(), head );
+      if ( it != pending.end() ) pending.erase( it );
+    }
+    s_origin += ring[size_t(head)].length();
+    head      = slot(1);
+    --nseg;
+    last_idx  = 0;
+    if ( nseg == 0 ) {
+      s_base  += s_end;
+      s_origin = s_end = 0;
+    } else if ( s_origin > rebase_factor*length() ) {
+      rebase();
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidWindow::drop_before( real_type s ) {
+    // s_base + absolute abscissa is not changed by the rebase
+    real_type s_tot = s_base + s_origin + s;
+    int_type  n     = 0;
+    while ( nseg > 0 &&
+            s_base + ring_s[size_t(head)] + ring[size_t(head)].length() < s_tot ) {
+      pop_front();
+      ++n;
+    }
+    return n;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  ClothoidCurve const &
+  ClothoidWindow::get( int_type idx ) const {
+    G2LIB_ASSERT(
+      idx >= 0 && idx < nseg,
+      "ClothoidWindow::get( " << idx << " ) out of range [0," << nseg-1 << "]"
+    );
+    return ring[size_t(slot(idx))];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  ClothoidWindow::segmentBegin( int_type idx ) const {
+    G2LIB_ASSERT(
+      idx >= 0 && idx < nseg,
+      "ClothoidWindow::segmentBegin( " << idx << " ) out of range [0," <<
+      nseg-1 << "]"
+    );
+    return ring_s[size_t(slot(idx))] - s_origin;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidWindow::findAtS( real_type s ) const {
+    G2LIB_ASSERT( nseg > 0, "ClothoidWindow::findAtS( " << s << " ) empty window" );
+    real_type s_abs = s_origin + s;
+    if ( last_idx >= nseg ) last_idx = nseg-1;
+    // the queries are usually close to the previous one
+    int_type is = slot(last_idx);
+    if ( s_abs >= ring_s[size_t(is)] &&
+         s_abs <= ring_s[size_t(is)] + ring[size_t(is)].length() )
+      return last_idx;
+    // binary search on the logical index
+    int_type lo = 0, hi = nseg-1;
+    while ( lo < hi ) {
+      int_type mid = (lo+hi+1)/2;
+      if ( ring_s[size_t(slot(mid))] <= s_abs ) lo = mid;
+      else                                      hi = mid-1;
+    }
+    last_idx = lo;
+    return last_idx;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  ClothoidCurve const &
+  ClothoidWindow::getAtS( real_type s ) const {
+    return get( findAtS( s ) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  ClothoidWindow::theta( real_type s ) const {
+    int_type idx = findAtS( s );
+    return get(idx).theta( s - segmentBegin(idx) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  ClothoidWindow::kappa( real_type s ) const {
+    int_type idx = findAtS( s );
+    return get(idx).kappa( s - segmentBegin(idx) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  ClothoidWindow::X( real_type s ) const {
+    int_type idx = findAtS( s );
+    return get(idx).X( s - segmentBegin(idx) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  ClothoidWindow::Y( real_type s ) const {
+    int_type idx = findAtS( s );
+    return get(idx).Y( s - segmentBegin(idx) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::eval(
+    real_type   s,
+    real_type & x,
+    real_type & y
+  ) const {
+    int_type idx = findAtS( s );
+    get(idx).eval( s - segmentBegin(idx), x, y );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::eval_D(
+    real_type   s,
+    real_type & x_D,
+    real_type & y_D
+  ) const {
+    int_type idx = findAtS( s );
+    get(idx).eval_D( s - segmentBegin(idx), x_D, y_D );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::eval_ISO(
+    real_type   s,
+    real_type   offs,
+    real_type & x,
+    real_type & y
+  ) const {
+    int_type idx = findAtS( s );
+    get(idx).eval_ISO( s - segmentBegin(idx), offs, x, y );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::evaluate(
+    real_type   s,
+    real_type & th,
+    real_type & k,
+    real_type & x,
+    real_type & y
+  ) const {
+    int_type idx = findAtS( s );
+    get(idx).evaluate( s - segmentBegin(idx), th, k, x, y );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::bbox_ISO(
+    real_type   offs,
+    real_type & xmin,
+    real_type & ymin,
+    real_type & xmax,
+    real_type & ymax
+  ) const {
+    G2LIB_ASSERT( nseg > 0, "ClothoidWindow::bbox_ISO( " << offs << " ) empty window" );
+    get(0).bbox_ISO( offs, xmin, ymin, xmax, ymax );
+    for ( int_type i = 1; i < nseg; ++i ) {
+      real_type xmi, ymi, xma, yma;
+      get(i).bbox_ISO( offs, xmi, ymi, xma, yma );
+      if ( xmi < xmin ) xmin = xmi;
+      if ( ymi < ymin ) ymin = ymi;
+      if ( xma > xmax ) xmax = xma;
+      if ( yma > ymax ) ymax = yma;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::build_AABBtree_ISO( real_type offs ) const {
+    if ( !isZero( offs-bb_offs ) ) {
+      // new offset, recompute the bbox of all the segments
+      bb_offs = offs;
+      for ( int_type i = 0; i < nseg; ++i ) setBBox( slot(i) );
+      aabb_done = false;
+    }
+    // the tree is rebuilt when the segments pushed or popped are many
+    int_type nchanged = int_type(pending.size()) + nstale;
+    if ( aabb_done && nchanged <= max( int_type(8), nseg/4 ) ) return;
+
+    #ifdef G2LIB_USE_CXX11
+    vector<shared_ptr<BBox const> > bboxes;
+    #else
+    vector<BBox const *> bboxes;
+    #endif
+
+    // one bbox for each segment, the leaves store the slot of the segment
+    bboxes.reserve( size_t(nseg) );
+    for ( int_type i = 0; i < nseg; ++i ) {
+      int_type is = slot(i);
+      real_type const * bb = &ring_bb[size_t(4*is)];
+      #ifdef G2LIB_USE_CXX11
+      bboxes.push_back( make_shared<BBox const>(
+        bb[0], bb[1], bb[2], bb[3], G2LIB_CLOTHOID, is
+      ) );
+      #else
+      bboxes.push_back(
+        new BBox( bb[0], bb[1], bb[2], bb[3], G2LIB_CLOTHOID, is )
+      );
+      #endif
+      ring_intree[size_t(is)] = true;
+    }
+    aabb_tree.build( bboxes );
+    G2LIB_PERF_COUNT(aabb_rebuilds);
+    pending.clear();
+    nstale    = 0;
+    aabb_done = true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidWindow::closestPoint_ISO(
+    real_type   qx,
+    real_type   qy,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & t,
+    real_type & dst
+  ) const {
+    G2LIB_ASSERT(
+      nseg > 0,
+      "ClothoidWindow::closestPoint_ISO( " << qx << ", " << qy << " ) empty window"
+    );
+    this->build_AABBtree_ISO( offs );
+    Nearest_segment fun( this, qx, qy, offs );
+    if ( int_type(pending.size()) < nseg ) aabb_tree.nearest( qx, qy, fun );
+    // the segments not yet in the tree
+    for ( size_t k = 0; k < pending.size(); ++k ) {
+      int_type is = pending[k];
+      if ( bbox_distance( &ring_bb[size_t(4*is)], qx, qy ) < fun.dst )
+        fun.distance( is );
+    }
+    x   = fun.x;
+    y   = fun.y;
+    s   = ring_s[size_t(fun.islot)] - s_origin + fun.s;
+    t   = fun.t;
+    dst = fun.dst;
+    real_type err = abs( abs(t) - dst );
+    if ( err > dst*machepsi1000 ) return -1;
+    return 1;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::overlapping_ISO(
+    real_type const    bb[4],
+    vector<int_type> & slots
+  ) const {
+    slots.clear();
+    if ( int_type(pending.size()) < nseg ) {
+      BBox box( bb[0], bb[1], bb[2], bb[3], 0, 0 );
+      AABBtree::VecPtrBBox bboxes;
+      aabb_tree.within_distance( box, 0, bboxes );
+      AABBtree::VecPtrBBox::const_iterator it;
+      for ( it = bboxes.begin(); it != bboxes.end(); ++it ) {
+        int_type is = (*it)->Ipos();
+        if ( ring_intree[size_t(is)] ) slots.push_back( is ); // skip the removed
+      }
+    }
+    // the segments not yet in the tree
+    for ( size_t k = 0; k < pending.size(); ++k ) {
+      real_type const * bbs = &ring_bb[size_t(4*pending[k])];
+      if ( bbs[0] <= bb[2] && bb[0] <= bbs[2] &&
+           bbs[1] <= bb[3] && bb[1] <= bbs[3] )
+        slots.push_back( pending[k] );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidWindow::collision_ISO(
+    real_type            offs,
+    ClothoidList const & CL,
+    real_type            offs_CL
+  ) const {
+    if ( nseg == 0 ) return false;
+    this->build_AABBtree_ISO( offs );
+    vector<int_type> slots;
+    for ( int_type j = 0; j < CL.numSegment(); ++j ) {
+      ClothoidCurve const & C = CL.get(j);
+      real_type bb[4];
+      C.bbox_ISO( offs_CL, bb[0], bb[1], bb[2], bb[3] );
+      overlapping_ISO( bb, slots );
+      for ( size_t k = 0; k < slots.size(); ++k )
+        if ( ring[size_t(slots[k])].collision_ISO( offs, C, offs_CL ) )
+          return true;
+    }
+    return false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::intersect_ISO(
+    real_type            offs,
+    ClothoidList const & CL,
+    real_type            offs_CL,
+    IntersectList      & ilist,
+    bool                 swap_s_vals
+  ) const {
+    if ( nseg == 0 ) return;
+    this->build_AABBtree_ISO( offs );
+    vector<int_type> slots;
+    IntersectList    ilist1;
+    real_type        s_CL = 0; // abscissa of the begin of the segment of CL
+    for ( int_type j = 0; j < CL.numSegment(); ++j ) {
+      ClothoidCurve const & C = CL.get(j);
+      real_type bb[4];
+      C.bbox_ISO( offs_CL, bb[0], bb[1], bb[2], bb[3] );
+      overlapping_ISO( bb, slots );
+      for ( size_t k = 0; k < slots.size(); ++k ) {
+        int_type is = slots[k];
+        ilist1.clear();
+        ring[size_t(is)].intersect_ISO( offs, C, offs_CL, ilist1, false );
+        real_type s_W = ring_s[size_t(is)] - s_origin;
+        for ( IntersectList::const_iterator it = ilist1.begin();
+              it != ilist1.end(); ++it ) {
+          real_type ss1 = s_W + it->first, ss2 = s_CL + it->second;
+          if ( swap_s_vals ) std::swap( ss1, ss2 );
+          ilist.push_back( Ipair( ss1, ss2 ) );
+        }
+      }
+      s_CL += C.length();
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::getClothoidList( ClothoidList & CL ) const {
+    CL.init();
+    CL.reserve( nseg );
+    for ( int_type i = 0; i < nseg; ++i ) CL.push_back( get(i) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidWindow::info( ostream_type & stream ) const {
+    stream
+      << "ClothoidWindow\n"
+      << "number of segments = " << nseg
+      << " (capacity " << ring.size() << ")\n"
+      << "length             = " << length() << '\n'
+      << "origin             = " << sOrigin() << '\n';
+  }
+
+}
+
+///
+/// eof: ClothoidWindow.cc
+///
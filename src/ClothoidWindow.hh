@@ -0,0 +1,375 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: ClothoidWindow.hh
+///
+
+#ifndef CLOTHOID_WINDOW_HH
+#define CLOTHOID_WINDOW_HH
+
+#include "ClothoidList.hh"
+
+#include <vector>
+#include <limits>
+
+namespace G2lib {
+
+  using std::vector;
+  using std::numeric_limits;
+
+  /*\
+   |    ____ _       _   _           _     ___        ___           _
+   |   / ___| | ___ | |_| |__   ___ (_) __| \ \      / (_)_ __   __| | _____      __
+   |  | |   | |/ _ \| __| '_ \ / _ \| |/ _` |\ \ /\ / /| | '_ \ / _` |/ _ \ \ /\ / /
+   |  | |___| | (_) | |_| | | | (_) | | (_| | \ V  V / | | | | | (_| | (_) \ V  V /
+   |   \____|_|\___/ \__|_| |_|\___/|_|\__,_|  \_/\_/  |_|_| |_|\__,_|\___/ \_/\_/
+  \*/
+
+  //! \brief Moving window of a path of clothoids (receding horizon)
+  /*!
+   * The segments are stored in a ring buffer: `push_back` and `pop_front`
+   * are amortized O(1).
+   * The curvilinear abscissa of the queries is measured from the begin
+   * of the window; internally the segments store an absolute abscissa
+   * that is rebased (in O(n)) only when the origin has moved far away
+   * with respect to the length of the window.
+   * Each segment keeps its own AABB tree (built by the queries) and its
+   * bbox is cached in the ring. The small tree of the bbox of the segments
+   * is not rebuilt when the window moves: the segments pushed are kept in
+   * a pending list checked one by one and the leaves of the segments
+   * popped are skipped, the tree is rebuilt (from the cached bbox) when
+   * they are more than a quarter of the segments.
+   */
+  class ClothoidWindow {
+
+    vector<ClothoidCurve> ring;     //!< ring buffer of the segments
+    vector<real_type>     ring_s;   //!< absolute abscissa of the begin of the segments
+    mutable vector<real_type> ring_bb;    //!< bbox of the segments at offset `bb_offs`
+    mutable vector<bool>      ring_intree; //!< the segment has a valid leaf in the tree
+    int_type              head;     //!< slot of the first segment
+    int_type              nseg;     //!< number of segments in the window
+    real_type             s_origin; //!< absolute abscissa of the begin of the window
+    real_type             s_end;    //!< absolute abscissa of the end of the window
+    real_type             s_base;   //!< abscissa removed by the rebase
+
+    mutable int_type         last_idx;
+    mutable real_type        bb_offs;
+    mutable bool             aabb_done;
+    mutable vector<int_type> pending; //!< slots of the segments not in the tree
+    mutable int_type         nstale;  //!< leaves of the segments removed
+    mutable AABBtree         aabb_tree;
+
+    // collect the segment nearest to the point (qx,qy), the projection
+    // on the nearest segment is the one computed by `distance`
+    class Nearest_segment {
+      ClothoidWindow const * pW;
+      real_type      const   qx;
+      real_type      const   qy;
+      real_type      const   offs;
+    public:
+      int_type  islot;
+      real_type x, y, s, t, dst;
+
+      Nearest_segment(
+        ClothoidWindow const * _pW,
+        real_type      const   _qx,
+        real_type      const   _qy,
+        real_type      const   _offs
+      )
+      : pW(_pW)
+      , qx(_qx)
+      , qy(_qy)
+      , offs(_offs)
+      , islot(-1)
+      , dst(numeric_limits<real_type>::infinity())
+      {}
+
+      real_type
+      distance( int_type is ) {
+        real_type xx, yy, ss, tt, dd;
+        pW->ring[size_t(is)].closestPoint_ISO( qx, qy, offs, xx, yy, ss, tt, dd );
+        if ( dd < dst ) {
+          islot = is;
+          x = xx; y = yy; s = ss; t = tt; dst = dd;
+        }
+        return dd;
+      }
+
+      real_type
+      distance( BBox::PtrBBox ptr ) {
+        int_type is = ptr->Ipos();
+        if ( !pW->ring_intree[size_t(is)] ) // segment removed
+          return numeric_limits<real_type>::infinity();
+        return distance( is );
+      }
+
+      bool
+      visit( BBox::PtrBBox, real_type )
+      { return false; } // the first is the nearest, already stored
+    };
+
+    int_type
+    slot( int_type i ) const
+    { return (head+i) % int_type(ring.size()); }
+
+    void grow();
+    void rebase();
+    void setBBox( int_type is ) const;
+
+    void build_AABBtree_ISO( real_type offs ) const;
+
+    // slots of the segments (with offset `offs`) whose bbox overlaps `bb`,
+    // the tree must be built with `build_AABBtree_ISO( offs )`
+    void
+    overlapping_ISO(
+      real_type const    bb[4],
+      vector<int_type> & slots
+    ) const;
+
+    ClothoidWindow( ClothoidWindow const & );
+    ClothoidWindow const & operator = ( ClothoidWindow const & );
+
+  public:
+
+    ClothoidWindow()
+    : head(0)
+    , nseg(0)
+    , s_origin(0)
+    , s_end(0)
+    , s_base(0)
+    , last_idx(0)
+    , bb_offs(0)
+    , aabb_done(false)
+    , nstale(0)
+    {}
+
+    void clear();
+
+    //! reserve space for `n` segments
+    void reserve( int_type n );
+
+    void push_back( ClothoidCurve const & c );
+    void push_back( real_type kappa0, real_type dkappa, real_type L );
+    void push_back( real_type x0, real_type y0, real_type theta0,
+                    real_type kappa0, real_type dkappa, real_type L );
+
+    void push_back_G1( real_type x1, real_type y1, real_type theta1 );
+
+    //! remove the first segment of the window
+    void pop_front();
+
+    /*!
+     * Remove the segments that end before `s`
+     * (abscissa measured from the begin of the window).
+     * \return the number of removed segments
+     */
+    int_type drop_before( real_type s );
+
+    int_type numSegment() const { return nseg; }
+    bool     empty()      const { return nseg == 0; }
+
+    //! the `idx`-th segment of the window
+    ClothoidCurve const & get( int_type idx ) const;
+    ClothoidCurve const & front() const { return get(0); }
+    ClothoidCurve const & back()  const { return get(nseg-1); }
+
+    //! the segment at abscissa `s`
+    ClothoidCurve const & getAtS( real_type s ) const;
+
+    //! the index of the segment at abscissa `s`
+    int_type findAtS( real_type s ) const;
+
+    //! length of the window
+    real_type length() const { return s_end-s_origin; }
+
+    //! abscissa of the begin of the window measured from the first `push_back`
+    real_type sOrigin() const { return s_base+s_origin; }
+
+    //! abscissa of the begin of the `idx`-th segment
+    real_type segmentBegin( int_type idx ) const;
+
+    real_type theta( real_type s ) const;
+    real_type kappa( real_type s ) const;
+    real_type X( real_type s ) const;
+    real_type Y( real_type s ) const;
+
+    void
+    eval( real_type s, real_type & x, real_type & y ) const;
+
+    void
+    eval_D( real_type s, real_type & x_D, real_type & y_D ) const;
+
+    void
+    eval_ISO(
+      real_type   s,
+      real_type   offs,
+      real_type & x,
+      real_type & y
+    ) const;
+
+    void
+    evaluate(
+      real_type   s,
+      real_type & th,
+      real_type & k,
+      real_type & x,
+      real_type & y
+    ) const;
+
+    void
+    bbox_ISO(
+      real_type   offs,
+      real_type & xmin,
+      real_type & ymin,
+      real_type & xmax,
+      real_type & ymax
+    ) const;
+
+    /*!
+     * Point of the window at minimum distance from `(qx,qy)`,
+     * same meaning of the arguments of `ClothoidList::closestPoint_ISO`
+     */
+    int_type
+    closestPoint_ISO(
+      real_type   qx,
+      real_type   qy,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & t,
+      real_type & dst
+    ) const;
+
+    int_type
+    closestPoint_SAE(
+      real_type   qx,
+      real_type   qy,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & t,
+      real_type & dst
+    ) const {
+      int_type res = closestPoint_ISO( qx, qy, -offs, x, y, s, t, dst );
+      t = -t;
+      return res;
+    }
+
+    real_type
+    distance( real_type qx, real_type qy ) const {
+      real_type x, y, s, t, dst;
+      closestPoint_ISO( qx, qy, 0, x, y, s, t, dst );
+      return dst;
+    }
+
+    real_type
+    distance_ISO(
+      real_type qx,
+      real_type qy,
+      real_type offs
+    ) const {
+      real_type x, y, s, t, dst;
+      closestPoint_ISO( qx, qy, offs, x, y, s, t, dst );
+      return dst;
+    }
+
+    real_type
+    distance_SAE(
+      real_type qx,
+      real_type qy,
+      real_type offs
+    ) const {
+      return distance_ISO( qx, qy, -offs );
+    }
+
+    /*\
+     |             _ _ _     _
+     |    ___ ___ | | (_)___(_) ___  _ __
+     |   / __/ _ \| | | / __| |/ _ \| '_ \
+     |  | (_| (_) | | | \__ \ | (_) | | | |
+     |   \___\___/|_|_|_|___/_|\___/|_| |_|
+    \*/
+
+    bool
+    collision( ClothoidList const & CL ) const
+    { return collision_ISO( 0, CL, 0 ); }
+
+    /*!
+     * Check the collision of the window (with offset `offs`) with `CL`
+     * (with offset `offs_CL`): the segments of `CL` are checked against
+     * the tree of the window, the pairs of segments that overlap are
+     * checked with the trees of the segments.
+     */
+    bool
+    collision_ISO(
+      real_type            offs,
+      ClothoidList const & CL,
+      real_type            offs_CL
+    ) const;
+
+    /*\
+     |   _       _                          _
+     |  (_)_ __ | |_ ___ _ __ ___  ___  ___| |_
+     |  | | '_ \| __/ _ \ '__/ __|/ _ \/ __| __|
+     |  | | | | | ||  __/ |  \__ \  __/ (__| |_
+     |  |_|_| |_|\__\___|_|  |___/\___|\___|\__|
+    \*/
+
+    void
+    intersect(
+      ClothoidList const & CL,
+      IntersectList      & ilist,
+      bool                 swap_s_vals
+    ) const {
+      intersect_ISO( 0, CL, 0, ilist, swap_s_vals );
+    }
+
+    /*!
+     * Intersections of the window (with offset `offs`) with `CL`
+     * (with offset `offs_CL`), the abscissa of the window is measured
+     * from the begin of the window.
+     */
+    void
+    intersect_ISO(
+      real_type            offs,
+      ClothoidList const & CL,
+      real_type            offs_CL,
+      IntersectList      & ilist,
+      bool                 swap_s_vals
+    ) const;
+
+    //! copy the segments of the window in a `ClothoidList`
+    void
+    getClothoidList( ClothoidList & CL ) const;
+
+    void
+    info( ostream_type & stream ) const;
+
+  };
+
+}
+
+#endif
+
+///
+/// eof: ClothoidWindow.hh
+///
@@ -0,0 +1,345 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "CurveScene.hh"
+
+#include <algorithm>
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#endif
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#endif
+
+namespace G2lib {
+
+  using std::vector;
+  using std::pair;
+  using std::sort;
+  using std::unique;
+  using std::find;
+  using std::min;
+  using std::max;
+
+  /*\
+   |    ____                     ____
+   |   / ___|   _ _ ____   _____/ ___|  ___ ___ _ __   ___
+   |  | |  | | | | '__\ \ / / _ \___ \ / __/ _ \ '_ \ / _ \
+   |  | |__| |_| | |   \ V /  __/___) | (_|  __/ | | |  __/
+   |   \____\__,_|_|    \_/ \___|____/ \___\___|_| |_|\___|
+  \*/
+
+  CurveScene::CurveScene( real_type _margin )
+  : margin(_margin)
+  , nstale(0)
+  , aabb_done(false)
+  {
+    G2LIB_ASSERT(
+      margin >= 0,
+      "CurveScene( margin = " << margin << " ) margin must be >= 0"
+    );
+  }
+
+  CurveScene::~CurveScene() {
+    clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::clear() {
+    curves.clear();
+    bboxes.clear();
+    state.clear();
+    freeSlots.clear();
+    pending.clear();
+    nstale = 0;
+    aabb_tree.clear();
+    aabb_done = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::setMargin( real_type _margin ) {
+    G2LIB_ASSERT(
+      _margin >= 0,
+      "CurveScene::setMargin( margin = " << _margin << " ) margin must be >= 0"
+    );
+    margin = _margin;
+    for ( int_type id = 0; id < int_type(curves.size()); ++id )
+      if ( curves[id] != nullptr ) setBBox( id );
+    aabb_done = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::setBBox( int_type id ) {
+    real_type * bb = &bboxes[4*id];
+    curves[id]->bbox( bb[0], bb[1], bb[2], bb[3] );
+    bb[0] -= margin;
+    bb[1] -= margin;
+    bb[2] += margin;
+    bb[3] += margin;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  CurveScene::insideBBox( int_type id ) const {
+    real_type const * bb = &bboxes[4*id];
+    real_type xmin, ymin, xmax, ymax;
+    curves[id]->bbox( xmin, ymin, xmax, ymax );
+    return xmin >= bb[0] && ymin >= bb[1] && xmax <= bb[2] && ymax <= bb[3];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::setPending( int_type id ) {
+    if ( state[id] == IN_TREE ) ++nstale; // the leaf of `id` is no more valid
+    if ( state[id] != PENDING ) pending.push_back( id );
+    state[id] = PENDING;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::unsetPending( int_type id ) {
+    vector<int_type>::iterator it = find( pending.begin(), pending.end(), id );
+    if ( it != pending.end() ) {
+      *it = pending.back();
+      pending.pop_back();
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  CurveScene::insert( BaseCurve const & C ) {
+    int_type id;
+    if ( freeSlots.empty() ) {
+      id = int_type(curves.size());
+      curves.push_back( &C );
+      state.push_back( FREE );
+      bboxes.resize( 4*curves.size() );
+    } else {
+      id = freeSlots.back();
+      freeSlots.pop_back();
+      curves[id] = &C;
+    }
+    setBBox( id );
+    setPending( id );
+    return id;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::remove( int_type id ) {
+    G2LIB_ASSERT(
+      isValid( id ), "CurveScene::remove( id = " << id << " ) bad id"
+    );
+    // the leaf remains in the tree and is skipped in the queries
+    if ( state[id] == IN_TREE ) ++nstale;
+    else                        unsetPending( id );
+    state[id]  = FREE;
+    curves[id] = nullptr;
+    freeSlots.push_back( id );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::moved( int_type id ) {
+    G2LIB_ASSERT(
+      isValid( id ), "CurveScene::moved( id = " << id << " ) bad id"
+    );
+    if ( insideBBox( id ) ) return;
+    setBBox( id );
+    setPending( id );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  BaseCurve const &
+  CurveScene::get( int_type id ) const {
+    G2LIB_ASSERT(
+      isValid( id ), "CurveScene::get( id = " << id << " ) bad id"
+    );
+    return *curves[id];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  CurveScene::rebuildThreshold() const {
+    int_type ntree = int_type(curves.size()) - int_type(freeSlots.size())
+                   - int_type(pending.size()) + nstale;
+    return std::max( int_type(16), ntree/4 );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::build_AABBtree() const {
+    if ( aabb_done &&
+         int_type(pending.size()) + nstale <= rebuildThreshold() ) return;
+
+    #ifdef G2LIB_USE_CXX11
+    vector<shared_ptr<BBox const> > bbox_list;
+    #else
+    vector<BBox const *> bbox_list;
+    #endif
+
+    bbox_list.reserve( curves.size() );
+    for ( int_type id = 0; id < int_type(curves.size()); ++id ) {
+      if ( curves[id] == nullptr ) continue;
+      state[id] = IN_TREE;
+      real_type const * bb = &bboxes[4*id];
+      #ifdef G2LIB_USE_CXX11
+      bbox_list.push_back( make_shared<BBox const>(
+        bb[0], bb[1], bb[2], bb[3], curves[id]->type(), id
+      ) );
+      #else
+      bbox_list.push_back(
+        new BBox( bb[0], bb[1], bb[2], bb[3], curves[id]->type(), id )
+      );
+      #endif
+    }
+    aabb_tree.build( bbox_list );
+    G2LIB_PERF_COUNT(aabb_rebuilds);
+    pending.clear();
+    nstale    = 0;
+    aabb_done = true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::collision(
+    BaseCurve const  & C,
+    vector<int_type> & ids
+  ) const {
+    collision_ISO( C, 0, ids );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::collision_ISO(
+    BaseCurve const  & C,
+    real_type          offs,
+    vector<int_type> & ids
+  ) const {
+    ids.clear();
+    if ( numCurves() == 0 ) return;
+    build_AABBtree();
+
+    real_type xmin, ymin, xmax, ymax;
+    C.bbox_ISO( offs, xmin, ymin, xmax, ymax );
+    BBox box( xmin, ymin, xmax, ymax, C.type(), 0 );
+
+    AABBtree::VecPtrBBox candidateList;
+    aabb_tree.within_distance( box, 0, candidateList );
+
+    AABBtree::VecPtrBBox::const_iterator ic;
+    for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
+      int_type id = (*ic)->Ipos();
+      if ( state[id] != IN_TREE ) continue; // stale leaf
+      if ( G2lib::collision_ISO( C, offs, *curves[id], 0 ) ) ids.push_back( id );
+    }
+    vector<int_type>::const_iterator ip;
+    for ( ip = pending.begin(); ip != pending.end(); ++ip )
+      if ( overlapBBox( *ip, box ) &&
+           G2lib::collision_ISO( C, offs, *curves[*ip], 0 ) ) ids.push_back( *ip );
+    sort( ids.begin(), ids.end() );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::collisionPairs( vector<pair<int_type,int_type> > & pairs ) const {
+    pairs.clear();
+    if ( numCurves() < 2 ) return;
+    build_AABBtree();
+
+    // each pair of distinct overlapping leaves is visited once
+    AABBtree::VecPairPtrBBox iList;
+    aabb_tree.intersect_self( iList );
+
+    AABBtree::VecPairPtrBBox::const_iterator ip;
+    for ( ip = iList.begin(); ip != iList.end(); ++ip ) {
+      int_type id1 = ip->first->Ipos();
+      int_type id2 = ip->second->Ipos();
+      if ( state[id1] != IN_TREE || state[id2] != IN_TREE ) continue;
+      if ( G2lib::collision( *curves[id1], *curves[id2] ) )
+        pairs.push_back( pair<int_type,int_type>( min(id1,id2), max(id1,id2) ) );
+    }
+
+    // pending curves against the tree and against each other
+    AABBtree::VecPtrBBox candidateList;
+    for ( size_t i = 0; i < pending.size(); ++i ) {
+      int_type          id1 = pending[i];
+      real_type const * bb  = &bboxes[4*id1];
+      BBox box( bb[0], bb[1], bb[2], bb[3], curves[id1]->type(), id1 );
+      candidateList.clear();
+      aabb_tree.within_distance( box, 0, candidateList );
+      AABBtree::VecPtrBBox::const_iterator ic;
+      for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
+        int_type id2 = (*ic)->Ipos();
+        if ( state[id2] != IN_TREE ) continue;
+        if ( G2lib::collision( *curves[id1], *curves[id2] ) )
+          pairs.push_back( pair<int_type,int_type>( min(id1,id2), max(id1,id2) ) );
+      }
+      for ( size_t j = i+1; j < pending.size(); ++j ) {
+        int_type id2 = pending[j];
+        if ( overlapBBox( id2, box ) &&
+             G2lib::collision( *curves[id1], *curves[id2] ) )
+          pairs.push_back( pair<int_type,int_type>( min(id1,id2), max(id1,id2) ) );
+      }
+    }
+    sort( pairs.begin(), pairs.end() );
+    pairs.erase( unique( pairs.begin(), pairs.end() ), pairs.end() );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveScene::info( ostream_type & stream ) const {
+    stream
+      << "CurveScene\n"
+      << "number of curves = " << numCurves()
+      << " (slots " << curves.size() << ")\n"
+      << "bbox margin      = " << margin << '\n'
+      << "pending curves   = " << pending.size()
+      << ", stale leaves = " << nstale << '\n';
+    if ( aabb_done ) aabb_tree.print( stream );
+    else             stream << "AABB tree not built\n";
+  }
+
+}
+
+///
+/// eof: CurveScene.cc
+///
@@ -0,0 +1,204 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: CurveScene.hh
+///
+
+#ifndef CURVE_SCENE_HH
+#define CURVE_SCENE_HH
+
+#include "G2lib.hh"
+#include "AABBtree.hh"
+
+#include <vector>
+#include <utility> // pair
+
+namespace G2lib {
+
+  using std::vector;
+  using std::pair;
+
+  /*\
+   |    ____                     ____
+   |   / ___|   _ _ ____   _____/ ___|  ___ ___ _ __   ___
+   |  | |  | | | | '__\ \ / / _ \___ \ / __/ _ \ '_ \ / _ \
+   |  | |__| |_| | |   \ V /  __/___) | (_|  __/ | | |  __/
+   |   \____\__,_|_|    \_/ \___|____/ \___\___|_| |_|\___|
+  \*/
+
+  //! \brief Broadphase collision manager for a set of curves
+  /*!
+   * The scene stores a pointer to each curve inserted (the curves are
+   * not copied and must live as long as they are in the scene) and an
+   * AABB tree of their bounding boxes.
+   * The bounding boxes are enlarged by `margin` so that a curve that
+   * moves inside its enlarged box does not change the tree.
+   * A curve inserted, or moved out of its enlarged box, is kept in a
+   * short pending list checked one by one, and its old leaf (if any)
+   * becomes stale and is skipped. The tree is rebuilt (lazily, at the
+   * next query) only when pending curves and stale leaves exceed
+   * `rebuildThreshold()`.
+   * The narrowphase uses the `collision` of the curves.
+   */
+  class CurveScene {
+
+    enum { FREE = 0, IN_TREE = 1, PENDING = 2 };
+
+    vector<BaseCurve const *> curves;    //!< inserted curves (nullptr = free slot)
+    vector<real_type>         bboxes;    //!< enlarged bbox of the curves [xmin,ymin,xmax,ymax]
+    vector<int_type>          freeSlots; //!< free positions in `curves`
+    real_type                 margin;    //!< enlargement of the bbox
+
+    mutable vector<int_type>  state;     //!< FREE, IN_TREE or PENDING
+    mutable vector<int_type>  pending;   //!< curves not in the tree
+    mutable int_type          nstale;    //!< leaves of the tree no more valid
+    mutable bool              aabb_done;
+    mutable AABBtree          aabb_tree;
+
+    CurveScene( CurveScene const & );
+    CurveScene const & operator = ( CurveScene const & );
+
+    void setBBox( int_type id );
+    bool insideBBox( int_type id ) const;
+    void setPending( int_type id );
+    void unsetPending( int_type id );
+
+    bool
+    overlapBBox( int_type id, BBox const & box ) const {
+      real_type const * bb = &bboxes[size_t(4*id)];
+      return bb[0] <= box.Xmax() && box.Xmin() <= bb[2] &&
+             bb[1] <= box.Ymax() && box.Ymin() <= bb[3];
+    }
+
+    void build_AABBtree() const;
+
+  public:
+
+        explicit
+    CurveScene( real_type _margin = 1 );
+
+    ~CurveScene();
+
+    void clear();
+
+    //! enlargement of the bbox used in the AABB tree
+    real_type Margin() const { return margin; }
+
+    //! set the enlargement of the bbox used in the AABB tree
+    void setMargin( real_type _margin );
+
+    /*!
+     * Insert a curve in the scene
+     *
+     * \param C the curve (only the pointer is stored)
+     * \return the id of the curve in the scene
+     */
+    int_type
+    insert( BaseCurve const & C );
+
+    //! remove the curve with id `id` from the scene
+    void
+    remove( int_type id );
+
+    /*!
+     * Notify that the curve with id `id` is changed (moved or modified).
+     * Nothing is done while the curve stays inside its enlarged bbox,
+     * otherwise the curve becomes pending.
+     */
+    void
+    moved( int_type id );
+
+    /*!
+     * Number of pending curves plus stale leaves that triggers the
+     * rebuild of the AABB tree: 16 or a quarter of the curves in the
+     * tree, whichever is greater.
+     */
+    int_type
+    rebuildThreshold() const;
+
+    //! number of curves in the scene
+    int_type
+    numCurves() const
+    { return int_type(curves.size() - freeSlots.size()); }
+
+    //! check if `id` is the id of a curve in the scene
+    bool
+    isValid( int_type id ) const {
+      return id >= 0 && id < int_type(curves.size()) &&
+             curves[size_t(id)] != nullptr;
+    }
+
+    //! the curve with id `id`
+    BaseCurve const &
+    get( int_type id ) const;
+
+    /*!
+     * Collect the curves of the scene that collide with the curve `C`
+     *
+     * \param[in]  C   curve to be checked
+     * \param[out] ids id of the curves that collide with `C`
+     */
+    void
+    collision( BaseCurve const & C, vector<int_type> & ids ) const;
+
+    /*!
+     * Collect the curves of the scene that collide with the curve `C`
+     * with offset `offs` (the curves of the scene are not offsetted)
+     *
+     * \param[in]  C    curve to be checked
+     * \param[in]  offs offset of the curve `C`
+     * \param[out] ids  id of the curves that collide with `C`
+     */
+    void
+    collision_ISO(
+      BaseCurve const  & C,
+      real_type          offs,
+      vector<int_type> & ids
+    ) const;
+
+    void
+    collision_SAE(
+      BaseCurve const  & C,
+      real_type          offs,
+      vector<int_type> & ids
+    ) const {
+      collision_ISO( C, -offs, ids );
+    }
+
+    /*!
+     * Collect all the pairs of colliding curves of the scene
+     *
+     * \param[out] pairs pairs `(id1,id2)` with `id1 < id2` of colliding curves
+     */
+    void
+    collisionPairs( vector<pair<int_type,int_type> > & pairs ) const;
+
+    void
+    info( ostream_type & stream ) const;
+
+  };
+
+}
+
+#endif
+
+///
+/// eof: CurveScene.hh
+///
@@ -0,0 +1,369 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: CurveStatic.hh
+///
+
+#ifndef CURVE_STATIC_HH
+#define CURVE_STATIC_HH
+
+#include "Line.hh"
+#include "Circle.hh"
+#include "Clothoid.hh"
+#include "Biarc.hh"
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace G2lib {
+
+  using std::vector;
+
+  /*\
+   |    ____                      ____  _        _   _
+   |   / ___|   _ _ ____   _____/ ___|| |_ __ _| |_(_) ___
+   |  | |  | | | | '__\ \ / / _ \___ \| __/ _` | __| |/ __|
+   |  | |__| |_| | |   \ V /  __/___) | || (_| | |_| | (__
+   |   \____\__,_|_|    \_/ \___|____/ \__\__,_|\__|_|\___|
+  \*/
+
+  //! \brief Algorithms on curves of a type known at compile time
+  /*!
+   * `CURVE` is one of `LineSegment`, `CircleArc`, `ClothoidCurve`
+   * or `Biarc`. The methods of the curve are called qualified
+   * (`C.CURVE::eval(...)`), so each call is resolved at compile time
+   * (no virtual dispatch). Only the methods defined in the headers
+   * (those of `LineSegment` and the simplest of `CircleArc`) are
+   * inlined, the Fresnel integrals of `ClothoidCurve` are computed in
+   * `Fresnel.cc`.
+   *
+   * The kernels are sampling, projection, bounding box and intersection
+   * on a single curve and on a vector of curves joined, the lists of
+   * curves (`ClothoidList`, `BiarcList`, `PolyLine`) and their AABB
+   * tree functors call them on their segments. The virtual methods of
+   * `BaseCurve` remain the interface for the curves of unknown type.
+   */
+  template <typename CURVE>
+  class CurveStatic {
+  public:
+
+    typedef CURVE curve_type;
+
+    //! as `BaseCurve::evaluate_ISO` with the calls resolved at compile time
+    static
+    void
+    evaluate_ISO(
+      CURVE const & C,
+      real_type     s,
+      real_type     offs,
+      real_type   & th,
+      real_type   & k,
+      real_type   & x,
+      real_type   & y
+    ) {
+      C.CURVE::eval_ISO( s, offs, x, y );
+      th = C.CURVE::theta( s );
+      k  = C.CURVE::theta_D( s );
+      k /= 1+offs*k; // scale curvature
+    }
+
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    //! evaluate the curve with offset `offs` at `s[i]`, `i=0..n-1`
+    static
+    void
+    sample_ISO(
+      CURVE const &   C,
+      real_type       offs,
+      int_type        n,
+      real_type const s[],
+      real_type       x[],
+      real_type       y[]
+    ) {
+      for ( int_type i = 0; i < n; ++i )
+        C.CURVE::eval_ISO( s[i], offs, x[i], y[i] );
+    }
+
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    /*!
+     * Segment of the curves joined (segment `i` starts at `s0[i]`, `ns`
+     * segments) containing `s`, `idx` is the segment of the previous
+     * abscissa: the current and the next segment are checked first,
+     * then a binary search is done. Outside the range the first/last
+     * segment is returned.
+     */
+    static
+    size_t
+    segment(
+      vector<real_type> const & s0,
+      size_t                    ns,
+      real_type                 s,
+      size_t                    idx
+    ) {
+      if ( s >= s0[idx] && s < s0[idx+1] ) return idx;
+      if ( idx+1 < ns && s >= s0[idx+1] && s < s0[idx+2] ) return idx+1;
+      vector<real_type>::const_iterator is =
+        std::upper_bound( s0.begin(), s0.begin()+std::ptrdiff_t(ns), s );
+      return is == s0.begin() ? 0 : size_t(is-s0.begin())-1;
+    }
+
+    /*!
+     * Evaluate the curves `V` joined (segment `i` starts at `s0[i]`)
+     * with offset `offs` at `s[i]`, `i=0..n-1`, outside the range the
+     * first/last segment is used. The abscissa in any order,
+     * increasing ones are the fastest.
+     */
+    static
+    void
+    sample_ISO(
+      vector<CURVE>     const & V,
+      vector<real_type> const & s0,
+      real_type                 offs,
+      int_type                  n,
+      real_type const           s[],
+      real_type                 x[],
+      real_type                 y[]
+    ) {
+      size_t ns  = V.size();
+      size_t idx = 0;
+      for ( int_type i = 0; i < n; ++i ) {
+        real_type ss = s[i];
+        idx = segment( s0, ns, ss, idx );
+        V[idx].CURVE::eval_ISO( ss - s0[idx], offs, x[i], y[i] );
+      }
+    }
+
+    //! as `sample_ISO` computing also angle and curvature
+    static
+    void
+    sample_ISO(
+      vector<CURVE>     const & V,
+      vector<real_type> const & s0,
+      real_type                 offs,
+      int_type                  n,
+      real_type const           s[],
+      real_type                 theta[],
+      real_type                 kappa[],
+      real_type                 x[],
+      real_type                 y[]
+    ) {
+      size_t ns  = V.size();
+      size_t idx = 0;
+      for ( int_type i = 0; i < n; ++i ) {
+        real_type ss = s[i];
+        idx = segment( s0, ns, ss, idx );
+        evaluate_ISO(
+          V[idx], ss - s0[idx], offs, theta[i], kappa[i], x[i], y[i]
+        );
+      }
+    }
+
+    /*\
+     |       _                     _   ____       _       _
+     |   ___| | ___  ___  ___  ___| |_|  _ \ ___ (_)_ __ | |_
+     |  / __| |/ _ \/ __|/ _ \/ __| __| |_) / _ \| | '_ \| __|
+     | | (__| | (_) \__ \  __/\__ \ |_|  __/ (_) | | | | | |_
+     |  \___|_|\___/|___/\___||___/\__|_|   \___/|_|_| |_|\__|
+    \*/
+
+    //! as `BaseCurve::closestPoint_ISO` with the call resolved at compile time
+    static
+    int_type
+    closestPoint_ISO(
+      CURVE const & C,
+      real_type     qx,
+      real_type     qy,
+      real_type     offs,
+      real_type   & x,
+      real_type   & y,
+      real_type   & s,
+      real_type   & t,
+      real_type   & dst
+    ) {
+      return C.CURVE::closestPoint_ISO( qx, qy, offs, x, y, s, t, dst );
+    }
+
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    //! distance of the points `(qx[i],qy[i])`, `i=0..n-1`, from the curve with offset `offs`
+    static
+    void
+    distance_ISO(
+      CURVE const &   C,
+      real_type       offs,
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type       dst[]
+    ) {
+      for ( int_type i = 0; i < n; ++i ) {
+        real_type x, y, s, t;
+        C.CURVE::closestPoint_ISO( qx[i], qy[i], offs, x, y, s, t, dst[i] );
+      }
+    }
+
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    /*!
+     * Closest point of the curves `V` joined (segment `i` starts at
+     * `s0[i]`) with offset `offs`, all the segments are checked.
+     * `s` is the abscissa on the curves joined, the segment of the
+     * closest point is returned (the first one for equal distances).
+     */
+    static
+    size_t
+    closestPoint_ISO(
+      vector<CURVE>     const & V,
+      vector<real_type> const & s0,
+      real_type                 qx,
+      real_type                 qy,
+      real_type                 offs,
+      real_type               & x,
+      real_type               & y,
+      real_type               & s,
+      real_type               & t,
+      real_type               & dst
+    ) {
+      size_t ipos = 0;
+      dst = std::numeric_limits<real_type>::infinity();
+      for ( size_t i = 0; i < V.size(); ++i ) {
+        real_type x1, y1, s1, t1, dst1;
+        V[i].CURVE::closestPoint_ISO( qx, qy, offs, x1, y1, s1, t1, dst1 );
+        if ( dst1 < dst ) {
+          dst  = dst1;
+          x    = x1;
+          y    = y1;
+          s    = s0[i] + s1;
+          t    = t1;
+          ipos = i;
+        }
+      }
+      return ipos;
+    }
+
+    /*\
+     |   _     _
+     |  | |__ | |__   _____  __
+     |  | '_ \| '_ \ / _ \ \/ /
+     |  | |_) | |_) | (_) >  <
+     |  |_.__/|_.__/ \___/_/\_\
+    \*/
+
+    //! as `BaseCurve::bbox_ISO` with the call resolved at compile time
+    static
+    void
+    bbox_ISO(
+      CURVE const & C,
+      real_type     offs,
+      real_type   & xmin,
+      real_type   & ymin,
+      real_type   & xmax,
+      real_type   & ymax
+    ) {
+      C.CURVE::bbox_ISO( offs, xmin, ymin, xmax, ymax );
+    }
+
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    //! bounding box of the curves `V` with offset `offs` (union of the bbox of each curve)
+    static
+    void
+    bbox_ISO(
+      vector<CURVE> const & V,
+      real_type             offs,
+      real_type           & xmin,
+      real_type           & ymin,
+      real_type           & xmax,
+      real_type           & ymax
+    ) {
+      xmin = ymin = std::numeric_limits<real_type>::infinity();
+      xmax = ymax = -xmin;
+      typename vector<CURVE>::const_iterator ic;
+      for ( ic = V.begin(); ic != V.end(); ++ic ) {
+        real_type xmi1, ymi1, xma1, yma1;
+        ic->CURVE::bbox_ISO( offs, xmi1, ymi1, xma1, yma1 );
+        if ( xmi1 < xmin ) xmin = xmi1;
+        if ( xma1 > xmax ) xmax = xma1;
+        if ( ymi1 < ymin ) ymin = ymi1;
+        if ( yma1 > ymax ) ymax = yma1;
+      }
+    }
+
+    /*\
+     |   _       _                          _
+     |  (_)_ __ | |_ ___ _ __ ___  ___  ___| |_
+     |  | | '_ \| __/ _ \ '__/ __|/ _ \/ __| __|
+     |  | | | | | ||  __/ |  \__ \  __/ (__| |_
+     |  |_|_| |_|\__\___|_|  |___/\___|\___|\__|
+    \*/
+
+    //! as `collision_ISO` of the curves with the call resolved at compile time
+    static
+    bool
+    collision_ISO(
+      CURVE const & C1,
+      real_type     offs1,
+      CURVE const & C2,
+      real_type     offs2
+    ) {
+      return C1.CURVE::collision_ISO( offs1, C2, offs2 );
+    }
+
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    /*!
+     * Intersections of `C1` and `C2` with offset, appended to `ilist`
+     * with the abscissa shifted by `s1` and `s2` (the start of the
+     * curves in their lists), swapped if `swap_s_vals`.
+     */
+    static
+    void
+    intersect_ISO(
+      CURVE const   & C1,
+      real_type       s1,
+      real_type       offs1,
+      CURVE const   & C2,
+      real_type       s2,
+      real_type       offs2,
+      IntersectList & ilist,
+      bool            swap_s_vals
+    ) {
+      size_t n0 = ilist.size();
+      C1.CURVE::intersect_ISO( offs1, C2, offs2, ilist, false );
+      for ( size_t i = n0; i < ilist.size(); ++i ) {
+        Ipair & ip = ilist[i];
+        ip.first  += s1;
+        ip.second += s2;
+        if ( swap_s_vals ) std::swap( ip.first, ip.second );
+      }
+    }
+
+  };
+
+}
+
+#endif
+
+///
+/// eof: CurveStatic.hh
+///
@@ -0,0 +1,485 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "Footprint.hh"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#endif
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#endif
+
+// Workaround for Visual Studio
+#ifdef min
+  #undef min
+#endif
+
+#ifdef max
+  #undef max
+#endif
+
+namespace G2lib {
+
+  using std::vector;
+  using std::numeric_limits;
+  using std::min;
+  using std::max;
+  using std::abs;
+  using std::sqrt;
+
+  /*\
+   |   _____           _             _       _
+   |  |  ___|__   ___ | |_ _ __  _ __(_)_ __ | |_
+   |  | |_ / _ \ / _ \| __| '_ \| '__| | '_ \| __|
+   |  |  _| (_) | (_) | |_| |_) | |  | | | | | |_
+   |  |_|  \___/ \___/ \__| .__/|_|  |_|_| |_|\__|
+   |                      |_|
+  \*/
+
+  void
+  Footprint::setRectangle(
+    real_type front,
+    real_type rear,
+    real_type left,
+    real_type right
+  ) {
+    G2LIB_ASSERT(
+      front+rear > 0 && left+right > 0,
+      "Footprint::setRectangle( front = " << front << ", rear = " << rear <<
+      ", left = " << left << ", right = " << right << " ) empty rectangle"
+    );
+    real_type u[] = { -rear, front, front, -rear };
+    real_type v[] = { -right, -right, left, left };
+    setPolygon( 4, u, v );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Footprint::setPolygon(
+    int_type        n,
+    real_type const u[],
+    real_type const v[]
+  ) {
+    G2LIB_ASSERT(
+      n >= 3, "Footprint::setPolygon( n = " << n << ", ...) n must be >= 3"
+    );
+    U.assign( u, u+n );
+    V.assign( v, v+n );
+    radius = 0;
+    for ( int_type i = 0; i < n; ++i )
+      radius = max( radius, hypot( u[i], v[i] ) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Footprint::pose(
+    real_type x,
+    real_type y,
+    real_type theta,
+    real_type X[],
+    real_type Y[]
+  ) const {
+    real_type C = cos(theta);
+    real_type S = sin(theta);
+    for ( size_t i = 0; i < U.size(); ++i ) {
+      X[i] = x + C * U[i] - S * V[i];
+      Y[i] = y + S * U[i] + C * V[i];
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Footprint::info( ostream_type & stream ) const {
+    stream << "Footprint, radius = " << radius << '\n';
+    for ( size_t i = 0; i < U.size(); ++i )
+      stream << "  ( " << U[i] << ", " << V[i] << " )\n";
+  }
+
+  /*\
+   |   ____
+   |  / ___|_      _____  ___ _ __
+   |  \___ \ \ /\ / / _ \/ _ \ '_ \
+   |   ___) \ V  V /  __/  __/ |_) |
+   |  |____/ \_/\_/ \___|\___| .__/
+   |                         |_|
+  \*/
+
+  //! projection of the polygon on the axis `(ax,ay)`
+  static
+  inline
+  void
+  project(
+    int_type        n,
+    real_type const X[],
+    real_type const Y[],
+    real_type       ax,
+    real_type       ay,
+    real_type     & pmin,
+    real_type     & pmax
+  ) {
+    pmin = pmax = X[0]*ax + Y[0]*ay;
+    for ( int_type i = 1; i < n; ++i ) {
+      real_type p = X[i]*ax + Y[i]*ay;
+      if      ( p < pmin ) pmin = p;
+      else if ( p > pmax ) pmax = p;
+    }
+  }
+
+  //! true if an edge of the first polygon is a separating axis
+  static
+  bool
+  separatingAxis(
+    int_type        n1,
+    real_type const X1[],
+    real_type const Y1[],
+    int_type        n2,
+    real_type const X2[],
+    real_type const Y2[]
+  ) {
+    for ( int_type i = 0, j = n1-1; i < n1; j = i++ ) {
+      real_type ax = Y1[i] - Y1[j];
+      real_type ay = X1[j] - X1[i];
+      real_type min1, max1, min2, max2;
+      project( n1, X1, Y1, ax, ay, min1, max1 );
+      project( n2, X2, Y2, ax, ay, min2, max2 );
+      if ( max1 < min2 || max2 < min1 ) return true;
+    }
+    return false;
+  }
+
+  //! distance of the point `(px,py)` from the segment `(ax,ay)-(bx,by)`
+  static
+  real_type
+  pointSegmentDistance(
+    real_type px, real_type py,
+    real_type ax, real_type ay,
+    real_type bx, real_type by
+  ) {
+    real_type dx = bx - ax;
+    real_type dy = by - ay;
+    real_type d2 = dx*dx + dy*dy;
+    real_type t  = 0;
+    if ( d2 > 0 ) {
+      t = ( (px-ax)*dx + (py-ay)*dy ) / d2;
+      if      ( t < 0 ) t = 0;
+      else if ( t > 1 ) t = 1;
+    }
+    return hypot( px - ax - t*dx, py - ay - t*dy );
+  }
+
+  //! minimum distance of the vertices of the first polygon from the edges of the second
+  static
+  real_type
+  vertexEdgeDistance(
+    int_type        n1,
+    real_type const X1[],
+    real_type const Y1[],
+    int_type        n2,
+    real_type const X2[],
+    real_type const Y2[]
+  ) {
+    real_type dst = numeric_limits<real_type>::infinity();
+    for ( int_type k = 0; k < n1; ++k )
+      for ( int_type i = 0, j = n2-1; i < n2; j = i++ )
+        dst = min( dst, pointSegmentDistance( X1[k], Y1[k],
+                                              X2[j], Y2[j], X2[i], Y2[i] ) );
+    return dst;
+  }
+
+  //! distance between two convex polygons (0 if they overlap)
+  static
+  real_type
+  polygonDistance(
+    int_type        n1,
+    real_type const X1[],
+    real_type const Y1[],
+    int_type        n2,
+    real_type const X2[],
+    real_type const Y2[]
+  ) {
+    if ( !separatingAxis( n1, X1, Y1, n2, X2, Y2 ) &&
+         !separatingAxis( n2, X2, Y2, n1, X1, Y1 ) ) return 0;
+    return min( vertexEdgeDistance( n1, X1, Y1, n2, X2, Y2 ),
+                vertexEdgeDistance( n2, X2, Y2, n1, X1, Y1 ) );
+  }
+
+  static
+  real_type
+  triangleDistance(
+    int_type           n,
+    real_type const    X[],
+    real_type const    Y[],
+    Triangle2D const & T
+  ) {
+    real_type TX[3] = { T.x1(), T.x2(), T.x3() };
+    real_type TY[3] = { T.y1(), T.y2(), T.y3() };
+    return polygonDistance( n, X, Y, 3, TX, TY );
+  }
+
+  //! true if the point `(px,py)` is inside the convex polygon
+  static
+  bool
+  insidePolygon(
+    real_type       px,
+    real_type       py,
+    int_type        n,
+    real_type const X[],
+    real_type const Y[]
+  ) {
+    bool pos = false, neg = false;
+    for ( int_type i = 0, j = n-1; i < n; j = i++ ) {
+      real_type c = (X[i]-X[j])*(py-Y[j]) - (Y[i]-Y[j])*(px-X[j]);
+      if ( c > 0 ) pos = true;
+      if ( c < 0 ) neg = true;
+    }
+    return !( pos && neg );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  //! triangle of an obstacle that may be hit by the footprint
+  class SweepCandidate {
+  public:
+    Triangle2D            T;
+    ClothoidCurve const * pC;
+    int_type              iobstacle;
+    SweepCandidate(
+      Triangle2D const &    _T,
+      ClothoidCurve const * _pC,
+      int_type              _iobstacle
+    )
+    : T(_T), pC(_pC), iobstacle(_iobstacle)
+    {}
+  };
+
+  //! buffers of the sweep shared by all the levels of the bisection
+  class SweepWorkspace {
+  public:
+    vector<SweepCandidate> candidates;
+    vector<int_type>       active; //!< stack of the active candidates of each level
+    vector<real_type>      X, Y;   //!< footprint at the current pose
+    vector<Triangle2D>     tvec;
+    ClothoidCurve          O, E;
+  };
+
+  /*!
+   * Exact check: the footprint posed in `(X,Y)` overlaps the piece of
+   * obstacle covered by the triangle `T`.
+   */
+  static
+  bool
+  footprintOverlap(
+    int_type               n,
+    SweepWorkspace       & ws,
+    SweepCandidate const & c
+  ) {
+    ws.O.copy( *c.pC );
+    ws.O.trim( c.T.S0(), c.T.S1() );
+    if ( insidePolygon( ws.O.xBegin(), ws.O.yBegin(), n, &ws.X.front(), &ws.Y.front() ) )
+      return true;
+    for ( int_type i = 0, j = n-1; i < n; j = i++ ) {
+      real_type dx = ws.X[i]-ws.X[j];
+      real_type dy = ws.Y[i]-ws.Y[j];
+      ws.E.build( ws.X[j], ws.Y[j], atan2( dy, dx ), 0, 0, hypot( dx, dy ) );
+      if ( ws.O.collision( ws.E ) ) return true;
+    }
+    return false;
+  }
+
+  /*!
+   * Bisect the interval `[a,b]` of the clothoid `C` with the candidates
+   * `ws.active[ibegin..iend)`. Return 1 if the footprint overlaps an
+   * obstacle at one of the poses checked in the first subinterval (of
+   * size less than `tol`) where it is closer to an obstacle than the
+   * motion bound, 2 if no overlap is found there, 0 if there is no
+   * such subinterval.
+   */
+  static
+  int_type
+  sweepBisect(
+    ClothoidCurve  const & C,
+    real_type              a,
+    real_type              b,
+    Footprint      const & fp,
+    SweepWorkspace       & ws,
+    size_t                 ibegin,
+    size_t                 iend,
+    real_type              tol,
+    real_type            & s,
+    int_type             & iobstacle
+  ) {
+    real_type h = (b-a)/2;
+    real_type m = a+h;
+
+    // the points of the footprint for s in [a,b] are within `delta`
+    // of the footprint at s = m, the curvature is linear in s
+    real_type kmax  = max( abs(C.kappa(a)), abs(C.kappa(b)) );
+    real_type delta = h*(1+fp.Radius()*kmax);
+
+    int_type  n = fp.numVertex();
+    real_type xm, ym;
+    C.eval( m, xm, ym );
+    fp.pose( xm, ym, C.theta(m), &ws.X.front(), &ws.Y.front() );
+
+    // the active candidates of this level are pushed on top of the stack
+    size_t first = ws.active.size();
+    for ( size_t k = ibegin; k < iend; ++k ) {
+      int_type ic = ws.active[k];
+      if ( triangleDistance( n, &ws.X.front(), &ws.Y.front(),
+                             ws.candidates[size_t(ic)].T ) <= delta )
+        ws.active.push_back( ic );
+    }
+    size_t last = ws.active.size();
+    if ( first == last ) return 0;
+
+    int_type res = 0;
+    if ( 2*h > tol ) {
+      res = sweepBisect( C, a, m, fp, ws, first, last, tol, s, iobstacle );
+      if ( res == 0 )
+        res = sweepBisect( C, m, b, fp, ws, first, last, tol, s, iobstacle );
+      ws.active.resize( first );
+      return res;
+    }
+
+    // final check on a covering of the obstacle with triangles
+    // thinner than `tol`
+    for ( size_t k = first; k < last && res == 0; ++k ) {
+      SweepCandidate const & c = ws.candidates[size_t(ws.active[k])];
+      ws.O.copy( *c.pC );
+      ws.O.trim( c.T.S0(), c.T.S1() );
+      real_type ko = max( abs(ws.O.kappaBegin()), abs(ws.O.kappaEnd()) );
+      real_type max_size = ko > 0 ? 2*sqrt(tol/ko) : ws.O.length();
+      ws.tvec.clear();
+      ws.O.bbTriangles_ISO( 0, ws.tvec, m_pi/18, max_size );
+      vector<Triangle2D>::const_iterator it;
+      for ( it = ws.tvec.begin(); it != ws.tvec.end(); ++it ) {
+        if ( triangleDistance( n, &ws.X.front(), &ws.Y.front(), *it ) <= delta ) {
+          s         = a;
+          iobstacle = c.iobstacle;
+          res       = 2;
+          break;
+        }
+      }
+    }
+
+    // possible contact, check the footprint at a, m and b
+    real_type const ss[3] = { a, m, b };
+    for ( int_type i = 0; i < 3 && res == 2; ++i ) {
+      real_type x, y;
+      C.eval( ss[i], x, y );
+      fp.pose( x, y, C.theta(ss[i]), &ws.X.front(), &ws.Y.front() );
+      for ( size_t k = first; k < last; ++k ) {
+        SweepCandidate const & c = ws.candidates[size_t(ws.active[k])];
+        if ( footprintOverlap( n, ws, c ) ) {
+          s         = ss[i];
+          iobstacle = c.iobstacle;
+          res       = 1;
+          break;
+        }
+      }
+    }
+    ws.active.resize( first );
+    return res;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidList::footprintCollision(
+    Footprint                    const & fp,
+    vector<ClothoidList const *> const & obstacles,
+    real_type                            tol,
+    real_type                          & s,
+    int_type                           & iobstacle
+  ) const {
+    G2LIB_ASSERT(
+      tol > 0,
+      "ClothoidList::footprintCollision( ..., tol = " << tol << ", ...) bad tolerance"
+    );
+    G2LIB_ASSERT(
+      fp.numVertex() >= 3,
+      "ClothoidList::footprintCollision, empty footprint"
+    );
+
+    vector<ClothoidList const *>::const_iterator io;
+    for ( io = obstacles.begin(); io != obstacles.end(); ++io )
+      (*io)->build_AABBtree_ISO( 0 );
+
+    // the footprint is in a circle of radius `R` around the curve point,
+    // the curve is inside the triangles
+    real_type R = fp.Radius();
+    vector<Triangle2D> ptri;
+    bbTriangles_ISO( 0, ptri, m_pi/18, 1e100 );
+
+    SweepWorkspace ws;
+    ws.X.resize( size_t(fp.numVertex()) );
+    ws.Y.resize( size_t(fp.numVertex()) );
+
+    AABBtree::VecPtrBBox candidateList;
+    vector<Triangle2D>::const_iterator it;
+    for ( it = ptri.begin(); it != ptri.end(); ++it ) {
+      real_type xmin, ymin, xmax, ymax;
+      it->bbox( xmin, ymin, xmax, ymax );
+      BBox box( xmin-R, ymin-R, xmax+R, ymax+R, G2LIB_CLOTHOID, 0 );
+
+      ws.candidates.clear();
+      ws.active.clear();
+      for ( io = obstacles.begin(); io != obstacles.end(); ++io ) {
+        ClothoidList const & O = **io;
+        candidateList.clear();
+        O.aabb_tree.within_distance( box, 0, candidateList );
+        AABBtree::VecPtrBBox::const_iterator ic;
+        for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
+          Triangle2D const & T = O.aabb_tri[size_t((*ic)->Ipos())];
+          ws.active.push_back( int_type(ws.candidates.size()) );
+          ws.candidates.push_back( SweepCandidate(
+            T, &O.clotoidList[size_t(T.Icurve())], int_type(io-obstacles.begin())
+          ) );
+        }
+      }
+      if ( ws.candidates.empty() ) continue;
+
+      int_type ipos = it->Icurve();
+      int_type res  = sweepBisect(
+        clotoidList[size_t(ipos)], it->S0(), it->S1(),
+        fp, ws, 0, ws.active.size(), tol, s, iobstacle
+      );
+      if ( res != 0 ) {
+        s += s0[size_t(ipos)];
+        return res;
+      }
+    }
+    return 0;
+  }
+
+}
+
+///
+/// eof: Footprint.cc
+///
@@ -0,0 +1,133 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: Footprint.hh
+///
+
+#ifndef FOOTPRINT_HH
+#define FOOTPRINT_HH
+
+#include "ClothoidList.hh"
+
+#include <vector>
+
+namespace G2lib {
+
+  using std::vector;
+
+  /*\
+   |   _____           _             _       _
+   |  |  ___|__   ___ | |_ _ __  _ __(_)_ __ | |_
+   |  | |_ / _ \ / _ \| __| '_ \| '__| | '_ \| __|
+   |  |  _| (_) | (_) | |_| |_) | |  | | | | | |_
+   |  |_|  \___/ \___/ \__| .__/|_|  |_|_| |_|\__|
+   |                      |_|
+  \*/
+
+  //! \brief Convex polygon (e.g. a vehicle) moving along a curve
+  /*!
+   * The vertices are given in the local frame of the moving point,
+   * `u` along the tangent and `v` along the normal (to the left).
+   */
+  class Footprint {
+    vector<real_type> U;
+    vector<real_type> V;
+    real_type         radius; //!< max distance of the vertices from the origin
+
+  public:
+
+    Footprint() : radius(0) {}
+
+    //! rectangle `[-rear,front] x [-right,left]`
+    Footprint(
+      real_type front,
+      real_type rear,
+      real_type left,
+      real_type right
+    ) : radius(0)
+    { setRectangle( front, rear, left, right ); }
+
+    //! rectangle `[-rear,front] x [-right,left]`
+    void
+    setRectangle(
+      real_type front,
+      real_type rear,
+      real_type left,
+      real_type right
+    );
+
+    //! convex polygon with vertices `(u[i],v[i])`
+    void
+    setPolygon(
+      int_type        n,
+      real_type const u[],
+      real_type const v[]
+    );
+
+    int_type
+    numVertex() const
+    { return int_type(U.size()); }
+
+    //! max distance of the polygon from the origin of the local frame
+    real_type
+    Radius() const
+    { return radius; }
+
+    //! vertices of the polygon with the origin at `(x,y)` rotated of `theta`
+    void
+    pose(
+      real_type x,
+      real_type y,
+      real_type theta,
+      real_type X[],
+      real_type Y[]
+    ) const;
+
+    void
+    info( ostream_type & stream ) const;
+
+  };
+
+  /*!
+   * Sweep the footprint along the curve `C` and find the first
+   * contact with the obstacles (see `ClothoidList::footprintCollision`
+   * for the return code)
+   */
+  inline
+  int_type
+  footprintCollision(
+    ClothoidCurve                const & C,
+    Footprint                    const & fp,
+    vector<ClothoidList const *> const & obstacles,
+    real_type                            tol,
+    real_type                          & s,
+    int_type                           & iobstacle
+  ) {
+    ClothoidList CL( C );
+    return CL.footprintCollision( fp, obstacles, tol, s, iobstacle );
+  }
+
+}
+
+#endif
+
+///
+/// eof: Footprint.hh
+///
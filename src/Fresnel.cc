@@ -140,6 +140,14 @@ namespace G2lib {
   //  #       #    # ######  ####  #    # ###### ######
   */
 
+  #ifdef G2LIB_FRESNEL_TABLE
+
+  void
+  FresnelCS( real_type y, real_type & C, real_type & S )
+  { FresnelCS_table( y, C, S ); }
+
+  #else
+
   void
   FresnelCS( real_type y, real_type & C, real_type & S ) {
     /*=======================================================*\
@@ -295,6 +303,370 @@ namespace G2lib {
     if ( y < 0 ) { C = -C; S = -S; }
   }
 
+  #endif
+
+  /*\
+   |   _____                         _  ____ ____    _        _     _
+   |  |  ___| __ ___  ___ _ __   ___| |/ ___/ ___|  | |_ __ _| |__ | | ___
+   |  | |_ | '__/ _ \/ __| '_ \ / _ \ | |   \___ \  | __/ _` | '_ \| |/ _ \
+   |  |  _|| | |  __/\__ \ | | |  __/ | |___ ___) | | || (_| | |_) | |  __/
+   |  |_|  |_|  \___||___/_| |_|\___|_|\____|____/___\__\__,_|_.__/|_|\___|
+   |                                            |_____|
+  \*/
+
+  //! \cond NODOC
+
+  // C(x)/x and S(x)/x^3 for 0 <= x < 1, Taylor polynomials in x^4
+  // (truncation error below 1e-17)
+  static const real_type fresnel_C0[] = {
+     1.00000000000000000e+00, -2.46740110027233978e-01,  2.81855008778942248e-02,
+    -1.60488313564253549e-03,  5.40741338140839160e-05, -1.20009725586002882e-06,
+     1.88434991152726863e-08, -2.20227692544546630e-10,  1.98968579241802189e-12,
+    -1.43091897317151983e-14,  8.38472970511855409e-17
+  };
+
+  static const real_type fresnel_S0[] = {
+     5.23598775598298927e-01, -9.22805853580351831e-02,  7.24478420419700370e-03,
+    -3.12116942354579222e-04,  8.44427288354525436e-06, -1.56471445009221090e-07,
+     2.10821219332145456e-09, -2.15743068058434439e-11,  1.73341020888748457e-13,
+    -1.12232447879839548e-15,  5.98005323921040462e-18
+  };
+
+  // auxiliary functions f(x) and g(x) for 1 <= x < 6:
+  // C(x) = 1/2 + f(x) sin(pi/2 x^2) - g(x) cos(pi/2 x^2)
+  // S(x) = 1/2 - f(x) cos(pi/2 x^2) - g(x) sin(pi/2 x^2)
+  // 20 intervals of width 1/4, on each interval a polynomial of degree 10
+  // in u in [-1,1] (Chebyshev interpolant of f and g computed with
+  // 400 bit arithmetic, max error 6e-17)
+  static const real_type fresnel_f_tab[20][11] = {
+    { // [1,1.25]
+       2.57060674735582195e-01, -2.14578297267455260e-02,  1.33360764470113156e-03,
+      -4.40131631017278297e-05, -2.17103636431485129e-06,  5.02364921858334978e-07,
+      -4.81825150769511264e-08,  3.16180792838719255e-09, -1.44598202842605624e-10,
+       3.25058046948226178e-12,  1.50144947358793330e-13
+    },
+    { // [1.25,1.5]
+       2.19105965463994079e-01, -1.66888155586481200e-02,  1.04793116955919459e-03,
+      -4.74653430692190771e-05,  6.99540369619666902e-07,  1.32304811875596746e-07,
+      -1.76534115371868737e-08,  1.37808875541361789e-09, -7.88857457151573043e-11,
+       3.27918552577846635e-12, -7.41575264218736615e-14
+    },
+    { // [1.5,1.75]
+       1.89554790664076933e-01, -1.30365510042618604e-02,  7.87074589842434681e-04,
+      -3.87545571551538022e-05,  1.27308016707987276e-06,  6.86634935301476870e-09,
+      -5.25471202796632114e-09,  5.12601293989838089e-10, -3.40187412424584631e-11,
+       1.74124500585091102e-12, -6.68652542205948477e-14
+    },
+    { // [1.75,2]
+       1.66340260990671091e-01, -1.03128298730229533e-02,  5.84680134799235433e-04,
+      -2.89015414366838412e-05,  1.13806032908715200e-06, -2.53629136983998365e-08,
+      -9.22602352830279760e-10,  1.62500097450224306e-10, -1.27300659138481474e-11,
+       7.42259596202919770e-13, -3.42833867355106550e-14
+    },
+    { // [2,2.25]
+       1.47839465644974327e-01, -8.28665476708775536e-03,  4.36423309686346573e-04,
+      -2.08875066184748005e-05,  8.62886114452709945e-07, -2.72396634980627509e-08,
+       3.24802485797388577e-10,  3.81688144435626621e-11, -4.18402513338166353e-12,
+       2.78365025081696112e-13, -1.43833028053685798e-14
+    },
+    { // [2.25,2.5]
+       1.32857708535391750e-01, -6.76610267676466554e-03,  3.29725594639588171e-04,
+      -1.50068673293985280e-05,  6.16925509587624839e-07, -2.15518512372491959e-08,
+       5.36248179060927951e-10,  5.51234713792617202e-14, -1.12361417659591320e-12,
+       9.36467909800101644e-14, -5.37885050370224742e-15
+    },
+    { // [2.5,2.75]
+       1.20533565852655192e-01, -5.60916321455888229e-03,  2.52893551408619522e-04,
+      -1.08492928174853119e-05,  4.32651356264225729e-07, -1.54648218674084363e-08,
+       4.58854534799722731e-10, -8.56885378867684895e-12, -1.49097678541956067e-13,
+       2.71771398957397990e-14, -1.83356201233724083e-15
+    },
+    { // [2.75,3]
+       1.10246475077859771e-01, -4.71508870278779853e-03,  1.97048446513417374e-04,
+      -7.93820348298768976e-06,  3.03055726546856299e-07, -1.07031614483940133e-08,
+       3.35331435388358404e-10, -8.42229590239596805e-12,  1.04082731569531337e-13,
+       5.45943902842545690e-15, -5.57301819083213536e-16
+    },
+    { // [3,3.25]
+       1.01545512632988055e-01, -4.01325110126676647e-03,  1.55911335649816025e-04,
+      -5.89273945037517809e-06,  2.13917751573758619e-07, -7.33284233824407399e-09,
+       2.31224862855939207e-10, -6.37750552459167832e-12,  1.33791321044817863e-13,
+      -6.65849359904285810e-16, -1.33585966674915863e-16
+    },
+    { // [3.25,3.5]
+       9.40987159063731426e-02, -3.45401821851890707e-03,  1.25153741181889788e-04,
+      -4.44105217889160688e-06,  1.52822761899209037e-07, -5.03612845146407410e-09,
+       1.56136207589839441e-10, -4.42167452267625889e-12,  1.07440854537839753e-13,
+      -1.82050424062791191e-15, -7.90356964350620043e-18
+    },
+    { // [3.5,3.75]
+       8.76580594780214523e-02, -3.00218033879359747e-03,  1.01806969535048851e-04,
+      -3.39722687671564325e-06,  1.10704537891707754e-07, -3.48946299031066872e-09,
+       1.05043290885348592e-10, -2.96256325791319799e-12,  7.56382020986421104e-14,
+      -1.61237669738278295e-15,  2.09686265969311925e-17
+    },
+    { // [3.75,4]
+       8.20354148354733304e-02, -2.63243688006998058e-03,  8.38247080512076877e-05,
+      -2.63589399832931463e-06,  8.13614900664159597e-08, -2.44698920525926707e-09,
+       7.10284917265257348e-11, -1.96346774169768253e-12,  5.06001007397069707e-14,
+      -1.16727007653743007e-15,  2.17884746240277269e-17
+    },
+    { // [4,4.25]
+       7.70859805426156591e-02, -2.32634816022770979e-03,  6.97820736166464062e-05,
+      -2.07253190263224441e-06,  6.06557863845275093e-08, -1.73909363632497232e-09,
+       4.84926549365495341e-11, -1.30224900423797067e-12,  3.32004284759723966e-14,
+      -7.84929277321844589e-16,  1.64802404937927731e-17
+    },
+    { // [4.25,4.5]
+       7.26967500479475393e-02, -2.07027963146612804e-03,  5.86743127711912920e-05,
+      -1.64976427270143143e-06,  4.58440105748556584e-08, -1.25315385923632638e-09,
+       3.35036896099516076e-11, -8.69637599852273687e-13,  2.16915572424950320e-14,
+      -5.12257930867878976e-16,  1.12504849747273926e-17
+    },
+    { // [4.5,4.75]
+       6.87783853633886638e-02, -1.85400673142563865e-03,  4.97832242045839155e-05,
+      -1.32822846687716188e-06,  3.51015668612881540e-08, -9.15389335491273748e-10,
+       2.34487105610651959e-11, -5.86637750256073515e-13,  1.42246391355776482e-14,
+      -3.30932249302137577e-16,  7.37526812220071698e-18
+    },
+    { // [4.75,5]
+       6.52594127313389782e-02, -1.66975830403844690e-03,  4.25883173779682798e-05,
+      -1.08058441005626656e-06,  2.72050277693254165e-08, -6.77521874664887453e-10,
+       1.66290969505270261e-11, -4.00408816158277828e-13,  9.40310666828158689e-15,
+      -2.13791382199034001e-16,  4.76829780659691137e-18
+    },
+    { // [5,5.25]
+       6.20820193325501493e-02, -1.51155266574557866e-03,  3.67072676599792291e-05,
+      -8.87592866503957859e-07,  2.13251693463693629e-08, -5.07790248807209939e-10,
+       1.19472728910132730e-11, -2.76723743982380648e-13,  6.28047771518168913e-15,
+      -1.38881268236436532e-16,  3.08349195002071881e-18
+    },
+    { // [5.25,5.5]
+       5.91989680129329995e-02, -1.37473075127419390e-03,  3.18555833404669808e-05,
+      -7.35535971390644108e-07,  1.68931327258127984e-08, -3.85111637462187177e-10,
+       8.69242044024653981e-12, -1.93670768049517099e-13,  4.24341290970169100e-15,
+      -9.09968949704439373e-17,  2.01175401596395712e-18
+    },
+    { // [5.5,5.75]
+       5.65713030550932805e-02, -1.25562349192735127e-03,  2.78189570069646080e-05,
+      -6.14505900279988982e-07,  1.35137438005572456e-08, -2.95338967341144086e-10,
+       6.40102261411013737e-12, -1.37239461962812806e-13,  2.90167652613041804e-15,
+      -6.02348400384131734e-17,  1.33235332894868193e-18
+    },
+    { // [5.75,6]
+       5.41666230139301041e-02, -1.15131175166678580e-03,  2.44340732957026746e-05,
+      -5.17257304880148152e-07,  1.09090111190395823e-08, -2.28867040931770936e-10,
+       4.76796458216463177e-12, -9.84306498134902849e-14,  2.00826552475155754e-15,
+      -4.03127831822429336e-17,  9.00154754019545962e-19
+    }
+  };
+
+  static const real_type fresnel_g_tab[20][11] = {
+    { // [1,1.25]
+       4.85705908485080939e-02, -1.14340727267925185e-02,  1.56932879056583766e-03,
+      -1.54712981344237770e-04,  1.15047230878252563e-05, -6.23925090586639911e-07,
+       1.92279226838925555e-08,  4.81857419221068226e-10, -1.21041559901189268e-10,
+       1.02035183426310320e-11, -5.64037457883150619e-13
+    },
+    { // [1.25,1.5]
+       3.09074326168177482e-02, -6.69127178041845593e-03,  8.72012715168588763e-04,
+      -8.44560357047561064e-05,  6.45268890551020771e-06, -3.90444965961184618e-07,
+       1.76296793403302281e-08, -4.33981753378248195e-10, -1.53049639847384282e-11,
+       2.81373335286795018e-12, -2.10946292671674405e-13
+    },
+    { // [1.5,1.75]
+       2.04291104807176847e-02, -4.03826263376247732e-03,  4.92828207673626727e-04,
+      -4.58898548057688868e-05,  3.47618879932554016e-06, -2.17992311405832941e-07,
+       1.11456397950283041e-08, -4.30892101619800580e-10,  8.64702274108332502e-12,
+       3.94441518664492377e-13, -5.66709124154209429e-14
+    },
+    { // [1.75,2]
+       1.40060829999562111e-02, -2.52187298644501083e-03,  2.85880339237081426e-04,
+      -2.52411891878889955e-05,  1.85497563428748970e-06, -1.16147001016729488e-07,
+       6.19823624800243610e-09, -2.74905821649963960e-10,  9.29579420311308607e-12,
+      -1.52377850711479758e-13, -8.26246607913733036e-15
+    },
+    { // [2,2.25]
+       9.93025556990521224e-03, -1.63010240507556535e-03,  1.70979575124141322e-04,
+      -1.41937565547003905e-05,  9.98139174683306598e-07, -6.10494179983259458e-08,
+       3.27095280422171418e-09, -1.52297682982112032e-10,  5.97459875440162443e-12,
+      -1.79351509037468079e-13,  2.50572946696385018e-15
+    },
+    { // [2.25,2.5]
+       7.25462694045912564e-03, -1.08888717119290618e-03,  1.05581018087160029e-04,
+      -8.20277006339409222e-06,  5.47264401837325283e-07, -3.22531870131200120e-08,
+       1.69711723090590101e-09, -7.96836987913452924e-11,  3.29689150473166148e-12,
+      -1.16243209243111016e-13,  3.14724940662473686e-15
+    },
+    { // [2.5,2.75]
+       5.44137784201918079e-03, -7.49770861447724107e-04,  6.72776569777567423e-05,
+      -4.88253624732095787e-06,  3.07512860912777346e-07, -1.73142433155710747e-08,
+       8.82673773645175223e-10, -4.08747629032686848e-11,  1.71139351726418879e-12,
+      -6.39520593734753881e-14,  2.04455810036201003e-15
+    },
+    { // [2.75,3]
+       4.17630427361630977e-03, -5.30642619659164481e-04,  4.41647773876548518e-05,
+      -2.99391215854613857e-06,  1.77570749361843805e-07, -9.50254981897097331e-09,
+       4.65373057328611682e-10, -2.09710115204189942e-11,  8.68971524652082254e-13,
+      -3.29700481765780016e-14,  1.11933163712637091e-15
+    },
+    { // [3,3.25]
+       3.27029120325426480e-03, -3.84907619998103997e-04,  2.98018130783927354e-05,
+      -1.88933598713140218e-06,  1.05450127025582187e-07, -5.34851891644233734e-09,
+       2.50318608253332172e-10, -1.08848736052741952e-11,  4.40483881180508020e-13,
+      -1.65900541993050971e-14,  5.72939486479662447e-16
+    },
+    { // [3.25,3.5]
+       2.60609930906901969e-03, -2.85382276566208723e-04,  2.06221997324898383e-05,
+      -1.22501180350907597e-06,  6.43699124302517340e-08, -3.09091099569657750e-09,
+       1.37831598892380109e-10, -5.75337322884361669e-12,  2.25501846184237676e-13,
+      -8.31944763203540743e-15,  2.85840282185937390e-16
+    },
+    { // [3.5,3.75]
+       2.10896260842947112e-03, -2.15756955646999305e-04,  1.45993161564420486e-05,
+      -8.14494257367554085e-07,  4.03423461718544511e-08, -1.83385835731969933e-09,
+       7.78044150698636113e-11, -3.10797346183554709e-12,  1.17373704236951373e-13,
+      -4.20683906894492192e-15,  1.41945223366829271e-16
+    },
+    { // [3.75,4]
+       1.72992141147063462e-03, -1.65975718425945696e-04,  1.05506352644285456e-05,
+      -5.54211804031877625e-07,  2.59180670250244460e-08, -1.11612743064497928e-09,
+       4.50362418565002961e-11, -1.71879557619807396e-12,  6.23468568773093707e-14,
+      -2.15965738965849832e-15,  7.09904081454874783e-17
+    },
+    { // [4,4.25]
+       1.43612047147821231e-03, -1.29675694910088315e-04,  7.76786407774552602e-06,
+      -3.85167945807053003e-07,  1.70397142117211201e-08, -6.95970294449345554e-10,
+       2.67174161322055538e-11, -9.73582451530559973e-13,  3.38605474790537988e-14,
+      -1.12994710111933651e-15,  3.60015076315042092e-17
+    },
+    { // [4.25,4.5]
+       1.20501115220224622e-03, -1.02731934890752259e-04,  5.81594572121417464e-06,
+      -2.72904336543768068e-07,  1.14442725852571837e-08, -4.43984625939292978e-10,
+       1.62284982052305707e-11, -5.64676915732732106e-13,  1.88149369554483311e-14,
+      -6.03744082568768239e-16,  1.85860636061585791e-17
+    },
+    { // [4.5,4.75]
+       1.02079770233786250e-03, -8.24094252278928448e-05,  4.42120999012152143e-06,
+      -1.96798458993917467e-07,  7.83889867743553931e-09, -2.89325888802068523e-10,
+       1.00805972646211570e-11, -3.35105225172189219e-13,  1.06955717429955084e-14,
+      -3.29711553977130758e-16,  9.78862876913804124e-18
+    },
+    { // [4.75,5]
+       8.72206072964787468e-04, -6.68566725001111794e-05,  3.40761864130487083e-06,
+      -1.44217531802528189e-07,  5.46741905836002311e-09, -1.92307951228502950e-10,
+       6.39506080468527102e-12, -2.03271246113927258e-13,  6.21662840429548696e-15,
+      -1.84050894466127722e-16,  5.26437158315684589e-18
+    },
+    { // [5,5.25]
+       7.51051171893511119e-04, -5.47960927887109411e-05,  2.65955543846527165e-06,
+      -1.07250891919985142e-07,  3.87741419399218002e-09, -1.30188810094793130e-10,
+       4.13781409717444035e-12, -1.25888443868330087e-13,  3.69139263186643202e-15,
+      -1.04976431219264964e-16,  2.89176307200486441e-18
+    },
+    { // [5.25,5.5]
+       6.51297323120291274e-04, -4.53304779737289434e-05,  2.09960756443055796e-06,
+      -8.08414851206456703e-08,  2.79229382361133959e-09, -8.96459764278033361e-11,
+       2.72706856804445189e-12, -7.95044560808818531e-14,  2.23706118800839747e-15,
+      -6.11358020135620597e-17,  1.62206153392737232e-18
+    },
+    { // [5.5,5.75]
+       5.68430038478348739e-04, -3.78194736760910450e-05,  1.67500684191437185e-06,
+      -6.16934612045293665e-08,  2.03947647575721745e-09, -6.27084400133539264e-11,
+       1.82842543449001163e-12, -5.11417542727220482e-14,  1.38215052862062670e-15,
+      -3.63224726663453637e-17,  9.28606350496825478e-19
+    },
+    { // [5.75,6]
+       4.99028306566965383e-04, -3.17991917884348564e-05,  1.34918360950011226e-06,
+      -4.76197831480934266e-08,  1.50919124526018108e-09, -4.45103034322960301e-11,
+       1.24567574217042407e-12, -3.34686111311228559e-14,  8.69668357234468127e-16,
+      -2.19947717761218337e-17,  5.42194177915768269e-19
+    }
+  };
+
+  // asymptotic expansions of f(x) and g(x) for x >= 6, polynomials
+  // in 1/(pi x^2)^2 truncated to 10 terms (truncation error below 1e-17)
+  static const real_type fresnel_f_inf[] = {
+    1.0, -3.0, 105.0, -10395.0, 2027025.0, -654729075.0,
+    316234143225.0, -213458046676875.0, 191898783962510625.0,
+    -221643095476699771875.0
+  };
+
+  static const real_type fresnel_g_inf[] = {
+    1.0, -15.0, 945.0, -135135.0, 34459425.0, -13749310575.0,
+    7905853580625.0, -6190283353629375.0, 6332659870762850625.0,
+    -8200794532637891559375.0
+  };
+
+  //! \endcond
+
+  void
+  FresnelCS_table( real_type y, real_type & C, real_type & S ) {
+
+    real_type const x = y > 0 ? y : -y;
+
+    if ( x < 1 ) {
+
+      real_type const x2 = x*x;
+      real_type const t  = x2*x2;
+      real_type c = fresnel_C0[10];
+      real_type s = fresnel_S0[10];
+      for ( int_type k = 9; k >= 0; --k ) {
+        c = fresnel_C0[k] + t*c;
+        s = fresnel_S0[k] + t*s;
+      }
+      C = x*c;
+      S = (x*x2)*s;
+
+    } else {
+
+      real_type f, g;
+      if ( x < 6 ) {
+        // x-1 is exact, so is the interval index
+        int_type  const i  = int_type(4*(x-1));
+        real_type const u  = 8*(x-1)-(2*i+1);
+        real_type const * pf = fresnel_f_tab[i];
+        real_type const * pg = fresnel_g_tab[i];
+        f = pf[10];
+        g = pg[10];
+        for ( int_type k = 9; k >= 0; --k ) {
+          f = pf[k] + u*f;
+          g = pg[k] + u*g;
+        }
+      } else {
+        real_type const px = m_pi*x;
+        real_type const w  = 1/(px*x);
+        real_type const t  = w*w;
+        f = fresnel_f_inf[9];
+        g = fresnel_g_inf[9];
+        for ( int_type k = 8; k >= 0; --k ) {
+          f = fresnel_f_inf[k] + t*f;
+          g = fresnel_g_inf[k] + t*g;
+        }
+        f /= px;
+        g /= px*px*x;
+      }
+
+      // pi/2*x^2 reduced modulo 2*pi: x^2 = hi + lo exactly (Dekker),
+      // then hi reduced (exactly) modulo 4
+      real_type const split = 134217729.0; // 2^27+1
+      real_type const p  = split*x;
+      real_type const xh = p-(p-x);
+      real_type const xl = x-xh;
+      real_type hi = x*x;
+      real_type const lo = ((xh*xh-hi)+2*xh*xl)+xl*xl;
+      hi -= 4*floor(0.25*hi+0.5);
+
+      real_type U    = m_pi_2*(hi+lo);
+      real_type SinU = sin(U);
+      real_type CosU = cos(U);
+      C = 0.5 + f*SinU - g*CosU;
+      S = 0.5 - f*CosU - g*SinU;
+
+    }
+    if ( y < 0 ) { C = -C; S = -S; }
+  }
+
   // -------------------------------------------------------------------------
   // -------------------------------------------------------------------------
 
@@ -330,6 +702,7 @@ namespace G2lib {
     real_type & X,
     real_type & Y
   ) {
+    G2LIB_PERF_COUNT(fresnel_large);
     real_type s    = a > 0 ? +1 : -1;
     real_type absa = abs(a);
     real_type z    = m_1_sqrt_pi*sqrt(absa);
@@ -360,6 +733,7 @@ namespace G2lib {
     real_type X[],
     real_type Y[]
   ) {
+    G2LIB_PERF_COUNT(fresnel_large);
 
     G2LIB_ASSERT(
       nk < 4 && nk > 0,
@@ -432,6 +806,7 @@ namespace G2lib {
     real_type X[],
     real_type Y[]
   ) {
+    G2LIB_PERF_COUNT(fresnel_zero);
     real_type sb = sin(b);
     real_type cb = cos(b);
     real_type b2 = b*b;
@@ -481,6 +856,7 @@ namespace G2lib {
     real_type & X,
     real_type & Y
   ) {
+    G2LIB_PERF_COUNT(fresnel_small);
 
     G2LIB_ASSERT(
       p < 11 && p > 0,
@@ -518,6 +894,7 @@ namespace G2lib {
     real_type X[],
     real_type Y[]
   ) {
+    G2LIB_PERF_COUNT(fresnel_small);
 
     int_type  nkk = nk + 4*p + 2; // max 45
     real_type X0[45], Y0[45];
@@ -598,6 +975,112 @@ namespace G2lib {
     }
   }
 
+  // -------------------------------------------------------------------------
+  // -------------------------------------------------------------------------
+
+  //! \cond NODOC
+
+  // positive nodes and weights of the Gauss-Legendre rule of 16 nodes on [-1,1]
+  static const real_type gauss16_x[] = {
+    9.89400934991649938510e-01, 9.44575023073232600268e-01, 8.65631202387831755196e-01,
+    7.55404408355002998654e-01, 6.17876244402643770570e-01, 4.58016777657227369680e-01,
+    2.81603550779258915426e-01, 9.50125098376374405129e-02
+  };
+
+  static const real_type gauss16_w[] = {
+    2.71524594117540964133e-02, 6.22535239386478936319e-02, 9.51585116824927856882e-02,
+    1.24628971255533876894e-01, 1.49595988816576735969e-01, 1.69156519395002535866e-01,
+    1.82603415044923583777e-01, 1.89450610455068502169e-01
+  };
+
+  // problems computed together and maximum phase change |a|/2+|b| of the
+  // Gauss-Legendre rule (error below 1e-14 for the 3 momenta)
+  static int_type  const lanes_block = 8;
+  static real_type const lanes_phase = 6.28318530717958647692;
+
+  //! \endcond
+
+  void
+  GeneralizedFresnelCS(
+    int_type        n,
+    int_type        nk,
+    real_type const a[],
+    real_type const b[],
+    real_type const c[],
+    real_type       intC[],
+    real_type       intS[]
+  ) {
+    G2LIB_ASSERT( nk > 0 && nk < 4, "nk = " << nk << " must be in 1..3" );
+
+    for ( int_type i0 = 0; i0 < n; i0 += lanes_block ) {
+
+      int_type  m = min( lanes_block, n-i0 );
+      bool      gauss[lanes_block];
+      real_type A[lanes_block], B[lanes_block], C[lanes_block];
+      real_type C0[lanes_block], C1[lanes_block], C2[lanes_block];
+      real_type S0[lanes_block], S1[lanes_block], S2[lanes_block];
+
+      // the lanes not used or with a large phase change are computed with 0
+      for ( int_type l = 0; l < lanes_block; ++l ) {
+        int_type i = i0+l;
+        gauss[l] = l < m && abs(a[i])/2+abs(b[i]) <= lanes_phase;
+        A[l] = B[l] = C[l] = 0;
+        if ( gauss[l] ) {
+          A[l] = a[i]/2;
+          B[l] = b[i];
+          C[l] = c[i];
+          rangeSymm( C[l] );
+        }
+        C0[l] = C1[l] = C2[l] = S0[l] = S1[l] = S2[l] = 0;
+      }
+
+      for ( int_type j = 0; j < 16; ++j ) {
+        real_type x  = j < 8 ? -gauss16_x[j] : gauss16_x[15-j];
+        real_type w  = j < 8 ? gauss16_w[j] : gauss16_w[15-j];
+        real_type t  = (1+x)/2;
+        real_type w0 = w/2;
+        real_type w1 = w0*t;
+        real_type w2 = w1*t;
+        // no branch and no call: the compiler vectorizes the loop
+        for ( int_type l = 0; l < lanes_block; ++l ) {
+          // phase in [-3pi,3pi], reduced to r in [-pi/4,pi/4] (q = round(2 ph/pi)+8)
+          real_type ph = (A[l]*t+B[l])*t+C[l];
+          int       q  = int( ph*0.63661977236758134308 + 8.5 );
+          real_type qq = real_type( q-8 );
+          real_type r  = (ph - qq*1.57079632673412561417e+00) - qq*6.07710050650619224932e-11;
+          real_type r2 = r*r;
+          // Taylor polynomials (truncation error below 1e-17)
+          real_type sr = r*(1+r2*(-1.0/6+r2*(1.0/120+r2*(-1.0/5040+r2*(1.0/362880+
+                         r2*(-1.0/39916800+r2*(1.0/6227020800+r2*(-1.0/1307674368000))))))));
+          real_type cr = 1+r2*(-1.0/2+r2*(1.0/24+r2*(-1.0/720+r2*(1.0/40320+
+                         r2*(-1.0/3628800+r2*(1.0/479001600+r2*(-1.0/87178291200+
+                         r2*(1.0/20922789888000))))))));
+          // sin(r+q*pi/2) and cos(r+q*pi/2)
+          int       qm = q & 3;
+          real_type ss = (qm & 1) != 0 ? cr : sr;
+          real_type cc = (qm & 1) != 0 ? sr : cr;
+          ss = qm >= 2 ? -ss : ss;
+          cc = qm == 1 || qm == 2 ? -cc : cc;
+          C0[l] += w0*cc; C1[l] += w1*cc; C2[l] += w2*cc;
+          S0[l] += w0*ss; S1[l] += w1*ss; S2[l] += w2*ss;
+        }
+      }
+
+      for ( int_type l = 0; l < m; ++l ) {
+        int_type    i  = i0+l;
+        real_type * IC = intC+i*nk;
+        real_type * IS = intS+i*nk;
+        if ( gauss[l] ) {
+          IC[0] = C0[l]; IS[0] = S0[l];
+          if ( nk > 1 ) { IC[1] = C1[l]; IS[1] = S1[l]; }
+          if ( nk > 2 ) { IC[2] = C2[l]; IS[2] = S2[l]; }
+        } else {
+          GeneralizedFresnelCS( nk, a[i], b[i], c[i], IC, IS );
+        }
+      }
+    }
+  }
+
   // -------------------------------------------------------------------------
 
   void
@@ -1091,6 +1574,79 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  ClothoidData::evaluate_ISO(
+    real_type   s,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & tx,
+    real_type & ty,
+    real_type & kappa
+  ) const {
+    real_type C, S;
+    GeneralizedFresnelCS( dk*s*s, kappa0*s, theta0, C, S );
+    real_type theta = theta0 + s*(kappa0+0.5*s*dk);
+    tx    = cos( theta );
+    ty    = sin( theta );
+    kappa = kappa0 + s*dk;
+    x     = x0 + s*C - offs * ty;
+    y     = y0 + s*S + offs * tx;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidData::eval_ISO(
+    real_type   s,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & x_D,
+    real_type & y_D
+  ) const {
+    real_type tx, ty, kappa;
+    evaluate_ISO( s, offs, x, y, tx, ty, kappa );
+    real_type scale = 1-offs*kappa;
+    x_D = tx*scale;
+    y_D = ty*scale;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidData::eval_ISO(
+    real_type   s,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & x_D,
+    real_type & y_D,
+    real_type & x_DD,
+    real_type & y_DD,
+    real_type & x_DDD,
+    real_type & y_DDD
+  ) const {
+    real_type C, S, kappa;
+    evaluate_ISO( s, offs, x, y, C, S, kappa );
+    real_type tmp0 = -kappa*offs;
+    // first derivative
+    x_D = C*(1+tmp0);
+    y_D = S*(1+tmp0);
+    // second derivative
+    real_type tmp1 = kappa*(1+tmp0);
+    real_type tmp2 = -offs*dk;
+    x_DD = -tmp1*S + C*tmp2;
+    y_DD =  tmp1*C + S*tmp2;
+    // third derivative
+    tmp1 = -kappa*kappa*(1+tmp0);
+    tmp2 = dk*(1+3*tmp0);
+    x_DDD = tmp1*C-tmp2*S;
+    y_DDD = tmp1*S+tmp2*C;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   ClothoidData::Pinfinity( real_type & x, real_type & y, bool plus ) const {
     real_type theta, tmp;
@@ -1340,6 +1896,10 @@ namespace G2lib {
       A  -= g / dg;
     } while ( ++niter <= 10 && abs(g) > tol );
 
+    G2LIB_PERF_COUNT(build_G1_calls);
+    G2LIB_PERF_ADD(build_G1_iter,niter);
+    if ( abs(g) > tol ) G2LIB_PERF_COUNT(build_G1_fail);
+
     G2LIB_ASSERT(
       abs(g) <= tol,
       "Newton do not converge, g = " << g << " niter = " << niter
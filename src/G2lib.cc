@@ -22,6 +22,10 @@
 
 #include <algorithm>
 
+#ifdef G2LIB_USE_CXX11
+  #include <mutex>
+#endif
+
 #ifdef __clang__
 #pragma clang diagnostic ignored "-Wglobal-constructors"
 #endif
@@ -66,6 +70,121 @@ namespace G2lib {
     "CLOTHOID_LIST"
   };
 
+  /*\
+   |   ____            __  ____                  _
+   |  |  _ \ ___ _ __ / _|/ ___|___  _   _ _ __ | |_ ___ _ __ ___
+   |  | |_) / _ \ '__| |_| |   / _ \| | | | '_ \| __/ _ \ '__/ __|
+   |  |  __/  __/ |  |  _| |__| (_) | |_| | | | | ||  __/ |  \__ \
+   |  |_|   \___|_|  |_|  \____\___/ \__,_|_| |_|\__\___|_|  |___/
+  \*/
+
+  void
+  PerfCounters::reset() {
+    build_G1_calls    = build_G1_iter    = build_G1_fail    = 0;
+    G2solve3arc_calls = G2solve3arc_iter = G2solve3arc_fail = 0;
+    intersect_calls   = intersect_iter   = intersect_fail   = 0;
+    closest_calls     = closest_iter     = closest_fail     = 0;
+    aabb_nodes        = aabb_leaf_tests  = aabb_rebuilds    = 0;
+    fresnel_large     = fresnel_small    = fresnel_zero     = 0;
+  }
+
+  PerfCounters &
+  PerfCounters::operator += ( PerfCounters const & c ) {
+    build_G1_calls    += c.build_G1_calls;
+    build_G1_iter     += c.build_G1_iter;
+    build_G1_fail     += c.build_G1_fail;
+    G2solve3arc_calls += c.G2solve3arc_calls;
+    G2solve3arc_iter  += c.G2solve3arc_iter;
+    G2solve3arc_fail  += c.G2solve3arc_fail;
+    intersect_calls   += c.intersect_calls;
+    intersect_iter    += c.intersect_iter;
+    intersect_fail    += c.intersect_fail;
+    closest_calls     += c.closest_calls;
+    closest_iter      += c.closest_iter;
+    closest_fail      += c.closest_fail;
+    aabb_nodes        += c.aabb_nodes;
+    aabb_leaf_tests   += c.aabb_leaf_tests;
+    aabb_rebuilds     += c.aabb_rebuilds;
+    fresnel_large     += c.fresnel_large;
+    fresnel_small     += c.fresnel_small;
+    fresnel_zero      += c.fresnel_zero;
+    return *this;
+  }
+
+  void
+  PerfCounters::info( ostream_type & stream ) const {
+    stream
+      << "build_G1        calls = " << build_G1_calls
+      << " iter = " << build_G1_iter << " fail = " << build_G1_fail
+      << "\nG2solve3arc     calls = " << G2solve3arc_calls
+      << " iter = " << G2solve3arc_iter << " fail = " << G2solve3arc_fail
+      << "\nintersect       calls = " << intersect_calls
+      << " iter = " << intersect_iter << " fail = " << intersect_fail
+      << "\nclosestPoint    calls = " << closest_calls
+      << " iter = " << closest_iter << " fail = " << closest_fail
+      << "\nAABB            nodes = " << aabb_nodes
+      << " leaf tests = " << aabb_leaf_tests << " rebuilds = " << aabb_rebuilds
+      << "\nFresnel         large = " << fresnel_large
+      << " small = " << fresnel_small << " zero = " << fresnel_zero
+      << '\n';
+  }
+
+  #ifdef G2LIB_USE_CXX11
+
+  static PerfCounters perf_retired; // counters of the terminated threads
+  static std::mutex   perf_mutex;
+
+  // counters of a thread, merged in `perf_retired` when the thread ends
+  class PerfCountersThread {
+  public:
+    PerfCounters counters;
+    ~PerfCountersThread() {
+      std::lock_guard<std::mutex> lock(perf_mutex);
+      perf_retired += counters;
+    }
+  };
+
+  static thread_local PerfCountersThread perf_thread;
+
+  PerfCounters &
+  perfCounters()
+  { return perf_thread.counters; }
+
+  void
+  perfCountersTotal( PerfCounters & tot ) {
+    std::lock_guard<std::mutex> lock(perf_mutex);
+    tot  = perf_retired;
+    tot += perf_thread.counters;
+  }
+
+  void
+  resetPerfCounters() {
+    std::lock_guard<std::mutex> lock(perf_mutex);
+    perf_retired.reset();
+    perf_thread.counters.reset();
+  }
+
+  #else
+
+  // no thread local storage, a single set of counters
+  static PerfCounters perf_counters;
+
+  PerfCounters &
+  perfCounters()
+  { return perf_counters; }
+
+  void
+  perfCountersTotal( PerfCounters & tot )
+  { tot = perf_counters; }
+
+  void
+  resetPerfCounters()
+  { perf_counters.reset(); }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   rangeSymm( real_type & ang ) {
     ang = fmod( ang, m_2pi );
@@ -401,7 +520,7 @@ namespace G2lib {
       }
     }
     real_type len1 = m_2pi/(machepsi+abs(kappa1));
-    real_type len2 = m_2pi/(machepsi+abs(kappa1));
+    real_type len2 = m_2pi/(machepsi+abs(kappa2));
     for ( int_type i = 0; i < nsol; ++i ) {
       real_type ss1 = invCoscSinc( kappa1, xx1[i], yy1[i] );
       real_type ss2 = invCoscSinc( kappa2, xx2[i], yy2[i] );
@@ -621,11 +740,24 @@ namespace G2lib {
     real_type k,
     real_type qx,
     real_type qy
+  ) {
+    return projectPointOnCircle( x0, y0, cos(theta0), sin(theta0), k, qx, qy );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  projectPointOnCircle(
+    real_type x0,
+    real_type y0,
+    real_type c0,
+    real_type s0,
+    real_type k,
+    real_type qx,
+    real_type qy
   ) {
     real_type dx  = x0 - qx;
     real_type dy  = y0 - qy;
-    real_type c0  = cos(theta0);
-    real_type s0  = sin(theta0);
     real_type a0  = c0 * dy - s0 * dx;
     real_type b0  = s0 * dy + c0 * dx;
     real_type tmp = a0*k;
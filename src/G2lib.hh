@@ -121,6 +121,15 @@ Authors:
 #endif
 
 #define G2LIB_PURE_VIRTUAL = 0
+
+// performance counters, see `G2lib::PerfCounters`
+#ifdef G2LIB_PERF_COUNTERS
+  #define G2LIB_PERF_COUNT(NAME) (++G2lib::perfCounters().NAME)
+  #define G2LIB_PERF_ADD(NAME,N) (G2lib::perfCounters().NAME += G2lib::PerfCounters::counter_type(N))
+#else
+  #define G2LIB_PERF_COUNT(NAME) ((void)0)
+  #define G2LIB_PERF_ADD(NAME,N) ((void)0)
+#endif
 #ifdef G2LIB_USE_CXX11
   #define G2LIB_OVERRIDE override
 #else
@@ -187,6 +196,62 @@ namespace G2lib {
   yesAABBtree()
   { intersect_with_AABBtree = true; }
 
+  /*\
+   |   ____            __  ____                  _
+   |  |  _ \ ___ _ __ / _|/ ___|___  _   _ _ __ | |_ ___ _ __ ___
+   |  | |_) / _ \ '__| |_| |   / _ \| | | | '_ \| __/ _ \ '__/ __|
+   |  |  __/  __/ |  |  _| |__| (_) | |_| | | | | ||  __/ |  \__ \
+   |  |_|   \___|_|  |_|  \____\___/ \__,_|_| |_|\__\___|_|  |___/
+  \*/
+
+  //! \brief Counters of the work done by the library
+  /*!
+   * The counters are updated only when the library is compiled with
+   * `G2LIB_PERF_COUNTERS` defined, otherwise they remain zero.
+   * Each thread updates its own copy (no locking), the copy of a thread
+   * is added to a global total when the thread terminates.
+   */
+  class PerfCounters {
+  public:
+    typedef unsigned long long counter_type;
+
+    counter_type build_G1_calls;     //!< calls of `ClothoidData::build_G1`
+    counter_type build_G1_iter;      //!< Newton iterations of `ClothoidData::build_G1`
+    counter_type build_G1_fail;      //!< Newton failures of `ClothoidData::build_G1`
+    counter_type G2solve3arc_calls;  //!< calls of `G2solve3arc::solve`
+    counter_type G2solve3arc_iter;   //!< Newton iterations of `G2solve3arc::solve`
+    counter_type G2solve3arc_fail;   //!< failures of `G2solve3arc::solve`
+    counter_type intersect_calls;    //!< calls of `ClothoidCurve::aabb_intersect_ISO`
+    counter_type intersect_iter;     //!< Newton iterations of `ClothoidCurve::aabb_intersect_ISO`
+    counter_type intersect_fail;     //!< non converged `ClothoidCurve::aabb_intersect_ISO`
+    counter_type closest_calls;      //!< calls of `ClothoidCurve::closestPoint_internal_ISO`
+    counter_type closest_iter;       //!< iterations of `ClothoidCurve::closestPoint_internal_ISO`
+    counter_type closest_fail;       //!< non converged `ClothoidCurve::closestPoint_internal_ISO`
+    counter_type aabb_nodes;         //!< nodes of AABB trees visited
+    counter_type aabb_leaf_tests;    //!< leaves (or pairs of leaves) passed to the narrow phase
+    counter_type aabb_rebuilds;      //!< AABB trees rebuilt by `build_AABBtree_ISO`
+    counter_type fresnel_large;      //!< Fresnel integrals evaluated with `evalXYaLarge`
+    counter_type fresnel_small;      //!< Fresnel integrals evaluated with `evalXYaSmall`
+    counter_type fresnel_zero;       //!< calls of `evalXYazero` (done by `evalXYaSmall`)
+
+    PerfCounters() { reset(); }
+
+    void reset();
+
+    PerfCounters & operator += ( PerfCounters const & c );
+
+    void info( ostream_type & stream ) const;
+  };
+
+  //! counters of the calling thread
+  PerfCounters & perfCounters();
+
+  //! sum of the counters of the calling thread and of the terminated threads
+  void perfCountersTotal( PerfCounters & tot );
+
+  //! reset the counters of the calling thread and of the terminated threads
+  void resetPerfCounters();
+
   //! check if cloating point number `x` is zero
   static
   inline
@@ -293,6 +358,21 @@ namespace G2lib {
     real_type qy
   );
 
+  /*!
+   * project point `(qx,qy)` to the circle passing from `(x0,y0)`
+   * with tangent direction `(c0,s0)` and curvature `k`
+   */
+  real_type
+  projectPointOnCircle(
+    real_type x0,
+    real_type y0,
+    real_type c0, //!< cos(theta0)
+    real_type s0, //!< sin(theta0)
+    real_type k,
+    real_type qx,
+    real_type qy
+  );
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   /*!
    * check if point `(qx,qy)` is inside the circle passing from `(x0,y0)`
@@ -510,6 +590,27 @@ namespace G2lib {
   typedef std::pair<real_type,real_type> Ipair;
   typedef std::vector<Ipair>             IntersectList;
 
+  //! value at `s` of a border of a corridor, a constant or a functor `f(s)`
+  template <typename BORDER>
+  struct CorridorBorder {
+    static real_type eval( BORDER const & f, real_type s ) { return f(s); }
+  };
+
+  template <>
+  struct CorridorBorder<real_type> {
+    static real_type eval( real_type offs, real_type ) { return offs; }
+  };
+
+  template <>
+  struct CorridorBorder<float> {
+    static real_type eval( float offs, real_type ) { return offs; }
+  };
+
+  template <>
+  struct CorridorBorder<int> {
+    static real_type eval( int offs, real_type ) { return offs; }
+  };
+
   /*\
    |   _       _                          _
    |  (_)_ __ | |_ ___ _ __ ___  ___  ___| |_
@@ -1784,6 +1885,78 @@ namespace G2lib {
       return dst;
     }
 
+    /*!
+     *  Project the point on the centerline once and return the signed
+     *  distances from the borders of the corridor delimited by the offset
+     *  curves `offs_left` and `offs_right`, positive inside the corridor.
+     *  ISO: `offs_right <= offs_left`, SAE: `offs_left <= offs_right`.
+     *
+     *  The borders are constant offsets or functors `offs(s)` (see
+     *  `CorridorBorder`) evaluated at the abscissa `s` of the projection.
+     *  The distances are measured along the normal at `s`:
+     *  `dst_left = offs_left(s)-t`, `dst_right = t-offs_right(s)`.
+     *  For constant offsets they are the distances from the offset
+     *  curves (as from `closestPoint_ISO` with `offs`) only when the
+     *  projection is orthogonal (return 1) and the point is nearer to the
+     *  centerline than its radius of curvature; with the return -1 the
+     *  point is beyond an end of the curve and `t` is not a lateral
+     *  coordinate.
+     *
+     *  \return the return code of `closestPoint_ISO` on the centerline
+     */
+    template <typename LEFT, typename RIGHT>
+    int_type
+    closestPointCorridor_ISO(
+      real_type     qx,
+      real_type     qy,
+      LEFT  const & offs_left,
+      RIGHT const & offs_right,
+      real_type   & s,
+      real_type   & t,
+      real_type   & dst_left,
+      real_type   & dst_right
+    ) const {
+      real_type x, y, dst;
+      int_type res = this->closestPoint_ISO( qx, qy, x, y, s, t, dst );
+      real_type oL = CorridorBorder<LEFT>::eval( offs_left, s );
+      real_type oR = CorridorBorder<RIGHT>::eval( offs_right, s );
+      G2LIB_ASSERT(
+        oR <= oL,
+        "closestPointCorridor: right border at the left of the left border"
+      )
+      // the offset curves share the normal of the centerline
+      dst_left  = oL - t;
+      dst_right = t - oR;
+      return res;
+    }
+
+    //! as `closestPointCorridor_ISO` with SAE borders (`offs_left(s) <= offs_right(s)`)
+    template <typename LEFT, typename RIGHT>
+    int_type
+    closestPointCorridor_SAE(
+      real_type     qx,
+      real_type     qy,
+      LEFT  const & offs_left,
+      RIGHT const & offs_right,
+      real_type   & s,
+      real_type   & t,
+      real_type   & dst_left,
+      real_type   & dst_right
+    ) const {
+      real_type x, y, dst;
+      int_type res = this->closestPoint_ISO( qx, qy, x, y, s, t, dst );
+      t = -t; // SAE lateral coordinate
+      real_type oL = CorridorBorder<LEFT>::eval( offs_left, s );
+      real_type oR = CorridorBorder<RIGHT>::eval( offs_right, s );
+      G2LIB_ASSERT(
+        oL <= oR,
+        "closestPointCorridor: right border at the left of the left border"
+      )
+      dst_left  = t - oL;
+      dst_right = oR - t;
+      return res;
+    }
+
     #ifdef G2LIB_COMPATIBILITY_MODE
     virtual
     real_type
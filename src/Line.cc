@@ -38,6 +38,7 @@
 namespace G2lib {
 
   using std::max;
+  using std::abs;
   using std::min;
   using std::swap;
 
@@ -478,6 +479,55 @@ namespace G2lib {
     return G2lib::collision( epsi, L1, L2 );
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  LineSegment::rayCast_ISO(
+    real_type   qx,
+    real_type   qy,
+    real_type   dx,
+    real_type   dy,
+    real_type   max_range,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & dst
+  ) const {
+    real_type len = hypot( dx, dy );
+    G2LIB_ASSERT(
+      len > 0, "LineSegment::rayCast_ISO, null direction of the ray"
+    );
+    real_type ux = dx/len;
+    real_type uy = dy/len;
+    // solve (qx,qy) + t * (ux,uy) = P0 + s * (c0,s0)
+    real_type wx  = xBegin_ISO(offs) - qx;
+    real_type wy  = yBegin_ISO(offs) - qy;
+    real_type det = ux*s0 - uy*c0;
+    real_type eps = machepsi100*max(L,real_type(1));
+    real_type t;
+    if ( abs(det) > machepsi1000 ) {
+      t = (wx*s0 - wy*c0)/det;
+      s = (wx*uy - wy*ux)/det;
+      if ( s < -eps || s > L+eps ) return false;
+    } else {
+      // parallel, hit only if collinear
+      if ( abs(wx*uy - wy*ux) > eps ) return false;
+      real_type ta = wx*ux + wy*uy;
+      real_type tb = ta + L*(c0*ux+s0*uy);
+      t = max( real_type(0), min( ta, tb ) );
+      if ( t > max( ta, tb ) ) return false;
+      s = (t-ta)*(c0*ux+s0*uy);
+    }
+    if ( t < 0 || t > max_range ) return false;
+    if      ( s < 0 ) s = 0;
+    else if ( s > L ) s = L;
+    dst = t;
+    x   = qx + t*ux;
+    y   = qy + t*uy;
+    return true;
+  }
+
   /*\
    |   _       _                          _
    |  (_)_ __ | |_ ___ _ __ ___  ___  ___| |_
@@ -654,6 +654,55 @@ namespace G2lib {
       real_type           S_offs
     ) const;
 
+    /*!
+     * \brief first intersection of a ray with the segment
+     *
+     * The ray is `(qx,qy)+t*(dx,dy)/|(dx,dy)|` with `0 <= t <= max_range`,
+     * a segment casting is a ray with `max_range` equal to the length
+     * of the segment.
+     *
+     * \param[in]  qx        x-coordinate of the origin of the ray
+     * \param[in]  qy        y-coordinate of the origin of the ray
+     * \param[in]  dx        x-component of the direction of the ray
+     * \param[in]  dy        y-component of the direction of the ray
+     * \param[in]  max_range maximum distance along the ray
+     * \param[in]  offs      offset of the segment
+     * \param[out] x         x-coordinate of the hit point
+     * \param[out] y         y-coordinate of the hit point
+     * \param[out] s         curvilinear coordinate of the hit point
+     * \param[out] dst       distance of the hit point from the origin
+     * \return true if the ray hit the segment
+     */
+    bool
+    rayCast_ISO(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const;
+
+    bool
+    rayCast_SAE(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const {
+      return rayCast_ISO( qx, qy, dx, dy, max_range, -offs, x, y, s, dst );
+    }
+
     /*\
      |   _   _ _   _ ____  ____ ____
      |  | \ | | | | |  _ \| __ ) ___|
@@ -22,6 +22,7 @@
 #include "Circle.hh"
 #include "Biarc.hh"
 #include "ClothoidList.hh"
+#include "CurveStatic.hh"
 
 // Workaround for Visual Studio
 #ifdef min
@@ -33,6 +34,7 @@
 #endif
 
 #include <algorithm>
+#include <limits>
 
 namespace G2lib {
 
@@ -42,6 +44,7 @@ namespace G2lib {
   using std::cout;
   using std::vector;
   using std::ceil;
+  using std::numeric_limits;
 
   typedef vector<LineSegment>::difference_type LS_dist_type;
 
@@ -564,22 +567,9 @@ namespace G2lib {
     real_type & DST
   ) const{
     G2LIB_ASSERT( !polylineList.empty(), "PolyLine::closestPoint, empty list" );
-    vector<LineSegment>::const_iterator ic = polylineList.begin();
-    vector<real_type>::const_iterator   is = s0.begin();
-    ic->closestPoint_ISO( x, y, X, Y, S, T, DST );
-    size_t ipos = 0;
-    for ( ++ic, ++is; ic != polylineList.end(); ++ic, ++is ) {
-      real_type X1, Y1, S1, T1, DST1;
-      ic->closestPoint_ISO( x, y, X1, Y1, S1, T1, DST1 );
-      if ( DST1 < DST ) {
-        DST  = DST1;
-        X    = X1;
-        Y    = Y1;
-        S    = *is + S1;
-        T    = T1;
-        ipos = size_t(ic-polylineList.begin());
-      }
-    }
+    size_t ipos = CurveStatic<LineSegment>::closestPoint_ISO(
+      polylineList, s0, x, y, 0, X, Y, S, T, DST
+    );
 
     real_type xx, yy;
     polylineList[ipos].eval_ISO( S - s0[ipos], T, xx, yy );
@@ -588,6 +578,126 @@ namespace G2lib {
     return 1;
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  PolyLine::segmentsInRadius(
+    real_type           qx,
+    real_type           qy,
+    real_type           r,
+    vector<int_type>  & segments,
+    vector<real_type> & dsts
+  ) const {
+    segments.clear();
+    dsts.clear();
+    this->build_AABBtree();
+    Nearest_list fun(
+      this, qx, qy, r, numeric_limits<size_t>::max(), segments, dsts
+    );
+    aabb_tree.nearest( qx, qy, fun );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  PolyLine::closestSegments(
+    real_type           qx,
+    real_type           qy,
+    int_type            k,
+    vector<int_type>  & segments,
+    vector<real_type> & dsts
+  ) const {
+    segments.clear();
+    dsts.clear();
+    if ( k <= 0 ) return;
+    this->build_AABBtree();
+    Nearest_list fun(
+      this, qx, qy, numeric_limits<real_type>::infinity(),
+      size_t(k), segments, dsts
+    );
+    aabb_tree.nearest( qx, qy, fun );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  PolyLine::rayCast(
+    real_type   qx,
+    real_type   qy,
+    real_type   dx,
+    real_type   dy,
+    real_type   max_range,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & dst
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    static thread_local AABBworkspace ws; // reused by the calls of the thread
+    #else
+    AABBworkspace ws;
+    #endif
+    return rayCast( qx, qy, dx, dy, max_range, x, y, s, dst, ws );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  PolyLine::rayCast(
+    real_type       qx,
+    real_type       qy,
+    real_type       dx,
+    real_type       dy,
+    real_type       max_range,
+    real_type     & x,
+    real_type     & y,
+    real_type     & s,
+    real_type     & dst,
+    AABBworkspace & ws
+  ) const {
+    real_type len = hypot( dx, dy );
+    G2LIB_ASSERT(
+      len > 0, "PolyLine::rayCast, null direction of the ray"
+    );
+    real_type ux = dx/len;
+    real_type uy = dy/len;
+    this->build_AABBtree();
+    Raycast_list fun( this, qx, qy, ux, uy, s, dst );
+    if ( !aabb_tree.raycast( qx, qy, ux, uy, max_range, fun, ws.queue ) )
+      return false;
+    x = qx + dst*ux;
+    y = qy + dst*uy;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  PolyLine::rayCast(
+    int_type        n,
+    real_type const qx[],
+    real_type const qy[],
+    real_type const dx[],
+    real_type const dy[],
+    real_type       max_range,
+    real_type       s[],
+    real_type       dst[]
+  ) const {
+    AABBworkspace ws; // the queue of the search is reused by all the rays
+    int_type      nhit = 0;
+    for ( int_type i = 0; i < n; ++i ) {
+      real_type x, y;
+      if ( rayCast( qx[i], qy[i], dx[i], dy[i], max_range,
+                    x, y, s[i], dst[i], ws ) ) {
+        ++nhit;
+      } else {
+        s[i]   = 0;
+        dst[i] = -1;
+      }
+    }
+    return nhit;
+  }
+
   /*\
    |             _ _ _     _
    |    ___ ___ | | (_)___(_) ___  _ __
@@ -26,6 +26,7 @@
 
 #include "Line.hh"
 #include "AABBtree.hh"
+#include "CurveStatic.hh"
 
 namespace G2lib {
 
@@ -75,6 +76,92 @@ namespace G2lib {
         return LS1.collision( LS2 );
       }
     };
+
+    // collect the segments by increasing distance from the point (qx,qy)
+    class Nearest_list {
+      PolyLine const * pPL;
+      real_type  const qx;
+      real_type  const qy;
+      real_type  const r;
+      size_t     const kmax;
+      vector<int_type>  & segments;
+      vector<real_type> & dsts;
+    public:
+      Nearest_list(
+        PolyLine const *    _pPL,
+        real_type  const    _qx,
+        real_type  const    _qy,
+        real_type  const    _r,
+        size_t     const    _kmax,
+        vector<int_type>  & _segments,
+        vector<real_type> & _dsts
+      )
+      : pPL(_pPL)
+      , qx(_qx)
+      , qy(_qy)
+      , r(_r)
+      , kmax(_kmax)
+      , segments(_segments)
+      , dsts(_dsts)
+      {}
+
+      real_type
+      distance( BBox::PtrBBox ptr ) const {
+        LineSegment const & LS = pPL->polylineList[size_t(ptr->Ipos())];
+        real_type x, y, s, t, dst;
+        CurveStatic<LineSegment>::closestPoint_ISO( LS, qx, qy, 0, x, y, s, t, dst );
+        return dst;
+      }
+
+      bool
+      visit( BBox::PtrBBox ptr, real_type dst ) {
+        if ( dst > r ) return false;
+        segments.push_back( ptr->Ipos() );
+        dsts.push_back( dst );
+        return segments.size() < kmax;
+      }
+    };
+
+    // first hit of the ray (qx,qy)+t*(ux,uy) with the segments
+    class Raycast_list {
+      PolyLine const * pPL;
+      real_type  const qx;
+      real_type  const qy;
+      real_type  const ux;
+      real_type  const uy;
+      real_type      & s;
+      real_type      & dst;
+    public:
+      Raycast_list(
+        PolyLine const * _pPL,
+        real_type  const _qx,
+        real_type  const _qy,
+        real_type  const _ux,
+        real_type  const _uy,
+        real_type      & _s,
+        real_type      & _dst
+      )
+      : pPL(_pPL)
+      , qx(_qx)
+      , qy(_qy)
+      , ux(_ux)
+      , uy(_uy)
+      , s(_s)
+      , dst(_dst)
+      {}
+
+      bool
+      hit( BBox::PtrBBox ptr, real_type tmax, real_type & t ) const {
+        int_type            ipos = ptr->Ipos();
+        LineSegment const & LS   = pPL->polylineList[size_t(ipos)];
+        real_type x, y, ss;
+        if ( !LS.rayCast_ISO( qx, qy, ux, uy, tmax, 0, x, y, ss, t ) )
+          return false;
+        s   = pPL->s0[size_t(ipos)] + ss;
+        dst = t;
+        return true;
+      }
+    };
   public:
 
     //explicit
@@ -456,6 +543,107 @@ namespace G2lib {
       G2LIB_DO_ERROR( "PolyLine::closestPoint( ... offs ... ) not available!");
     }
 
+    /*!
+     * \brief segments with distance from the point `[x,y]` not greater than `r`
+     *
+     * \param qx       x-coordinate
+     * \param qy       y-coordinate
+     * \param r        search radius
+     * \param segments index of the segments found, ordered by increasing distance
+     * \param dsts     distance of the point from the segments found
+     */
+    void
+    segmentsInRadius(
+      real_type           qx,
+      real_type           qy,
+      real_type           r,
+      vector<int_type>  & segments,
+      vector<real_type> & dsts
+    ) const;
+
+    /*!
+     * \brief the `k` segments nearest to the point `[x,y]`
+     *
+     * \param qx       x-coordinate
+     * \param qy       y-coordinate
+     * \param k        number of segments to be found
+     * \param segments index of the segments found, ordered by increasing distance
+     * \param dsts     distance of the point from the segments found
+     */
+    void
+    closestSegments(
+      real_type           qx,
+      real_type           qy,
+      int_type            k,
+      vector<int_type>  & segments,
+      vector<real_type> & dsts
+    ) const;
+
+    /*!
+     * \brief first intersection of a ray with the polyline
+     *
+     * The ray is `(qx,qy)+t*(dx,dy)/|(dx,dy)|` with `0 <= t <= max_range`,
+     * a segment casting is a ray with `max_range` equal to the length
+     * of the segment.
+     *
+     * \param[in]  qx        x-coordinate of the origin of the ray
+     * \param[in]  qy        y-coordinate of the origin of the ray
+     * \param[in]  dx        x-component of the direction of the ray
+     * \param[in]  dy        y-component of the direction of the ray
+     * \param[in]  max_range maximum distance along the ray
+     * \param[out] x         x-coordinate of the hit point
+     * \param[out] y         y-coordinate of the hit point
+     * \param[out] s         curvilinear coordinate of the hit point
+     * \param[out] dst       distance of the hit point from the origin
+     * \return true if the ray hit the polyline
+     */
+    bool
+    rayCast(
+      real_type   qx,
+      real_type   qy,
+      real_type   dx,
+      real_type   dy,
+      real_type   max_range,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & dst
+    ) const;
+
+    //! as `rayCast` using the scratch space `ws` (no allocation)
+    bool
+    rayCast(
+      real_type       qx,
+      real_type       qy,
+      real_type       dx,
+      real_type       dy,
+      real_type       max_range,
+      real_type     & x,
+      real_type     & y,
+      real_type     & s,
+      real_type     & dst,
+      AABBworkspace & ws
+    ) const;
+
+    /*!
+     * \brief cast `n` rays `(qx[i],qy[i])+t*(dx[i],dy[i])`
+     *
+     * \param[out] s   curvilinear coordinate of the hits
+     * \param[out] dst distance of the hits, `-1` if the ray miss the polyline
+     * \return the number of rays that hit the polyline
+     */
+    int_type
+    rayCast(
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type const dx[],
+      real_type const dy[],
+      real_type       max_range,
+      real_type       s[],
+      real_type       dst[]
+    ) const;
+
     /*\
      |             _ _ _     _
      |    ___ ___ | | (_)___(_) ___  _ __
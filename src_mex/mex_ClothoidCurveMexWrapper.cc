@@ -733,6 +733,7 @@ namespace G2lib {
 
       MEX_ASSERT( mxIsChar(arg_in_0), "First argument must be a string" );
       string cmd = mxArrayToString(arg_in_0);
+      mex_clones_check( cmd );
 
       switch ( cmd_to_idx.at(cmd) ) {
       case CMD_NEW:
@@ -8,6 +8,235 @@ do_is_ISO( mxArray const * plhs, char const msg[] ) {
   return cmd == "ISO";
 }
 
+// . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+/*
+ * Vectorized commands: the points are split in blocks evaluated by
+ * threads running in parallel (at least `mex_min_block` points per
+ * thread). Each thread but the calling one works on a copy of the
+ * object, the curves keep caches (last segment found, AABB tree, ...)
+ * that cannot be shared. A kernel `K( C, i0, i1 )` evaluates the points
+ * `i0..i1-1` reading and writing directly the `mxArray` buffers and
+ * calling the methods of `G2LIB_CLASS` qualified (no virtual call).
+ */
+
+static mwSize const mex_min_block = 10000;
+
+// Copies of the object used by the worker threads of `do_parallel`.
+// They are kept between the calls on the same object, so that the caches
+// of the copies (last segment, AABB trees) are built once: any command
+// that is not a query drops them (see `mex_clones_check` in mexFunction)
+static G2LIB_CLASS const * mex_clones_src = nullptr;
+static vector<G2LIB_CLASS> mex_clones;
+
+// drop the copies unless the command `cmd` does not change the objects
+static
+void
+mex_clones_check( string const & cmd ) {
+  static char const * queries[] = {
+    "length", "bbox", "distance", "closestPoint", "collision", "intersect",
+    "findST", "info", "evaluate", "eval", "eval_D", "eval_DD", "eval_DDD",
+    "theta", "theta_D", "theta_DD", "theta_DDD", "kappa", "kappa_D", "kappa_DD",
+    "xyBegin", "xBegin", "yBegin", "thetaBegin", "kappaBegin",
+    "xyEnd", "xEnd", "yEnd", "thetaEnd", "kappaEnd", nullptr
+  };
+  for ( char const ** q = queries; *q != nullptr; ++q )
+    if ( cmd == *q ) return;
+  mex_clones_src = nullptr;
+  mex_clones.clear();
+}
+
+template <typename KERNEL>
+static
+void
+do_parallel( KERNEL const & K, G2LIB_CLASS const * ptr, mwSize npts ) {
+  #ifdef G2LIB_USE_CXX11
+  mwSize nth = mwSize(std::thread::hardware_concurrency());
+  if ( nth > npts/mex_min_block ) nth = npts/mex_min_block;
+  if ( nth > 1 ) {
+    mwSize const blk = (npts+nth-1)/nth;
+    // the copies are done before any thread can update the caches of `ptr`
+    if ( mex_clones_src != ptr || mex_clones.size() < nth-1 ) {
+      mex_clones.assign( nth-1, *ptr );
+      mex_clones_src = ptr;
+    }
+    vector<std::exception_ptr> exc( nth );
+    vector<std::thread>        workers;
+    for ( mwSize it = 1; it < nth; ++it ) {
+      workers.push_back( std::thread( [&,it]() {
+        try {
+          K( mex_clones[it-1], it*blk, min( npts, (it+1)*blk ) );
+        } catch (...) {
+          exc[it] = std::current_exception();
+        }
+      } ) );
+    }
+    try {
+      K( *ptr, 0, blk );
+    } catch (...) {
+      exc[0] = std::current_exception();
+    }
+    for ( mwSize it = 0; it < workers.size(); ++it ) workers[it].join();
+    for ( mwSize it = 0; it < nth; ++it )
+      if ( exc[it] ) std::rethrow_exception( exc[it] );
+    return;
+  }
+  #endif
+  K( *ptr, 0, npts );
+}
+
+// mode of the kernels with offset
+enum { MEX_NO_OFFS = 0, MEX_ISO = 1, MEX_SAE = 2 };
+
+// (x,y) or its derivatives at (s[i],t[i]), `incs`/`inct` are 0 for a
+// scalar `s`/`t`, `incxy` is 2 for the output [x;y] and 1 for x and y
+#define MEX_EVAL_KERNEL(NAME,FUN,FUN_ISO,FUN_SAE)                         \
+struct NAME {                                                             \
+  real_type const * s;                                                    \
+  real_type const * t;                                                    \
+  real_type       * x;                                                    \
+  real_type       * y;                                                    \
+  mwSize            incs, inct, incxy;                                    \
+  int               mode;                                                 \
+  void                                                                    \
+  operator () ( G2LIB_CLASS const & C, mwSize i0, mwSize i1 ) const {      \
+    real_type const * ps = s+i0*incs;                                     \
+    real_type const * pt = t+i0*inct;                                     \
+    real_type       * px = x+i0*incxy;                                    \
+    real_type       * py = y+i0*incxy;                                    \
+    mwSize i = i0;                                                        \
+    if ( mode == MEX_ISO ) {                                              \
+      for ( ; i < i1; ++i, ps += incs, pt += inct, px += incxy, py += incxy ) \
+        C.G2LIB_CLASS::FUN_ISO( *ps, *pt, *px, *py );                     \
+    } else if ( mode == MEX_SAE ) {                                       \
+      for ( ; i < i1; ++i, ps += incs, pt += inct, px += incxy, py += incxy ) \
+        C.G2LIB_CLASS::FUN_SAE( *ps, *pt, *px, *py );                     \
+    } else {                                                              \
+      for ( ; i < i1; ++i, ps += incs, px += incxy, py += incxy )         \
+        C.G2LIB_CLASS::FUN( *ps, *px, *py );                              \
+    }                                                                     \
+  }                                                                       \
+}
+
+MEX_EVAL_KERNEL( EvalKernel,     eval,     eval_ISO,     eval_SAE     );
+MEX_EVAL_KERNEL( EvalKernel_D,   eval_D,   eval_ISO_D,   eval_SAE_D   );
+MEX_EVAL_KERNEL( EvalKernel_DD,  eval_DD,  eval_ISO_DD,  eval_SAE_DD  );
+MEX_EVAL_KERNEL( EvalKernel_DDD, eval_DDD, eval_ISO_DDD, eval_SAE_DDD );
+
+#undef MEX_EVAL_KERNEL
+
+// theta, kappa, x, y at (s[i],t[i]), `inc` is 4 for the output
+// [theta;kappa;x;y] and 1 for separate outputs
+struct EvaluateKernel {
+  real_type const * s;
+  real_type const * t;
+  real_type       * th;
+  real_type       * k;
+  real_type       * x;
+  real_type       * y;
+  mwSize            incs, inct, inc;
+  int               mode;
+  void
+  operator () ( G2LIB_CLASS const & C, mwSize i0, mwSize i1 ) const {
+    real_type const * ps  = s+i0*incs;
+    real_type const * pt  = t+i0*inct;
+    real_type       * pth = th+i0*inc;
+    real_type       * pk  = k+i0*inc;
+    real_type       * px  = x+i0*inc;
+    real_type       * py  = y+i0*inc;
+    for ( mwSize i = i0; i < i1;
+          ++i, ps += incs, pt += inct, pth += inc, pk += inc, px += inc, py += inc ) {
+      if      ( mode == MEX_ISO ) C.G2LIB_CLASS::evaluate_ISO( *ps, *pt, *pth, *pk, *px, *py );
+      else if ( mode == MEX_SAE ) C.G2LIB_CLASS::evaluate_SAE( *ps, *pt, *pth, *pk, *px, *py );
+      else                        C.G2LIB_CLASS::evaluate( *ps, *pth, *pk, *px, *py );
+    }
+  }
+};
+
+// v[i] = FUN(s[i])
+#define MEX_S_KERNEL(NAME,FUN)                                            \
+struct NAME {                                                             \
+  real_type const * s;                                                    \
+  real_type       * v;                                                    \
+  void                                                                    \
+  operator () ( G2LIB_CLASS const & C, mwSize i0, mwSize i1 ) const {      \
+    for ( mwSize i = i0; i < i1; ++i ) v[i] = C.G2LIB_CLASS::FUN( s[i] ); \
+  }                                                                       \
+}
+
+MEX_S_KERNEL( ThetaKernel,     theta     );
+MEX_S_KERNEL( ThetaKernel_D,   theta_D   );
+MEX_S_KERNEL( ThetaKernel_DD,  theta_DD  );
+MEX_S_KERNEL( ThetaKernel_DDD, theta_DDD );
+MEX_S_KERNEL( KappaKernel,     kappa     );
+MEX_S_KERNEL( KappaKernel_D,   kappa_D   );
+MEX_S_KERNEL( KappaKernel_DD,  kappa_DD  );
+
+#undef MEX_S_KERNEL
+
+// projection of (qx[i],qy[i])
+struct ClosestPointKernel {
+  real_type const * qx;
+  real_type const * qy;
+  real_type         offs;
+  real_type       * x;
+  real_type       * y;
+  real_type       * s;
+  real_type       * t;
+  int32_t         * iflag;
+  real_type       * dst;
+  int               mode;
+  void
+  operator () ( G2LIB_CLASS const & C, mwSize i0, mwSize i1 ) const {
+    for ( mwSize i = i0; i < i1; ++i ) {
+      if ( mode == MEX_ISO )
+        iflag[i] = C.G2LIB_CLASS::closestPoint_ISO(
+          qx[i], qy[i], offs, x[i], y[i], s[i], t[i], dst[i]
+        );
+      else if ( mode == MEX_SAE )
+        iflag[i] = C.G2LIB_CLASS::closestPoint_SAE(
+          qx[i], qy[i], offs, x[i], y[i], s[i], t[i], dst[i]
+        );
+      else
+        iflag[i] = C.G2LIB_CLASS::closestPoint_ISO(
+          qx[i], qy[i], x[i], y[i], s[i], t[i], dst[i]
+        );
+    }
+  }
+};
+
+// distance of (qx[i],qy[i])
+struct DistanceKernel {
+  real_type const * qx;
+  real_type const * qy;
+  real_type         offs;
+  real_type       * dst;
+  int               mode;
+  void
+  operator () ( G2LIB_CLASS const & C, mwSize i0, mwSize i1 ) const {
+    for ( mwSize i = i0; i < i1; ++i ) {
+      if      ( mode == MEX_ISO ) dst[i] = C.G2LIB_CLASS::distance_ISO( qx[i], qy[i], offs );
+      else if ( mode == MEX_SAE ) dst[i] = C.G2LIB_CLASS::distance_SAE( qx[i], qy[i], offs );
+      else                        dst[i] = C.G2LIB_CLASS::distance( qx[i], qy[i] );
+    }
+  }
+};
+
+// (s,t) coordinates of (x[i],y[i])
+struct FindSTKernel {
+  real_type const * x;
+  real_type const * y;
+  real_type       * s;
+  real_type       * t;
+  int               mode;
+  void
+  operator () ( G2LIB_CLASS const & C, mwSize i0, mwSize i1 ) const {
+    for ( mwSize i = i0; i < i1; ++i ) {
+      if ( mode == MEX_SAE ) C.G2LIB_CLASS::findST_SAE( x[i], y[i], s[i], t[i] );
+      else                   C.G2LIB_CLASS::findST_ISO( x[i], y[i], s[i], t[i] );
+    }
+  }
+};
+
 static
 void
 do_length(
@@ -312,30 +541,16 @@ do_closestPoint(
   int32_t   * iflag = createMatrixInt32( arg_out_4, nrx, ncx );
   real_type * dst   = createMatrixValue( arg_out_5, nrx, ncx );
 
-  mwSize size = nrx * ncx;
+  ClosestPointKernel K = { qx, qy, 0, x, y, s, t, iflag, dst, MEX_NO_OFFS };
   if ( nrhs >= 5 ) {
-    real_type offs = getScalarValue(
+    K.offs = getScalarValue(
       arg_in_4, CMD "`offs` expected to be a real scalar"
     );
     bool ISO = true;
     if ( nrhs == 6 ) ISO = do_is_ISO( arg_in_5, CMD " last argument must be a string");
-    if ( ISO ) {
-      for ( mwSize i = 0; i < size; ++i )
-        *iflag++ = ptr->closestPoint_ISO(
-          *qx++,  *qy++, offs, *x++, *y++, *s++, *t++, *dst++
-        );
-    } else {
-      for ( mwSize i = 0; i < size; ++i )
-        *iflag++ = ptr->closestPoint_SAE(
-          *qx++,  *qy++, offs, *x++, *y++, *s++, *t++, *dst++
-        );
-    }
-  } else {
-    for ( mwSize i = 0; i < size; ++i )
-      *iflag++ = ptr->closestPoint_ISO(
-        *qx++, *qy++, *x++, *y++, *s++, *t++, *dst++
-      );
+    K.mode = ISO ? MEX_ISO : MEX_SAE;
   }
+  do_parallel( K, ptr, nrx * ncx );
 
   #undef CMD
 }
@@ -382,24 +597,16 @@ do_distance(
 
   real_type * dst = createMatrixValue( arg_out_0, nrx, ncx );
 
-  mwSize size = nrx * ncx;
+  DistanceKernel K = { qx, qy, 0, dst, MEX_NO_OFFS };
   if ( nrhs >= 5 ) {
-    real_type offs = getScalarValue(
+    K.offs = getScalarValue(
       arg_in_4, CMD "`offs` expected to be a real scalar"
     );
     bool ISO = true;
     if ( nrhs == 6 ) ISO = do_is_ISO( arg_in_5, CMD " last argument must be a string");
-    if ( ISO ) {
-      for ( mwSize i = 0; i < size; ++i )
-        *dst++ = ptr->distance_ISO( *qx++, *qy++, offs );
-    } else {
-      for ( mwSize i = 0; i < size; ++i )
-        *dst++ = ptr->distance_SAE( *qx++, *qy++, offs );
-    }
-  } else {
-    for ( mwSize i = 0; i < size; ++i )
-      *dst++ = ptr->distance( *qx++, *qy++ );
+    K.mode = ISO ? MEX_ISO : MEX_SAE;
   }
+  do_parallel( K, ptr, nrx * ncx );
 
   #undef CMD
 }
@@ -560,14 +767,8 @@ do_findST(
   bool ISO = true;
   if ( nrhs == 5 ) ISO = do_is_ISO( arg_in_4, CMD " last argument must be a string");
 
-  mwSize size = nrx*ncx;
-  if ( ISO ) {
-    for ( mwSize i = 0; i < size; ++i )
-      ptr->findST_ISO( *x++, *y++, *s++, *t++ );
-  } else {
-    for ( mwSize i = 0; i < size; ++i )
-      ptr->findST_SAE( *x++, *y++, *s++, *t++ );
-  }
+  FindSTKernel K = { x, y, s, t, ISO ? MEX_ISO : MEX_SAE };
+  do_parallel( K, ptr, nrx*ncx );
   #undef CMD
 }
 
@@ -623,33 +824,28 @@ do_eval(
       sizet << " or size(s|t) == 1"
     );
 
-    mwSize incs = size  == 1 ? 0 : 1;
-    mwSize inct = sizet == 1 ? 0 : 1;
     mwSize npts = max(size,sizet);
 
-    #define LOOPXY1 for ( mwSize i = 0; i < npts; ++i, s += incs, t += inct, pXY += 2 )
-    #define LOOPXY2 for ( mwSize i = 0; i < npts; ++i, s += incs, t += inct, ++pX, ++pY )
+    EvalKernel K;
+    K.s     = s;
+    K.t     = t;
+    K.incs  = size  == 1 ? 0 : 1;
+    K.inct  = sizet == 1 ? 0 : 1;
+    K.mode  = ISO ? MEX_ISO : MEX_SAE;
 
     if ( nlhs == 1 ) {
-      real_type *pXY = createMatrixValue( arg_out_0, 2,size );
-      if ( ISO ) {
-        LOOPXY1 ptr->eval_ISO( *s, *t, pXY[0], pXY[1] );
-      } else {
-        LOOPXY1 ptr->eval_SAE( *s, *t, pXY[0], pXY[1] );
-      }
+      K.x     = createMatrixValue( arg_out_0, 2, npts );
+      K.y     = K.x+1;
+      K.incxy = 2;
     } else if ( nlhs == 2 ) {
-      real_type *pX = createMatrixValue( arg_out_0, 1,size );
-      real_type *pY = createMatrixValue( arg_out_1, 1,size );
-      if ( ISO ) {
-        LOOPXY2 ptr->eval_ISO( *s, *t, *pX, *pY );
-      } else {
-        LOOPXY2 ptr->eval_SAE( *s, *t, *pX, *pY );
-      }
+      K.x     = createMatrixValue( arg_out_0, 1, npts );
+      K.y     = createMatrixValue( arg_out_1, 1, npts );
+      K.incxy = 1;
     } else {
       MEX_ASSERT( nlhs == 0, CMD "expected 1 or 2 outputs, nlhs = " << nlhs );
+      return;
     }
-    #undef LOOPXY1
-    #undef LOOPXY2
+    do_parallel( K, ptr, npts );
 
     #undef CMD
 
@@ -664,24 +860,29 @@ do_eval(
       CMD "`s` expected to be a real vector"
     );
 
-    #define LOOPXY1 for ( mwSize i = 0; i < npts; ++i, ++s, pXY += 2 )
-    #define LOOPXY2 for ( mwSize i = 0; i < npts; ++i, ++s, ++pX, ++pY )
+    EvalKernel K;
+    K.s     = s;
+    K.t     = nullptr;
+    K.incs  = 1;
+    K.inct  = 0;
+    K.mode  = MEX_NO_OFFS;
 
     if ( nlhs == 1 ) {
-      real_type *pXY = createMatrixValue( arg_out_0, 2, npts );
-      LOOPXY1 ptr->eval( *s, pXY[0], pXY[1] );
+      K.x     = createMatrixValue( arg_out_0, 2, npts );
+      K.y     = K.x+1;
+      K.incxy = 2;
     } else if ( nlhs == 2 ) {
-      real_type *pX = createMatrixValue( arg_out_0, 1, npts );
-      real_type *pY = createMatrixValue( arg_out_1, 1, npts );
-      LOOPXY2 ptr->eval( *s, *pX, *pY );
+      K.x     = createMatrixValue( arg_out_0, 1, npts );
+      K.y     = createMatrixValue( arg_out_1, 1, npts );
+      K.incxy = 1;
     } else {
       MEX_ASSERT(
         nlhs == 0,
         CMD "expected 1 or 2 outputs, nlhs = " << nlhs
       );
+      return;
     }
-    #undef LOOPXY1
-    #undef LOOPXY2
+    do_parallel( K, ptr, npts );
 
     #undef CMD
   }
@@ -722,33 +923,28 @@ do_eval_D(
       " or size(s|t) == 1"
     );
 
-    mwSize incs = size  == 1 ? 0 : 1;
-    mwSize inct = sizet == 1 ? 0 : 1;
     mwSize npts = max(size,sizet);
 
-    #define LOOPXY1 for ( mwSize i = 0; i < npts; ++i, s += incs, t += inct, pXY += 2 )
-    #define LOOPXY2 for ( mwSize i = 0; i < npts; ++i, s += incs, t += inct, ++pX, ++pY )
+    EvalKernel_D K;
+    K.s     = s;
+    K.t     = t;
+    K.incs  = size  == 1 ? 0 : 1;
+    K.inct  = sizet == 1 ? 0 : 1;
+    K.mode  = ISO ? MEX_ISO : MEX_SAE;
 
     if ( nlhs == 1 ) {
-      real_type *pXY = createMatrixValue( arg_out_0, 2,size );
-      if ( ISO ) {
-        LOOPXY1 ptr->eval_ISO_D( *s, *t, pXY[0], pXY[1] );
-      } else {
-        LOOPXY1 ptr->eval_SAE_D( *s, *t, pXY[0], pXY[1] );
-      }
+      K.x     = createMatrixValue( arg_out_0, 2, npts );
+      K.y     = K.x+1;
+      K.incxy = 2;
     } else if ( nlhs == 2 ) {
-      real_type *pX = createMatrixValue( arg_out_0, 1,size );
-      real_type *pY = createMatrixValue( arg_out_1, 1,size );
-      if ( ISO ) {
-        LOOPXY2 ptr->eval_ISO_D( *s, *t, *pX, *pY );
-      } else {
-        LOOPXY2 ptr->eval_SAE_D( *s, *t, *pX, *pY );
-      }
+      K.x     = createMatrixValue( arg_out_0, 1, npts );
+      K.y     = createMatrixValue( arg_out_1, 1, npts );
+      K.incxy = 1;
     } else {
       MEX_ASSERT( nlhs == 0, CMD "expected 1 or 2 outputs, nlhs = " << nlhs );
+      return;
     }
-    #undef LOOPXY1
-    #undef LOOPXY2
+    do_parallel( K, ptr, npts );
 
     #undef CMD
 
@@ -762,23 +958,28 @@ do_eval_D(
       arg_in_2, npts, CMD "`s` expected to be a real vector"
     );
 
-    #define LOOPXY1 for ( mwSize i = 0; i < npts; ++i, ++s, pXY += 2 )
-    #define LOOPXY2 for ( mwSize i = 0; i < npts; ++i, ++s, ++pX, ++pY )
+    EvalKernel_D K;
+    K.s     = s;
+    K.t     = nullptr;
+    K.incs  = 1;
+    K.inct  = 0;
+    K.mode  = MEX_NO_OFFS;
 
     if ( nlhs == 1 ) {
-      real_type *pXY = createMatrixValue( arg_out_0, 2, npts );
-      LOOPXY1 ptr->eval_D( *s, pXY[0], pXY[1] );
+      K.x     = createMatrixValue( arg_out_0, 2, npts );
+      K.y     = K.x+1;
+      K.incxy = 2;
     } else if ( nlhs == 2 ) {
-      real_type *pX = createMatrixValue( arg_out_0, 1, npts );
-      real_type *pY = createMatrixValue( arg_out_1, 1, npts );
-      LOOPXY2 ptr->eval_D( *s, *pX, *pY );
+      K.x     = createMatrixValue( arg_out_0, 1, npts );
+      K.y     = createMatrixValue( arg_out_1, 1, npts );
+      K.incxy = 1;
     } else {
       MEX_ASSERT(
         nlhs == 0, CMD "expected 1 or 2 outputs, nlhs = " << nlhs
       );
+      return;
     }
-    #undef LOOPXY1
-    #undef LOOPXY2
+    do_parallel( K, ptr, npts );
 
     #undef CMD
   }
@@ -816,36 +1017,31 @@ do_eval_DD(
       " or size(s|t) == 1"
     );
 
-    mwSize incs = size  == 1 ? 0 : 1;
-    mwSize inct = sizet == 1 ? 0 : 1;
-    mwSize npts = max(size,sizet);
-
-    #define LOOPXY1 for ( mwSize i = 0; i < npts; ++i, s += incs, t += inct, pXY += 2 )
-    #define LOOPXY2 for ( mwSize i = 0; i < npts; ++i, s += incs, t += inct, ++pX, ++pY )
-
     bool ISO = true;
     if ( nrhs == 5 ) ISO = do_is_ISO( arg_in_4, CMD " last argument must be a string");
 
+    mwSize npts = max(size,sizet);
+
+    EvalKernel_DD K;
+    K.s     = s;
+    K.t     = t;
+    K.incs  = size  == 1 ? 0 : 1;
+    K.inct  = sizet == 1 ? 0 : 1;
+    K.mode  = ISO ? MEX_ISO : MEX_SAE;
+
     if ( nlhs == 1 ) {
-      real_type *pXY = createMatrixValue( arg_out_0, 2,size );
-      if ( ISO ) {
-        LOOPXY1 ptr->eval_ISO_DD( *s, *t, pXY[0], pXY[1] );
-      } else {
-        LOOPXY1 ptr->eval_SAE_DD( *s, *t, pXY[0], pXY[1] );
-      }
+      K.x     = createMatrixValue( arg_out_0, 2, npts );
+      K.y     = K.x+1;
+      K.incxy = 2;
     } else if ( nlhs == 2 ) {
-      real_type *pX = createMatrixValue( arg_out_0, 1,size );
-      real_type *pY = createMatrixValue( arg_out_1, 1,size );
-      if ( ISO ) {
-        LOOPXY2 ptr->eval_ISO_DD( *s, *t, *pX, *pY );
-      } else {
-        LOOPXY2 ptr->eval_SAE_DD( *s, *t, *pX, *pY );
-      }
+      K.x     = createMatrixValue( arg_out_0, 1, npts );
+      K.y     = createMatrixValue( arg_out_1, 1, npts );
+      K.incxy = 1;
     } else {
       MEX_ASSERT( nlhs == 0, CMD "expected 1 or 2 outputs, nlhs = " << nlhs );
+      return;
     }
-    #undef LOOPXY1
-    #undef LOOPXY2
+    do_parallel( K, ptr, npts );
 
     #undef CMD
 
@@ -859,23 +1055,28 @@ do_eval_DD(
       arg_in_2, npts, CMD "`s` expected to be a real vector"
     );
 
-    #define LOOPXY1 for ( mwSize i = 0; i < npts; ++i, ++s, pXY += 2 )
-    #define LOOPXY2 for ( mwSize i = 0; i < npts; ++i, ++s, ++pX, ++pY )
+    EvalKernel_DD K;
+    K.s     = s;
+    K.t     = nullptr;
+    K.incs  = 1;
+    K.inct  = 0;
+    K.mode  = MEX_NO_OFFS;
 
     if ( nlhs == 1 ) {
-      real_type *pXY = createMatrixValue( arg_out_0, 2, npts );
-      LOOPXY1 ptr->eval_DD( *s, pXY[0], pXY[1] );
+      K.x     = createMatrixValue( arg_out_0, 2, npts );
+      K.y     = K.x+1;
+      K.incxy = 2;
     } else if ( nlhs == 2 ) {
-      real_type *pX = createMatrixValue( arg_out_0, 1, npts );
-      real_type *pY = createMatrixValue( arg_out_1, 1, npts );
-      LOOPXY2 ptr->eval_DD( *s, *pX, *pY );
+      K.x     = createMatrixValue( arg_out_0, 1, npts );
+      K.y     = createMatrixValue( arg_out_1, 1, npts );
+      K.incxy = 1;
     } else {
       MEX_ASSERT(
         nlhs == 0, CMD "expected 1 or 2 outputs, nlhs = " << nlhs
       );
+      return;
     }
-    #undef LOOPXY1
-    #undef LOOPXY2
+    do_parallel( K, ptr, npts );
 
     #undef CMD
   }
@@ -913,36 +1114,31 @@ do_eval_DDD(
       " or size(s|t) == 1"
     );
 
-    mwSize incs = size  == 1 ? 0 : 1;
-    mwSize inct = sizet == 1 ? 0 : 1;
-    mwSize npts = max(size,sizet);
-
-    #define LOOPXY1 for ( mwSize i = 0; i < npts; ++i, s += incs, t += inct, pXY += 2 )
-    #define LOOPXY2 for ( mwSize i = 0; i < npts; ++i, s += incs, t += inct, ++pX, ++pY )
-
     bool ISO = true;
     if ( nrhs == 5 ) ISO = do_is_ISO( arg_in_4, CMD " last argument must be a string");
 
+    mwSize npts = max(size,sizet);
+
+    EvalKernel_DDD K;
+    K.s     = s;
+    K.t     = t;
+    K.incs  = size  == 1 ? 0 : 1;
+    K.inct  = sizet == 1 ? 0 : 1;
+    K.mode  = ISO ? MEX_ISO : MEX_SAE;
+
     if ( nlhs == 1 ) {
-      real_type *pXY = createMatrixValue( arg_out_0, 2,size );
-      if ( ISO ) {
-        LOOPXY1 ptr->eval_ISO_DDD( *s, *t, pXY[0], pXY[1] );
-      } else {
-        LOOPXY1 ptr->eval_SAE_DDD( *s, *t, pXY[0], pXY[1] );
-      }
+      K.x     = createMatrixValue( arg_out_0, 2, npts );
+      K.y     = K.x+1;
+      K.incxy = 2;
     } else if ( nlhs == 2 ) {
-      real_type *pX = createMatrixValue( arg_out_0, 1,size );
-      real_type *pY = createMatrixValue( arg_out_1, 1,size );
-      if ( ISO ) {
-        LOOPXY2 ptr->eval_ISO_DDD( *s, *t, *pX, *pY );
-      } else {
-        LOOPXY2 ptr->eval_SAE_DDD( *s, *t, *pX, *pY );
-      }
+      K.x     = createMatrixValue( arg_out_0, 1, npts );
+      K.y     = createMatrixValue( arg_out_1, 1, npts );
+      K.incxy = 1;
     } else {
       MEX_ASSERT( nlhs == 0, CMD "expected 1 or 2 outputs, nlhs = " << nlhs );
+      return;
     }
-    #undef LOOPXY1
-    #undef LOOPXY2
+    do_parallel( K, ptr, npts );
 
     #undef CMD
 
@@ -956,23 +1152,28 @@ do_eval_DDD(
       arg_in_2, npts, CMD "`s` expected to be a real vector"
     );
 
-    #define LOOPXY1 for ( mwSize i = 0; i < npts; ++i, ++s, pXY += 2 )
-    #define LOOPXY2 for ( mwSize i = 0; i < npts; ++i, ++s, ++pX, ++pY )
+    EvalKernel_DDD K;
+    K.s     = s;
+    K.t     = nullptr;
+    K.incs  = 1;
+    K.inct  = 0;
+    K.mode  = MEX_NO_OFFS;
 
     if ( nlhs == 1 ) {
-      real_type *pXY = createMatrixValue( arg_out_0, 2, npts );
-      LOOPXY1 ptr->eval_DDD( *s, pXY[0], pXY[1] );
+      K.x     = createMatrixValue( arg_out_0, 2, npts );
+      K.y     = K.x+1;
+      K.incxy = 2;
     } else if ( nlhs == 2 ) {
-      real_type *pX = createMatrixValue( arg_out_0, 1, npts );
-      real_type *pY = createMatrixValue( arg_out_1, 1, npts );
-      LOOPXY2 ptr->eval_DDD( *s, *pX, *pY );
+      K.x     = createMatrixValue( arg_out_0, 1, npts );
+      K.y     = createMatrixValue( arg_out_1, 1, npts );
+      K.incxy = 1;
     } else {
       MEX_ASSERT(
         nlhs == 0, CMD "expected 1 or 2 outputs, nlhs = " << nlhs
       );
+      return;
     }
-    #undef LOOPXY1
-    #undef LOOPXY2
+    do_parallel( K, ptr, npts );
 
     #undef CMD
   }
@@ -1012,39 +1213,32 @@ do_evaluate(
       " or size(s|t) == 1"
     );
 
-    mwSize incs = size  == 1 ? 0 : 1;
-    mwSize inct = sizet == 1 ? 0 : 1;
     mwSize npts = max(size,sizet);
 
-    #define LOOPXY1 \
-      for ( mwSize i = 0; i < npts;  \
-            ++i, s += incs, t += inct, pXY += 4 )
-    #define LOOPXY2 \
-      for ( mwSize i = 0; i < npts; \
-            ++i, s += incs, t += inct, ++pTH, ++pK, ++pX, ++pY  )
+    EvaluateKernel K;
+    K.s    = s;
+    K.t    = t;
+    K.incs = size  == 1 ? 0 : 1;
+    K.inct = sizet == 1 ? 0 : 1;
+    K.mode = ISO ? MEX_ISO : MEX_SAE;
 
     if ( nlhs == 1 ) {
-      real_type *pXY = createMatrixValue( arg_out_0, 4, size );
-      if ( ISO ) {
-        LOOPXY1 ptr->evaluate_ISO( *s, *t, pXY[0], pXY[1], pXY[2], pXY[3] );
-      } else {
-        LOOPXY1 ptr->evaluate_SAE( *s, *t, pXY[0], pXY[1], pXY[2], pXY[3] );
-      }
+      K.th  = createMatrixValue( arg_out_0, 4, npts );
+      K.k   = K.th+1;
+      K.x   = K.th+2;
+      K.y   = K.th+3;
+      K.inc = 4;
     } else if ( nlhs == 4 ) {
-      real_type *pX  = createMatrixValue( arg_out_0, 1, size );
-      real_type *pY  = createMatrixValue( arg_out_1, 1, size );
-      real_type *pTH = createMatrixValue( arg_out_2, 1, size );
-      real_type *pK  = createMatrixValue( arg_out_3, 1, size );
-      if ( ISO ) {
-        LOOPXY2 ptr->evaluate_ISO( *s, *t, *pTH, *pK, *pX, *pY );
-      } else {
-        LOOPXY2 ptr->evaluate_SAE( *s, *t, *pTH, *pK, *pX, *pY );
-      }
+      K.x   = createMatrixValue( arg_out_0, 1, npts );
+      K.y   = createMatrixValue( arg_out_1, 1, npts );
+      K.th  = createMatrixValue( arg_out_2, 1, npts );
+      K.k   = createMatrixValue( arg_out_3, 1, npts );
+      K.inc = 1;
     } else {
       MEX_ASSERT( nlhs == 0, CMD "expected 1 or 2 outputs, nlhs = " << nlhs );
+      return;
     }
-    #undef LOOPXY1
-    #undef LOOPXY2
+    do_parallel( K, ptr, npts );
 
     #undef CMD
 
@@ -1058,28 +1252,30 @@ do_evaluate(
       arg_in_2, npts, CMD "`s` expected to be a real vector"
     );
 
-    #define LOOPXY1 \
-      for ( mwSize i = 0; i < npts;  \
-            ++i, ++s, pXY += 4 )
-    #define LOOPXY2 \
-      for ( mwSize i = 0; i < npts; \
-            ++i, ++s, ++pTH, ++pK, ++pX, ++pY )
+    EvaluateKernel K;
+    K.s    = s;
+    K.t    = nullptr;
+    K.incs = 1;
+    K.inct = 0;
+    K.mode = MEX_NO_OFFS;
 
     if ( nlhs == 1 ) {
-      real_type *pXY = createMatrixValue( arg_out_0, 4, npts );
-      LOOPXY1 ptr->evaluate( *s, pXY[0], pXY[1], pXY[2], pXY[3] );
+      K.th  = createMatrixValue( arg_out_0, 4, npts );
+      K.k   = K.th+1;
+      K.x   = K.th+2;
+      K.y   = K.th+3;
+      K.inc = 4;
     } else if ( nlhs == 4 ) {
-      real_type *pX  = createMatrixValue( arg_out_0, 1, npts );
-      real_type *pY  = createMatrixValue( arg_out_1, 1, npts );
-      real_type *pTH = createMatrixValue( arg_out_2, 1, npts );
-      real_type *pK  = createMatrixValue( arg_out_3, 1, npts );
-      LOOPXY2 ptr->evaluate( *s, *pTH, *pK, *pX, *pY);
+      K.x   = createMatrixValue( arg_out_0, 1, npts );
+      K.y   = createMatrixValue( arg_out_1, 1, npts );
+      K.th  = createMatrixValue( arg_out_2, 1, npts );
+      K.k   = createMatrixValue( arg_out_3, 1, npts );
+      K.inc = 1;
     } else {
       MEX_ASSERT( nlhs == 0, CMD "expected 1 or 2 outputs, nlhs = " << nlhs );
+      return;
     }
-
-    #undef LOOPXY1
-    #undef LOOPXY2
+    do_parallel( K, ptr, npts );
 
     #undef CMD
   }
@@ -1108,8 +1304,8 @@ do_theta(
 
   real_type *theta = createMatrixValue( arg_out_0, 1, size );
 
-  for ( mwSize i = 0; i < size; ++i )
-    *theta++ = ptr->theta( *s++ );
+  ThetaKernel K = { s, theta };
+  do_parallel( K, ptr, size );
 
   #undef CMD
 }
@@ -1137,8 +1333,8 @@ do_theta_D(
 
   real_type *theta = createMatrixValue( arg_out_0, 1, size );
 
-  for ( mwSize i = 0; i < size; ++i )
-    *theta++ = ptr->theta_D( *s++ );
+  ThetaKernel_D K = { s, theta };
+  do_parallel( K, ptr, size );
 
   #undef CMD
 }
@@ -1166,8 +1362,8 @@ do_theta_DD(
 
   real_type *theta = createMatrixValue( arg_out_0, 1, size );
 
-  for ( mwSize i = 0; i < size; ++i )
-    *theta++ = ptr->theta_DD( *s++ );
+  ThetaKernel_DD K = { s, theta };
+  do_parallel( K, ptr, size );
 
   #undef CMD
 }
@@ -1195,8 +1391,8 @@ do_theta_DDD(
 
   real_type *theta = createMatrixValue( arg_out_0, 1, size );
 
-  for ( mwSize i = 0; i < size; ++i )
-    *theta++ = ptr->theta_DDD( *s++ );
+  ThetaKernel_DDD K = { s, theta };
+  do_parallel( K, ptr, size );
 
   #undef CMD
 }
@@ -1224,8 +1420,8 @@ do_kappa(
 
   real_type *kappa = createMatrixValue( arg_out_0, 1, size );
 
-  for ( mwSize i = 0; i < size; ++i )
-    *kappa++ = ptr->kappa( *s++ );
+  KappaKernel K = { s, kappa };
+  do_parallel( K, ptr, size );
 
   #undef CMD
 }
@@ -1253,8 +1449,8 @@ do_kappa_D(
 
   real_type *kappa_D = createMatrixValue( arg_out_0, 1, size );
 
-  for ( mwSize i = 0; i < size; ++i )
-    *kappa_D++ = ptr->kappa_D( *s++ );
+  KappaKernel_D K = { s, kappa_D };
+  do_parallel( K, ptr, size );
 
   #undef CMD
 }
@@ -1282,8 +1478,8 @@ do_kappa_DD(
 
   real_type *kappa_DD = createMatrixValue( arg_out_0, 1, size );
 
-  for ( mwSize i = 0; i < size; ++i )
-    *kappa_DD++ = ptr->kappa_DD( *s++ );
+  KappaKernel_DD K = { s, kappa_DD };
+  do_parallel( K, ptr, size );
 
   #undef CMD
 }
@@ -35,6 +35,13 @@ either expressed or implied, of the FreeBSD Project.
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <vector>
+
+// threads of the vectorized commands (G2lib.hh is included before)
+#ifdef G2LIB_USE_CXX11
+  #include <thread>
+  #include <exception>
+#endif
 
 #define arg_in_0 prhs[0]
 #define arg_in_1 prhs[1]
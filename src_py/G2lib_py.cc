@@ -0,0 +1,1173 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2018                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: G2lib_py.cc
+///
+/// Python module `G2lib`: the classes `ClothoidCurve`, `ClothoidList`,
+/// `BiarcList`, `PolyLine` and the G2 solvers.
+///
+/// The vectors are exchanged with the buffer protocol: a C contiguous
+/// buffer of `float64` (a NumPy array, an `array.array('d')`, ...) is
+/// used without copy, any other sequence is converted. The results are
+/// NumPy arrays (or `array.array('d')` if NumPy is not installed), they
+/// are filled in place by the batched methods of the library. Only the
+/// header `Python.h` is needed to compile the module.
+///
+/// The computations are done with the GIL released. The queries of the
+/// curves are not thread safe (`last_idx`, lazy AABB tree), so each
+/// object has a mutex: the calls on the same object are serialized, the
+/// calls on different objects run concurrently. Python threads that
+/// query the same curve in parallel must each use their own `copy()`.
+///
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "ClothoidList.hh"
+#include "BiarcList.hh"
+#include "PolyLine.hh"
+#include "CurveStatic.hh"
+#include "Fresnel.hh"
+
+#include <mutex>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <exception>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using G2lib::BaseCurve;
+using G2lib::ClothoidCurve;
+using G2lib::ClothoidList;
+using G2lib::BiarcList;
+using G2lib::PolyLine;
+using G2lib::CurveStatic;
+using G2lib::AABBworkspace;
+using G2lib::IntersectList;
+using std::vector;
+using std::string;
+
+namespace {
+
+  /*\
+   |   ____         __  __
+   |  | __ ) _   _ / _|/ _| ___ _ __ ___
+   |  |  _ \| | | | |_| |_ / _ \ '__/ __|
+   |  | |_) | |_| |  _|  _|  __/ |  \__ \
+   |  |____/ \__,_|_| |_|  \___|_|  |___/
+  \*/
+
+  PyObject * np_empty        = nullptr; // numpy.empty
+  PyObject * np_ascontiguous = nullptr; // numpy.ascontiguousarray
+  PyObject * array_array     = nullptr; // array.array
+
+  //! the buffer is a vector of native `double`
+  bool
+  is_double( Py_buffer const & view ) {
+    if ( view.itemsize != sizeof(real_type) ) return false;
+    char const * fmt = view.format;
+    if ( fmt == nullptr ) return true; // unsigned bytes
+    if ( *fmt == '@' || *fmt == '=' ) ++fmt;
+    #if PY_LITTLE_ENDIAN
+    else if ( *fmt == '<' ) ++fmt;
+    #else
+    else if ( *fmt == '>' || *fmt == '!' ) ++fmt;
+    #endif
+    return std::strcmp( fmt, "d" ) == 0;
+  }
+
+  //! vector (or scalar) in input
+  class InBuf {
+    Py_buffer view;
+    bool      has_view;
+    real_type value;
+  public:
+    real_type const * ptr;
+    Py_ssize_t        n;
+    bool              scalar;
+
+    InBuf() : has_view(false), value(0), ptr(nullptr), n(0), scalar(false) {}
+    ~InBuf() { if ( has_view ) PyBuffer_Release( &view ); }
+
+    //! element `i`, the scalars are broadcasted
+    real_type operator [] ( Py_ssize_t i ) const { return ptr[scalar?0:i]; }
+
+    bool
+    set( PyObject * obj, char const * name ) {
+      if ( PyFloat_Check(obj) || PyLong_Check(obj) ) {
+        value  = PyFloat_AsDouble( obj );
+        if ( value == -1 && PyErr_Occurred() ) return false;
+        ptr    = &value;
+        n      = 1;
+        scalar = true;
+        return true;
+      }
+      // zero copy
+      if ( PyObject_GetBuffer( obj, &view, PyBUF_C_CONTIGUOUS|PyBUF_FORMAT ) == 0 ) {
+        if ( is_double( view ) ) {
+          has_view = true;
+          ptr      = static_cast<real_type const *>(view.buf);
+          n        = view.len / Py_ssize_t(sizeof(real_type));
+          return true;
+        }
+        PyBuffer_Release( &view );
+      }
+      PyErr_Clear();
+      // conversion (the converted object is kept alive by the view)
+      PyObject * tmp = np_ascontiguous != nullptr
+                     ? PyObject_CallFunction( np_ascontiguous, "Os", obj, "float64" )
+                     : PyObject_CallFunction( array_array, "sO", "d", obj );
+      if ( tmp == nullptr ) {
+        PyErr_Format(
+          PyExc_TypeError, "G2lib: `%s` must be a float or a vector of floats", name
+        );
+        return false;
+      }
+      int ok = PyObject_GetBuffer( tmp, &view, PyBUF_C_CONTIGUOUS|PyBUF_FORMAT );
+      Py_DECREF( tmp );
+      if ( ok != 0 ) return false;
+      has_view = true;
+      if ( !is_double( view ) ) {
+        PyErr_Format( PyExc_TypeError, "G2lib: `%s` cannot be converted to float64", name );
+        return false;
+      }
+      ptr = static_cast<real_type const *>(view.buf);
+      n   = view.len / Py_ssize_t(sizeof(real_type));
+      return true;
+    }
+  };
+
+  //! vector in output, filled in place
+  class OutBuf {
+    Py_buffer view;
+    bool      has_view;
+    PyObject * obj;
+  public:
+    real_type * ptr;
+
+    OutBuf() : has_view(false), obj(nullptr), ptr(nullptr) {}
+    ~OutBuf() {
+      if ( has_view ) PyBuffer_Release( &view );
+      Py_XDECREF( obj );
+    }
+
+    bool
+    allocate( Py_ssize_t n ) {
+      if ( np_empty != nullptr ) {
+        obj = PyObject_CallFunction( np_empty, "n", n );
+      } else {
+        PyObject * one = PyObject_CallFunction( array_array, "s[d]", "d", 0.0 );
+        if ( one == nullptr ) return false;
+        obj = PySequence_Repeat( one, n );
+        Py_DECREF( one );
+      }
+      if ( obj == nullptr ) return false;
+      if ( PyObject_GetBuffer( obj, &view, PyBUF_C_CONTIGUOUS|PyBUF_WRITABLE ) != 0 )
+        return false;
+      has_view = true;
+      ptr      = static_cast<real_type *>(view.buf);
+      return true;
+    }
+
+    //! new reference to the result (a float if `scalar`)
+    PyObject *
+    result( bool scalar ) {
+      if ( scalar ) return PyFloat_FromDouble( ptr[0] );
+      Py_INCREF( obj );
+      return obj;
+    }
+  };
+
+  //! vector of `int32` in output, filled in place
+  class OutBufInt32 {
+    Py_buffer view;
+    bool      has_view;
+    PyObject * obj;
+  public:
+    int32_t * ptr;
+
+    OutBufInt32() : has_view(false), obj(nullptr), ptr(nullptr) {}
+    ~OutBufInt32() {
+      if ( has_view ) PyBuffer_Release( &view );
+      Py_XDECREF( obj );
+    }
+
+    bool
+    allocate( Py_ssize_t n ) {
+      if ( np_empty != nullptr ) {
+        obj = PyObject_CallFunction( np_empty, "ns", n, "int32" );
+      } else {
+        PyObject * one = PyObject_CallFunction( array_array, "s[i]", "i", 0 );
+        if ( one == nullptr ) return false;
+        obj = PySequence_Repeat( one, n );
+        Py_DECREF( one );
+      }
+      if ( obj == nullptr ) return false;
+      if ( PyObject_GetBuffer( obj, &view, PyBUF_C_CONTIGUOUS|PyBUF_WRITABLE ) != 0 )
+        return false;
+      has_view = true;
+      if ( view.itemsize != Py_ssize_t(sizeof(int32_t)) ) {
+        PyErr_SetString( PyExc_TypeError, "G2lib: no 32 bit integer vector available" );
+        return false;
+      }
+      ptr = static_cast<int32_t *>(view.buf);
+      return true;
+    }
+
+    //! new reference to the result (an int if `scalar`)
+    PyObject *
+    result( bool scalar ) {
+      if ( scalar ) return PyLong_FromLong( ptr[0] );
+      Py_INCREF( obj );
+      return obj;
+    }
+  };
+
+  bool
+  allocate( Py_ssize_t n, OutBuf * out, int nout ) {
+    for ( int i = 0; i < nout; ++i )
+      if ( !out[i].allocate( n ) ) return false;
+    return true;
+  }
+
+  bool
+  same_size( InBuf const & a, InBuf const & b, char const * na, char const * nb ) {
+    if ( a.n == b.n ) return true;
+    PyErr_Format(
+      PyExc_ValueError, "G2lib: `%s` and `%s` of different size (%zd and %zd)",
+      na, nb, a.n, b.n
+    );
+    return false;
+  }
+
+  /*\
+   |    ____ _ _
+   |   / ___(_) |
+   |  | |  _| | |
+   |  | |_| | | |___
+   |   \____|_|_____|
+  \*/
+
+  /*!
+   * Run `fun` with the GIL released, the C++ exceptions are
+   * raised as `RuntimeError` when the GIL is acquired again.
+   */
+  template <typename FUN>
+  bool
+  nogil( FUN fun ) {
+    string err;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+      fun();
+    } catch ( std::exception const & exc ) {
+      err = exc.what();
+      if ( err.empty() ) err = "G2lib: error";
+    } catch ( ... ) {
+      err = "G2lib: unknown error";
+    }
+    Py_END_ALLOW_THREADS
+    if ( err.empty() ) return true;
+    PyErr_SetString( PyExc_RuntimeError, err.c_str() );
+    return false;
+  }
+
+  /*\
+   |    ____                        ___  _     _           _
+   |   / ___|   _ _ ____   _____  / _ \| |__ (_) ___  ___| |_
+   |  | |  | | | | '__\ \ / / _ \| | | | '_ \| |/ _ \/ __| __|
+   |  | |__| |_| | |   \ V /  __/| |_| | |_) | |  __/ (__| |_
+   |   \____\__,_|_|    \_/ \___| \___/|_.__// |\___|\___|\__|
+   |                                       |__/
+  \*/
+
+  struct CurveObject {
+    PyObject_HEAD
+    BaseCurve  * curve;
+    std::mutex * mtx;
+  };
+
+  template <typename CURVE> struct PyCurve;
+
+  template <> struct PyCurve<ClothoidCurve> { static PyTypeObject * type; };
+  template <> struct PyCurve<ClothoidList>  { static PyTypeObject * type; };
+  template <> struct PyCurve<BiarcList>     { static PyTypeObject * type; };
+  template <> struct PyCurve<PolyLine>      { static PyTypeObject * type; };
+
+  PyTypeObject * PyCurve<ClothoidCurve>::type = nullptr;
+  PyTypeObject * PyCurve<ClothoidList>::type  = nullptr;
+  PyTypeObject * PyCurve<BiarcList>::type     = nullptr;
+  PyTypeObject * PyCurve<PolyLine>::type      = nullptr;
+
+  template <typename CURVE>
+  CURVE &
+  curve_of( PyObject * self )
+  { return *static_cast<CURVE*>(reinterpret_cast<CurveObject*>(self)->curve); }
+
+  std::mutex &
+  mutex_of( PyObject * self )
+  { return *reinterpret_cast<CurveObject*>(self)->mtx; }
+
+  template <typename CURVE>
+  bool
+  is_a( PyObject * obj )
+  { return PyObject_TypeCheck( obj, PyCurve<CURVE>::type ) != 0; }
+
+  bool
+  is_curve( PyObject * obj ) {
+    return is_a<ClothoidCurve>( obj ) || is_a<ClothoidList>( obj ) ||
+           is_a<BiarcList>( obj )     || is_a<PolyLine>( obj );
+  }
+
+  //! new Python object owning `C`
+  template <typename CURVE>
+  PyObject *
+  wrap( CURVE * C ) {
+    PyTypeObject * type = PyCurve<CURVE>::type;
+    CurveObject  * self = reinterpret_cast<CurveObject*>(type->tp_alloc( type, 0 ));
+    if ( self == nullptr ) { delete C; return nullptr; }
+    self->curve = C;
+    self->mtx   = new std::mutex();
+    return reinterpret_cast<PyObject*>(self);
+  }
+
+  template <typename CURVE>
+  PyObject *
+  py_new( PyTypeObject * type, PyObject *, PyObject * ) {
+    CurveObject * self = reinterpret_cast<CurveObject*>(type->tp_alloc( type, 0 ));
+    if ( self == nullptr ) return nullptr;
+    self->curve = new CURVE();
+    self->mtx   = new std::mutex();
+    return reinterpret_cast<PyObject*>(self);
+  }
+
+  void
+  py_dealloc( PyObject * obj ) {
+    CurveObject  * self = reinterpret_cast<CurveObject*>(obj);
+    PyTypeObject * type = Py_TYPE( obj );
+    delete self->curve;
+    delete self->mtx;
+    type->tp_free( obj );
+    Py_DECREF( type );
+  }
+
+  /*\
+   |   _  __                    _
+   |  | |/ /___ _ __ _ __   ___| |___
+   |  | ' // _ \ '__| '_ \ / _ \ / __|
+   |  | . \  __/ |  | | | |  __/ \__ \
+   |  |_|\_\___|_|  |_| |_|\___|_|___/
+  \*/
+
+  //! batched evaluation and projection, the fastest path of each class
+  template <typename CURVE> struct Kernels;
+
+  template <>
+  struct Kernels<ClothoidCurve> {
+    typedef CurveStatic<ClothoidCurve> CS;
+
+    static
+    void
+    eval(
+      ClothoidCurve const & C, int_type n, real_type const s[], real_type offs,
+      real_type x[], real_type y[]
+    ) { CS::sample_ISO( C, offs, n, s, x, y ); }
+
+    static
+    void
+    evaluate(
+      ClothoidCurve const & C, int_type n, real_type const s[], real_type offs,
+      real_type th[], real_type k[], real_type x[], real_type y[]
+    ) {
+      for ( int_type i = 0; i < n; ++i )
+        CS::evaluate_ISO( C, s[i], offs, th[i], k[i], x[i], y[i] );
+    }
+
+    static
+    void
+    closestPoint(
+      ClothoidCurve const & C, int_type n,
+      real_type const qx[], real_type const qy[], real_type offs,
+      real_type x[], real_type y[], real_type s[], real_type t[], real_type dst[],
+      int32_t res[]
+    ) {
+      for ( int_type i = 0; i < n; ++i )
+        res[i] = int32_t( C.ClothoidCurve::closestPoint_ISO(
+          qx[i], qy[i], offs, x[i], y[i], s[i], t[i], dst[i]
+        ) );
+    }
+  };
+
+  template <>
+  struct Kernels<ClothoidList> {
+    static
+    void
+    eval(
+      ClothoidList const & C, int_type n, real_type const s[], real_type offs,
+      real_type x[], real_type y[]
+    ) { C.eval_ISO( n, s, offs, x, y ); }
+
+    static
+    void
+    evaluate(
+      ClothoidList const & C, int_type n, real_type const s[], real_type offs,
+      real_type th[], real_type k[], real_type x[], real_type y[]
+    ) { C.evaluate_ISO( n, s, offs, th, k, x, y ); }
+
+    static
+    void
+    closestPoint(
+      ClothoidList const & C, int_type n,
+      real_type const qx[], real_type const qy[], real_type offs,
+      real_type x[], real_type y[], real_type s[], real_type t[], real_type dst[],
+      int32_t res[]
+    ) {
+      AABBworkspace ws;
+      for ( int_type i = 0; i < n; ++i )
+        res[i] = int32_t( C.closestPoint_ISO(
+          qx[i], qy[i], offs, x[i], y[i], s[i], t[i], dst[i], ws
+        ) );
+    }
+  };
+
+  template <>
+  struct Kernels<BiarcList> {
+    static
+    void
+    eval(
+      BiarcList const & C, int_type n, real_type const s[], real_type offs,
+      real_type x[], real_type y[]
+    ) { C.eval_ISO( n, s, offs, x, y ); }
+
+    static
+    void
+    evaluate(
+      BiarcList const & C, int_type n, real_type const s[], real_type offs,
+      real_type th[], real_type k[], real_type x[], real_type y[]
+    ) { C.evaluate_ISO( n, s, offs, th, k, x, y ); }
+
+    static
+    void
+    closestPoint(
+      BiarcList const & C, int_type n,
+      real_type const qx[], real_type const qy[], real_type offs,
+      real_type x[], real_type y[], real_type s[], real_type t[], real_type dst[],
+      int32_t res[]
+    ) {
+      AABBworkspace ws;
+      for ( int_type i = 0; i < n; ++i )
+        res[i] = int32_t( C.closestPoint_ISO(
+          qx[i], qy[i], offs, x[i], y[i], s[i], t[i], dst[i], ws
+        ) );
+    }
+  };
+
+  template <>
+  struct Kernels<PolyLine> {
+    static
+    void
+    eval(
+      PolyLine const & C, int_type n, real_type const s[], real_type offs,
+      real_type x[], real_type y[]
+    ) {
+      for ( int_type i = 0; i < n; ++i )
+        C.PolyLine::eval_ISO( s[i], offs, x[i], y[i] );
+    }
+
+    static
+    void
+    evaluate(
+      PolyLine const & C, int_type n, real_type const s[], real_type offs,
+      real_type th[], real_type k[], real_type x[], real_type y[]
+    ) {
+      for ( int_type i = 0; i < n; ++i )
+        C.PolyLine::evaluate_ISO( s[i], offs, th[i], k[i], x[i], y[i] );
+    }
+
+    static
+    void
+    closestPoint(
+      PolyLine const & C, int_type n,
+      real_type const qx[], real_type const qy[], real_type offs,
+      real_type x[], real_type y[], real_type s[], real_type t[], real_type dst[],
+      int32_t res[]
+    ) {
+      G2LIB_ASSERT( offs == 0, "PolyLine::closestPoint, offset not available" );
+      for ( int_type i = 0; i < n; ++i )
+        res[i] = int32_t( C.PolyLine::closestPoint_ISO(
+          qx[i], qy[i], x[i], y[i], s[i], t[i], dst[i]
+        ) );
+    }
+  };
+
+  /*\
+   |    ____                                        __  __      _   _               _
+   |   / ___|___  _ __ ___  _ __ ___   ___  _ __   |  \/  | ___| |_| |__   ___   __| |___
+   |  | |   / _ \| '_ ` _ \| '_ ` _ \ / _ \| '_ \  | |\/| |/ _ \ __| '_ \ / _ \ / _` / __|
+   |  | |__| (_) | | | | | | | | | | | (_) | | | | | |  | |  __/ |_| | | | (_) | (_| \__ \
+   |   \____\___/|_| |_| |_|_| |_| |_|\___/|_| |_| |_|  |_|\___|\__|_| |_|\___/ \__,_|___/
+  \*/
+
+  template <typename CURVE>
+  PyObject *
+  py_length( PyObject * self, PyObject * ) {
+    real_type L = 0;
+    CURVE const & C = curve_of<CURVE>( self );
+    if ( !nogil( [&]() {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      L = C.length();
+    } ) ) return nullptr;
+    return PyFloat_FromDouble( L );
+  }
+
+  template <typename CURVE>
+  PyObject *
+  py_bbox( PyObject * self, PyObject * args, PyObject * kwds ) {
+    static char const * kwlist[] = { "offs", nullptr };
+    real_type offs = 0;
+    if ( !PyArg_ParseTupleAndKeywords(
+           args, kwds, "|d", const_cast<char**>(kwlist), &offs
+         ) ) return nullptr;
+    real_type xmin, ymin, xmax, ymax;
+    CURVE const & C = curve_of<CURVE>( self );
+    if ( !nogil( [&]() {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      C.bbox_ISO( offs, xmin, ymin, xmax, ymax );
+    } ) ) return nullptr;
+    return Py_BuildValue( "(dddd)", xmin, ymin, xmax, ymax );
+  }
+
+  //! `eval(s, offs=0)` -> `(x, y)`
+  template <typename CURVE>
+  PyObject *
+  py_eval( PyObject * self, PyObject * args, PyObject * kwds ) {
+    static char const * kwlist[] = { "s", "offs", nullptr };
+    PyObject * s_obj;
+    real_type  offs = 0;
+    if ( !PyArg_ParseTupleAndKeywords(
+           args, kwds, "O|d", const_cast<char**>(kwlist), &s_obj, &offs
+         ) ) return nullptr;
+    InBuf s;
+    if ( !s.set( s_obj, "s" ) ) return nullptr;
+    OutBuf out[2];
+    if ( !allocate( s.n, out, 2 ) ) return nullptr;
+    CURVE const & C = curve_of<CURVE>( self );
+    if ( !nogil( [&]() {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      Kernels<CURVE>::eval( C, int_type(s.n), s.ptr, offs, out[0].ptr, out[1].ptr );
+    } ) ) return nullptr;
+    return Py_BuildValue( "(NN)", out[0].result(s.scalar), out[1].result(s.scalar) );
+  }
+
+  //! `evaluate(s, offs=0)` -> `(theta, kappa, x, y)`
+  template <typename CURVE>
+  PyObject *
+  py_evaluate( PyObject * self, PyObject * args, PyObject * kwds ) {
+    static char const * kwlist[] = { "s", "offs", nullptr };
+    PyObject * s_obj;
+    real_type  offs = 0;
+    if ( !PyArg_ParseTupleAndKeywords(
+           args, kwds, "O|d", const_cast<char**>(kwlist), &s_obj, &offs
+         ) ) return nullptr;
+    InBuf s;
+    if ( !s.set( s_obj, "s" ) ) return nullptr;
+    OutBuf out[4];
+    if ( !allocate( s.n, out, 4 ) ) return nullptr;
+    CURVE const & C = curve_of<CURVE>( self );
+    if ( !nogil( [&]() {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      Kernels<CURVE>::evaluate(
+        C, int_type(s.n), s.ptr, offs,
+        out[0].ptr, out[1].ptr, out[2].ptr, out[3].ptr
+      );
+    } ) ) return nullptr;
+    bool sc = s.scalar;
+    return Py_BuildValue(
+      "(NNNN)",
+      out[0].result(sc), out[1].result(sc), out[2].result(sc), out[3].result(sc)
+    );
+  }
+
+  //! `closestPoint(qx, qy, offs=0)` -> `(x, y, s, t, dst, res)`
+  template <typename CURVE>
+  PyObject *
+  py_closestPoint( PyObject * self, PyObject * args, PyObject * kwds ) {
+    static char const * kwlist[] = { "qx", "qy", "offs", nullptr };
+    PyObject * qx_obj, * qy_obj;
+    real_type  offs = 0;
+    if ( !PyArg_ParseTupleAndKeywords(
+           args, kwds, "OO|d", const_cast<char**>(kwlist), &qx_obj, &qy_obj, &offs
+         ) ) return nullptr;
+    InBuf qx, qy;
+    if ( !qx.set( qx_obj, "qx" ) || !qy.set( qy_obj, "qy" ) ) return nullptr;
+    if ( !same_size( qx, qy, "qx", "qy" ) ) return nullptr;
+    OutBuf      out[5];
+    OutBufInt32 res;
+    if ( !allocate( qx.n, out, 5 ) || !res.allocate( qx.n ) ) return nullptr;
+    CURVE const & C = curve_of<CURVE>( self );
+    if ( !nogil( [&]() {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      Kernels<CURVE>::closestPoint(
+        C, int_type(qx.n), qx.ptr, qy.ptr, offs,
+        out[0].ptr, out[1].ptr, out[2].ptr, out[3].ptr, out[4].ptr, res.ptr
+      );
+    } ) ) return nullptr;
+    bool sc = qx.scalar;
+    return Py_BuildValue(
+      "(NNNNNN)",
+      out[0].result(sc), out[1].result(sc), out[2].result(sc),
+      out[3].result(sc), out[4].result(sc), res.result(sc)
+    );
+  }
+
+  //! `distance(qx, qy, offs=0)` -> `dst`
+  template <typename CURVE>
+  PyObject *
+  py_distance( PyObject * self, PyObject * args, PyObject * kwds ) {
+    static char const * kwlist[] = { "qx", "qy", "offs", nullptr };
+    PyObject * qx_obj, * qy_obj;
+    real_type  offs = 0;
+    if ( !PyArg_ParseTupleAndKeywords(
+           args, kwds, "OO|d", const_cast<char**>(kwlist), &qx_obj, &qy_obj, &offs
+         ) ) return nullptr;
+    InBuf qx, qy;
+    if ( !qx.set( qx_obj, "qx" ) || !qy.set( qy_obj, "qy" ) ) return nullptr;
+    if ( !same_size( qx, qy, "qx", "qy" ) ) return nullptr;
+    OutBuf dst;
+    if ( !dst.allocate( qx.n ) ) return nullptr;
+    CURVE const & C = curve_of<CURVE>( self );
+    if ( !nogil( [&]() {
+      vector<real_type> x(size_t(qx.n)), y(size_t(qx.n)), s(size_t(qx.n)), t(size_t(qx.n));
+      vector<int32_t>   res(size_t(qx.n));
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      Kernels<CURVE>::closestPoint(
+        C, int_type(qx.n), qx.ptr, qy.ptr, offs,
+        &x.front(), &y.front(), &s.front(), &t.front(), dst.ptr, &res.front()
+      );
+    } ) ) return nullptr;
+    return dst.result( qx.scalar );
+  }
+
+  //! `intersect(other, offs=0, offs_other=0)` -> `(s, s_other)`
+  template <typename CURVE>
+  PyObject *
+  py_intersect( PyObject * self, PyObject * args, PyObject * kwds ) {
+    static char const * kwlist[] = { "other", "offs", "offs_other", nullptr };
+    PyObject * other;
+    real_type  offs = 0, offs_other = 0;
+    if ( !PyArg_ParseTupleAndKeywords(
+           args, kwds, "O|dd", const_cast<char**>(kwlist), &other, &offs, &offs_other
+         ) ) return nullptr;
+    if ( !is_curve( other ) ) {
+      PyErr_SetString( PyExc_TypeError, "G2lib: intersect, `other` must be a curve" );
+      return nullptr;
+    }
+    BaseCurve const & C1 = curve_of<CURVE>( self );
+    BaseCurve const & C2 = *reinterpret_cast<CurveObject*>(other)->curve;
+    IntersectList ilist;
+    if ( !nogil( [&]() {
+      if ( self == other ) {
+        std::lock_guard<std::mutex> lock( mutex_of( self ) );
+        G2lib::intersect_ISO( C1, offs, C2, offs_other, ilist, false );
+      } else {
+        std::unique_lock<std::mutex> l1( mutex_of( self ),  std::defer_lock );
+        std::unique_lock<std::mutex> l2( mutex_of( other ), std::defer_lock );
+        std::lock( l1, l2 );
+        G2lib::intersect_ISO( C1, offs, C2, offs_other, ilist, false );
+      }
+    } ) ) return nullptr;
+    OutBuf out[2];
+    if ( !allocate( Py_ssize_t(ilist.size()), out, 2 ) ) return nullptr;
+    for ( size_t i = 0; i < ilist.size(); ++i ) {
+      out[0].ptr[i] = ilist[i].first;
+      out[1].ptr[i] = ilist[i].second;
+    }
+    return Py_BuildValue( "(NN)", out[0].result(false), out[1].result(false) );
+  }
+
+  template <typename CURVE>
+  PyObject *
+  py_copy( PyObject * self, PyObject * ) {
+    CURVE * C = nullptr;
+    if ( !nogil( [&]() {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      C = new CURVE( curve_of<CURVE>( self ) );
+    } ) ) return nullptr;
+    return wrap( C );
+  }
+
+  template <typename CURVE>
+  PyObject *
+  py_repr( PyObject * self ) {
+    std::ostringstream ss;
+    {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      ss << '<' << Py_TYPE(self)->tp_name
+         << " length=" << curve_of<CURVE>( self ).length() << '>';
+    }
+    return PyUnicode_FromString( ss.str().c_str() );
+  }
+
+  #define G2LIB_PY_KW(FUN) reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(FUN))
+
+  #define G2LIB_PY_COMMON_METHODS(CURVE)                                        \
+    { "length", py_length<CURVE>, METH_NOARGS,                                  \
+      "length()\n\nlength of the curve" },                                      \
+    { "bbox", G2LIB_PY_KW(py_bbox<CURVE>), METH_VARARGS|METH_KEYWORDS,          \
+      "bbox(offs=0)\n\n(xmin, ymin, xmax, ymax) of the curve with offset" },    \
+    { "eval", G2LIB_PY_KW(py_eval<CURVE>), METH_VARARGS|METH_KEYWORDS,          \
+      "eval(s, offs=0)\n\n(x, y) at the curvilinear abscissa `s`" },            \
+    { "evaluate", G2LIB_PY_KW(py_evaluate<CURVE>), METH_VARARGS|METH_KEYWORDS,  \
+      "evaluate(s, offs=0)\n\n(theta, kappa, x, y) at the abscissa `s`" },      \
+    { "closestPoint", G2LIB_PY_KW(py_closestPoint<CURVE>),                      \
+      METH_VARARGS|METH_KEYWORDS,                                               \
+      "closestPoint(qx, qy, offs=0)\n\n"                                        \
+      "(x, y, s, t, dst, res) projection of the points (qx, qy), `res`\n"       \
+      "(int32) is the return code of each point (1 orthogonal projection,\n"   \
+      "0 more than one projection, -1 not orthogonal)" },                       \
+    { "distance", G2LIB_PY_KW(py_distance<CURVE>), METH_VARARGS|METH_KEYWORDS,  \
+      "distance(qx, qy, offs=0)\n\ndistance of the points (qx, qy)" },          \
+    { "intersect", G2LIB_PY_KW(py_intersect<CURVE>), METH_VARARGS|METH_KEYWORDS,\
+      "intersect(other, offs=0, offs_other=0)\n\n"                              \
+      "(s, s_other) abscissa of the intersections" },                           \
+    { "copy", py_copy<CURVE>, METH_NOARGS,                                      \
+      "copy()\n\ncopy of the curve, the calls on the same curve are\n"          \
+      "serialized: the threads querying it in parallel use a copy each" }
+
+  /*\
+   |   ____        _ _     _
+   |  | __ ) _   _(_) | __| | ___ _ __ ___
+   |  |  _ \| | | | | |/ _` |/ _ \ '__/ __|
+   |  | |_) | |_| | | | (_| |  __/ |  \__ \
+   |  |____/ \__,_|_|_|\__,_|\___|_|  |___/
+  \*/
+
+  //! `ClothoidCurve.build_G1(x0, y0, theta0, x1, y1, theta1)` -> iterations
+  PyObject *
+  py_clothoid_build_G1( PyObject * self, PyObject * args ) {
+    real_type x0, y0, th0, x1, y1, th1;
+    if ( !PyArg_ParseTuple( args, "dddddd", &x0, &y0, &th0, &x1, &y1, &th1 ) )
+      return nullptr;
+    int iter = 0;
+    if ( !nogil( [&]() {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      iter = curve_of<ClothoidCurve>( self ).build_G1( x0, y0, th0, x1, y1, th1 );
+    } ) ) return nullptr;
+    return PyLong_FromLong( iter );
+  }
+
+  //! `ClothoidCurve.build(x0, y0, theta0, kappa0, dkappa, L)`
+  PyObject *
+  py_clothoid_build( PyObject * self, PyObject * args ) {
+    real_type x0, y0, th0, k0, dk, L;
+    if ( !PyArg_ParseTuple( args, "dddddd", &x0, &y0, &th0, &k0, &dk, &L ) )
+      return nullptr;
+    if ( !nogil( [&]() {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      curve_of<ClothoidCurve>( self ).build( x0, y0, th0, k0, dk, L );
+    } ) ) return nullptr;
+    Py_RETURN_NONE;
+  }
+
+  //! `build_G1(x, y, theta=None)` -> bool, for `ClothoidList` and `BiarcList`
+  template <typename CURVE>
+  PyObject *
+  py_list_build_G1( PyObject * self, PyObject * args ) {
+    PyObject * x_obj, * y_obj, * th_obj = Py_None;
+    if ( !PyArg_ParseTuple( args, "OO|O", &x_obj, &y_obj, &th_obj ) ) return nullptr;
+    InBuf x, y, th;
+    if ( !x.set( x_obj, "x" ) || !y.set( y_obj, "y" ) ) return nullptr;
+    if ( !same_size( x, y, "x", "y" ) ) return nullptr;
+    bool with_theta = th_obj != Py_None;
+    if ( with_theta ) {
+      if ( !th.set( th_obj, "theta" ) ) return nullptr;
+      if ( !same_size( x, th, "x", "theta" ) ) return nullptr;
+    }
+    bool ok = false;
+    if ( !nogil( [&]() {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      CURVE & C = curve_of<CURVE>( self );
+      if ( with_theta ) ok = C.build_G1( int_type(x.n), x.ptr, y.ptr, th.ptr );
+      else              ok = C.build_G1( int_type(x.n), x.ptr, y.ptr );
+    } ) ) return nullptr;
+    return PyBool_FromLong( ok );
+  }
+
+  //! `ClothoidList.push_back(curve)`, `curve` a `ClothoidCurve`
+  PyObject *
+  py_list_push_back( PyObject * self, PyObject * args ) {
+    PyObject * other;
+    if ( !PyArg_ParseTuple( args, "O!", PyCurve<ClothoidCurve>::type, &other ) )
+      return nullptr;
+    if ( !nogil( [&]() {
+      std::unique_lock<std::mutex> l1( mutex_of( self ),  std::defer_lock );
+      std::unique_lock<std::mutex> l2( mutex_of( other ), std::defer_lock );
+      std::lock( l1, l2 );
+      curve_of<ClothoidList>( self ).push_back( curve_of<ClothoidCurve>( other ) );
+    } ) ) return nullptr;
+    Py_RETURN_NONE;
+  }
+
+  //! `ClothoidList.numSegment()`, `BiarcList.numSegment()`
+  template <typename CURVE>
+  PyObject *
+  py_numSegment( PyObject * self, PyObject * ) {
+    std::lock_guard<std::mutex> lock( mutex_of( self ) );
+    return PyLong_FromLong( curve_of<CURVE>( self ).numSegment() );
+  }
+
+  //! `BiarcList.build(CL, tol, nthreads=1)` -> bound of the distance from `CL`
+  PyObject *
+  py_biarc_build( PyObject * self, PyObject * args, PyObject * kwds ) {
+    static char const * kwlist[] = { "CL", "tol", "nthreads", nullptr };
+    PyObject * other;
+    real_type  tol;
+    int        nthreads = 1;
+    if ( !PyArg_ParseTupleAndKeywords(
+           args, kwds, "O!d|i", const_cast<char**>(kwlist),
+           PyCurve<ClothoidList>::type, &other, &tol, &nthreads
+         ) ) return nullptr;
+    real_type err = 0;
+    if ( !nogil( [&]() {
+      std::unique_lock<std::mutex> l1( mutex_of( self ),  std::defer_lock );
+      std::unique_lock<std::mutex> l2( mutex_of( other ), std::defer_lock );
+      std::lock( l1, l2 );
+      err = curve_of<BiarcList>( self ).build(
+        curve_of<ClothoidList>( other ), tol, nthreads
+      );
+    } ) ) return nullptr;
+    return PyFloat_FromDouble( err );
+  }
+
+  //! `PolyLine.build(x, y)` or `PolyLine.build(curve, tol)`
+  PyObject *
+  py_polyline_build( PyObject * self, PyObject * args ) {
+    PyObject * a, * b;
+    if ( !PyArg_ParseTuple( args, "OO", &a, &b ) ) return nullptr;
+    PolyLine & P = curve_of<PolyLine>( self );
+    if ( is_a<ClothoidCurve>( a ) || is_a<ClothoidList>( a ) ) {
+      real_type tol = PyFloat_AsDouble( b );
+      if ( tol == -1 && PyErr_Occurred() ) return nullptr;
+      if ( !nogil( [&]() {
+        std::unique_lock<std::mutex> l1( mutex_of( self ), std::defer_lock );
+        std::unique_lock<std::mutex> l2( mutex_of( a ),    std::defer_lock );
+        std::lock( l1, l2 );
+        if ( is_a<ClothoidCurve>( a ) ) P.build( curve_of<ClothoidCurve>( a ), tol );
+        else                            P.build( curve_of<ClothoidList>( a ), tol );
+      } ) ) return nullptr;
+      Py_RETURN_NONE;
+    }
+    InBuf x, y;
+    if ( !x.set( a, "x" ) || !y.set( b, "y" ) ) return nullptr;
+    if ( !same_size( x, y, "x", "y" ) ) return nullptr;
+    if ( !nogil( [&]() {
+      std::lock_guard<std::mutex> lock( mutex_of( self ) );
+      P.build( x.ptr, y.ptr, int_type(x.n) );
+    } ) ) return nullptr;
+    Py_RETURN_NONE;
+  }
+
+  /*\
+   |   _____
+   |  |_   _|   _ _ __   ___  ___
+   |    | || | | | '_ \ / _ \/ __|
+   |    | || |_| | |_) |  __/\__ \
+   |    |_| \__, | .__/ \___||___/
+   |        |___/|_|
+  \*/
+
+  PyMethodDef ClothoidCurve_methods[] = {
+    G2LIB_PY_COMMON_METHODS(ClothoidCurve),
+    { "build_G1", py_clothoid_build_G1, METH_VARARGS,
+      "build_G1(x0, y0, theta0, x1, y1, theta1)\n\n"
+      "solve the G1 Hermite problem, return the number of iterations" },
+    { "build", py_clothoid_build, METH_VARARGS,
+      "build(x0, y0, theta0, kappa0, dkappa, L)" },
+    { nullptr, nullptr, 0, nullptr }
+  };
+
+  PyMethodDef ClothoidList_methods[] = {
+    G2LIB_PY_COMMON_METHODS(ClothoidList),
+    { "build_G1", py_list_build_G1<ClothoidList>, METH_VARARGS,
+      "build_G1(x, y, theta=None)\n\nG1 interpolation of the points (x, y)" },
+    { "push_back", py_list_push_back, METH_VARARGS,
+      "push_back(curve)\n\nappend the ClothoidCurve `curve`" },
+    { "numSegment", py_numSegment<ClothoidList>, METH_NOARGS,
+      "numSegment()\n\nnumber of segments" },
+    { nullptr, nullptr, 0, nullptr }
+  };
+
+  PyMethodDef BiarcList_methods[] = {
+    G2LIB_PY_COMMON_METHODS(BiarcList),
+    { "build_G1", py_list_build_G1<BiarcList>, METH_VARARGS,
+      "build_G1(x, y, theta=None)\n\nG1 interpolation of the points (x, y)" },
+    { "build", G2LIB_PY_KW(py_biarc_build), METH_VARARGS|METH_KEYWORDS,
+      "build(CL, tol, nthreads=1)\n\n"
+      "approximate the ClothoidList `CL` within `tol`, return a bound of the distance" },
+    { "numSegment", py_numSegment<BiarcList>, METH_NOARGS,
+      "numSegment()\n\nnumber of segments" },
+    { nullptr, nullptr, 0, nullptr }
+  };
+
+  PyMethodDef PolyLine_methods[] = {
+    G2LIB_PY_COMMON_METHODS(PolyLine),
+    { "build", py_polyline_build, METH_VARARGS,
+      "build(x, y) or build(curve, tol)\n\n"
+      "polyline through the points (x, y) or approximating `curve` within `tol`" },
+    { nullptr, nullptr, 0, nullptr }
+  };
+
+  template <typename CURVE>
+  bool
+  add_type(
+    PyObject    * module,
+    char const  * name,
+    char const  * fullname,
+    char const  * doc,
+    PyMethodDef * methods
+  ) {
+    PyType_Slot slots[] = {
+      { Py_tp_doc,     const_cast<char*>(doc) },
+      { Py_tp_new,     reinterpret_cast<void*>(py_new<CURVE>) },
+      { Py_tp_dealloc, reinterpret_cast<void*>(py_dealloc) },
+      { Py_tp_repr,    reinterpret_cast<void*>(py_repr<CURVE>) },
+      { Py_tp_methods, methods },
+      { 0, nullptr }
+    };
+    PyType_Spec spec = {
+      fullname, sizeof(CurveObject), 0, Py_TPFLAGS_DEFAULT, slots
+    };
+    PyObject * type = PyType_FromSpec( &spec );
+    if ( type == nullptr ) return false;
+    PyCurve<CURVE>::type = reinterpret_cast<PyTypeObject*>(type);
+    Py_INCREF( type ); // one reference is kept by PyCurve
+    if ( PyModule_AddObject( module, name, type ) != 0 ) {
+      Py_DECREF( type );
+      return false;
+    }
+    return true;
+  }
+
+  /*\
+   |    ____ ____              _
+   |   / ___|___ \   ___  ___ | |_   _____ _ __ ___
+   |  | |  _  __) | / __|/ _ \| \ \ / / _ \ '__/ __|
+   |  | |_| |/ __/  \__ \ (_) | |\ V /  __/ |  \__ \
+   |   \____|_____| |___/\___/|_| \_/ \___|_|  |___/
+  \*/
+
+  template <typename SOLVER> struct G2segments;
+
+  template <>
+  struct G2segments<G2lib::G2solve2arc> {
+    static
+    void
+    push( G2lib::G2solve2arc const & g2, ClothoidList & CL ) {
+      CL.push_back( g2.getS0() );
+      CL.push_back( g2.getS1() );
+    }
+  };
+
+  template <>
+  struct G2segments<G2lib::G2solveCLC> {
+    static
+    void
+    push( G2lib::G2solveCLC const & g2, ClothoidList & CL ) {
+      CL.push_back( g2.getS0() );
+      CL.push_back( g2.getSM() );
+      CL.push_back( g2.getS1() );
+    }
+  };
+
+  template <>
+  struct G2segments<G2lib::G2solve3arc> {
+    static
+    void
+    push( G2lib::G2solve3arc const & g2, ClothoidList & CL ) {
+      CL.push_back( g2.getS0() );
+      CL.push_back( g2.getSM() );
+      CL.push_back( g2.getS1() );
+    }
+  };
+
+  /*!
+   * `G2solve*(x0, y0, theta0, kappa0, x1, y1, theta1, kappa1)`:
+   * with scalar arguments return the `ClothoidList` of the solution
+   * (`RuntimeError` if the solver fails), with vectors (the scalars
+   * are broadcasted) return the list of the solutions (`None` for
+   * the problems not solved).
+   */
+  template <typename SOLVER>
+  PyObject *
+  py_G2solve( PyObject *, PyObject * args ) {
+    PyObject * obj[8];
+    if ( !PyArg_ParseTuple(
+           args, "OOOOOOOO",
+           obj, obj+1, obj+2, obj+3, obj+4, obj+5, obj+6, obj+7
+         ) ) return nullptr;
+    static char const * names[] = {
+      "x0", "y0", "theta0", "kappa0", "x1", "y1", "theta1", "kappa1"
+    };
+    InBuf      a[8];
+    Py_ssize_t n      = 1;
+    bool       scalar = true;
+    for ( int j = 0; j < 8; ++j ) {
+      if ( !a[j].set( obj[j], names[j] ) ) return nullptr;
+      if ( a[j].scalar ) continue;
+      if ( !scalar && a[j].n != n ) {
+        PyErr_SetString( PyExc_ValueError, "G2lib: G2 solver, vectors of different size" );
+        return nullptr;
+      }
+      n      = a[j].n;
+      scalar = false;
+    }
+    vector<ClothoidList*> sol( size_t(n), nullptr );
+    if ( !nogil( [&]() {
+      SOLVER g2;
+      for ( Py_ssize_t i = 0; i < n; ++i ) {
+        int iter = g2.build(
+          a[0][i], a[1][i], a[2][i], a[3][i], a[4][i], a[5][i], a[6][i], a[7][i]
+        );
+        if ( iter < 0 ) continue;
+        sol[size_t(i)] = new ClothoidList();
+        G2segments<SOLVER>::push( g2, *sol[size_t(i)] );
+      }
+    } ) ) {
+      for ( size_t i = 0; i < sol.size(); ++i ) delete sol[i];
+      return nullptr;
+    }
+    if ( scalar ) {
+      if ( sol[0] != nullptr ) return wrap( sol[0] );
+      PyErr_SetString( PyExc_RuntimeError, "G2lib: G2 solver failed" );
+      return nullptr;
+    }
+    PyObject * res = PyList_New( n );
+    for ( Py_ssize_t i = 0; i < n; ++i ) {
+      ClothoidList * CL = sol[size_t(i)];
+      PyObject * item = nullptr;
+      if ( res != nullptr ) {
+        if ( CL != nullptr ) item = wrap( CL );
+        else { item = Py_None; Py_INCREF( item ); }
+      } else {
+        delete CL;
+      }
+      if ( res == nullptr ) continue;
+      if ( item == nullptr ) { Py_CLEAR( res ); continue; }
+      PyList_SET_ITEM( res, i, item );
+    }
+    return res;
+  }
+
+  //! `FresnelCS(y)` -> `(C, S)`
+  PyObject *
+  py_FresnelCS( PyObject *, PyObject * args ) {
+    PyObject * y_obj;
+    if ( !PyArg_ParseTuple( args, "O", &y_obj ) ) return nullptr;
+    InBuf y;
+    if ( !y.set( y_obj, "y" ) ) return nullptr;
+    OutBuf out[2];
+    if ( !allocate( y.n, out, 2 ) ) return nullptr;
+    if ( !nogil( [&]() {
+      for ( Py_ssize_t i = 0; i < y.n; ++i )
+        G2lib::FresnelCS( y.ptr[i], out[0].ptr[i], out[1].ptr[i] );
+    } ) ) return nullptr;
+    return Py_BuildValue( "(NN)", out[0].result(y.scalar), out[1].result(y.scalar) );
+  }
+
+  PyMethodDef G2lib_functions[] = {
+    { "G2solve2arc", py_G2solve<G2lib::G2solve2arc>, METH_VARARGS,
+      "G2solve2arc(x0, y0, theta0, kappa0, x1, y1, theta1, kappa1)\n\n"
+      "G2 Hermite interpolation with 2 clothoids, a ClothoidList\n"
+      "(a list of them, None if not solved, with vector arguments)" },
+    { "G2solveCLC", py_G2solve<G2lib::G2solveCLC>, METH_VARARGS,
+      "G2solveCLC(x0, y0, theta0, kappa0, x1, y1, theta1, kappa1)\n\n"
+      "G2 Hermite interpolation with clothoid-line-clothoid, a ClothoidList\n"
+      "(a list of them, None if not solved, with vector arguments)" },
+    { "G2solve3arc", py_G2solve<G2lib::G2solve3arc>, METH_VARARGS,
+      "G2solve3arc(x0, y0, theta0, kappa0, x1, y1, theta1, kappa1)\n\n"
+      "G2 Hermite interpolation with 3 clothoids, a ClothoidList\n"
+      "(a list of them, None if not solved, with vector arguments)" },
+    { "FresnelCS", py_FresnelCS, METH_VARARGS,
+      "FresnelCS(y)\n\n(C, S) Fresnel integrals" },
+    { nullptr, nullptr, 0, nullptr }
+  };
+
+  PyModuleDef G2lib_module = {
+    PyModuleDef_HEAD_INIT,
+    "G2lib",
+    "Clothoids, biarcs and polylines (G2lib) with batched NumPy methods.\n\n"
+    "The computations release the GIL, the calls on the same curve are\n"
+    "serialized: the threads querying a curve in parallel use a copy() each.",
+    -1,
+    G2lib_functions,
+    nullptr, nullptr, nullptr, nullptr
+  };
+
+}
+
+PyMODINIT_FUNC
+PyInit_G2lib() {
+  // NumPy is optional: without it the results are `array.array('d')`
+  PyObject * numpy = PyImport_ImportModule( "numpy" );
+  if ( numpy != nullptr ) {
+    np_empty        = PyObject_GetAttrString( numpy, "empty" );
+    np_ascontiguous = PyObject_GetAttrString( numpy, "ascontiguousarray" );
+    Py_DECREF( numpy );
+    if ( np_empty == nullptr || np_ascontiguous == nullptr ) return nullptr;
+  } else {
+    PyErr_Clear();
+  }
+  PyObject * array = PyImport_ImportModule( "array" );
+  if ( array == nullptr ) return nullptr;
+  array_array = PyObject_GetAttrString( array, "array" );
+  Py_DECREF( array );
+  if ( array_array == nullptr ) return nullptr;
+
+  PyObject * module = PyModule_Create( &G2lib_module );
+  if ( module == nullptr ) return nullptr;
+  bool ok =
+    add_type<ClothoidCurve>(
+      module, "ClothoidCurve", "G2lib.ClothoidCurve",
+      "clothoid curve", ClothoidCurve_methods
+    ) &&
+    add_type<ClothoidList>(
+      module, "ClothoidList", "G2lib.ClothoidList",
+      "list of clothoid curves", ClothoidList_methods
+    ) &&
+    add_type<BiarcList>(
+      module, "BiarcList", "G2lib.BiarcList",
+      "list of biarcs", BiarcList_methods
+    ) &&
+    add_type<PolyLine>(
+      module, "PolyLine", "G2lib.PolyLine",
+      "polyline", PolyLine_methods
+    );
+  if ( !ok ) {
+    Py_DECREF( module );
+    return nullptr;
+  }
+  return module;
+}
+
+///
+/// eof: G2lib_py.cc
+///
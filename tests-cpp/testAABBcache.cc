@@ -0,0 +1,99 @@
+/*
+ * Check the cache of the AABB trees of ClothoidList
+ *
+ * Queries that alternate between several offsets (the two borders of a
+ * lane) must give the same result of a list that builds the tree from
+ * scratch at each call, also after the list is moved.
+ */
+
+#include "ClothoidList.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static
+void
+build_path( G2lib::ClothoidList & CL ) {
+  int_type const n = 60;
+  vector<real_type> x(n), y(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    x[i] = 5*i;
+    y[i] = 20*sin(0.15*i)+3*cos(0.7*i);
+  }
+  CL.build_G1( n, &x.front(), &y.front() );
+}
+
+int
+main() {
+
+  G2lib::ClothoidList CL, CL0;
+  build_path( CL );
+  CL0.copy( CL );
+  CL0.setAABBcacheCapacity( 0 ); // never cached
+
+  G2lib::ClothoidList OB;
+  OB.push_back( 100, -40, G2lib::m_pi/2, 0, 0, 80 );
+
+  real_type const offs[] = { 3, -3, 0, 3, -3, 1.5, -3, 3 };
+  int_type nerr = 0;
+  for ( int_type k = 0; k < 8; ++k ) {
+    for ( int_type i = 0; i < 20; ++i ) {
+      real_type qx = 15*i+1.7, qy = 25*sin(0.3*i);
+      real_type x, y, s, t, d, x0, y0, s0, t0, d0;
+      G2lib::ClothoidList F( CL ); // fresh copy, no cached tree
+      int_type res  = CL.closestPoint_ISO( qx, qy, offs[k], x, y, s, t, d );
+      int_type res0 = F.closestPoint_ISO( qx, qy, offs[k], x0, y0, s0, t0, d0 );
+      int_type res1 = CL0.closestPoint_ISO( qx, qy, offs[k], x0, y0, s0, t0, d0 );
+      if ( res != res0 || res != res1 ||
+           abs(s-s0) > 1e-8 || abs(d-d0) > 1e-8 ) {
+        cout << "closestPoint offs = " << offs[k] << " q = (" << qx << "," << qy
+             << ") s = " << s << " expected " << s0 << '\n';
+        ++nerr;
+      }
+    }
+    G2lib::IntersectList ilist, ilist0;
+    G2lib::ClothoidList  F( CL );
+    CL.intersect_ISO( offs[k], OB, 0, ilist, false );
+    F.intersect_ISO( offs[k], OB, 0, ilist0, false );
+    if ( ilist.size() != ilist0.size() ) {
+      cout << "intersect offs = " << offs[k] << " found " << ilist.size()
+           << " expected " << ilist0.size() << '\n';
+      ++nerr;
+    } else {
+      for ( size_t i = 0; i < ilist.size(); ++i ) {
+        if ( abs(ilist[i].first-ilist0[i].first) > 1e-8 ) {
+          cout << "intersect offs = " << offs[k] << " s = " << ilist[i].first
+               << " expected " << ilist0[i].first << '\n';
+          ++nerr;
+        }
+      }
+    }
+  }
+
+  // the trees of the list moved must be rebuilt
+  CL.translate( 7, -4 );
+  CL.rotate( 0.3, 50, 0 );
+  for ( int_type i = 0; i < 20; ++i ) {
+    real_type qx = 15*i+1.7, qy = 25*sin(0.3*i);
+    real_type x, y, s, t, d, x0, y0, s0, t0, d0;
+    G2lib::ClothoidList F( CL );
+    CL.closestPoint_ISO( qx, qy, 3, x, y, s, t, d );
+    F.closestPoint_ISO( qx, qy, 3, x0, y0, s0, t0, d0 );
+    if ( abs(s-s0) > 1e-8 || abs(d-d0) > 1e-8 ) {
+      cout << "closestPoint after translate/rotate q = (" << qx << "," << qy
+           << ") s = " << s << " expected " << s0 << '\n';
+      ++nerr;
+    }
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,348 @@
+/*
+ * Replay realistic workloads on the circuits of the directory tests-matlab
+ *
+ * usage: testBenchTracks [data_dir] [num_queries]
+ *
+ * The tracks are read from `Mugello.txt` (table X Y THETA) and from the
+ * `S.push_back(...)` lines of the `testList_*.m` scripts, resampled and
+ * rebuilt with `ClothoidList::build_G1`. For each track the following
+ * workloads are timed:
+ *
+ *  - projection:     closestPoint_ISO of points scattered around the track
+ *  - collision:      collision_ISO/intersect_ISO of the left/right boundary
+ *  - self-intersect: self intersections of the track (intersect_self_ISO)
+ *  - tessellation:   PolyLine::build with a chordal tolerance
+ *  - serialization:  export_table to a string stream
+ *
+ * when the library is compiled with G2LIB_PERF_COUNTERS the counters
+ * of the work done for each track are printed.
+ */
+
+#include "Clothoid.hh"
+#include "ClothoidList.hh"
+#include "PolyLine.hh"
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#ifndef G2LIB_OS_WINDOWS
+  #include <sys/resource.h>
+#endif
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+typedef chrono::high_resolution_clock bench_clock;
+
+static real_type const sample_step = 10;   // resampling step of the tracks [m]
+static real_type const half_width  = 6;    // half width of the road [m]
+static real_type const scatter     = 20;   // max distance of the query points
+static real_type const tess_tol    = 0.01; // tolerance of the tessellation
+
+static
+real_type
+elapsed_us( bench_clock::time_point const & t0, bench_clock::time_point const & t1 ) {
+  return chrono::duration_cast<chrono::nanoseconds>(t1-t0).count()*1e-3;
+}
+
+// peak resident memory in kB (0 if not available)
+static
+long
+peak_memory_kb() {
+  #ifdef G2LIB_OS_WINDOWS
+  return 0;
+  #else
+  struct rusage ru;
+  getrusage( RUSAGE_SELF, &ru );
+  #ifdef __APPLE__
+  return long(ru.ru_maxrss/1024); // bytes on OSX
+  #else
+  return long(ru.ru_maxrss);
+  #endif
+  #endif
+}
+
+/*\
+ |   _                 _
+ |  | | ___   __ _  __| |
+ |  | |/ _ \ / _` |/ _` |
+ |  | | (_) | (_| | (_| |
+ |  |_|\___/ \__,_|\__,_|
+\*/
+
+// read the table X Y THETA saved by ClothoidList.save
+static
+bool
+load_table(
+  string const      & fname,
+  vector<real_type> & x,
+  vector<real_type> & y,
+  vector<real_type> & theta
+) {
+  ifstream file( fname.c_str() );
+  if ( !file.good() ) return false;
+  string line;
+  getline( file, line ); // header
+  real_type xx, yy, tt;
+  while ( file >> xx >> yy >> tt ) {
+    x.push_back( xx );
+    y.push_back( yy );
+    theta.push_back( tt );
+  }
+  return x.size() > 2;
+}
+
+// collect the `S.push_back(...)` of the first list of a matlab script
+static
+bool
+load_script( string const & fname, G2lib::ClothoidList & CL ) {
+  ifstream file( fname.c_str() );
+  if ( !file.good() ) return false;
+  CL.init();
+  string line;
+  while ( getline( file, line ) ) {
+    size_t i0 = line.find( "S.push_back(" );
+    if ( i0 == string::npos ) {
+      if ( line.find( "ClothoidList()" ) != string::npos &&
+           CL.numSegment() > 0 ) break; // second list of the script
+      continue;
+    }
+    size_t i1 = line.find( ')', i0 );
+    if ( i1 == string::npos ) continue;
+    istringstream     is( line.substr( i0+12, i1-i0-12 ) );
+    vector<real_type> v;
+    vector<bool>      ok;
+    string            tk;
+    while ( getline( is, tk, ',' ) ) {
+      istringstream its( tk );
+      real_type a = 0;
+      bool good = bool( its >> a );
+      if ( good && !its.eof() ) good = bool( its >> ws ) && its.eof();
+      ok.push_back( good );
+      v.push_back( ok.back() ? a : 0 );
+    }
+    // the initial point and angle (x0, y0, theta0) may be symbolic,
+    // a rigid motion of the track is irrelevant for the benchmark
+    if ( v.size() == 6 && ok[3] && ok[4] && ok[5] )
+      CL.push_back( v[0], v[1], v[2], v[3], v[4], v[5] );
+    else if ( v.size() == 3 && ok[0] && ok[1] && ok[2] && CL.numSegment() > 0 )
+      CL.push_back( v[0], v[1], v[2] );
+  }
+  return CL.numSegment() > 1;
+}
+
+/*\
+ |   ____                  _
+ |  | __ )  ___ _ __   ___| |__
+ |  |  _ \ / _ \ '_ \ / __| '_ \
+ |  | |_) |  __/ | | | (__| | | |
+ |  |____/ \___|_| |_|\___|_| |_|
+\*/
+
+class Stat {
+  vector<real_type> lat; // latency of the single operations [us]
+  real_type         tot; // total time [us]
+public:
+  Stat() : tot(0) {}
+
+  void
+  add( real_type us )
+  { lat.push_back( us ); tot += us; }
+
+  void
+  report( char const * name, char const * unit = "op" ) {
+    if ( lat.empty() ) return;
+    sort( lat.begin(), lat.end() );
+    size_t n = lat.size();
+    cout
+      << "  " << setw(14) << left << name << right
+      << setw(8)  << n << ' ' << setw(3) << unit
+      << setw(12) << fixed << setprecision(0) << (tot > 0 ? 1e6*n/tot : 0) << " " << unit << "/s"
+      << "  p50 " << setw(10) << setprecision(2) << lat[n/2]
+      << "  p90 " << setw(10) << lat[(9*n)/10]
+      << "  p99 " << setw(10) << lat[(99*n)/100]
+      << "  max " << setw(10) << lat.back() << " us\n";
+  }
+};
+
+static
+void
+bench_track(
+  string              const & name,
+  G2lib::ClothoidList const & CL,
+  int_type                    nq
+) {
+  bench_clock::time_point t0, t1;
+
+  G2lib::resetPerfCounters();
+
+  cout
+    << "\n" << name << ": " << CL.numSegment() << " segments, length "
+    << fixed << setprecision(1) << CL.length() << " m\n";
+
+  // ---------------------------------------------------------------------------
+  // projection of points scattered around the track
+  Stat st_proj;
+  real_type L = CL.length();
+  srand(1234);
+  for ( int_type i = 0; i < nq; ++i ) {
+    real_type s = L*rand()/real_type(RAND_MAX);
+    real_type d = scatter*(2*rand()/real_type(RAND_MAX)-1);
+    real_type qx, qy;
+    CL.eval_ISO( s, d, qx, qy );
+    real_type x, y, ss, tt, dst;
+    t0 = bench_clock::now();
+    CL.closestPoint_ISO( qx, qy, x, y, ss, tt, dst );
+    t1 = bench_clock::now();
+    st_proj.add( elapsed_us( t0, t1 ) );
+  }
+
+  // ---------------------------------------------------------------------------
+  // collision of the left and right boundary of the road
+  Stat st_coll, st_inter;
+  int_type ninter = 0;
+  for ( int_type k = 0; k < 5; ++k ) {
+    // fresh copies, AABB trees are rebuilt (one for each boundary)
+    G2lib::ClothoidList CC( CL ), CR( CL );
+    t0 = bench_clock::now();
+    CC.collision_ISO( half_width, CR, -half_width );
+    t1 = bench_clock::now();
+    st_coll.add( elapsed_us( t0, t1 ) );
+  }
+  for ( int_type k = 0; k < 5; ++k ) {
+    // fresh copies, the trees built by the collision are not reused
+    G2lib::ClothoidList  CC( CL ), CR( CL );
+    G2lib::IntersectList ilist;
+    t0 = bench_clock::now();
+    CC.intersect_ISO( half_width, CR, -half_width, ilist, false );
+    t1 = bench_clock::now();
+    st_inter.add( elapsed_us( t0, t1 ) );
+    ninter = int_type(ilist.size());
+  }
+
+  // ---------------------------------------------------------------------------
+  // self intersection of the track
+  Stat     st_self;
+  int_type nself = 0;
+  for ( int_type k = 0; k < 5; ++k ) {
+    G2lib::ClothoidList  CC( CL ); // fresh copy, AABB tree is rebuilt
+    G2lib::IntersectList ilist;
+    t0 = bench_clock::now();
+    CC.intersect_self_ISO( 0, ilist );
+    t1 = bench_clock::now();
+    nself = int_type(ilist.size());
+    st_self.add( elapsed_us( t0, t1 ) );
+  }
+
+  // ---------------------------------------------------------------------------
+  // tessellation
+  Stat     st_tess;
+  int_type npts = 0;
+  for ( int_type k = 0; k < 5; ++k ) {
+    G2lib::PolyLine PL;
+    t0 = bench_clock::now();
+    PL.build( CL, tess_tol );
+    t1 = bench_clock::now();
+    st_tess.add( elapsed_us( t0, t1 ) );
+    npts = PL.numSegment()+1;
+  }
+
+  // ---------------------------------------------------------------------------
+  // serialization
+  Stat   st_ser;
+  size_t nbytes = 0;
+  for ( int_type k = 0; k < 5; ++k ) {
+    ostringstream ss;
+    t0 = bench_clock::now();
+    CL.export_table( ss );
+    nbytes = ss.str().size();
+    t1 = bench_clock::now();
+    st_ser.add( elapsed_us( t0, t1 ) );
+  }
+
+  st_proj.report( "projection" );
+  st_coll.report( "collision" );
+  st_inter.report( "intersect" );
+  st_self.report( "self-intersect" );
+  st_tess.report( "tessellation" );
+  st_ser.report( "serialization" );
+
+  cout
+    << "  boundary intersections = " << ninter
+    << ", self intersections = " << nself
+    << ", tessellation points = " << npts
+    << ", serialized bytes = " << nbytes
+    << "\n  segment storage = "
+    << (sizeof(G2lib::ClothoidCurve)*size_t(CL.numSegment()))/1024.0 << " kB"
+    << ", peak memory = " << peak_memory_kb() << " kB\n";
+
+  #ifdef G2LIB_PERF_COUNTERS
+  G2lib::PerfCounters pc;
+  G2lib::perfCountersTotal( pc );
+  pc.info( cout );
+  #endif
+}
+
+/*\
+ |                   _
+ |   _ __ ___   __ _(_)_ __
+ |  | '_ ` _ \ / _` | | '_ \
+ |  | | | | | | (_| | | | | |
+ |  |_| |_| |_|\__,_|_|_| |_|
+\*/
+
+int
+main( int argc, char const * argv[] ) {
+
+  string   dir = argc > 1 ? argv[1] : "tests-matlab";
+  int_type nq  = argc > 2 ? int_type(atoi(argv[2])) : 2000;
+
+  // try also from the build directory
+  if ( argc <= 1 && !ifstream( (dir+"/Mugello.txt").c_str() ).good() )
+    dir = "../tests-matlab";
+
+  // scripts with the segments written explicitly (the others use matlab functions)
+  char const * scripts[] = { "Montecarlo", "Monza", "Silverstone", nullptr };
+
+  int_type ntracks = 0;
+
+  vector<real_type> x, y, theta;
+  if ( load_table( dir+"/Mugello.txt", x, y, theta ) ) {
+    G2lib::ClothoidList CL;
+    CL.build_G1( int_type(x.size()), &x.front(), &y.front(), &theta.front() );
+    bench_track( "Mugello.txt", CL, nq );
+    ++ntracks;
+  }
+
+  for ( char const ** p = scripts; *p != nullptr; ++p ) {
+    G2lib::ClothoidList CL0;
+    string fname = dir+"/testList_"+*p+".m";
+    if ( !load_script( fname, CL0 ) ) continue;
+    // resample the track and rebuild it as a G1 list
+    int_type n = int_type( ceil( CL0.length()/sample_step ) )+1;
+    x.resize( size_t(n) );
+    y.resize( size_t(n) );
+    for ( int_type i = 0; i < n; ++i )
+      CL0.eval( (i*CL0.length())/(n-1), x[size_t(i)], y[size_t(i)] );
+    G2lib::ClothoidList CL;
+    CL.build_G1( n, &x.front(), &y.front() );
+    bench_track( *p, CL, nq );
+    ++ntracks;
+  }
+
+  if ( ntracks == 0 )
+    cout << "no track found in `" << dir << "`, usage: testBenchTracks [data_dir] [num_queries]\n";
+
+  cout << "\n\nALL DONE FOLKS!!!\n";
+
+  return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Check the closest point of BiarcList (closed form projection on the
+ * blocks of arcs) against a brute force search on all the arcs.
+ *
+ * The offsets include values beyond the center of the arcs
+ * (1-k*offs < 0), where the offset arc is on the other side of
+ * the center.
+ *
+ * Check also that the error returned by build( CL, tol ) bounds the
+ * distance of the points of the clothoid list from the biarcs.
+ */
+
+#include "BiarcList.hh"
+#include "ClothoidList.hh"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+int
+main() {
+
+  // spiral with radius of curvature from about 10 to 60
+  int_type const n = 120;
+  vector<real_type> x(n), y(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    real_type a = 0.12*i;
+    x[i] = (10+0.4*i)*cos(a) + 300*(i/40);
+    y[i] = (10+0.4*i)*sin(a);
+  }
+  G2lib::BiarcList BL;
+  BL.build_G1( n, &x.front(), &y.front() );
+
+  int_type nerr = 0;
+  real_type const offs[] = { 0, 3, -7, 25, -25, 80 };
+  srand(1234);
+  for ( int_type q = 0; q < 400; ++q ) {
+    real_type qx = -150 + 1000*(rand()/real_type(RAND_MAX));
+    real_type qy = -150 + 300*(rand()/real_type(RAND_MAX));
+    for ( int_type k = 0; k < 6; ++k ) {
+      // brute force on the arcs
+      real_type dref = numeric_limits<real_type>::infinity();
+      for ( int_type i = 0; i < BL.numSegment(); ++i ) {
+        G2lib::Biarc const & b = BL.get(i);
+        real_type xx, yy, ss, tt, dd;
+        b.getC0().closestPoint_ISO( qx, qy, offs[k], xx, yy, ss, tt, dd );
+        if ( dd < dref ) dref = dd;
+        b.getC1().closestPoint_ISO( qx, qy, offs[k], xx, yy, ss, tt, dd );
+        if ( dd < dref ) dref = dd;
+      }
+      real_type xx, yy, ss, tt, dd;
+      BL.closestPoint_ISO( qx, qy, offs[k], xx, yy, ss, tt, dd );
+      // the returned point must be on the curve at abscissa ss
+      real_type xs, ys;
+      BL.eval_ISO( ss, offs[k], xs, ys );
+      if ( abs(dd-dref) > 1e-8*(1+dref) || hypot( xs-xx, ys-yy ) > 1e-8 ) {
+        cout << "offs = " << offs[k] << " q = (" << qx << "," << qy
+             << ") dst = " << dd << " expected " << dref << '\n';
+        ++nerr;
+      }
+    }
+  }
+
+  // error bound of the approximation of a clothoid list
+  G2lib::ClothoidList CL;
+  CL.build_G1( n, &x.front(), &y.front() );
+  real_type const tol[] = { 1e-2, 1e-4 };
+  for ( int_type k = 0; k < 2; ++k ) {
+    G2lib::BiarcList BA;
+    real_type err = BA.build( CL, tol[k] );
+    real_type dmax = 0;
+    int_type  ns   = 100000;
+    for ( int_type i = 0; i <= ns; ++i ) {
+      real_type qx, qy, xx, yy, ss, tt, dd;
+      CL.eval( CL.length()*i/ns, qx, qy );
+      BA.closestPoint_ISO( qx, qy, xx, yy, ss, tt, dd );
+      if ( dd > dmax ) dmax = dd;
+    }
+    if ( err > tol[k] || dmax > err ) {
+      cout << "build( CL, " << tol[k] << " ) error = " << err
+           << " measured distance = " << dmax << '\n';
+      ++nerr;
+    }
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * Check the certified error bounds of ClothoidListApprox
+ *
+ * The list has zero-length segments and a segment of high curvature,
+ * the deviation from ClothoidList of eval, eval_D and evaluate on dense
+ * samples must be within the requested tolerance and the bounds.
+ */
+
+#include "ClothoidListApprox.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+int
+main() {
+
+  G2lib::ClothoidList CL;
+  CL.push_back( 0, 0, 0.2, 0.01, 0.002, 30 );
+  CL.push_back( 0, 0, 0 );          // zero-length segment
+  CL.push_back( 0.05, -0.01, 20 );
+  CL.push_back( 5, 2, 1.5 );        // high curvature
+  CL.push_back( -0.3, 0.05, 10 );
+  CL.push_back( 0, 0, 0 );          // zero-length segment
+  CL.push_back( 0.1, 0, 25 );
+
+  // max curvature of the list
+  real_type kmax = 0;
+  for ( int_type i = 0; i < CL.numSegment(); ++i ) {
+    G2lib::ClothoidCurve const & C = CL.get(i);
+    kmax = max( kmax, max( abs(C.kappaBegin()), abs(C.kappaEnd()) ) );
+  }
+
+  int_type nerr = 0;
+  real_type const tols[] = { 1e-2, 1e-4, 1e-6, 1e-9 };
+  for ( int_type k = 0; k < 4; ++k ) {
+    G2lib::ClothoidListApprox A( CL, tols[k] );
+    real_type eD  = A.errorBound_D();
+    real_type eDD = A.errorBound_DD();
+    if ( A.errorBound() > tols[k] || abs( A.length()-CL.length() ) > 1e-10 ) {
+      cout << "tol = " << tols[k] << " bound = " << A.errorBound()
+           << " length = " << A.length() << " expected " << CL.length() << '\n';
+      ++nerr;
+    }
+
+    // error of the angle and of the curvature from the bounds of the
+    // derivatives, |r'| = 1 and |r''| = |kappa|
+    real_type eth = asin( min( eD, real_type(1) ) );
+    real_type q   = 1/pow( 1-eD, 3 );
+    real_type ek  = ( eD*(kmax+eDD) + eDD )*q + kmax*(q-1);
+
+    real_type err = 0, err_D = 0, err_th = 0, err_k = 0;
+    int_type  ns  = 200000;
+    for ( int_type i = 0; i <= ns; ++i ) {
+      real_type s = CL.length()*i/ns;
+      real_type th, kappa, x, y, ath, akappa, ax, ay, ax_D, ay_D;
+      CL.evaluate( s, th, kappa, x, y );
+      A.eval( s, ax, ay );
+      err = max( err, hypot( ax-x, ay-y ) );
+      A.eval_D( s, ax_D, ay_D );
+      err_D = max( err_D, hypot( ax_D-cos(th), ay_D-sin(th) ) );
+      A.evaluate( s, ath, akappa, ax, ay );
+      err    = max( err, hypot( ax-x, ay-y ) );
+      err_th = max( err_th, abs( ath-th ) );
+      err_k  = max( err_k, abs( akappa-kappa ) );
+    }
+    // the evaluation of the clothoids is exact to about 1e-14
+    real_type eps = 1e-12;
+    if ( err > A.errorBound()+eps || err_D > eD+eps ||
+         err_th > eth+eps || err_k > ek+eps ) {
+      cout << "tol = " << tols[k]
+           << " eval " << err << " (bound " << A.errorBound() << ")"
+           << " eval_D " << err_D << " (bound " << eD << ")"
+           << " theta " << err_th << " (bound " << eth << ")"
+           << " kappa " << err_k << " (bound " << ek << ")\n";
+      ++nerr;
+    }
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
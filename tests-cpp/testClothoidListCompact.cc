@@ -0,0 +1,104 @@
+/*
+ * Check ClothoidListCompact against the original ClothoidList
+ *
+ *  - closestPoint_ISO at several offsets: the distance within errorBound()
+ *  - each segment (widened to double) inside its rounded bbox
+ *  - the memory used below the one of the segments of the ClothoidList
+ */
+
+#include "ClothoidListCompact.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static
+int_type
+check( G2lib::ClothoidList const & CL, int_type nseg_tile ) {
+  G2lib::ClothoidListCompact CC( CL, nseg_tile );
+  real_type eb   = CC.errorBound();
+  int_type  nerr = 0;
+
+  if ( CC.numSegment() != CL.numSegment() ||
+       abs( CC.length()-CL.length() ) > 1e-6*CL.length() ) {
+    cout << "tiles of " << nseg_tile << ": " << CC.numSegment()
+         << " segments, length " << CC.length() << '\n';
+    return 1;
+  }
+
+  // the segments stored in float are close to the original ones
+  if ( eb > 1e-3 ) {
+    cout << "tiles of " << nseg_tile << ": error bound " << eb << '\n';
+    ++nerr;
+  }
+
+  // each segment inside its bbox
+  for ( int_type i = 0; i < CC.numSegment(); ++i ) {
+    G2lib::ClothoidCurve C;
+    CC.get( i, C );
+    real_type xmin, ymin, xmax, ymax;
+    CC.segmentBBox( i, xmin, ymin, xmax, ymax );
+    for ( int_type k = 0; k <= 100; ++k ) {
+      real_type x, y;
+      C.eval( C.length()*k/100, x, y );
+      if ( x < xmin || x > xmax || y < ymin || y > ymax ) {
+        cout << "tiles of " << nseg_tile << ": segment " << i
+             << " outside its bbox at (" << x << "," << y << ")\n";
+        ++nerr;
+        break;
+      }
+    }
+  }
+
+  // closest point with and without offset
+  real_type const offs[] = { 0, 0.5, -1.5 };
+  for ( int_type io = 0; io < 3; ++io ) {
+    for ( int_type i = 0; i < 300; ++i ) {
+      real_type ss = CL.length()*(i+0.5)/300;
+      real_type qx, qy;
+      CL.eval_ISO( ss, 4*sin(0.31*i), qx, qy );
+      real_type x, y, s, t, dst, xr, yr, sr, tr, dstr;
+      CC.closestPoint_ISO( qx, qy, offs[io], x, y, s, t, dst );
+      CL.closestPoint_ISO( qx, qy, offs[io], xr, yr, sr, tr, dstr );
+      if ( abs( dst-dstr ) > eb + 1e-10 ) {
+        cout << "tiles of " << nseg_tile << " offs = " << offs[io]
+             << ": closestPoint dst = " << dst << " expected " << dstr << '\n';
+        ++nerr;
+      }
+    }
+  }
+
+  // the list stores a ClothoidCurve and its abscissa for each segment
+  size_t mem = size_t(CL.numSegment())*( sizeof(G2lib::ClothoidCurve) + sizeof(real_type) );
+  if ( CC.memory() >= mem ) {
+    cout << "tiles of " << nseg_tile << ": memory " << CC.memory()
+         << " bytes, ClothoidList " << mem << '\n';
+    ++nerr;
+  }
+  return nerr;
+}
+
+int
+main() {
+
+  int_type const n = 400;
+  vector<real_type> x(n), y(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    x[i] = 2000 + 6*i;
+    y[i] = -1000 + 15*sin(0.17*i) + 4*cos(0.53*i);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( n, &x.front(), &y.front() );
+
+  int_type nerr = check( CL, 32 ) + check( CL, 7 ) + check( CL, 1 );
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
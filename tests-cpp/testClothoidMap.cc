@@ -0,0 +1,178 @@
+/*
+ * Check ClothoidMap against the queries on the original curves
+ *
+ * The curves are written with small tiles and the map is opened with a
+ * capacity of few tiles, so that the queries load and evict tiles:
+ *  - closestPoint_ISO: id, abscissa and distance
+ *  - listsInRadius_ISO: ids and distances
+ *  - intersect_ISO with a probe curve
+ *  - numLoads: no load when the tiles are in memory, a load for each
+ *    tile evicted and needed again
+ *
+ * The tiles are written in the directory given on the command line
+ * (default `bin`, the tests are run from the root of the repository).
+ */
+
+#include "ClothoidMap.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+typedef pair<int_type,G2lib::Ipair> IdIpair;
+
+static
+bool
+less_dst( pair<real_type,int_type> const & a, pair<real_type,int_type> const & b )
+{ return a.first < b.first; }
+
+int
+main( int argc, char const * argv[] ) {
+
+  string dir = argc > 1 ? argv[1] : "bin";
+
+  // waves along x and along y: they cross each other
+  vector<G2lib::ClothoidList> lists(8);
+  int_type const n = 30;
+  vector<real_type> x(n), y(n);
+  for ( int_type k = 0; k < 8; ++k ) {
+    for ( int_type i = 0; i < n; ++i ) {
+      real_type u = 12*i, v = 40 + 45*(k/2) + 8*sin(0.4*i+k);
+      if ( k % 2 == 0 ) { x[i] = u; y[i] = v; }
+      else              { x[i] = v; y[i] = u; }
+    }
+    lists[k].build_G1( n, &x.front(), &y.front() );
+  }
+
+  G2lib::ClothoidMapWriter W( 40 );
+  for ( size_t k = 0; k < lists.size(); ++k ) W.add( lists[k] );
+  W.write( dir );
+
+  G2lib::ClothoidMap M( dir, 3 );
+  int_type nerr = 0;
+  if ( M.numLists() != 8 || M.numTiles() != W.numTiles() || M.numTiles() < 20 ) {
+    cout << "map with " << M.numLists() << " lists and " << M.numTiles()
+         << " tiles, written " << W.numTiles() << '\n';
+    ++nerr;
+  }
+
+  real_type const offs[] = { 0, 1.5 };
+  for ( int_type io = 0; io < 2; ++io ) {
+    for ( int_type i = 0; i < 200; ++i ) {
+      real_type qx = 175 + 170*sin(1.3*i), qy = 175 + 170*cos(0.7*i);
+
+      // closest point
+      int_type  id;
+      real_type xx, yy, s, t, dst;
+      M.closestPoint_ISO( qx, qy, offs[io], id, xx, yy, s, t, dst );
+      int_type  idr = -1;
+      real_type sr = 0, dstr = 0, dst2 = 1e100; // the two nearest curves
+      for ( int_type k = 0; k < 8; ++k ) {
+        real_type xk, yk, sk, tk, dk;
+        lists[k].closestPoint_ISO( qx, qy, offs[io], xk, yk, sk, tk, dk );
+        if ( idr < 0 || dk < dstr ) {
+          if ( idr >= 0 ) dst2 = dstr;
+          idr = k; sr = sk; dstr = dk;
+        } else if ( dk < dst2 ) {
+          dst2 = dk;
+        }
+      }
+      bool tie = dst2-dstr < 1e-8;
+      if ( abs(dst-dstr) > 1e-9 || ( !tie && ( id != idr || abs(s-sr) > 1e-8 ) ) ) {
+        cout << "closestPoint (" << qx << "," << qy << ") id = " << id
+             << " s = " << s << " dst = " << dst << " expected id = " << idr
+             << " s = " << sr << " dst = " << dstr << '\n';
+        ++nerr;
+      }
+
+      // curves in radius
+      vector<int_type>  ids;
+      vector<real_type> dsts;
+      M.listsInRadius_ISO( qx, qy, offs[io], 30, ids, dsts );
+      vector<pair<real_type,int_type> > ref;
+      for ( int_type k = 0; k < 8; ++k ) {
+        real_type dk = lists[k].distance_ISO( qx, qy, offs[io] );
+        if ( dk <= 30 ) ref.push_back( pair<real_type,int_type>( dk, k ) );
+      }
+      sort( ref.begin(), ref.end(), less_dst );
+      bool ok = ids.size() == ref.size() && dsts.size() == ref.size();
+      for ( size_t j = 0; ok && j < ref.size(); ++j )
+        ok = abs( dsts[j]-ref[j].first ) < 1e-9 &&
+             ( ids[j] == ref[j].second || ( j+1 < ref.size() &&
+               abs( ref[j+1].first-ref[j].first ) < 1e-9 ) ||
+               ( j > 0 && abs( ref[j-1].first-ref[j].first ) < 1e-9 ) );
+      if ( !ok ) {
+        cout << "listsInRadius (" << qx << "," << qy << ") found "
+             << ids.size() << " curves, expected " << ref.size() << '\n';
+        ++nerr;
+      }
+      if ( M.numLoaded() > 3 ) {
+        cout << M.numLoaded() << " tiles in memory, capacity 3\n";
+        ++nerr;
+      }
+    }
+
+    // intersections with a diagonal probe
+    G2lib::ClothoidList P;
+    P.push_back( -5, 10, 0.8, 0.002, 0, 450 );
+    vector<int_type>     ids;
+    G2lib::IntersectList il;
+    M.intersect_ISO( offs[io], P, 0, ids, il );
+    vector<IdIpair> found, ref;
+    for ( size_t j = 0; j < il.size(); ++j )
+      found.push_back( IdIpair( ids[j], il[j] ) );
+    for ( int_type k = 0; k < 8; ++k ) {
+      G2lib::IntersectList ilk;
+      lists[k].intersect_ISO( offs[io], P, 0, ilk, false );
+      for ( size_t j = 0; j < ilk.size(); ++j )
+        ref.push_back( IdIpair( k, ilk[j] ) );
+    }
+    sort( found.begin(), found.end() );
+    sort( ref.begin(), ref.end() );
+    bool ok = found.size() == ref.size() && ref.size() >= 6;
+    for ( size_t j = 0; ok && j < ref.size(); ++j )
+      ok = found[j].first == ref[j].first &&
+           abs( found[j].second.first-ref[j].second.first ) < 1e-8 &&
+           abs( found[j].second.second-ref[j].second.second ) < 1e-8;
+    if ( !ok ) {
+      cout << "offs = " << offs[io] << " intersect found " << found.size()
+           << " intersections, expected " << ref.size() << '\n';
+      ++nerr;
+    }
+  }
+
+  // the tiles in memory are not loaded again
+  M.setCapacity( 2 );
+  int_type  id;
+  real_type xx, yy, s, t, dst;
+  M.closestPoint_ISO( 10, 40, 0, id, xx, yy, s, t, dst );
+  unsigned long nl = M.numLoads();
+  for ( int_type i = 0; i < 10; ++i )
+    M.closestPoint_ISO( 10, 40, 0, id, xx, yy, s, t, dst );
+  if ( M.numLoads() != nl ) {
+    cout << "tiles in memory loaded again: " << M.numLoads()-nl << " loads\n";
+    ++nerr;
+  }
+  // two far corners alternated: each query evicts the tiles of the other
+  for ( int_type i = 0; i < 10; ++i ) {
+    M.closestPoint_ISO( 10, 40, 0, id, xx, yy, s, t, dst );
+    M.closestPoint_ISO( 340, 330, 0, id, xx, yy, s, t, dst );
+  }
+  if ( M.numLoads() < nl+20 ) {
+    cout << "alternated queries: " << M.numLoads()-nl << " loads, at least 20 expected\n";
+    ++nerr;
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << M.numLoads() << " tiles loaded\n";
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
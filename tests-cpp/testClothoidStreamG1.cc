@@ -0,0 +1,165 @@
+/*
+ * Check ClothoidStreamG1 against ClothoidList::build_G1( n, x, y )
+ *
+ *  - the segments streamed into a ClothoidList are the ones of the
+ *    batch interpolation of an open set of points
+ *  - the duplicated points are skipped
+ *  - two points: a single straight segment from finish()
+ *  - a ClothoidWindow as sink, the old segments popped on the way
+ */
+
+#include "ClothoidStreamG1.hh"
+#include "ClothoidList.hh"
+#include "ClothoidWindow.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static
+bool
+same( G2lib::ClothoidCurve const & A, G2lib::ClothoidCurve const & B ) {
+  return abs( A.xBegin()-B.xBegin() )         < 1e-10 &&
+         abs( A.yBegin()-B.yBegin() )         < 1e-10 &&
+         abs( A.thetaBegin()-B.thetaBegin() ) < 1e-10 &&
+         abs( A.kappaBegin()-B.kappaBegin() ) < 1e-10 &&
+         abs( A.dkappa()-B.dkappa() )         < 1e-10 &&
+         abs( A.length()-B.length() )         < 1e-10;
+}
+
+static
+int_type
+compare(
+  char const                * what,
+  G2lib::ClothoidList const & CL,
+  G2lib::ClothoidList const & ref
+) {
+  if ( CL.numSegment() != ref.numSegment() ) {
+    cout << what << ": " << CL.numSegment() << " segments, expected "
+         << ref.numSegment() << '\n';
+    return 1;
+  }
+  for ( int_type i = 0; i < ref.numSegment(); ++i ) {
+    if ( !same( CL.get(i), ref.get(i) ) ) {
+      cout << what << ": segment " << i << " differs from build_G1\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int
+main() {
+
+  int_type const n = 60;
+  vector<real_type> x(n), y(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    x[i] = 3*i + sin(0.9*i);
+    y[i] = 10*sin(0.25*i) + 2*cos(0.7*i);
+  }
+  G2lib::ClothoidList ref;
+  ref.build_G1( n, &x.front(), &y.front() );
+
+  int_type nerr = 0;
+
+  // open set of points
+  G2lib::ClothoidStreamG1 S;
+  G2lib::ClothoidList     CL;
+  int_type nfinal = 0;
+  for ( int_type i = 0; i < n; ++i )
+    if ( S.push_back( x[i], y[i], CL ) ) ++nfinal;
+  if ( nfinal != n-2 ) {
+    cout << "push_back finalized " << nfinal << " segments, expected " << n-2 << '\n';
+    ++nerr;
+  }
+  if ( !S.finish( CL ) || S.finish( CL ) || S.numSegment() != n-1 ) {
+    cout << "finish: " << S.numSegment() << " segments\n";
+    ++nerr;
+  }
+  nerr += compare( "stream", CL, ref );
+
+  // duplicated points
+  S.clear();
+  CL.init();
+  for ( int_type i = 0; i < n; ++i ) {
+    S.push_back( x[i], y[i], CL );
+    if ( i % 3 == 0 ) S.push_back( x[i], y[i], CL );
+    if ( i % 7 == 0 ) S.push_back( x[i]+1e-12, y[i], CL );
+  }
+  S.finish( CL );
+  nerr += compare( "duplicated points", CL, ref );
+
+  // two points (and duplicates): a straight segment
+  S.clear();
+  CL.init();
+  bool ok = !S.push_back( 1, 2, CL ) && !S.push_back( 1, 2, CL ) &&
+            !S.push_back( 4, 6, CL ) && !S.push_back( 4, 6, CL ) &&
+            S.finish( CL ) && CL.numSegment() == 1;
+  if ( ok ) {
+    G2lib::ClothoidCurve const & C = CL.get(0);
+    ok = abs( C.xBegin()-1 ) < 1e-12 && abs( C.yBegin()-2 ) < 1e-12 &&
+         abs( C.xEnd()-4 )   < 1e-12 && abs( C.yEnd()-6 )   < 1e-12 &&
+         abs( C.length()-5 ) < 1e-12 && abs( C.kappaBegin() ) < 1e-12 &&
+         abs( C.dkappa() )   < 1e-12;
+  }
+  if ( !ok ) {
+    cout << "two points: " << CL.numSegment() << " segments\n";
+    ++nerr;
+  }
+
+  // a single point: no segment
+  S.clear();
+  S.push_back( 1, 2 );
+  if ( S.finish() || S.numSegment() != 0 ) {
+    cout << "single point: " << S.numSegment() << " segments\n";
+    ++nerr;
+  }
+
+  // window sink, the last 10 segments are kept
+  S.clear();
+  G2lib::ClothoidWindow W;
+  int_type  npop = 0;
+  real_type spop = 0; // length of the segments popped
+  for ( int_type i = 0; i < n; ++i ) {
+    S.push_back( x[i], y[i], W );
+    if ( W.numSegment() > 10 ) {
+      spop += W.front().length();
+      W.pop_front();
+      ++npop;
+    }
+    if ( W.numSegment() > 0 && i % 5 == 0 ) {
+      // the window against the segments of the batch interpolation
+      real_type s = W.length()/2, xw, yw, xr, yr;
+      W.eval( s, xw, yw );
+      ref.eval( spop + s, xr, yr );
+      if ( hypot( xw-xr, yw-yr ) > 1e-9 ) {
+        cout << "window at point " << i << " (" << xw << "," << yw
+             << ") expected (" << xr << "," << yr << ")\n";
+        ++nerr;
+      }
+    }
+  }
+  S.finish( W );
+  if ( W.numSegment() != 11 || npop+W.numSegment() != ref.numSegment() ) {
+    cout << "window with " << W.numSegment() << " segments, "
+         << npop << " popped\n";
+    ++nerr;
+  } else {
+    for ( int_type i = 0; i < W.numSegment(); ++i ) {
+      if ( !same( W.get(i), ref.get(npop+i) ) ) {
+        cout << "window segment " << i << " differs from build_G1\n";
+        ++nerr;
+      }
+    }
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * Check ClothoidWindow against a ClothoidList with the same segments
+ *
+ * Segments are pushed at the end and popped at the front well past the
+ * rebase of the abscissa (1000 times the length of the window), the
+ * queries are done also with segments pending out of the tree:
+ *  - eval and closestPoint_ISO
+ *  - intersect_ISO and collision_ISO with a crossing ClothoidList
+ */
+
+#include "ClothoidWindow.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static
+int_type
+check( G2lib::ClothoidWindow const & W, deque<G2lib::ClothoidCurve> const & segs ) {
+  int_type nerr = 0;
+  G2lib::ClothoidList CL;
+  for ( size_t i = 0; i < segs.size(); ++i ) CL.push_back( segs[i] );
+
+  if ( abs( W.length()-CL.length() ) > 1e-9 ) {
+    cout << "length " << W.length() << " expected " << CL.length() << '\n';
+    return 1;
+  }
+
+  for ( int_type i = 0; i <= 50; ++i ) {
+    real_type ss = W.length()*i/50;
+    real_type x, y, xr, yr;
+    W.eval( ss, x, y );
+    CL.eval( ss, xr, yr );
+    if ( hypot( x-xr, y-yr ) > 1e-9 ) {
+      cout << "eval s = " << ss << " (" << x << "," << y << ") expected ("
+           << xr << "," << yr << ")\n";
+      ++nerr;
+    }
+
+    // points at both sides of the path
+    real_type qx, qy, s, t, dst, sr, tr, dstr;
+    CL.eval_ISO( ss, 2*sin(0.7*i), qx, qy );
+    W.closestPoint_ISO( qx, qy, 0, x, y, s, t, dst );
+    CL.closestPoint_ISO( qx, qy, 0, xr, yr, sr, tr, dstr );
+    if ( abs( dst-dstr ) > 1e-9 || abs( s-sr ) > 1e-6 ) {
+      cout << "closestPoint s = " << s << " dst = " << dst
+           << " expected s = " << sr << " dst = " << dstr << '\n';
+      ++nerr;
+    }
+  }
+
+  // segments crossing the path
+  for ( int_type k = 1; k < 4; ++k ) {
+    real_type sc = W.length()*k/4, xc, yc, th = CL.theta( sc ) + 1.3;
+    CL.eval( sc, xc, yc );
+    G2lib::ClothoidList P;
+    P.push_back( xc-3*cos(th), yc-3*sin(th), th, 0.02, 0, 6 );
+    P.push_back( 0.02, 0, 4 );
+    for ( int_type io = 0; io < 2; ++io ) {
+      real_type offs = io == 0 ? 0 : 0.5;
+      G2lib::IntersectList il, ilr;
+      W.intersect_ISO( offs, P, -offs, il, false );
+      CL.intersect_ISO( offs, P, -offs, ilr, false );
+      sort( il.begin(), il.end() );
+      sort( ilr.begin(), ilr.end() );
+      bool ok = il.size() == ilr.size();
+      for ( size_t i = 0; ok && i < il.size(); ++i )
+        ok = abs( il[i].first-ilr[i].first ) < 1e-8 &&
+             abs( il[i].second-ilr[i].second ) < 1e-8;
+      if ( !ok || il.empty() ) {
+        cout << "intersect at s = " << sc << " found " << il.size()
+             << " expected " << ilr.size() << '\n';
+        ++nerr;
+      }
+      if ( W.collision_ISO( offs, P, -offs ) != CL.collision_ISO( offs, P, -offs ) ) {
+        cout << "collision at s = " << sc << '\n';
+        ++nerr;
+      }
+    }
+  }
+
+  // far from the window
+  real_type xmin, ymin, xmax, ymax;
+  W.bbox_ISO( 0, xmin, ymin, xmax, ymax );
+  G2lib::ClothoidList F;
+  F.push_back( xmax+10, ymax+10, 0, 0, 0, 10 );
+  if ( W.collision( F ) ) {
+    cout << "collision with a far list\n";
+    ++nerr;
+  }
+  return nerr;
+}
+
+int
+main() {
+
+  G2lib::ClothoidWindow      W;
+  deque<G2lib::ClothoidCurve> segs;
+
+  W.push_back( 0, 0, 0, 0, 0, 1 );
+  segs.push_back( W.back() );
+
+  int_type nerr = 0, nchecks = 0;
+  real_type sOrigin = 0;
+  for ( int_type i = 1; i < 100000 && nerr == 0; ++i ) {
+    // curvature bounded and continuous: the path wanders without spirals
+    real_type k0 = W.back().kappaEnd();
+    real_type k1 = 0.2*sin(0.05*i);
+    real_type L  = 1+0.5*sin(0.3*i);
+    W.push_back( k0, (k1-k0)/L, L );
+    segs.push_back( W.back() );
+    // about 20 segments in the window
+    if ( W.numSegment() > 20 + int_type(5*sin(0.01*i)) ) {
+      sOrigin += W.front().length();
+      W.pop_front();
+      segs.pop_front();
+    }
+    // queries between the checks: the tree is updated lazily
+    if ( i % 7 == 0 ) W.distance( W.back().xEnd()+1, W.back().yEnd() );
+    if ( i % 4999 == 0 ) {
+      nerr += check( W, segs );
+      ++nchecks;
+      if ( abs( W.sOrigin()-sOrigin ) > 1e-6*sOrigin ) {
+        cout << "origin " << W.sOrigin() << " expected " << sOrigin << '\n';
+        ++nerr;
+      }
+    }
+  }
+
+  // the abscissa must have been rebased more than once
+  if ( sOrigin < 2*1000*W.length() ) {
+    cout << "origin " << sOrigin << " not past the rebase threshold\n";
+    ++nerr;
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << nchecks << " windows checked\n";
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
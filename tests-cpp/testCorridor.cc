@@ -0,0 +1,110 @@
+/*
+ * Check the corridor query of ClothoidList and BiarcList
+ *
+ *  - constant borders against two separate closestPoint_ISO calls on the
+ *    offset curves, for the points projected orthogonally
+ *  - borders that are functions of s against the borders evaluated at
+ *    the abscissa of the projection
+ *  - the SAE version against the ISO version
+ */
+
+#include "ClothoidList.hh"
+#include "BiarcList.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// lane that widens along the path
+class Border {
+  real_type w0, dw;
+public:
+  Border( real_type _w0, real_type _dw ) : w0(_w0), dw(_dw) {}
+  real_type operator () ( real_type s ) const { return w0 + dw*s; }
+};
+
+static
+int_type
+check( char const * what, G2lib::BaseCurve const & C ) {
+  real_type const L = 2.5, R = -1.5;
+  int_type nerr = 0, northo = 0;
+  for ( int_type i = 0; i < 400; ++i ) {
+    real_type ss = C.length()*(i+0.5)/400;
+    real_type d  = 3*sin(0.37*i); // inside and outside of the corridor
+    real_type px, py;
+    C.eval_ISO( ss, d, px, py );
+
+    real_type s, t, dL, dR;
+    int_type res = C.closestPointCorridor_ISO( px, py, L, R, s, t, dL, dR );
+
+    // the borders share the normal of the centerline: the feet on the
+    // offset curves are at the same abscissa for an orthogonal projection
+    real_type x, y, sL, sR, tt, distL, distR;
+    C.closestPoint_ISO( px, py, L, x, y, sL, tt, distL );
+    C.closestPoint_ISO( px, py, R, x, y, sR, tt, distR );
+    if ( res == 1 && abs(sL-s) < 1e-6 && abs(sR-s) < 1e-6 ) {
+      ++northo;
+      // signed: positive inside the corridor
+      if ( abs( abs(dL)-distL ) > 1e-8 || abs( abs(dR)-distR ) > 1e-8 ||
+           (dL < 0) != (d > L) || (dR < 0) != (d < R) ) {
+        cout << what << " s = " << ss << " d = " << d
+             << " corridor (" << dL << "," << dR << ") expected ("
+             << distL << "," << distR << ")\n";
+        ++nerr;
+      }
+    }
+
+    // borders function of s
+    Border BL( 2, 0.01 ), BR( -1, -0.02 );
+    real_type s1, t1, dL1, dR1;
+    C.closestPointCorridor_ISO( px, py, BL, BR, s1, t1, dL1, dR1 );
+    if ( abs(s1-s) > 1e-12 || abs( dL1-(BL(s1)-t1) ) > 1e-12 ||
+         abs( dR1-(t1-BR(s1)) ) > 1e-12 ) {
+      cout << what << " variable borders s = " << s1 << '\n';
+      ++nerr;
+    }
+
+    // SAE: the borders and t change sign
+    real_type s2, t2, dL2, dR2;
+    C.closestPointCorridor_SAE( px, py, -L, -R, s2, t2, dL2, dR2 );
+    if ( abs(s2-s) > 1e-12 || abs(t2+t) > 1e-12 ||
+         abs(dL2-dL) > 1e-12 || abs(dR2-dR) > 1e-12 ) {
+      cout << what << " SAE s = " << s2 << " (" << dL2 << "," << dR2
+           << ") expected (" << dL << "," << dR << ")\n";
+      ++nerr;
+    }
+  }
+  if ( northo < 300 ) {
+    cout << what << " only " << northo << " orthogonal projections\n";
+    ++nerr;
+  }
+  return nerr;
+}
+
+int
+main() {
+
+  int_type const n = 40;
+  vector<real_type> x(n), y(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    x[i] = 8*i;
+    y[i] = 12*sin(0.2*i);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( n, &x.front(), &y.front() );
+
+  G2lib::BiarcList BL;
+  BL.build_G1( n, &x.front(), &y.front() );
+
+  int_type nerr = check( "ClothoidList", CL ) + check( "BiarcList", BL );
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Check the broadphase of CurveScene against a brute force search
+ *
+ * Random insertions, removals and moves (inside and outside the margin
+ * of the bbox) alternate with collision and collisionPairs queries,
+ * the result must be the one of G2lib::collision on all the curves.
+ */
+
+#include "CurveScene.hh"
+#include "Clothoid.hh"
+#include "Circle.hh"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <utility>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+typedef pair<int_type,int_type> IdPair;
+
+static
+real_type
+rnd( real_type a, real_type b )
+{ return a + (b-a)*rand()/real_type(RAND_MAX); }
+
+int
+main() {
+
+  int_type const N = 120;
+  // the scene stores pointers: the curves must not be reallocated
+  vector<G2lib::ClothoidCurve> clothoids(N);
+  vector<G2lib::CircleArc>     arcs(N);
+  vector<G2lib::BaseCurve *>   curves(2*N);
+  for ( int_type i = 0; i < N; ++i ) {
+    clothoids[i].build( rnd(0,200), rnd(0,200), rnd(-3,3), rnd(-0.05,0.05),
+                        rnd(-0.002,0.002), rnd(5,30) );
+    arcs[i].build( rnd(0,200), rnd(0,200), rnd(-3,3), rnd(-0.1,0.1), rnd(5,30) );
+    curves[2*i]   = &clothoids[i];
+    curves[2*i+1] = &arcs[i];
+  }
+
+  G2lib::CurveScene scene( 2 );
+  vector<int_type> id_of( 2*N, -1 ); // id in the scene of each curve
+  vector<int_type> curve_of;         // curve of each id of the scene
+
+  srand(1234);
+  int_type nerr = 0;
+  vector<int_type> ids, ref;
+  vector<IdPair>   pairs, refPairs;
+  for ( int_type step = 0; step < 600; ++step ) {
+    int_type k = rand() % (2*N);
+    int_type op = rand() % 4;
+    if ( id_of[k] < 0 ) { // insert
+      int_type id = scene.insert( *curves[k] );
+      if ( id >= int_type(curve_of.size()) ) curve_of.resize( id+1, -1 );
+      id_of[k]     = id;
+      curve_of[id] = k;
+    } else if ( op == 0 ) { // remove
+      scene.remove( id_of[k] );
+      curve_of[id_of[k]] = -1;
+      id_of[k] = -1;
+    } else { // move, small or large
+      real_type d = op == 1 ? 0.5 : 40;
+      curves[k]->translate( rnd(-d,d), rnd(-d,d) );
+      scene.moved( id_of[k] );
+    }
+
+    if ( step % 10 != 9 ) continue;
+
+    // collision with a probe curve
+    G2lib::ClothoidCurve P( rnd(0,200), rnd(0,200), rnd(-3,3), 0.01, 0, 60 );
+    scene.collision( P, ids );
+    ref.clear();
+    for ( int_type id = 0; id < int_type(curve_of.size()); ++id )
+      if ( curve_of[id] >= 0 && G2lib::collision( P, *curves[curve_of[id]] ) )
+        ref.push_back( id );
+    if ( ids != ref ) {
+      cout << "step " << step << " collision found " << ids.size()
+           << " curves, expected " << ref.size() << '\n';
+      ++nerr;
+    }
+
+    // all the pairs
+    scene.collisionPairs( pairs );
+    refPairs.clear();
+    for ( int_type i = 0; i < int_type(curve_of.size()); ++i ) {
+      if ( curve_of[i] < 0 ) continue;
+      for ( int_type j = i+1; j < int_type(curve_of.size()); ++j )
+        if ( curve_of[j] >= 0 &&
+             G2lib::collision( *curves[curve_of[i]], *curves[curve_of[j]] ) )
+          refPairs.push_back( IdPair( i, j ) );
+    }
+    if ( pairs != refPairs ) {
+      cout << "step " << step << " collisionPairs found " << pairs.size()
+           << " pairs, expected " << refPairs.size() << '\n';
+      ++nerr;
+    }
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * Check the swept footprint collision of ClothoidList
+ *
+ *  - a rectangle swept along a path crosses obstacle segments: the first
+ *    contact against a dense sampling of the poses
+ *  - segments parallel to the path just inside and just outside the
+ *    rectangle: a contact is never missed, a clearance is never taken
+ *    for a confirmed contact
+ */
+
+#include "Footprint.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static
+real_type
+cross( real_type ax, real_type ay, real_type bx, real_type by )
+{ return ax*by - ay*bx; }
+
+// true if the segments p0-p1 and q0-q1 intersect
+static
+bool
+segmentSegment(
+  real_type p0x, real_type p0y, real_type p1x, real_type p1y,
+  real_type q0x, real_type q0y, real_type q1x, real_type q1y
+) {
+  real_type d1 = cross( p1x-p0x, p1y-p0y, q0x-p0x, q0y-p0y );
+  real_type d2 = cross( p1x-p0x, p1y-p0y, q1x-p0x, q1y-p0y );
+  real_type d3 = cross( q1x-q0x, q1y-q0y, p0x-q0x, p0y-q0y );
+  real_type d4 = cross( q1x-q0x, q1y-q0y, p1x-q0x, p1y-q0y );
+  return d1*d2 <= 0 && d3*d4 <= 0;
+}
+
+// true if the footprint at `s` overlaps the segment (ax,ay)-(bx,by)
+static
+bool
+overlap(
+  G2lib::ClothoidList const & P,
+  G2lib::Footprint    const & fp,
+  real_type                   s,
+  real_type ax, real_type ay, real_type bx, real_type by
+) {
+  int_type n = fp.numVertex();
+  vector<real_type> X(n), Y(n);
+  real_type x, y;
+  P.eval( s, x, y );
+  fp.pose( x, y, P.theta(s), &X.front(), &Y.front() );
+  bool inside = true; // (ax,ay) inside the (counterclockwise) polygon
+  for ( int_type i = 0, j = n-1; i < n; j = i++ ) {
+    if ( segmentSegment( X[j], Y[j], X[i], Y[i], ax, ay, bx, by ) ) return true;
+    if ( cross( X[i]-X[j], Y[i]-Y[j], ax-X[j], ay-Y[j] ) < 0 ) inside = false;
+  }
+  return inside;
+}
+
+// first s of the dense sampling with an overlap, -1 if none
+static
+real_type
+firstContact(
+  G2lib::ClothoidList const & P,
+  G2lib::Footprint    const & fp,
+  real_type                   h,
+  real_type ax, real_type ay, real_type bx, real_type by
+) {
+  int_type ns = int_type( ceil( P.length()/h ) );
+  for ( int_type i = 0; i <= ns; ++i ) {
+    real_type s = min( i*h, P.length() );
+    if ( overlap( P, fp, s, ax, ay, bx, by ) ) return s;
+  }
+  return -1;
+}
+
+int
+main() {
+
+  // path: a gentle S curve
+  int_type const n = 12;
+  vector<real_type> x(n), y(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    x[i] = 10*i;
+    y[i] = 6*sin(0.35*i);
+  }
+  G2lib::ClothoidList P;
+  P.build_G1( n, &x.front(), &y.front() );
+
+  // car-like rectangle: 3 ahead, 1 behind, 1 on each side
+  G2lib::Footprint fp( 3, 1, 1, 1 );
+
+  real_type const tol = 1e-3;
+  real_type const h   = 1e-4; // step of the dense sampling
+  int_type nerr = 0;
+
+  // segments crossing the path
+  for ( int_type k = 0; k < 12; ++k ) {
+    real_type sc = 8 + 8*k, xc, yc, th;
+    P.eval( sc, xc, yc );
+    th = P.theta( sc ) + 1.2 + 0.1*k; // not orthogonal to the path
+    real_type ax = xc - 4*cos(th), ay = yc - 4*sin(th);
+    real_type bx = xc + 4*cos(th), by = yc + 4*sin(th);
+    G2lib::ClothoidList O;
+    O.push_back( ax, ay, th, 0, 0, 8 );
+    vector<G2lib::ClothoidList const *> obstacles( 1, &O );
+
+    real_type s;
+    int_type  iobs;
+    int_type  res  = P.footprintCollision( fp, obstacles, tol, s, iobs );
+    real_type sref = firstContact( P, fp, h, ax, ay, bx, by );
+    bool ok = res != 0 && iobs == 0 && sref >= s-tol-h;
+    if ( res == 1 ) ok = ok && sref <= s+h; // contact in [s-tol,s]
+    if ( res == 2 ) ok = ok && sref <= s+tol+h;
+    if ( !ok ) {
+      cout << "crossing segment " << k << " res = " << res << " s = " << s
+           << " expected contact at " << sref << '\n';
+      ++nerr;
+    }
+  }
+
+  // segments parallel to a straight path, just inside or outside the
+  // left side of the rectangle
+  G2lib::ClothoidList S;
+  S.push_back( 0, 0, 0.3, 0, 0, 60 );
+  real_type const gap[] = { 1e-2, 1e-3, 1e-5, -1e-5, -1e-3, -1e-2 };
+  for ( int_type k = 0; k < 6; ++k ) {
+    real_type s0 = 30, xa, ya, th = 0.3;
+    S.eval_ISO( s0, 1+gap[k], xa, ya );
+    real_type xb = xa + 5*cos(th), yb = ya + 5*sin(th);
+    G2lib::ClothoidList O;
+    O.push_back( xa, ya, th, 0, 0, 5 );
+    vector<G2lib::ClothoidList const *> obstacles( 1, &O );
+
+    real_type s;
+    int_type  iobs;
+    int_type  res  = S.footprintCollision( fp, obstacles, tol, s, iobs );
+    real_type sref = firstContact( S, fp, h, xa, ya, xb, yb );
+    if ( (sref >= 0) != (gap[k] < 0) ) {
+      cout << "parallel segment gap = " << gap[k] << " bad reference\n";
+      ++nerr;
+    }
+    bool ok;
+    if ( sref < 0 ) ok = res != 1; // clearance: no confirmed contact
+    else            ok = res != 0 && sref >= s-tol-h && ( res == 2 || sref <= s+h );
+    if ( !ok ) {
+      cout << "parallel segment gap = " << gap[k] << " res = " << res
+           << " s = " << s << " expected contact at " << sref << '\n';
+      ++nerr;
+    }
+  }
+
+  // no obstacle near the path
+  G2lib::ClothoidList O;
+  O.push_back( 50, 40, 0, 0, 0, 10 );
+  vector<G2lib::ClothoidList const *> obstacles( 1, &O );
+  real_type s;
+  int_type  iobs;
+  if ( P.footprintCollision( fp, obstacles, tol, s, iobs ) != 0 ) {
+    cout << "contact with a far obstacle\n";
+    ++nerr;
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
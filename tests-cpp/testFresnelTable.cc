@@ -0,0 +1,68 @@
+/*
+ * Check FresnelCS_table against FresnelCS
+ *
+ *  - at the breakpoints of the tables (1, each 1/4 up to 6) and at the
+ *    nearest floating point numbers on both sides
+ *  - on a grid of [-12,12], negative arguments included
+ *  - continuity of FresnelCS_table across the breakpoints
+ */
+
+#include "Fresnel.hh"
+#include <cmath>
+#include <iostream>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static
+int_type
+check( real_type x, real_type tol ) {
+  real_type C, S, Ct, St;
+  G2lib::FresnelCS( x, C, S );
+  G2lib::FresnelCS_table( x, Ct, St );
+  if ( abs(C-Ct) > tol || abs(S-St) > tol ) {
+    cout << "x = " << x << " C = " << Ct << " expected " << C
+         << " S = " << St << " expected " << S << '\n';
+    return 1;
+  }
+  return 0;
+}
+
+int
+main() {
+
+  cout.precision(17);
+  int_type nerr = 0;
+
+  // breakpoints of the tables
+  for ( int_type i = 4; i <= 24; ++i ) {
+    real_type x  = i/4.0;
+    real_type xl = nextafter( x, real_type(0) );
+    real_type xr = nextafter( x, real_type(10) );
+    nerr += check( x, 1e-14 );
+    nerr += check( xl, 1e-14 );
+    nerr += check( xr, 1e-14 );
+    nerr += check( -x, 1e-14 );
+
+    // the pieces on the two sides must agree
+    real_type Cl, Sl, Cr, Sr;
+    G2lib::FresnelCS_table( xl, Cl, Sl );
+    G2lib::FresnelCS_table( xr, Cr, Sr );
+    if ( abs(Cr-Cl) > 1e-14 || abs(Sr-Sl) > 1e-14 ) {
+      cout << "jump at x = " << x << " dC = " << Cr-Cl << " dS = " << Sr-Sl << '\n';
+      ++nerr;
+    }
+  }
+
+  // grid
+  for ( int_type i = -1200; i <= 1200; ++i )
+    nerr += check( i/100.0+1e-3, 1e-13 );
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * Check G2solve3arcBatch against G2solve3arc
+ *
+ *  - the batched GeneralizedFresnelCS against the scalar one, also with
+ *    the phase changes computed one by one and a number of problems not
+ *    multiple of the block
+ *  - the problems of testG2stat (angles and curvatures on a grid) solved
+ *    with the batch and one by one: same problems solved, curves within
+ *    the tolerance
+ */
+
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static
+real_type
+rnd( real_type a, real_type b )
+{ return a + (b-a)*rand()/real_type(RAND_MAX); }
+
+static
+bool
+same( G2lib::ClothoidCurve const & A, G2lib::ClothoidCurve const & B, real_type tol ) {
+  return abs( A.xBegin()-B.xBegin() )         < tol &&
+         abs( A.yBegin()-B.yBegin() )         < tol &&
+         abs( A.thetaBegin()-B.thetaBegin() ) < tol &&
+         abs( A.kappaBegin()-B.kappaBegin() ) < tol &&
+         abs( A.dkappa()-B.dkappa() )         < tol*max( real_type(1), abs(B.dkappa()) ) &&
+         abs( A.length()-B.length() )         < tol;
+}
+
+int
+main() {
+
+  static const real_type m_pi = 3.14159265358979323846264338328;
+
+  int_type nerr = 0;
+
+  // Fresnel integrals
+  int_type const nf = 1003;
+  vector<real_type> a(nf), b(nf), c(nf), X(3*nf), Y(3*nf);
+  for ( int_type i = 0; i < nf; ++i ) {
+    real_type scale = i % 5 == 0 ? 20 : 4; // some with large phase change
+    a[i] = rnd( -scale, scale );
+    b[i] = rnd( -scale, scale )/2;
+    c[i] = rnd( -50, 50 );
+  }
+  for ( int_type nk = 1; nk <= 3; ++nk ) {
+    G2lib::GeneralizedFresnelCS( nf, nk, &a.front(), &b.front(), &c.front(), &X.front(), &Y.front() );
+    real_type err = 0;
+    for ( int_type i = 0; i < nf; ++i ) {
+      real_type XX[3], YY[3];
+      G2lib::GeneralizedFresnelCS( nk, a[i], b[i], c[i], XX, YY );
+      for ( int_type k = 0; k < nk; ++k )
+        err = max( err, max( abs(X[i*nk+k]-XX[k]), abs(Y[i*nk+k]-YY[k]) ) );
+    }
+    if ( err > 1e-9 ) {
+      cout << "GeneralizedFresnelCS nk = " << nk << " batched error " << err << '\n';
+      ++nerr;
+    }
+  }
+
+  // the problems of testG2stat
+  int_type const NMAX = 16;
+  int_type const nkur = 17;
+  real_type kur[nkur], kmax = 10;
+  real_type q  = exp( 2*log(kmax)/7 );
+  real_type k0 = 1/kmax;
+  kur[0] = 0;
+  for ( int_type ii = 1; ii < nkur; ii += 2 ) {
+    kur[ii]   = k0;
+    kur[ii+1] = -k0;
+    k0 *= q;
+  }
+  real_type const thmin = -m_pi*0.999;
+  real_type const thmax =  m_pi*0.999;
+
+  vector<real_type> x0, y0, th0, kk0, x1, y1, th1, kk1;
+  for ( int_type ii = 0; ii < nkur; ++ii ) {
+    for ( int_type jj = 0; jj < nkur; ++jj ) {
+      for ( int_type i = 0; i < NMAX; ++i ) {
+        for ( int_type j = 0; j < NMAX; ++j ) {
+          x0.push_back( rnd( -1, 1 ) );
+          y0.push_back( rnd( -1, 1 ) );
+          th0.push_back( thmin + ((thmax-thmin)*i)/(NMAX-1) );
+          kk0.push_back( kur[ii] );
+          x1.push_back( x0.back() + rnd( 0.5, 2 ) );
+          y1.push_back( y0.back() + rnd( -1, 1 ) );
+          th1.push_back( thmin + ((thmax-thmin)*j)/(NMAX-1) );
+          kk1.push_back( kur[jj] );
+        }
+      }
+    }
+  }
+  int_type n = int_type(x0.size());
+
+  G2lib::G2solve3arcBatch       batch;
+  vector<int_type>              iter( x0.size() );
+  vector<G2lib::ClothoidCurve>  S0( x0.size() ), SM( x0.size() ), S1( x0.size() );
+  TicToc tictoc;
+  tictoc.tic();
+  int_type nsolved = batch.build(
+    n, &x0.front(), &y0.front(), &th0.front(), &kk0.front(),
+    &x1.front(), &y1.front(), &th1.front(), &kk1.front(),
+    &iter.front(), &S0.front(), &SM.front(), &S1.front()
+  );
+  tictoc.toc();
+  real_type tbatch = tictoc.elapsed_ms();
+
+  G2lib::G2solve3arc g2;
+  int_type nsolved1 = 0, ndiff = 0;
+  tictoc.tic();
+  for ( int_type i = 0; i < n; ++i )
+    if ( g2.build( x0[i], y0[i], th0[i], kk0[i], x1[i], y1[i], th1[i], kk1[i] ) >= 0 )
+      ++nsolved1;
+  tictoc.toc();
+  real_type tscalar = tictoc.elapsed_ms();
+
+  for ( int_type i = 0; i < n; ++i ) {
+    int_type it = g2.build( x0[i], y0[i], th0[i], kk0[i], x1[i], y1[i], th1[i], kk1[i] );
+    if ( (it >= 0) != (iter[i] >= 0) ) {
+      ++ndiff; // at the boundary of the convergence region
+      continue;
+    }
+    if ( it < 0 ) continue;
+    if ( !same( S0[i], g2.getS0(), 1e-7 ) ||
+         !same( SM[i], g2.getSM(), 1e-7 ) ||
+         !same( S1[i], g2.getS1(), 1e-7 ) ) {
+      cout << "problem " << i << ": the curves differ from G2solve3arc\n";
+      ++nerr;
+    }
+  }
+  if ( ndiff > n/1000 || nsolved < n*9/10 ) {
+    cout << "solved " << nsolved << " problems of " << n << ", G2solve3arc "
+         << nsolved1 << ", " << ndiff << " different\n";
+    ++nerr;
+  }
+
+  cout << n << " problems, batch " << tbatch << " ms, one by one "
+       << tscalar << " ms\n";
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
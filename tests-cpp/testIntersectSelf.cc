@@ -0,0 +1,100 @@
+/*
+ * Check the self intersections of ClothoidList and BiarcList
+ *
+ *  - a closed circle has no self intersections (the closure point
+ *    and the common points of the segments are not reported)
+ *  - a closed and an open figure eight cross once, also with offset
+ */
+
+#include "ClothoidList.hh"
+#include "BiarcList.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+template <typename LIST>
+int_type
+check(
+  char const * what,
+  LIST const & L,
+  real_type    offs,
+  size_t       nexpected
+) {
+  G2lib::IntersectList ilist;
+  L.intersect_self_ISO( offs, ilist );
+  if ( ilist.size() != nexpected ) {
+    cout << what << " offs = " << offs << ": found " << ilist.size()
+         << " self intersections, expected " << nexpected << '\n';
+    return 1;
+  }
+  for ( size_t i = 0; i < ilist.size(); ++i ) {
+    real_type x1, y1, x2, y2;
+    L.eval_ISO( ilist[i].first,  offs, x1, y1 );
+    L.eval_ISO( ilist[i].second, offs, x2, y2 );
+    if ( !( ilist[i].first < ilist[i].second ) || hypot( x2-x1, y2-y1 ) > 1e-6 ) {
+      cout << what << " offs = " << offs << ": bad intersection s = "
+           << ilist[i].first << ", " << ilist[i].second << '\n';
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// figure eight x = 60*sin(t), y = 30*sin(2*t) for t in [t0,t0+dt],
+// the crossing is in the origin at t = 0 and t = pi
+static
+void
+eight( G2lib::ClothoidList & CL, real_type t0, real_type dt, bool closed ) {
+  int_type const n = 80;
+  vector<real_type> x(n), y(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    real_type t = t0 + (dt*i)/(n-1);
+    x[i] = 60*sin(t);
+    y[i] = 30*sin(2*t);
+  }
+  if ( closed ) { x[n-1] = x[0]; y[n-1] = y[0]; }
+  CL.build_G1( n, &x.front(), &y.front() );
+}
+
+int
+main() {
+
+  int_type const n = 40;
+  vector<real_type> x(n), y(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    x[i] = 50*cos( (G2lib::m_2pi*i)/(n-1) );
+    y[i] = 50*sin( (G2lib::m_2pi*i)/(n-1) );
+  }
+  x[n-1] = x[0]; y[n-1] = y[0];
+  G2lib::ClothoidList circle, closed8, open8;
+  circle.build_G1( n, &x.front(), &y.front() );
+  eight( closed8, 0.3, G2lib::m_2pi, true );
+  eight( open8, -1.2, G2lib::m_pi+2.4, false );
+
+  G2lib::BiarcList bcircle, bclosed8, bopen8;
+  bcircle.build( circle, 1e-5 );
+  bclosed8.build( closed8, 1e-5 );
+  bopen8.build( open8, 1e-5 );
+
+  int_type nerr = 0;
+  real_type const offs[] = { 0, 2, -2 };
+  for ( int_type k = 0; k < 3; ++k ) {
+    nerr += check( "ClothoidList circle",  circle,   offs[k], 0 );
+    nerr += check( "ClothoidList closed8", closed8,  offs[k], 1 );
+    nerr += check( "ClothoidList open8",   open8,    offs[k], 1 );
+    nerr += check( "BiarcList circle",     bcircle,  offs[k], 0 );
+    nerr += check( "BiarcList closed8",    bclosed8, offs[k], 1 );
+    nerr += check( "BiarcList open8",      bopen8,   offs[k], 1 );
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * Check the streaming and the first intersection queries of
+ * ClothoidList and BiarcList against intersect_ISO
+ *
+ *  - intersect_visit_ISO must find the same intersections
+ *    and stop when the functor returns false
+ *  - intersect_first_ISO must return the intersection with minimum s1,
+ *    also when a line crosses twice an arc covered by a single triangle
+ */
+
+#include "ClothoidList.hh"
+#include "BiarcList.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// collect the intersections, stop after `nmax`
+class Collect {
+public:
+  G2lib::IntersectList ilist;
+  size_t               nmax;
+  Collect( size_t n ) : nmax(n) {}
+  bool
+  operator () ( real_type s1, real_type s2 ) {
+    ilist.push_back( G2lib::Ipair( s1, s2 ) );
+    return ilist.size() < nmax;
+  }
+};
+
+static
+bool
+same( G2lib::Ipair const & a, G2lib::Ipair const & b ) {
+  return abs(a.first-b.first) < 1e-8 && abs(a.second-b.second) < 1e-8;
+}
+
+// sort and remove the duplicates (intersect_ISO of BiarcList reports
+// an intersection once for each pair of overlapping triangles)
+static
+void
+normalize( G2lib::IntersectList & ilist ) {
+  sort( ilist.begin(), ilist.end() );
+  ilist.erase( unique( ilist.begin(), ilist.end(), same ), ilist.end() );
+}
+
+template <typename LIST>
+int_type
+check(
+  char const * what,
+  LIST const & A,
+  LIST const & B,
+  real_type    offsA,
+  real_type    offsB
+) {
+  G2lib::IntersectList ref;
+  A.intersect_ISO( offsA, B, offsB, ref, false );
+  normalize( ref );
+
+  int_type nerr = 0;
+
+  // all the intersections
+  Collect all( 1000000 );
+  bool done = A.intersect_visit_ISO( offsA, B, offsB, all );
+  normalize( all.ilist );
+  if ( !done || all.ilist.size() != ref.size() ) {
+    cout << what << " offs = " << offsA << ", " << offsB << ": visit found "
+         << all.ilist.size() << " intersections, expected " << ref.size() << '\n';
+    ++nerr;
+  } else {
+    for ( size_t i = 0; i < ref.size(); ++i ) {
+      if ( !same( all.ilist[i], ref[i] ) ) {
+        cout << what << ": visit s1 = " << all.ilist[i].first
+             << " expected " << ref[i].first << '\n';
+        ++nerr;
+      }
+    }
+  }
+
+  // stop at the first one
+  if ( !ref.empty() ) {
+    Collect one( 1 );
+    done = A.intersect_visit_ISO( offsA, B, offsB, one );
+    if ( done || one.ilist.size() != 1 ) {
+      cout << what << ": the visit was not stopped\n";
+      ++nerr;
+    }
+  }
+
+  // first along the list
+  real_type s1, s2;
+  bool found = A.intersect_first_ISO( offsA, B, offsB, s1, s2 );
+  if ( found != !ref.empty() ||
+       ( found && ( abs(s1-ref[0].first) > 1e-8 || abs(s2-ref[0].second) > 1e-8 ) ) ) {
+    cout << what << " offs = " << offsA << ", " << offsB << ": first s1 = "
+         << ( found ? s1 : -1 ) << " expected "
+         << ( ref.empty() ? -1 : ref[0].first ) << '\n';
+    ++nerr;
+  }
+  return nerr;
+}
+
+int
+main() {
+
+  int_type const n = 50;
+  vector<real_type> x(n), y(n), x1(n), y1(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    x[i]  = 5*i;
+    y[i]  = 12*sin(0.3*i);
+    x1[i] = 5*i+2;
+    y1[i] = 10*cos(0.25*i)+1;
+  }
+  G2lib::ClothoidList A, B, L;
+  A.build_G1( n, &x.front(), &y.front() );
+  B.build_G1( n, &x1.front(), &y1.front() );
+  L.push_back( -10, 0, 0.05, 0, 0, 300 ); // nearly straight line
+
+  G2lib::BiarcList BA, BB;
+  BA.build( A, 1e-4 );
+  BB.build( B, 1e-4 );
+
+  int_type nerr = 0;
+  real_type const offs[] = { 0, 1.5, -2 };
+  for ( int_type i = 0; i < 3; ++i ) {
+    for ( int_type j = 0; j < 3; ++j ) {
+      nerr += check( "ClothoidList", A, B, offs[i], offs[j] );
+      nerr += check( "ClothoidList", A, L, offs[i], offs[j] );
+      nerr += check( "BiarcList", BA, BB, offs[i], offs[j] );
+    }
+  }
+
+  // a line crossing twice an arc of radius 100 inside one triangle (the
+  // crossings get closer to a tangency with k),
+  // first crossing from the intersection of the line with the circle
+  G2lib::ClothoidList AC, LC;
+  AC.push_back( 0, 0, 0, 0.01, 0, 15 );
+  G2lib::BiarcList BAC, BLC;
+  BAC.build( AC, 1e-6 );
+  for ( int_type k = 0; k < 20; ++k ) {
+    real_type qx = -10, qy = -0.82 - 0.006*k, m = 0.07;
+    real_type len = hypot( 1, m ), ux = 1/len, uy = m/len;
+    LC.init();
+    LC.push_back( qx, qy, atan(m), 0, 0, 40 );
+    BLC.init();
+    BLC.build( LC, 1e-6 );
+    // |q + t u - (0,100)| = 100
+    real_type cy = qy-100;
+    real_type b  = qx*ux + cy*uy;
+    real_type d  = sqrt( b*b - qx*qx - cy*cy + 1e4 );
+    real_type t  = -b-d, x = qx+t*ux, y = qy+t*uy;
+    real_type s1ref = 100*atan2( x, 100-y );
+    real_type s1, s2, bs1, bs2;
+    bool found  = AC.intersect_first_ISO( 0, LC, 0, s1, s2 );
+    bool bfound = BAC.intersect_first_ISO( 0, BLC, 0, bs1, bs2 );
+    if ( !found || abs(s1-s1ref) > 1e-8 || abs(s2-t) > 1e-8 ||
+         !bfound || abs(bs1-s1ref) > 1e-5 || abs(bs2-t) > 1e-5 ) {
+      cout << "double crossing " << k << " first s1 = " << s1 << " (biarc "
+           << bs1 << ") expected " << s1ref << '\n';
+      ++nerr;
+    }
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
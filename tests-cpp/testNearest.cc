@@ -0,0 +1,128 @@
+/*
+ * Check the k-nearest and radius queries of ClothoidList, BiarcList
+ * and PolyLine against a brute force search on all the segments.
+ */
+
+#include "ClothoidList.hh"
+#include "BiarcList.hh"
+#include "PolyLine.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+typedef pair<real_type,int_type> DstSeg;
+
+// compare the distances, equal distances may come in any order
+static
+int_type
+check(
+  char const              * what,
+  vector<DstSeg>    const & ref,
+  vector<int_type>  const & segments,
+  vector<real_type> const & dsts
+) {
+  if ( segments.size() != ref.size() || dsts.size() != ref.size() ) {
+    cout << what << ": found " << segments.size()
+         << " segments, expected " << ref.size() << '\n';
+    return 1;
+  }
+  for ( size_t i = 0; i < ref.size(); ++i ) {
+    if ( abs( dsts[i]-ref[i].first ) > 1e-8 ) {
+      cout << what << ": distance " << dsts[i] << " of segment " << segments[i]
+           << ", expected " << ref[i].first << " of segment " << ref[i].second << '\n';
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int
+main() {
+
+  int_type const n = 80;
+  vector<real_type> x(n), y(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    real_type a = 0.08*i;
+    x[i] = (50+4*i)*cos(a);
+    y[i] = (50+4*i)*sin(a);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( n, &x.front(), &y.front() );
+
+  G2lib::BiarcList BL;
+  BL.build_G1( n, &x.front(), &y.front() );
+
+  G2lib::PolyLine PL;
+  PL.build( CL, 0.05 );
+
+  int_type nerr = 0;
+  real_type const offs[] = { 0, 2.5, -4 };
+  vector<int_type>  segments;
+  vector<real_type> dsts;
+  for ( int_type q = 0; q < 50; ++q ) {
+    real_type qx = 400*cos(0.37*q)*(q%7)/6.0;
+    real_type qy = 400*sin(0.53*q)*(q%5)/4.0;
+    for ( int_type k = 0; k < 3; ++k ) {
+      vector<DstSeg> ref;
+      for ( int_type i = 0; i < CL.numSegment(); ++i )
+        ref.push_back( DstSeg( CL.get(i).distance_ISO( qx, qy, offs[k] ), i ) );
+      sort( ref.begin(), ref.end() );
+
+      CL.closestSegments_ISO( qx, qy, offs[k], 5, segments, dsts );
+      nerr += check( "ClothoidList::closestSegments_ISO",
+                     vector<DstSeg>( ref.begin(), ref.begin()+5 ), segments, dsts );
+
+      real_type r = ref[10].first + 1e-6;
+      CL.segmentsInRadius_ISO( qx, qy, offs[k], r, segments, dsts );
+      size_t nr = 0;
+      while ( nr < ref.size() && ref[nr].first <= r ) ++nr;
+      nerr += check( "ClothoidList::segmentsInRadius_ISO",
+                     vector<DstSeg>( ref.begin(), ref.begin()+nr ), segments, dsts );
+
+      ref.clear();
+      for ( int_type i = 0; i < BL.numSegment(); ++i )
+        ref.push_back( DstSeg( BL.get(i).distance_ISO( qx, qy, offs[k] ), i ) );
+      sort( ref.begin(), ref.end() );
+
+      BL.closestSegments_ISO( qx, qy, offs[k], 5, segments, dsts );
+      nerr += check( "BiarcList::closestSegments_ISO",
+                     vector<DstSeg>( ref.begin(), ref.begin()+5 ), segments, dsts );
+
+      r = ref[10].first + 1e-6;
+      BL.segmentsInRadius_ISO( qx, qy, offs[k], r, segments, dsts );
+      nr = 0;
+      while ( nr < ref.size() && ref[nr].first <= r ) ++nr;
+      nerr += check( "BiarcList::segmentsInRadius_ISO",
+                     vector<DstSeg>( ref.begin(), ref.begin()+nr ), segments, dsts );
+    }
+
+    vector<DstSeg> ref;
+    for ( int_type i = 0; i < PL.numSegment(); ++i )
+      ref.push_back( DstSeg( PL.getSegment(i).distance( qx, qy ), i ) );
+    sort( ref.begin(), ref.end() );
+
+    PL.closestSegments( qx, qy, 7, segments, dsts );
+    nerr += check( "PolyLine::closestSegments",
+                   vector<DstSeg>( ref.begin(), ref.begin()+7 ), segments, dsts );
+
+    real_type r = ref[20].first + 1e-6;
+    PL.segmentsInRadius( qx, qy, r, segments, dsts );
+    size_t nr = 0;
+    while ( nr < ref.size() && ref[nr].first <= r ) ++nr;
+    nerr += check( "PolyLine::segmentsInRadius",
+                   vector<DstSeg>( ref.begin(), ref.begin()+nr ), segments, dsts );
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
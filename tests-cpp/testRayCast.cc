@@ -0,0 +1,158 @@
+/*
+ * Check the ray casting of ClothoidList
+ *
+ *  - the first hit of random rays against the intersection of the list
+ *    with the segment of the ray
+ *  - grazing rays on a circle, where the Newton iteration from the
+ *    middle of the triangle may fail
+ *  - the batched call against the single ray
+ *  - rays crossing twice a gentle arc covered by a single triangle,
+ *    against the first sign change of (P(s)-q) x u on dense samples
+ */
+
+#include "ClothoidList.hh"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// first crossing (smallest t >= 0) of the ray with the curve by dense
+// sampling of g(s) = (P(s)-q) x u and bisection, -1 if none
+static
+real_type
+firstCrossing(
+  G2lib::BaseCurve const & C,
+  real_type qx, real_type qy, real_type ux, real_type uy,
+  real_type & sref
+) {
+  real_type tbest = -1;
+  int_type  ns    = 20000;
+  real_type h     = C.length()/ns;
+  real_type x, y;
+  C.eval( 0, x, y );
+  real_type gl = (x-qx)*uy - (y-qy)*ux;
+  for ( int_type i = 1; i <= ns; ++i ) {
+    real_type l = (i-1)*h, r = i*h;
+    C.eval( r, x, y );
+    real_type gr = (x-qx)*uy - (y-qy)*ux, g0 = gl;
+    gl = gr;
+    if ( g0*gr > 0 ) continue;
+    for ( int_type k = 0; k < 60; ++k ) {
+      real_type m = (l+r)/2;
+      C.eval( m, x, y );
+      real_type gm = (x-qx)*uy - (y-qy)*ux;
+      if ( g0*gm <= 0 ) r = m;
+      else            { l = m; g0 = gm; }
+    }
+    C.eval( l, x, y );
+    real_type t = (x-qx)*ux + (y-qy)*uy;
+    if ( t >= 0 && ( tbest < 0 || t < tbest ) ) { tbest = t; sref = l; }
+  }
+  return tbest;
+}
+
+int
+main() {
+
+  int_type nerr = 0;
+
+  int_type const n = 40;
+  vector<real_type> x(n), y(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    x[i] = 6*i;
+    y[i] = 15*sin(0.25*i)+4*cos(0.9*i);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( n, &x.front(), &y.front() );
+
+  // random rays
+  real_type const max_range = 400;
+  srand(4321);
+  int_type nq = 300, nhit = 0;
+  vector<real_type> qx(nq), qy(nq), dx(nq), dy(nq), s(nq), dst(nq);
+  for ( int_type q = 0; q < nq; ++q ) {
+    qx[q] = 240*rand()/real_type(RAND_MAX);
+    qy[q] = 80*rand()/real_type(RAND_MAX)-40;
+    real_type a = G2lib::m_2pi*rand()/real_type(RAND_MAX);
+    dx[q] = cos(a);
+    dy[q] = sin(a);
+
+    G2lib::ClothoidList R;
+    R.push_back( qx[q], qy[q], a, 0, 0, max_range );
+    G2lib::IntersectList ilist;
+    CL.intersect( R, ilist, false );
+    real_type tref = -1;
+    for ( size_t i = 0; i < ilist.size(); ++i )
+      if ( tref < 0 || ilist[i].second < tref ) tref = ilist[i].second;
+
+    real_type xx, yy;
+    bool ok = CL.rayCast_ISO(
+      qx[q], qy[q], dx[q], dy[q], max_range, 0, xx, yy, s[q], dst[q]
+    );
+    if ( ok ) ++nhit;
+    if ( ok != (tref >= 0) || ( ok && abs(dst[q]-tref) > 1e-6 ) ) {
+      cout << "ray " << q << " hit " << ok << " dst = " << (ok ? dst[q] : -1)
+           << " expected " << tref << '\n';
+      ++nerr;
+    }
+  }
+
+  // batched call
+  vector<real_type> s1(nq), dst1(nq);
+  int_type nhit1 = CL.rayCast_ISO(
+    nq, &qx.front(), &qy.front(), &dx.front(), &dy.front(),
+    max_range, 0, &s1.front(), &dst1.front()
+  );
+  if ( nhit1 != nhit ) {
+    cout << "batched rayCast_ISO: " << nhit1 << " hits, expected " << nhit << '\n';
+    ++nerr;
+  }
+
+  // grazing rays on a circle of radius 10 centered in (0,10)
+  G2lib::ClothoidList C;
+  C.push_back( 0, 0, 0, 0.1, 0, 20*G2lib::m_pi );
+  real_type const gap[] = { 1e-2, 1e-4, 1e-6, 1e-8 };
+  for ( int_type k = 0; k < 4; ++k ) {
+    real_type d = 10-gap[k]; // distance of the ray from the center
+    real_type h = sqrt( 100-d*d );
+    real_type xx, yy, ss, tt;
+    bool ok = C.rayCast_ISO( -30, 10-d, 1, 0, 100, 0, xx, yy, ss, tt );
+    if ( !ok || abs( tt-(30-h) ) > 1e-6 ) {
+      cout << "grazing ray gap = " << gap[k] << " hit " << ok << " dst = " << tt
+           << " expected " << 30-h << '\n';
+      ++nerr;
+    }
+  }
+
+  // a gentle arc covered by one triangle, the rays cross it twice: the
+  // Newton iteration from the middle of the triangle finds the second
+  G2lib::ClothoidCurve A( 0, 0, 0, 0.01, 0, 15 );
+  G2lib::ClothoidList  AL;
+  AL.push_back( A );
+  for ( int_type k = 0; k < 40; ++k ) {
+    real_type qx = -10, qy = -0.82 + 0.01*k, m = 0.07 + 0.001*(k%7);
+    real_type len = hypot( 1, m ), ux = 1/len, uy = m/len;
+    real_type sref = 0, tref = firstCrossing( A, qx, qy, ux, uy, sref );
+    real_type xx, yy, ss, tt, ss1, tt1;
+    bool ok  = A.rayCast_ISO( qx, qy, 1, m, 100, 0, xx, yy, ss, tt );
+    bool ok1 = AL.rayCast_ISO( qx, qy, 1, m, 100, 0, xx, yy, ss1, tt1 );
+    if ( ok != (tref >= 0) || ok1 != ok ||
+         ( ok && ( abs(tt-tref) > 1e-6 || abs(tt1-tref) > 1e-6 ) ) ) {
+      cout << "double crossing ray " << k << " hit " << ok << " s = " << ss
+           << " dst = " << tt << " (list " << tt1 << ") expected s = " << sref
+           << " dst = " << tref << '\n';
+      ++nerr;
+    }
+  }
+
+  if ( nerr > 0 ) {
+    cout << "FAILED " << nerr << " checks\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
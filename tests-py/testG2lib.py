@@ -0,0 +1,141 @@
+#
+# Smoke test of the Python module G2lib
+#
+#  - the vectors in input: lists, `array.array('d')` and C contiguous
+#    float64 buffers (used without copy), strided and float32 buffers
+#    (converted), the buffers in input are not modified
+#  - scalar in input: float (int for the codes) in output, vector in
+#    input: vectors of the same size in output
+#  - the codes of closestPoint: 1 orthogonal projection, -1 projection
+#    on an extremum
+#  - copy() used by threads querying the same curve
+#
+# Run from the root of the repository after `cmake -DG2LIB_PYTHON=ON`,
+# the directory of the module is the first argument (default `lib`).
+#
+
+import sys
+import math
+import array
+import threading
+
+sys.path.insert(0, sys.argv[1] if len(sys.argv) > 1 else 'lib')
+import G2lib
+
+nerr = 0
+
+
+def check(ok, what):
+    global nerr
+    if not ok:
+        print(what)
+        nerr += 1
+
+
+def close(a, b, tol=1e-12):
+    return len(a) == len(b) and all(abs(u - v) <= tol for u, v in zip(a, b))
+
+
+# L shaped polyline (0,0) -> (10,0) -> (10,10)
+P = G2lib.PolyLine()
+P.build(array.array('d', [0, 10, 10]), array.array('d', [0, 0, 10]))
+check(abs(P.length() - 20) < 1e-12, 'PolyLine length %g' % P.length())
+
+# scalar in input
+r = P.closestPoint(5.0, 1.0)
+check(len(r) == 6 and all(isinstance(v, float) for v in r[:5]) and
+      isinstance(r[5], int), 'closestPoint scalar: %s' % (r,))
+check(close(r[:5], (5, 0, 5, 1, 1)) and r[5] == 1,
+      'closestPoint (5,1): %s' % (r,))
+d = P.distance(5, 1)
+check(isinstance(d, float) and abs(d - 1) < 1e-12, 'distance scalar: %s' % d)
+
+# vectors in input, the last point projects on the extremum (0,0)
+qx = [5, 12, -3]
+qy = [1, 5, -2]
+ref = P.closestPoint(qx, qy)
+check(all(len(v) == 3 for v in ref), 'closestPoint vector sizes')
+check(close(ref[2], [5, 15, 0]) and close(ref[4], [1, 2, math.hypot(3, 2)]),
+      'closestPoint vector: s = %s dst = %s' % (list(ref[2]), list(ref[4])))
+check(list(ref[5]) == [1, 1, -1], 'closestPoint codes %s' % list(ref[5]))
+
+# the same points in the buffers
+ax = array.array('d', qx)
+ay = array.array('d', qy)
+bx = memoryview(array.array('d', qx).tobytes()).cast('d')  # read only
+sx = memoryview(array.array('d', [5, 0, 12, 0, -3, 0]))[::2]  # strided
+fy = array.array('f', qy)                                     # float32
+for x, y, name in ((ax, ay, 'array'), (bx, ay, 'read only buffer'),
+                   (sx, ay, 'strided buffer'), (ax, fy, 'float32 buffer')):
+    r = P.closestPoint(x, y)
+    check(all(close(r[k], ref[k]) for k in range(5)) and
+          list(r[5]) == list(ref[5]), 'closestPoint with %s' % name)
+check(list(ax) == qx and list(ay) == qy, 'input buffers modified')
+
+# eval and evaluate on a clothoid
+C = G2lib.ClothoidCurve()
+C.build_G1(0, 0, 0, 10, 0, 0)
+s = array.array('d', [0, 2.5, 5, 7.5, 10])
+x, y = C.eval(s)
+th, k, xx, yy = C.evaluate(s, 0.5)
+check(len(x) == 5 and close(x, s) and close(y, [0] * 5),
+      'eval: %s %s' % (list(x), list(y)))
+check(len(th) == 5 and close(xx, s) and close(yy, [0.5] * 5) and
+      close(th, [0] * 5) and close(k, [0] * 5), 'evaluate with offset')
+x0, y0 = C.eval(2.5)
+check(isinstance(x0, float) and abs(x0 - 2.5) < 1e-12, 'eval scalar')
+r = C.closestPoint([5, 12], [1, 0])
+check(list(r[5]) == [1, -1] and close(r[4], [1, 2]),
+      'ClothoidCurve closestPoint: dst = %s res = %s' % (list(r[4]), list(r[5])))
+
+# errors
+try:
+    P.closestPoint([1, 2], [1])
+    check(False, 'no error for vectors of different size')
+except ValueError:
+    pass
+try:
+    P.eval('abc')
+    check(False, 'no error for a string')
+except TypeError:
+    pass
+
+# intersections of the polyline with a clothoid list
+# (vertical line x = 5 from y = -5 to y = 5)
+CL = G2lib.ClothoidList()
+CL.build_G1(array.array('d', [5, 5, 5]), array.array('d', [-5, 2, 5]))
+s1, s2 = P.intersect(CL)
+check(len(s1) == 1 and close(s1, [5], 1e-8) and close(s2, [5], 1e-8),
+      'intersect: %s %s' % (list(s1), list(s2)))
+CL.build_G1(array.array('d', [5, 5, 15]), array.array('d', [-5, 5, 5]))
+
+# threads: each one queries its own copy of the same list
+n = 2000
+tx = [20 * math.sin(0.37 * i) for i in range(n)]
+ty = [20 * math.cos(0.23 * i) for i in range(n)]
+dref = list(CL.distance(tx, ty))
+out = {}
+
+
+def worker(j, curve):
+    out[j] = list(curve.distance(tx, ty))
+
+
+threads = [threading.Thread(target=worker, args=(j, CL.copy())) for j in range(4)]
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+check(all(close(out[j], dref) for j in range(4)), 'distance on the copies')
+
+# Fresnel integrals
+c, sf = G2lib.FresnelCS(0.0)
+check(c == 0 and sf == 0, 'FresnelCS(0)')
+c, sf = G2lib.FresnelCS([0, 1e6])
+check(len(c) == 2 and abs(c[1] - 0.5) < 1e-5 and abs(sf[1] - 0.5) < 1e-5,
+      'FresnelCS at infinity: %s %s' % (list(c), list(sf)))
+
+if nerr > 0:
+    print('FAILED %d checks' % nerr)
+    sys.exit(1)
+print('\n\nALL DONE FOLKS!!!')